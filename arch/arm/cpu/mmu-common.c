@@ -60,16 +60,25 @@ void *dma_alloc_map(struct device *dev,
 void *dma_alloc_coherent(struct device *dev,
 			 size_t size, dma_addr_t *dma_handle)
 {
+	void *ret;
+
 	/*
 	 * FIXME: This function needs a device argument to support non 1:1 mappings
 	 */
 
+	ret = dma_pool_alloc_coherent(size, dma_handle);
+	if (ret)
+		return ret;
+
 	return dma_alloc_map(dev, size, dma_handle, MAP_UNCACHED);
 }
 
 void dma_free_coherent(struct device *dev,
 		       void *mem, dma_addr_t dma_handle, size_t size)
 {
+	if (dma_pool_free_coherent(mem))
+		return;
+
 	size = PAGE_ALIGN(size);
 	remap_range(mem, size, MAP_CACHED);
 
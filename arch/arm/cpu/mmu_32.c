@@ -676,7 +676,16 @@ void __mmu_init(bool mmu_on)
  */
 void mmu_disable(void)
 {
-	__mmu_cache_flush();
+	/*
+	 * The ARMv7 __mmu_cache_off cleans and invalidates the whole
+	 * cache hierarchy by set/way after clearing the C bit, which
+	 * also covers everything dirtied until that point. Cleaning
+	 * here as well would run the most expensive part of the kernel
+	 * handoff twice. Earlier cores only invalidate in their
+	 * __mmu_cache_off and do need the explicit clean.
+	 */
+	if (cpu_architecture() < CPU_ARCH_ARMv7)
+		__mmu_cache_flush();
 	if (outer_cache.disable) {
 		outer_cache.flush_all();
 		outer_cache.disable();
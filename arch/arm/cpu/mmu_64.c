@@ -192,6 +192,74 @@ static void split_block(uint64_t *pte, int level, bool bbm)
 	set_pte_range(level, pte, (uint64_t)new_table, 1, PTE_TYPE_TABLE, bbm);
 }
 
+#ifdef __PBL__
+static void free_pte(uint64_t *table)
+{
+	/* The early page table allocator cannot reclaim */
+}
+#else
+static void free_pte(uint64_t *table)
+{
+	free(table);
+}
+#endif
+
+/*
+ * Folds a fully populated table back into a single block PTE.
+ *
+ * Remapping a window inside a larger region splits its block into a
+ * page table, and remapping the window back leaves the fine-grained
+ * table in place. Over time big cached regions end up translated by 4k
+ * entries, which thrashes the TLB during bulk copies and digest runs
+ * over large images. When all entries of a table turn out physically
+ * contiguous with identical attributes, point the parent back at a
+ * 2M/1G block descriptor and release the table.
+ */
+static void try_merge_block(uint64_t *pte, int level, bool bbm)
+{
+	uint64_t granularity, required_type, attrs, phys;
+	uint64_t *table;
+	int i;
+
+	if (pte_type(pte) != PTE_TYPE_TABLE)
+		return;
+
+	table = get_level_table(pte);
+
+	/* Deepest tables first, so chains of splits can fold completely */
+	if (level + 1 < 3) {
+		for (i = 0; i < MAX_PTE_ENTRIES; i++)
+			try_merge_block(&table[i], level + 1, bbm);
+	}
+
+	/* Level 0 entries cannot be block descriptors */
+	if (level == 0)
+		return;
+
+	/* Level 3 entries encode pages with the table type */
+	required_type = (level + 1 == 3) ? PTE_TYPE_PAGE : PTE_TYPE_BLOCK;
+	if ((table[0] & PTE_TYPE_MASK) != required_type)
+		return;
+
+	granularity = granule_size(level + 1);
+	phys = table[0] & XLAT_ADDR_MASK;
+	attrs = table[0] & ~XLAT_ADDR_MASK;
+
+	if (!IS_ALIGNED(phys, granule_size(level)))
+		return;
+
+	for (i = 1; i < MAX_PTE_ENTRIES; i++) {
+		if ((table[i] & XLAT_ADDR_MASK) != phys + (uint64_t)i * granularity)
+			return;
+		if ((table[i] & ~XLAT_ADDR_MASK) != attrs)
+			return;
+	}
+
+	set_pte_range(level, pte, phys, 1,
+		      (attrs & ~PTE_TYPE_MASK) | PTE_TYPE_BLOCK, bbm);
+	free_pte(table);
+}
+
 static int __arch_remap_range(uint64_t virt, uint64_t phys, uint64_t size,
 			      maptype_t map_type, bool bbm)
 {
@@ -203,6 +271,7 @@ static int __arch_remap_range(uint64_t virt, uint64_t phys, uint64_t size,
 	uint64_t *pte;
 	uint64_t idx;
 	uint64_t addr;
+	uint64_t end;
 	uint64_t *table;
 	uint64_t type;
 	int level;
@@ -220,6 +289,8 @@ static int __arch_remap_range(uint64_t virt, uint64_t phys, uint64_t size,
 	if (!size)
 		return 0;
 
+	end = virt + size - 1;
+
 	while (size) {
 		table = ttb;
 		for (level = 0; level < 4; level++) {
@@ -252,6 +323,18 @@ static int __arch_remap_range(uint64_t virt, uint64_t phys, uint64_t size,
 
 	}
 
+	/*
+	 * Fold tables that became uniform back into block descriptors,
+	 * unless the caller explicitly asked for page granularity.
+	 */
+	if (!force_pages) {
+		uint64_t first = (virt & level2mask(0)) >> level2shift(0);
+		uint64_t last = (end & level2mask(0)) >> level2shift(0);
+
+		for (idx = first; idx <= last; idx++)
+			try_merge_block(&ttb[idx], 0, bbm);
+	}
+
 	tlb_invalidate();
 	return 0;
 }
@@ -0,0 +1,119 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * pmu.c - wrap PMU event counters around a command invocation
+ */
+
+#include <common.h>
+#include <command.h>
+#include <getopt.h>
+#include <malloc.h>
+#include <string.h>
+#include <asm/pmu.h>
+
+/* programmable counters used at once; every ARMv7/v8 PMU has at least two */
+#define PMU_MAX_EVENTS	2
+
+static const struct {
+	const char *name;
+	unsigned int event;
+} pmu_events[] = {
+	{ "inst",	PMU_EV_INST_RETIRED },
+	{ "l1imiss",	PMU_EV_L1I_CACHE_REFILL },
+	{ "l1dmiss",	PMU_EV_L1D_CACHE_REFILL },
+	{ "l2miss",	PMU_EV_L2D_CACHE_REFILL },
+	{ "brmiss",	PMU_EV_BR_MIS_PRED },
+	{ "memaccess",	PMU_EV_MEM_ACCESS },
+};
+
+static int pmu_event_by_name(const char *name)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(pmu_events); i++)
+		if (!strcmp(pmu_events[i].name, name))
+			return i;
+
+	return -EINVAL;
+}
+
+static int do_pmu(int argc, char *argv[])
+{
+	unsigned int events[PMU_MAX_EVENTS];
+	int event_idx[PMU_MAX_EVENTS];
+	u64 counts[PMU_MAX_EVENTS + 1];
+	unsigned int i, num = 0;
+	u32 overflow;
+	char *cmd;
+	int opt, idx;
+
+	while ((opt = getopt(argc, argv, "+e:l")) > 0) {
+		switch (opt) {
+		case 'e':
+			if (num == min_t(unsigned int, PMU_MAX_EVENTS,
+					 pmu_num_counters())) {
+				printf("at most %u events\n", num);
+				return COMMAND_ERROR;
+			}
+
+			idx = pmu_event_by_name(optarg);
+			if (idx < 0) {
+				printf("unknown event '%s'\n", optarg);
+				return COMMAND_ERROR;
+			}
+
+			event_idx[num] = idx;
+			events[num] = pmu_events[idx].event;
+			num++;
+			break;
+		case 'l':
+			for (i = 0; i < ARRAY_SIZE(pmu_events); i++)
+				printf("%s\n", pmu_events[i].name);
+			return 0;
+		default:
+			return COMMAND_ERROR_USAGE;
+		}
+	}
+
+	argv += optind;
+	argc -= optind;
+
+	if (argc < 1)
+		return COMMAND_ERROR_USAGE;
+
+	cmd = strjoin(" ", argv, argc);
+
+	pmu_start(events, num);
+
+	run_command(cmd);
+
+	overflow = pmu_stop(counts, num);
+
+	free(cmd);
+
+	printf("cycles:    %llu\n", counts[num]);
+	for (i = 0; i < num; i++)
+		printf("%-10s %llu\n", pmu_events[event_idx[i]].name,
+		       counts[i]);
+
+	if (overflow)
+		printf("warning: counters overflowed, results are invalid\n");
+
+	return 0;
+}
+
+BAREBOX_CMD_HELP_START(pmu)
+BAREBOX_CMD_HELP_TEXT("Run COMMAND with PMU counters armed and print the cycle count")
+BAREBOX_CMD_HELP_TEXT("and the selected event counts afterwards.")
+BAREBOX_CMD_HELP_TEXT("")
+BAREBOX_CMD_HELP_TEXT("Options:")
+BAREBOX_CMD_HELP_OPT ("-e EVENT",  "count EVENT, may be given twice")
+BAREBOX_CMD_HELP_OPT ("-l",        "list the available events")
+BAREBOX_CMD_HELP_END
+
+BAREBOX_CMD_START(pmu)
+	.cmd		= do_pmu,
+	BAREBOX_CMD_DESC("measure a command with the PMU")
+	BAREBOX_CMD_OPTS("[-e EVENT] [-l] COMMAND")
+	BAREBOX_CMD_GROUP(CMD_GRP_MISC)
+	BAREBOX_CMD_HELP(cmd_pmu_help)
+BAREBOX_CMD_END
@@ -0,0 +1,122 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * pmu_32.c - ARMv7 performance monitor unit access (PMUv2)
+ */
+
+#include <common.h>
+#include <asm/pmu.h>
+#include <asm/system.h>
+
+#define PMCR_E		BIT(0)	/* enable all counters */
+#define PMCR_P		BIT(1)	/* reset event counters */
+#define PMCR_C		BIT(2)	/* reset cycle counter */
+#define PMCR_N_SHIFT	11
+#define PMCR_N_MASK	0x1f
+
+#define PMCNTEN_C	BIT(31)	/* cycle counter enable bit */
+
+static inline u32 pmcr_read(void)
+{
+	u32 val;
+
+	asm volatile("mrc p15, 0, %0, c9, c12, 0" : "=r" (val));
+	return val;
+}
+
+static inline void pmcr_write(u32 val)
+{
+	asm volatile("mcr p15, 0, %0, c9, c12, 0" : : "r" (val));
+}
+
+static inline void pmcntenset_write(u32 val)
+{
+	asm volatile("mcr p15, 0, %0, c9, c12, 1" : : "r" (val));
+}
+
+static inline void pmcntenclr_write(u32 val)
+{
+	asm volatile("mcr p15, 0, %0, c9, c12, 2" : : "r" (val));
+}
+
+static inline u32 pmovsr_read(void)
+{
+	u32 val;
+
+	asm volatile("mrc p15, 0, %0, c9, c12, 3" : "=r" (val));
+	return val;
+}
+
+static inline void pmovsr_write(u32 val)
+{
+	asm volatile("mcr p15, 0, %0, c9, c12, 3" : : "r" (val));
+}
+
+static inline void pmselr_write(u32 val)
+{
+	asm volatile("mcr p15, 0, %0, c9, c12, 5" : : "r" (val));
+}
+
+static inline void pmxevtyper_write(u32 val)
+{
+	asm volatile("mcr p15, 0, %0, c9, c13, 1" : : "r" (val));
+}
+
+static inline u32 pmxevcntr_read(void)
+{
+	u32 val;
+
+	asm volatile("mrc p15, 0, %0, c9, c13, 2" : "=r" (val));
+	return val;
+}
+
+static inline u32 pmccntr_read(void)
+{
+	u32 val;
+
+	asm volatile("mrc p15, 0, %0, c9, c13, 0" : "=r" (val));
+	return val;
+}
+
+unsigned int pmu_num_counters(void)
+{
+	return (pmcr_read() >> PMCR_N_SHIFT) & PMCR_N_MASK;
+}
+
+void pmu_start(const unsigned int *events, unsigned int num)
+{
+	u32 enable = PMCNTEN_C;
+	unsigned int i;
+
+	/* stop everything before reprogramming */
+	pmcr_write(pmcr_read() & ~PMCR_E);
+	pmcntenclr_write(~0);
+	pmovsr_write(~0);
+
+	for (i = 0; i < num; i++) {
+		pmselr_write(i);
+		isb();
+		pmxevtyper_write(events[i]);
+		enable |= BIT(i);
+	}
+
+	pmcntenset_write(enable);
+	pmcr_write(pmcr_read() | PMCR_P | PMCR_C | PMCR_E);
+	isb();
+}
+
+u32 pmu_stop(u64 *counts, unsigned int num)
+{
+	unsigned int i;
+
+	isb();
+	pmcr_write(pmcr_read() & ~PMCR_E);
+
+	for (i = 0; i < num; i++) {
+		pmselr_write(i);
+		isb();
+		counts[i] = pmxevcntr_read();
+	}
+	counts[num] = pmccntr_read();
+
+	return pmovsr_read();
+}
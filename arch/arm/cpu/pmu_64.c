@@ -0,0 +1,62 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * pmu_64.c - ARMv8 performance monitor unit access (PMUv3)
+ */
+
+#include <common.h>
+#include <asm/pmu.h>
+#include <asm/sysreg.h>
+#include <asm/system.h>
+
+#define PMCR_E		BIT(0)	/* enable all counters */
+#define PMCR_P		BIT(1)	/* reset event counters */
+#define PMCR_C		BIT(2)	/* reset cycle counter */
+#define PMCR_N_SHIFT	11
+#define PMCR_N_MASK	0x1f
+
+#define PMCNTEN_C	BIT(31)	/* cycle counter enable bit */
+
+unsigned int pmu_num_counters(void)
+{
+	return (read_sysreg(pmcr_el0) >> PMCR_N_SHIFT) & PMCR_N_MASK;
+}
+
+void pmu_start(const unsigned int *events, unsigned int num)
+{
+	u32 enable = PMCNTEN_C;
+	unsigned int i;
+
+	/* stop everything before reprogramming */
+	write_sysreg(read_sysreg(pmcr_el0) & ~PMCR_E, pmcr_el0);
+	write_sysreg(~0UL, pmcntenclr_el0);
+	write_sysreg(~0UL, pmovsclr_el0);
+
+	for (i = 0; i < num; i++) {
+		write_sysreg(i, pmselr_el0);
+		isb();
+		write_sysreg(events[i], pmxevtyper_el0);
+		enable |= BIT(i);
+	}
+
+	write_sysreg(enable, pmcntenset_el0);
+	write_sysreg(read_sysreg(pmcr_el0) | PMCR_P | PMCR_C | PMCR_E,
+		     pmcr_el0);
+	isb();
+}
+
+u32 pmu_stop(u64 *counts, unsigned int num)
+{
+	unsigned int i;
+
+	isb();
+	write_sysreg(read_sysreg(pmcr_el0) & ~PMCR_E, pmcr_el0);
+
+	for (i = 0; i < num; i++) {
+		write_sysreg(i, pmselr_el0);
+		isb();
+		counts[i] = read_sysreg(pmxevcntr_el0);
+	}
+	counts[num] = read_sysreg(pmccntr_el0);
+
+	return read_sysreg(pmovsclr_el0);
+}
@@ -92,6 +92,12 @@ static struct digest_algo sha224 = {
 
 static int sha224_ce_digest_register(void)
 {
+	uint64_t isar0;
+
+	isar0 = read_sysreg(ID_AA64ISAR0_EL1);
+	if (!(isar0 & ID_AA64ISAR0_EL1_SHA2_MASK))
+		return -EOPNOTSUPP;
+
 	return digest_algo_register(&sha224);
 }
 coredevice_initcall(sha224_ce_digest_register);
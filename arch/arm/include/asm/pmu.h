@@ -0,0 +1,40 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * pmu.h - ARM performance monitor unit access
+ */
+#ifndef __ASM_PMU_H
+#define __ASM_PMU_H
+
+#include <linux/types.h>
+
+/*
+ * Architected PMU event encodings, identical for ARMv7 PMUv2 and
+ * ARMv8 PMUv3. Only events that are architecturally required (or
+ * close to universally implemented) are listed here.
+ */
+#define PMU_EV_L1I_CACHE_REFILL	0x01
+#define PMU_EV_L1D_CACHE_REFILL	0x03
+#define PMU_EV_INST_RETIRED	0x08
+#define PMU_EV_BR_MIS_PRED	0x10
+#define PMU_EV_CPU_CYCLES	0x11
+#define PMU_EV_MEM_ACCESS	0x13
+#define PMU_EV_L2D_CACHE_REFILL	0x17
+
+/* number of programmable event counters, from PMCR.N */
+unsigned int pmu_num_counters(void);
+
+/*
+ * Program the first num event counters with the given event numbers,
+ * reset all counters including the dedicated cycle counter and start
+ * counting.
+ */
+void pmu_start(const unsigned int *events, unsigned int num);
+
+/*
+ * Stop counting and read back the results: counts[0..num-1] hold the
+ * programmed event counters, counts[num] the cycle counter. Returns
+ * the overflow flags in the same layout, 0 means all counts are valid.
+ */
+u32 pmu_stop(u64 *counts, unsigned int num);
+
+#endif /* __ASM_PMU_H */
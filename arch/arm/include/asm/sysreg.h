@@ -17,6 +17,7 @@
  */
 #define ID_AA64ISAR0_EL1_SHA1_MASK      0xF00UL
 #define ID_AA64ISAR0_EL1_SHA2_MASK      0xF000UL
+#define ID_AA64ISAR0_EL1_CRC32_MASK     0xF0000UL
 
 /*
  * Unlike read_cpuid, calls to read_sysreg are never expected to be
@@ -398,3 +398,30 @@ void dump_stack(void)
 {
 	unwind_backtrace(NULL);
 }
+
+unsigned int stack_save(unsigned long *entries, unsigned int max_entries,
+			unsigned int skip)
+{
+	struct stackframe frame;
+	register unsigned long current_sp asm ("sp");
+	unsigned int nr = 0;
+
+	frame.fp = (unsigned long)__builtin_frame_address(0);
+	frame.sp = current_sp;
+	frame.lr = (unsigned long)__builtin_return_address(0);
+	frame.pc = (unsigned long)stack_save;
+
+	while (nr < max_entries) {
+		unsigned long where = frame.pc;
+
+		if (unwind_frame(&frame) < 0)
+			break;
+		if (skip) {
+			skip--;
+			continue;
+		}
+		entries[nr++] = where;
+	}
+
+	return nr;
+}
@@ -29,11 +29,14 @@ static int do_barebox_update(int argc, char *argv[])
 	const char *name;
 	const char *fmt;
 
-	while ((opt = getopt(argc, argv, "t:yf:ld:r")) > 0) {
+	while ((opt = getopt(argc, argv, "t:yf:ld:rc")) > 0) {
 		switch (opt) {
 		case 'd':
 			data.devicefile = optarg;
 			break;
+		case 'c':
+			data.flags |= BBU_FLAG_DIFF;
+			break;
 		case 'f':
 			data.force = simple_strtoul(optarg, NULL, 0);
 			data.flags |= BBU_FLAG_FORCE;
@@ -119,12 +122,13 @@ BAREBOX_CMD_HELP_OPT("-d DEVICE", "write image to DEVICE")
 BAREBOX_CMD_HELP_OPT("-r\t", "refresh or repair. Do not update, but repair an existing image")
 BAREBOX_CMD_HELP_OPT("-y\t", "autom. use 'yes' when asking confirmations")
 BAREBOX_CMD_HELP_OPT("-f LEVEL", "set force level")
+BAREBOX_CMD_HELP_OPT("-c\t", "compare before write, only update differing blocks")
 BAREBOX_CMD_HELP_END
 
 BAREBOX_CMD_START(barebox_update)
 	.cmd		= do_barebox_update,
 	BAREBOX_CMD_DESC("update barebox to persistent media")
-	BAREBOX_CMD_OPTS("[-ltdyfr] [IMAGE]")
+	BAREBOX_CMD_OPTS("[-ltdyfrc] [IMAGE]")
 	BAREBOX_CMD_GROUP(CMD_GRP_MISC)
 	BAREBOX_CMD_HELP(cmd_barebox_update_help)
 BAREBOX_CMD_END
@@ -6,15 +6,65 @@
 #include <getopt.h>
 #include <fs.h>
 
+static const char * const blkstats_size_classes[BLK_STATS_SIZE_CLASSES] = {
+	"<=8", "<=64", "<=512", ">512",
+};
+
+static void blkstats_print_histogram(struct block_device *blk,
+				     enum blk_stats_dir dir)
+{
+	const char *what = dir == BLK_STATS_READ ? "read" : "write";
+	u32 total = 0;
+	int bucket, class;
+
+	for (class = 0; class < BLK_STATS_SIZE_CLASSES; class++)
+		for (bucket = 0; bucket < BLK_STATS_LAT_BUCKETS; bucket++)
+			total += blk->stats.latency[dir][class][bucket];
+
+	if (!total)
+		return;
+
+	printf("\n%s: %s latency (us) by transfer size (sectors)\n",
+	       blk->cdev.name, what);
+	printf("%16s", "");
+	for (class = 0; class < BLK_STATS_SIZE_CLASSES; class++)
+		printf(" %8s", blkstats_size_classes[class]);
+	printf("\n");
+
+	for (bucket = 0; bucket < BLK_STATS_LAT_BUCKETS; bucket++) {
+		u32 row = 0;
+
+		for (class = 0; class < BLK_STATS_SIZE_CLASSES; class++)
+			row += blk->stats.latency[dir][class][bucket];
+		if (!row)
+			continue;
+
+		if (bucket == 0)
+			printf("%16s", "<1");
+		else if (bucket == BLK_STATS_LAT_BUCKETS - 1)
+			printf("%13u+   ", 1 << (bucket - 1));
+		else
+			printf("%7u - %-6u", 1 << (bucket - 1), 1 << bucket);
+
+		for (class = 0; class < BLK_STATS_SIZE_CLASSES; class++)
+			printf(" %8u", blk->stats.latency[dir][class][bucket]);
+		printf("\n");
+	}
+}
+
 static int do_blkstats(int argc, char *argv[])
 {
 	struct block_device *blk;
 	const char *name;
 	bool first = false;
+	bool histogram = false;
 	int opt;
 
-	while ((opt = getopt(argc, argv, "l")) > 0) {
+	while ((opt = getopt(argc, argv, "lH")) > 0) {
 		switch (opt) {
+		case 'H':
+			histogram = true;
+			break;
 		case 'l':
 			for_each_block_device(blk) {
 				printf("%s\n", blk->cdev.name);
@@ -45,6 +95,11 @@ static int do_blkstats(int argc, char *argv[])
 
 		printf("%-16s %10llu %10llu %10llu\n", blk->cdev.name,
 		       stats->read_sectors, stats->write_sectors, stats->erase_sectors);
+
+		if (histogram) {
+			blkstats_print_histogram(blk, BLK_STATS_READ);
+			blkstats_print_histogram(blk, BLK_STATS_WRITE);
+		}
 	}
 
 	return 0;
@@ -55,12 +110,13 @@ BAREBOX_CMD_HELP_TEXT("Display a block device's number of read, written and eras
 BAREBOX_CMD_HELP_TEXT("")
 BAREBOX_CMD_HELP_TEXT("Options:")
 BAREBOX_CMD_HELP_OPT("-l",  "list all currently registered block devices")
+BAREBOX_CMD_HELP_OPT("-H",  "also show per-device service time histograms")
 BAREBOX_CMD_HELP_END
 
 BAREBOX_CMD_START(blkstats)
 	.cmd		= do_blkstats,
 	BAREBOX_CMD_DESC("display block layer statistics")
-	BAREBOX_CMD_OPTS("[-l] [DEVICE]")
+	BAREBOX_CMD_OPTS("[-lH] [DEVICE]")
 	BAREBOX_CMD_GROUP(CMD_GRP_INFO)
 	BAREBOX_CMD_HELP(cmd_blkstats_help)
 BAREBOX_CMD_END
@@ -11,13 +11,21 @@ static int do_checkleak(int argc, char *argv[])
 	unsigned int count;
 	int opt;
 
-	while ((opt = getopt(argc, argv, "l:")) > 0) {
+	while ((opt = getopt(argc, argv, "l:t:p")) > 0) {
 		switch(opt) {
 		case 'l':
 			if (kstrtouint(optarg, 0, &count))
 				return COMMAND_ERROR;
 			(void)malloc(count);
 			break;
+		case 't':
+			if (kstrtouint(optarg, 0, &count))
+				return COMMAND_ERROR;
+			malloc_trace_enable(count);
+			return 0;
+		case 'p':
+			malloc_trace_report();
+			return 0;
 		default:
 			return COMMAND_ERROR_USAGE;
 		}
@@ -40,12 +48,14 @@ BAREBOX_CMD_HELP_TEXT("the command ran.")
 BAREBOX_CMD_HELP_TEXT("")
 BAREBOX_CMD_HELP_TEXT("Options:")
 BAREBOX_CMD_HELP_OPT ("-l COUNT",  "force leak of COUNT bytes")
+BAREBOX_CMD_HELP_OPT ("-t N",  "sample every Nth allocation, 0 disables")
+BAREBOX_CMD_HELP_OPT ("-p",  "print sampled live bytes by call site")
 BAREBOX_CMD_HELP_END
 
 BAREBOX_CMD_START(checkleak)
 	.cmd		= do_checkleak,
 	BAREBOX_CMD_DESC("check for memory leaks")
-	BAREBOX_CMD_OPTS("[-l]")
+	BAREBOX_CMD_OPTS("[-ltp]")
 	BAREBOX_CMD_GROUP(CMD_GRP_MISC)
 	BAREBOX_CMD_HELP(cmd_checkleak_help)
 BAREBOX_CMD_END
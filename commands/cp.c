@@ -27,8 +27,9 @@ static int do_cp(int argc, char *argv[])
 	int opt;
 	int flags = 0, recursive = 0;
 	int argc_min;
+	const char *algo = NULL, *digest = NULL;
 
-	while ((opt = getopt(argc, argv, "vnr")) > 0) {
+	while ((opt = getopt(argc, argv, "vnrsa:V:")) > 0) {
 		switch (opt) {
 		case 'v':
 			flags |= COPY_FILE_VERBOSE;
@@ -39,9 +40,21 @@ static int do_cp(int argc, char *argv[])
 		case 'r':
 			recursive = 1;
 			break;
+		case 's':
+			flags |= COPY_FILE_SPARSE;
+			break;
+		case 'a':
+			algo = optarg;
+			break;
+		case 'V':
+			digest = optarg;
+			break;
 		}
 	}
 
+	if (digest && (!algo || recursive || (flags & COPY_FILE_SPARSE)))
+		return COMMAND_ERROR_USAGE;
+
 	argc_min = optind + 2;
 
 	if (argc < argc_min)
@@ -70,6 +83,10 @@ static int do_cp(int argc, char *argv[])
 
 		if (recursive)
 			ret = copy_recursive(argv[i], dst, flags);
+		else if (digest)
+			ret = copy_file_verify(argv[i],
+					       last_is_dir ? dst : argv[argc - 1],
+					       flags, algo, digest);
 		else if (last_is_dir)
 			ret = copy_file(argv[i], dst, flags);
 		else
@@ -91,13 +108,17 @@ BAREBOX_CMD_HELP_TEXT("")
 BAREBOX_CMD_HELP_TEXT("Options:")
 BAREBOX_CMD_HELP_OPT ("-r", "recursive")
 BAREBOX_CMD_HELP_OPT ("-n", "do not overwrite an existing file")
+BAREBOX_CMD_HELP_OPT ("-s", "expand SRC as Android sparse image")
 BAREBOX_CMD_HELP_OPT ("-v", "verbose")
+BAREBOX_CMD_HELP_OPT ("-a ALGO", "digest algorithm for -V, e.g. sha256")
+BAREBOX_CMD_HELP_OPT ("-V DIGEST", "verify that SRC has the given hex DIGEST while")
+BAREBOX_CMD_HELP_OPT ("", "copying, without a separate verification read")
 BAREBOX_CMD_HELP_END
 
 BAREBOX_CMD_START(cp)
 	.cmd		= do_cp,
 	BAREBOX_CMD_DESC("copy files")
-	BAREBOX_CMD_OPTS("[-rnv] SRC DEST")
+	BAREBOX_CMD_OPTS("[-rnvs] [-a ALGO -V DIGEST] SRC DEST")
 	BAREBOX_CMD_GROUP(CMD_GRP_FILE)
 	BAREBOX_CMD_HELP(cmd_cp_help)
 BAREBOX_CMD_END
@@ -93,7 +93,7 @@ static int do_devinfo(int argc, char *argv[])
 				printf("Parameters:\n");
 				first = false;
 			}
-			printf("  %s: %s (type: %s)", param->name, dev_get_param(dev, param->name),
+			printf("  %s: %s (type: %s)", param->name, param_get_value(param),
 			       get_param_type(param));
 			if (param->info) {
 				param->info(param);
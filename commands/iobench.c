@@ -0,0 +1,195 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+/* iobench - measure sequential/random device and file I/O performance */
+
+#include <command.h>
+#include <common.h>
+#include <clock.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <fs.h>
+#include <getopt.h>
+#include <malloc.h>
+#include <stdlib.h>
+#include <xfuncs.h>
+#include <linux/err.h>
+#include <linux/kstrtox.h>
+#include <linux/math64.h>
+#include <linux/sizes.h>
+#include <linux/time.h>
+
+#define IOBENCH_DEFAULT_BS	SZ_64K
+#define IOBENCH_DEFAULT_SIZE	SZ_4M
+
+struct iobench_stats {
+	u64 bytes;
+	u64 total_ns;
+	u64 lat_min_ns;
+	u64 lat_max_ns;
+	unsigned int ops;
+};
+
+static u64 iobench_rate_kib(const struct iobench_stats *st)
+{
+	if (!st->total_ns)
+		return 0;
+
+	return div64_u64(st->bytes * NSEC_PER_SEC, st->total_ns) / SZ_1K;
+}
+
+static int iobench_run(int fd, loff_t area, void *buf, size_t bs, u64 size,
+		       bool random, bool writing, struct iobench_stats *st)
+{
+	u32 nblocks = div64_u64(area, bs);
+	loff_t pos = 0;
+	u64 done;
+
+	st->lat_min_ns = U64_MAX;
+
+	for (done = 0; done < size; done += bs) {
+		u64 start, delta;
+		ssize_t ret;
+
+		if (random)
+			pos = (loff_t)prandom_u32_max(nblocks) * bs;
+		else if (pos + bs > area)
+			pos = 0;
+
+		start = get_time_ns();
+
+		if (lseek(fd, pos, SEEK_SET) < 0)
+			return -errno;
+
+		if (writing)
+			ret = write(fd, buf, bs);
+		else
+			ret = read(fd, buf, bs);
+
+		delta = get_time_ns() - start;
+
+		if (ret < 0)
+			return -errno;
+		if (!ret)
+			break;
+
+		st->bytes += ret;
+		st->total_ns += delta;
+		st->lat_min_ns = min(st->lat_min_ns, delta);
+		st->lat_max_ns = max(st->lat_max_ns, delta);
+		st->ops++;
+
+		pos += ret;
+
+		if (ctrlc())
+			return -EINTR;
+	}
+
+	return 0;
+}
+
+static int do_iobench(int argc, char *argv[])
+{
+	size_t bs = IOBENCH_DEFAULT_BS;
+	u64 size = IOBENCH_DEFAULT_SIZE;
+	bool random = false, writing = false;
+	struct iobench_stats st = {};
+	struct stat s;
+	const char *path;
+	loff_t area;
+	void *buf;
+	int opt, fd, ret;
+
+	while ((opt = getopt(argc, argv, "b:s:rw")) > 0) {
+		switch (opt) {
+		case 'b':
+			bs = strtoul_suffix(optarg, NULL, 0);
+			break;
+		case 's':
+			size = strtoull_suffix(optarg, NULL, 0);
+			break;
+		case 'r':
+			random = true;
+			break;
+		case 'w':
+			writing = true;
+			break;
+		default:
+			return COMMAND_ERROR_USAGE;
+		}
+	}
+
+	if (!bs || !size || optind == argc)
+		return COMMAND_ERROR_USAGE;
+
+	path = argv[optind];
+
+	fd = open(path, writing ? O_RDWR : O_RDONLY);
+	if (fd < 0) {
+		printf("could not open %s: %m\n", path);
+		return COMMAND_ERROR;
+	}
+
+	ret = fstat(fd, &s);
+	if (ret) {
+		printf("could not stat %s: %m\n", path);
+		ret = COMMAND_ERROR;
+		goto out_close;
+	}
+
+	area = s.st_size;
+	if (area < bs) {
+		printf("%s is smaller than one %zu byte block\n", path, bs);
+		ret = COMMAND_ERROR;
+		goto out_close;
+	}
+
+	buf = xmemalign(64, bs);
+	if (writing)
+		memset(buf, 0x5a, bs);
+
+	ret = iobench_run(fd, area, buf, bs, size, random, writing, &st);
+	if (ret) {
+		printf("%s failed: %pe\n", writing ? "write" : "read",
+		       ERR_PTR(ret));
+		ret = COMMAND_ERROR;
+		goto out_free;
+	}
+
+	/* one key=value line per run for easy consumption by scripts */
+	printf("iobench: op=%s%s path=%s bs=%zu bytes=%llu time_ns=%llu "
+	       "rate_kib_s=%llu lat_min_ns=%llu lat_avg_ns=%llu lat_max_ns=%llu\n",
+	       random ? "rnd" : "seq", writing ? "write" : "read",
+	       path, bs, st.bytes, st.total_ns, iobench_rate_kib(&st),
+	       st.lat_min_ns, st.ops ? div64_u64(st.total_ns, st.ops) : 0,
+	       st.lat_max_ns);
+
+	ret = 0;
+out_free:
+	free(buf);
+out_close:
+	close(fd);
+
+	return ret;
+}
+
+BAREBOX_CMD_HELP_START(iobench)
+BAREBOX_CMD_HELP_TEXT("Benchmark reads or writes on a device or file. The target is accessed")
+BAREBOX_CMD_HELP_TEXT("in BS sized blocks until SIZE bytes are transferred, sequentially")
+BAREBOX_CMD_HELP_TEXT("wrapping at the end of the target, or at random block offsets with -r.")
+BAREBOX_CMD_HELP_TEXT("Writing with -w overwrites the target and is irreversible.")
+BAREBOX_CMD_HELP_TEXT("Results are printed as a single key=value line.")
+BAREBOX_CMD_HELP_TEXT("")
+BAREBOX_CMD_HELP_TEXT("Options:")
+BAREBOX_CMD_HELP_OPT("-b BS", "block size (default 64K)")
+BAREBOX_CMD_HELP_OPT("-s SIZE", "total bytes to transfer (default 4M)")
+BAREBOX_CMD_HELP_OPT("-r", "access blocks in random order")
+BAREBOX_CMD_HELP_OPT("-w", "write instead of read (destroys data!)")
+BAREBOX_CMD_HELP_END
+
+BAREBOX_CMD_START(iobench)
+	.cmd		= do_iobench,
+	BAREBOX_CMD_DESC("benchmark device and file I/O")
+	BAREBOX_CMD_OPTS("[-bsrw] FILE")
+	BAREBOX_CMD_GROUP(CMD_GRP_FILE)
+	BAREBOX_CMD_HELP(cmd_iobench_help)
+BAREBOX_CMD_END
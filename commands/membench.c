@@ -0,0 +1,96 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+/* membench - measure memcpy/memset bandwidth */
+
+#include <command.h>
+#include <common.h>
+#include <clock.h>
+#include <getopt.h>
+#include <malloc.h>
+#include <xfuncs.h>
+#include <linux/kstrtox.h>
+#include <linux/math64.h>
+#include <linux/sizes.h>
+#include <linux/time.h>
+
+#define MEMBENCH_DEFAULT_SIZE		SZ_4M
+#define MEMBENCH_DEFAULT_ITERATIONS	8
+
+static unsigned long membench_rate(u64 bytes, u64 ns)
+{
+	if (!ns)
+		return 0;
+
+	return div64_u64(bytes * NSEC_PER_SEC, ns) / SZ_1M;
+}
+
+static int do_membench(int argc, char *argv[])
+{
+	size_t size = MEMBENCH_DEFAULT_SIZE;
+	int iterations = MEMBENCH_DEFAULT_ITERATIONS;
+	u64 start, t_memset, t_memcpy, total;
+	void *src, *dst;
+	int opt, i;
+
+	while ((opt = getopt(argc, argv, "s:i:")) > 0) {
+		switch (opt) {
+		case 's':
+			size = strtoul_suffix(optarg, NULL, 0);
+			break;
+		case 'i':
+			iterations = simple_strtoul(optarg, NULL, 0);
+			break;
+		default:
+			return COMMAND_ERROR_USAGE;
+		}
+	}
+
+	if (!size || iterations <= 0)
+		return COMMAND_ERROR_USAGE;
+
+	src = xmemalign(64, size);
+	dst = xmemalign(64, size);
+
+	/* Warm up the caches and fault in the buffers. */
+	memset(src, 0x55, size);
+	memset(dst, 0xaa, size);
+
+	start = get_time_ns();
+	for (i = 0; i < iterations; i++)
+		memset(dst, i, size);
+	t_memset = get_time_ns() - start;
+
+	start = get_time_ns();
+	for (i = 0; i < iterations; i++)
+		memcpy(dst, src, size);
+	t_memcpy = get_time_ns() - start;
+
+	total = (u64)size * iterations;
+
+	printf("buffer size %zu bytes, %d iterations\n", size, iterations);
+	printf("memset: %10lluns (%lu MiB/s)\n", t_memset,
+	       membench_rate(total, t_memset));
+	printf("memcpy: %10lluns (%lu MiB/s)\n", t_memcpy,
+	       membench_rate(total, t_memcpy));
+
+	free(src);
+	free(dst);
+
+	return 0;
+}
+
+BAREBOX_CMD_HELP_START(membench)
+BAREBOX_CMD_HELP_TEXT("Measure the memcpy/memset bandwidth of the running CPU.")
+BAREBOX_CMD_HELP_TEXT("")
+BAREBOX_CMD_HELP_TEXT("Options:")
+BAREBOX_CMD_HELP_OPT("-s SIZE", "buffer size (default 4M)")
+BAREBOX_CMD_HELP_OPT("-i ITERATIONS", "number of iterations (default 8)")
+BAREBOX_CMD_HELP_END
+
+BAREBOX_CMD_START(membench)
+	.cmd		= do_membench,
+	BAREBOX_CMD_DESC("measure memcpy/memset bandwidth")
+	BAREBOX_CMD_OPTS("[-si]")
+	BAREBOX_CMD_GROUP(CMD_GRP_MEM)
+	BAREBOX_CMD_HELP(cmd_membench_help)
+BAREBOX_CMD_END
@@ -0,0 +1,282 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+/* netbench - UDP echo/blast and TFTP throughput benchmarks */
+
+#include <common.h>
+#include <command.h>
+#include <clock.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <fs.h>
+#include <getopt.h>
+#include <libbb.h>
+#include <libfile.h>
+#include <malloc.h>
+#include <net.h>
+#include <xfuncs.h>
+#include <linux/err.h>
+#include <linux/math64.h>
+#include <linux/sizes.h>
+#include <linux/time.h>
+
+#define NETBENCH_DEFAULT_PORT	7	/* UDP echo service */
+#define NETBENCH_DEFAULT_COUNT	100
+#define NETBENCH_DEFAULT_SIZE	1024
+#define NETBENCH_MAX_SIZE	1400
+#define NETBENCH_TIMEOUT	SECOND
+
+#define NETBENCH_MOUNT_PATH	"/.netbench_tmp_path"
+
+struct netbench_echo {
+	u32 seq;
+	bool replied;
+};
+
+static void netbench_handler(void *ctx, char *pkt, unsigned len)
+{
+	struct netbench_echo *echo = ctx;
+	u32 seq;
+
+	if (net_eth_to_udplen(pkt) < sizeof(seq))
+		return;
+
+	memcpy(&seq, net_eth_to_udp_payload(pkt), sizeof(seq));
+	if (seq == echo->seq)
+		echo->replied = true;
+}
+
+static u64 netbench_mbps(u64 bytes, u64 ns)
+{
+	if (!ns)
+		return 0;
+
+	return div64_u64(bytes * 8 * NSEC_PER_SEC, ns * 1000000);
+}
+
+static int netbench_udp(IPaddr_t ip, u16 port, unsigned count, size_t size,
+			bool blast)
+{
+	u64 rtt_min = U64_MAX, rtt_max = 0, rtt_total = 0;
+	unsigned sent = 0, received = 0;
+	struct netbench_echo echo;
+	struct net_connection *con;
+	u64 start, bench_start;
+	unsigned i;
+	int ret;
+
+	con = net_udp_new(ip, port, netbench_handler, &echo);
+	if (IS_ERR(con))
+		return PTR_ERR(con);
+
+	bench_start = get_time_ns();
+
+	for (i = 0; i < count; i++) {
+		void *payload = net_udp_get_payload(con);
+
+		echo.seq = i;
+		echo.replied = false;
+
+		memcpy(payload, &echo.seq, sizeof(echo.seq));
+		memset(payload + sizeof(echo.seq), 0x5a,
+		       size - sizeof(echo.seq));
+
+		start = get_time_ns();
+
+		ret = net_udp_send(con, size);
+		if (ret)
+			goto out;
+
+		sent++;
+
+		if (blast)
+			continue;
+
+		/* wait for the echoed packet before sending the next one */
+		while (!echo.replied) {
+			if (ctrlc()) {
+				ret = -EINTR;
+				goto out;
+			}
+
+			net_poll();
+
+			if (is_timeout(start, NETBENCH_TIMEOUT))
+				break;
+		}
+
+		if (echo.replied) {
+			u64 rtt = get_time_ns() - start;
+
+			received++;
+			rtt_total += rtt;
+			rtt_min = min(rtt_min, rtt);
+			rtt_max = max(rtt_max, rtt);
+		}
+	}
+
+	ret = 0;
+out:
+	if (sent) {
+		u64 total_ns = get_time_ns() - bench_start;
+
+		printf("netbench: op=udp%s host=%pI4 port=%u size=%zu "
+		       "sent=%u received=%u lost=%u time_ns=%llu mbps=%llu",
+		       blast ? "blast" : "echo", &ip, port, size,
+		       sent, received, sent - received, total_ns,
+		       netbench_mbps((u64)(blast ? sent : received) * size,
+				     total_ns));
+		if (received)
+			printf(" rtt_min_ns=%llu rtt_avg_ns=%llu rtt_max_ns=%llu",
+			       rtt_min, div64_u64(rtt_total, received), rtt_max);
+		printf("\n");
+	}
+
+	net_unregister(con);
+
+	if (ret)
+		printf("netbench failed: %pe\n", ERR_PTR(ret));
+
+	return ret;
+}
+
+static int netbench_tftp(IPaddr_t ip, const char *file)
+{
+	char ip4_str[sizeof("255.255.255.255")];
+	u64 start, total_ns, bytes = 0;
+	char *path, *buf;
+	int fd, ret;
+
+	ret = make_directory(NETBENCH_MOUNT_PATH);
+	if (ret)
+		return ret;
+
+	sprintf(ip4_str, "%pI4", &ip);
+
+	ret = mount(ip4_str, "tftp", NETBENCH_MOUNT_PATH, "");
+	if (ret)
+		goto out_rmdir;
+
+	path = xasprintf("%s/%s", NETBENCH_MOUNT_PATH, file);
+	buf = xmalloc(SZ_64K);
+
+	fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		printf("could not open %s: %m\n", path);
+		ret = -errno;
+		goto out_free;
+	}
+
+	start = get_time_ns();
+
+	while (1) {
+		ssize_t now = read(fd, buf, SZ_64K);
+		if (now < 0) {
+			ret = -errno;
+			break;
+		}
+		if (!now)
+			break;
+
+		bytes += now;
+
+		if (ctrlc()) {
+			ret = -EINTR;
+			break;
+		}
+	}
+
+	total_ns = get_time_ns() - start;
+
+	close(fd);
+
+	if (!ret)
+		printf("netbench: op=tftp host=%pI4 file=%s bytes=%llu "
+		       "time_ns=%llu mbps=%llu\n", &ip, file, bytes, total_ns,
+		       netbench_mbps(bytes, total_ns));
+	else
+		printf("netbench failed: %pe\n", ERR_PTR(ret));
+
+out_free:
+	free(buf);
+	free(path);
+	umount(NETBENCH_MOUNT_PATH);
+out_rmdir:
+	rmdir(NETBENCH_MOUNT_PATH);
+
+	return ret;
+}
+
+static int do_netbench(int argc, char *argv[])
+{
+	unsigned count = NETBENCH_DEFAULT_COUNT;
+	size_t size = NETBENCH_DEFAULT_SIZE;
+	u16 port = NETBENCH_DEFAULT_PORT;
+	const char *tftp_file = NULL;
+	bool blast = false;
+	IPaddr_t ip;
+	int opt, ret;
+
+	while ((opt = getopt(argc, argv, "p:c:s:bt:")) > 0) {
+		switch (opt) {
+		case 'p':
+			port = simple_strtoul(optarg, NULL, 0);
+			break;
+		case 'c':
+			count = simple_strtoul(optarg, NULL, 0);
+			break;
+		case 's':
+			size = simple_strtoul(optarg, NULL, 0);
+			break;
+		case 'b':
+			blast = true;
+			break;
+		case 't':
+			tftp_file = optarg;
+			break;
+		default:
+			return COMMAND_ERROR_USAGE;
+		}
+	}
+
+	if (optind == argc || !count ||
+	    size < sizeof(u32) || size > NETBENCH_MAX_SIZE)
+		return COMMAND_ERROR_USAGE;
+
+	ret = resolv(argv[optind], &ip);
+	if (ret) {
+		printf("Cannot resolve \"%s\": %pe\n", argv[optind],
+		       ERR_PTR(ret));
+		return 1;
+	}
+
+	if (tftp_file)
+		ret = netbench_tftp(ip, tftp_file);
+	else
+		ret = netbench_udp(ip, port, count, size, blast);
+
+	return ret ? COMMAND_ERROR : 0;
+}
+
+BAREBOX_CMD_HELP_START(netbench)
+BAREBOX_CMD_HELP_TEXT("Benchmark the network path to HOST. By default COUNT UDP packets of")
+BAREBOX_CMD_HELP_TEXT("SIZE bytes are sent to an echo service and round trip time, loss and")
+BAREBOX_CMD_HELP_TEXT("throughput are reported. With -b packets are sent back-to-back without")
+BAREBOX_CMD_HELP_TEXT("waiting for echoes, measuring the transmit path alone. With -t the")
+BAREBOX_CMD_HELP_TEXT("named file is fetched from HOST via TFTP and the achieved throughput")
+BAREBOX_CMD_HELP_TEXT("is reported. Results are printed as a single key=value line.")
+BAREBOX_CMD_HELP_TEXT("")
+BAREBOX_CMD_HELP_TEXT("Options:")
+BAREBOX_CMD_HELP_OPT("-p PORT", "UDP port (default 7, the echo service)")
+BAREBOX_CMD_HELP_OPT("-c COUNT", "number of packets to send (default 100)")
+BAREBOX_CMD_HELP_OPT("-s SIZE", "UDP payload size (default 1024)")
+BAREBOX_CMD_HELP_OPT("-b", "blast packets without waiting for echoes")
+BAREBOX_CMD_HELP_OPT("-t FILE", "benchmark a TFTP transfer of FILE instead")
+BAREBOX_CMD_HELP_END
+
+BAREBOX_CMD_START(netbench)
+	.cmd		= do_netbench,
+	BAREBOX_CMD_DESC("benchmark network throughput and latency")
+	BAREBOX_CMD_OPTS("[-pcsb] [-t FILE] HOST")
+	BAREBOX_CMD_GROUP(CMD_GRP_NET)
+	BAREBOX_CMD_HELP(cmd_netbench_help)
+BAREBOX_CMD_END
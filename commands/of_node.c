@@ -52,6 +52,8 @@ static int do_of_node_create_now(struct device_node *root, const char *path)
 	if (!node)
 		return -EINVAL;
 
+	of_fix_tree_dirty();
+
 	return 0;
 }
 
@@ -65,6 +67,7 @@ static int do_of_node_delete_now(struct device_node *root, const char *path)
 	}
 
 	of_delete_node(node);
+	of_fix_tree_dirty();
 
 	return 0;
 }
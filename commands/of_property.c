@@ -271,6 +271,8 @@ static int do_of_property_set_now(struct device_node *root, const char *path,
 		}
 	}
 
+	of_fix_tree_dirty();
+
 	return 0;
 }
 
@@ -292,6 +294,7 @@ static int do_of_property_delete_now(struct device_node *root, const char *path,
 	}
 
 	of_delete_property(pp);
+	of_fix_tree_dirty();
 
 	return 0;
 }
@@ -50,7 +50,8 @@ static int do_state(int argc, char *argv[])
 		else
 			ret = state_load(state);
 	} else if (do_save) {
-		ret = state_save(state);
+		/* an explicit save is expected to hit the backend */
+		ret = state_flush(state);
 	}
 
 	if (ret == -ENOMEDIUM)
@@ -61,7 +61,7 @@ static int do_varinfo(int argc, char *argv[])
 			continue;
 
 		printf("%s: %s (type: %s)", param->name,
-		       dev_get_param(dev, param->name), get_param_type(param));
+		       param_get_value(param), get_param_type(param));
 		if (param->info)
 			param->info(param);
 		printf("\n");
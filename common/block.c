@@ -6,17 +6,34 @@
  */
 #include <common.h>
 #include <block.h>
+#include <clock.h>
 #include <disks.h>
 #include <malloc.h>
+#include <objcache.h>
+#include <linux/bitops.h>
 #include <linux/err.h>
 #include <linux/list.h>
+#include <linux/math64.h>
 #include <dma.h>
+#include <qsort.h>
 #include <range.h>
 #include <bootargs.h>
 #include <file-list.h>
+#include <perfstat.h>
 
 LIST_HEAD(block_device_list);
 
+enum {
+	BLOCK_PERFSTAT_CACHE_HIT,
+	BLOCK_PERFSTAT_CACHE_MISS,
+};
+
+static DEFINE_PERFSTAT_GROUP(block_perfstat, "block",
+	[BLOCK_PERFSTAT_CACHE_HIT] = { .name = "cache_hit" },
+	[BLOCK_PERFSTAT_CACHE_MISS] = { .name = "cache_miss" },
+);
+PERFSTAT_GROUP_REGISTER(block_perfstat);
+
 /* a chunk of contiguous data */
 struct chunk {
 	void *data; /* data buffer */
@@ -28,32 +45,70 @@ struct chunk {
 
 #define BUFSIZE (PAGE_SIZE * 16)
 
+/* default number of chunks in the cache and the minimum we insist on */
+#define NUM_CHUNKS_DEFAULT 8
+#define NUM_CHUNKS_MIN 2
+
+/* number of chunks fetched in one transfer when reads turn out sequential */
+#define RA_CHUNKS 4
+
 static int writebuffer_io_len(struct block_device *blk, struct chunk *chunk)
 {
 	return min_t(blkcnt_t, blk->rdbufsize, blk->num_blocks - chunk->block_start);
 }
 
 #ifdef CONFIG_BLOCK_STATS
-static void blk_stats_record_read(struct block_device *blk, blkcnt_t count)
+static int blk_stats_size_class(blkcnt_t count)
+{
+	if (count <= 8)
+		return 0;
+	if (count <= 64)
+		return 1;
+	if (count <= 512)
+		return 2;
+	return 3;
+}
+
+static void blk_stats_record_latency(struct block_device *blk,
+				     enum blk_stats_dir dir, blkcnt_t count,
+				     u64 start)
+{
+	u64 us = div_u64(get_time_ns() - start, 1000);
+	unsigned int bucket;
+
+	bucket = us ? min_t(unsigned int, fls64(us),
+			    BLK_STATS_LAT_BUCKETS - 1) : 0;
+
+	blk->stats.latency[dir][blk_stats_size_class(count)][bucket]++;
+}
+
+static void blk_stats_record_read(struct block_device *blk, blkcnt_t count,
+				  u64 start)
 {
 	blk->stats.read_sectors += count;
+	blk_stats_record_latency(blk, BLK_STATS_READ, count, start);
 }
-static void blk_stats_record_write(struct block_device *blk, blkcnt_t count)
+static void blk_stats_record_write(struct block_device *blk, blkcnt_t count,
+				   u64 start)
 {
 	blk->stats.write_sectors += count;
+	blk_stats_record_latency(blk, BLK_STATS_WRITE, count, start);
 }
 static void blk_stats_record_erase(struct block_device *blk, blkcnt_t count)
 {
 	blk->stats.erase_sectors += count;
 }
 #else
-static void blk_stats_record_read(struct block_device *blk, blkcnt_t count) { }
-static void blk_stats_record_write(struct block_device *blk, blkcnt_t count) { }
+static void blk_stats_record_read(struct block_device *blk, blkcnt_t count,
+				  u64 start) { }
+static void blk_stats_record_write(struct block_device *blk, blkcnt_t count,
+				   u64 start) { }
 static void blk_stats_record_erase(struct block_device *blk, blkcnt_t count) { }
 #endif
 
 static int chunk_flush(struct block_device *blk, struct chunk *chunk)
 {
+	u64 start;
 	size_t len;
 	int ret;
 
@@ -61,34 +116,111 @@ static int chunk_flush(struct block_device *blk, struct chunk *chunk)
 		return 0;
 
 	len = writebuffer_io_len(blk, chunk);
+	start = get_time_ns();
 	ret = blk->ops->write(blk, chunk->data, chunk->block_start, len);
 	if (ret < 0)
 		return ret;
 
-	blk_stats_record_write(blk, len);
+	blk_stats_record_write(blk, len, start);
 
 	chunk->dirty = 0;
 
 	return 0;
 }
 
+static int chunk_cmp(const void *a, const void *b)
+{
+	const struct chunk *ca = *(struct chunk **)a;
+	const struct chunk *cb = *(struct chunk **)b;
+
+	if (ca->block_start < cb->block_start)
+		return -1;
+
+	return ca->block_start > cb->block_start ? 1 : 0;
+}
+
 /*
- * Write all dirty chunks back to the device
+ * Write all dirty chunks back to the device, ordered by sector.
+ * Adjacent chunks are gathered into the readahead transfer buffer and
+ * written in a single transfer: as with reads, one large write
+ * amortizes the per-command overhead that dominates chunk-sized
+ * scattered writes on MMC/SD.
  */
 static int writebuffer_flush(struct block_device *blk)
 {
-	struct chunk *chunk;
-	int ret;
+	struct chunk *chunk, **dirty;
+	unsigned int n = 0, i = 0, j;
+	int ret = 0;
 
 	if (!IS_ENABLED(CONFIG_BLOCK_WRITE))
 		return 0;
 
 	list_for_each_entry(chunk, &blk->buffered_blocks, list) {
-		ret = chunk_flush(blk, chunk);
-		if (ret < 0)
-			return ret;
+		if (chunk->dirty)
+			n++;
+	}
+
+	if (!n)
+		goto out_devflush;
+
+	dirty = xmalloc(n * sizeof(*dirty));
+
+	n = 0;
+	list_for_each_entry(chunk, &blk->buffered_blocks, list) {
+		if (chunk->dirty)
+			dirty[n++] = chunk;
+	}
+
+	qsort(dirty, n, sizeof(*dirty), chunk_cmp);
+
+	while (i < n) {
+		struct chunk *first = dirty[i];
+		unsigned int run = 1;
+
+		while (run < RA_CHUNKS && i + run < n &&
+		       dirty[i + run]->block_start ==
+		       first->block_start + (sector_t)run * blk->rdbufsize)
+			run++;
+
+		if (run > 1) {
+			blkcnt_t len = (blkcnt_t)(run - 1) * blk->rdbufsize +
+				writebuffer_io_len(blk, dirty[i + run - 1]);
+			u64 start;
+
+			if (!blk->ra_buf)
+				blk->ra_buf = dma_alloc(BUFSIZE * RA_CHUNKS);
+
+			for (j = 0; j < run; j++)
+				memcpy(blk->ra_buf + (size_t)j * BUFSIZE,
+				       dirty[i + j]->data, BUFSIZE);
+
+			start = get_time_ns();
+			ret = blk->ops->write(blk, blk->ra_buf,
+					      first->block_start, len);
+			if (ret < 0)
+				goto out;
+
+			blk_stats_record_write(blk, len, start);
+
+			for (j = 0; j < run; j++)
+				dirty[i + j]->dirty = 0;
+		} else {
+			ret = chunk_flush(blk, first);
+			if (ret < 0)
+				goto out;
+		}
+
+		i += run;
 	}
 
+	ret = 0;
+out:
+	free(dirty);
+
+	if (ret < 0)
+		return ret;
+
+out_devflush:
 	if (blk->ops->flush)
 		return blk->ops->flush(blk);
 
@@ -112,10 +244,13 @@ static struct chunk *chunk_get_cached(struct block_device *blk, sector_t block)
 			 * move most recently used entry to the head of the list
 			 */
 			list_move(&chunk->list, &blk->buffered_blocks);
+			perfstat_inc(block_perfstat, BLOCK_PERFSTAT_CACHE_HIT);
 			return chunk;
 		}
 	}
 
+	perfstat_inc(block_perfstat, BLOCK_PERFSTAT_CACHE_MISS);
+
 	return NULL;
 }
 
@@ -159,6 +294,53 @@ static struct chunk *get_chunk(struct block_device *blk)
 	return chunk;
 }
 
+/*
+ * Speculatively read RA_CHUNKS chunks in a single transfer. Devices like
+ * MMC/SD amortize their per-command overhead over the transfer length, so
+ * one large read is considerably faster than RA_CHUNKS small ones. The
+ * data is distributed from the transfer buffer into regular cache chunks,
+ * skipping chunks that are already cached so that dirty data is preserved.
+ */
+static int block_cache_ahead(struct block_device *blk, sector_t block_start)
+{
+	blkcnt_t len = (blkcnt_t)blk->rdbufsize * RA_CHUNKS;
+	struct chunk *chunk;
+	u64 start;
+	int ret, i;
+
+	if (block_start + len > blk->num_blocks)
+		return -ENOSPC;
+
+	if (!blk->ra_buf)
+		blk->ra_buf = dma_alloc(BUFSIZE * RA_CHUNKS);
+
+	start = get_time_ns();
+	ret = blk->ops->read(blk, blk->ra_buf, block_start, len);
+	if (ret)
+		return ret;
+
+	blk_stats_record_read(blk, len, start);
+
+	for (i = RA_CHUNKS - 1; i >= 0; i--) {
+		sector_t start = block_start + (sector_t)i * blk->rdbufsize;
+
+		if (chunk_get_cached(blk, start))
+			continue;
+
+		chunk = get_chunk(blk);
+		if (IS_ERR(chunk))
+			return PTR_ERR(chunk);
+
+		chunk->block_start = start;
+		memcpy(chunk->data, blk->ra_buf + (size_t)i * BUFSIZE, BUFSIZE);
+		list_add(&chunk->list, &blk->buffered_blocks);
+	}
+
+	blk->ra_next = block_start + len;
+
+	return 0;
+}
+
 /*
  * read a block into the cache. This assumes that the block is
  * not cached already. By definition block_get_cached() for
@@ -166,15 +348,29 @@ static struct chunk *get_chunk(struct block_device *blk)
  */
 static int block_cache(struct block_device *blk, sector_t block)
 {
+	sector_t block_start = block & ~blk->blkmask;
 	struct chunk *chunk;
 	size_t len;
+	u64 start;
 	int ret;
 
+	/*
+	 * The second miss on a chunk directly following the previous one
+	 * identifies a sequential reader and switches to multi-chunk
+	 * transfers. Skip this while a discard range is pending as the
+	 * single chunk path handles discarded regions.
+	 */
+	if (block_start && block_start == blk->ra_next && !blk->discard_size) {
+		ret = block_cache_ahead(blk, block_start);
+		if (!ret)
+			return 0;
+	}
+
 	chunk = get_chunk(blk);
 	if (IS_ERR(chunk))
 		return PTR_ERR(chunk);
 
-	chunk->block_start = block & ~blk->blkmask;
+	chunk->block_start = block_start;
 
 	dev_vdbg(blk->dev, "%s: %llu to %d\n", __func__, chunk->block_start,
 		chunk->num);
@@ -188,15 +384,18 @@ static int block_cache(struct block_device *blk, sector_t block)
 		return 0;
 	}
 
+	start = get_time_ns();
 	ret = blk->ops->read(blk, chunk->data, chunk->block_start, len);
 	if (ret) {
 		list_add_tail(&chunk->list, &blk->idle_blocks);
 		return ret;
 	}
 
-	blk_stats_record_read(blk, len);
+	blk_stats_record_read(blk, len, start);
 	list_add(&chunk->list, &blk->buffered_blocks);
 
+	blk->ra_next = chunk->block_start + blk->rdbufsize;
+
 	return 0;
 }
 
@@ -227,6 +426,39 @@ static void *block_get(struct block_device *blk, sector_t block)
 	return outdata;
 }
 
+/*
+ * Read a span of full blocks straight from the device into the caller's
+ * buffer, bypassing the chunk cache. Used for large reads, where staging
+ * the data through the cache would evict all of its contents and cost an
+ * extra memcpy per chunk. The span ends at the first cached chunk, since
+ * that may contain dirty data which the caller has to get served from the
+ * cache instead. Returns the number of blocks read or a negative error.
+ */
+static ssize_t block_read_direct(struct block_device *blk, void *buf,
+				 sector_t block, blkcnt_t blocks)
+{
+	blkcnt_t run = blk->rdbufsize - (block & blk->blkmask);
+	u64 start;
+	int ret;
+
+	while (run < blocks && !chunk_get_cached(blk, block + run))
+		run += blk->rdbufsize;
+
+	run = min_t(blkcnt_t, run, blocks);
+
+	start = get_time_ns();
+	ret = blk->ops->read(blk, buf, block, run);
+	if (ret < 0)
+		return ret;
+
+	blk_stats_record_read(blk, run, start);
+
+	/* keep sequential read detection in sync with the device position */
+	blk->ra_next = block + run;
+
+	return run;
+}
+
 static ssize_t block_op_read(struct cdev *cdev, void *buf, size_t count,
 		loff_t offset, unsigned long flags)
 {
@@ -254,7 +486,29 @@ static ssize_t block_op_read(struct cdev *cdev, void *buf, size_t count,
 	blocks = count >> blk->blockbits;
 
 	while (blocks) {
-		void *iobuf = block_get(blk, block);
+		void *iobuf;
+
+		/*
+		 * Reads spanning at least a whole chunk bypass the cache,
+		 * provided the buffer is usable for DMA and the start block
+		 * is not already cached (and thus possibly dirty).
+		 */
+		if (blocks >= blk->rdbufsize &&
+		    IS_ALIGNED((uintptr_t)buf, DMA_ALIGNMENT) &&
+		    !chunk_get_cached(blk, block)) {
+			ssize_t n = block_read_direct(blk, buf, block, blocks);
+
+			if (n < 0)
+				return n;
+
+			buf += n << blk->blockbits;
+			count -= n << blk->blockbits;
+			block += n;
+			blocks -= n;
+			continue;
+		}
+
+		iobuf = block_get(blk, block);
 
 		if (IS_ERR(iobuf))
 			return PTR_ERR(iobuf);
@@ -280,6 +534,41 @@ static ssize_t block_op_read(struct cdev *cdev, void *buf, size_t count,
 
 #ifdef CONFIG_BLOCK_WRITE
 
+/*
+ * Write a chunk-aligned span of full chunks straight from the caller's
+ * buffer to the device, bypassing the chunk cache. Used for large writes,
+ * where staging the data through the cache would evict all of its contents
+ * and cost an extra memcpy per chunk, and where one maximal transfer
+ * amortizes the per-command overhead. Cached chunks overlapped by the span
+ * are fully covered by it and thus superseded, dirty or not, so they are
+ * simply dropped. Returns the number of blocks written or a negative error.
+ */
+static ssize_t block_write_direct(struct block_device *blk, const void *buf,
+				  sector_t block, blkcnt_t blocks)
+{
+	blkcnt_t run = blocks & ~(blkcnt_t)blk->blkmask;
+	struct chunk *chunk, *tmp;
+	u64 start;
+	int ret;
+
+	list_for_each_entry_safe(chunk, tmp, &blk->buffered_blocks, list) {
+		if (region_overlap_size(block, run, chunk->block_start,
+					blk->rdbufsize)) {
+			chunk->dirty = 0;
+			list_move(&chunk->list, &blk->idle_blocks);
+		}
+	}
+
+	start = get_time_ns();
+	ret = blk->ops->write(blk, buf, block, run);
+	if (ret < 0)
+		return ret;
+
+	blk_stats_record_write(blk, run, start);
+
+	return run;
+}
+
 /*
  * Put data into a block. This only overwrites the data in the
  * cache and marks the corresponding chunk as dirty.
@@ -347,6 +636,25 @@ static ssize_t block_op_write(struct cdev *cdev, const void *buf, size_t count,
 	blocks = count >> blk->blockbits;
 
 	while (blocks) {
+		/*
+		 * Chunk-aligned writes spanning at least a whole chunk
+		 * bypass the cache, provided the buffer is usable for DMA.
+		 */
+		if (blocks >= blk->rdbufsize &&
+		    !(block & blk->blkmask) &&
+		    IS_ALIGNED((uintptr_t)buf, DMA_ALIGNMENT)) {
+			ssize_t n = block_write_direct(blk, buf, block, blocks);
+
+			if (n < 0)
+				return n;
+
+			buf += n << blk->blockbits;
+			count -= n << blk->blockbits;
+			block += n;
+			blocks -= n;
+			continue;
+		}
+
 		ret = block_put(blk, buf, block);
 		if (ret)
 			return ret;
@@ -436,6 +744,84 @@ static __maybe_unused int block_op_erase(struct cdev *cdev, loff_t count, loff_t
 	return 0;
 }
 
+/*
+ * Chunks and their data buffers are recycled through object caches
+ * shared by all block devices, so resizing the cache or reregistering
+ * a device doesn't have to go through the general purpose allocator
+ * for every chunk.
+ */
+static struct objcache *chunk_cache;
+static struct objcache *chunk_data_cache;
+
+static void chunk_free(struct chunk *chunk)
+{
+	objcache_free(chunk_data_cache, chunk->data);
+	objcache_free(chunk_cache, chunk);
+}
+
+static void writebuffer_free_chunks(struct block_device *blk)
+{
+	struct chunk *chunk, *tmp;
+
+	list_for_each_entry_safe(chunk, tmp, &blk->buffered_blocks, list) {
+		list_del(&chunk->list);
+		chunk_free(chunk);
+	}
+
+	list_for_each_entry_safe(chunk, tmp, &blk->idle_blocks, list) {
+		list_del(&chunk->list);
+		chunk_free(chunk);
+	}
+}
+
+static void writebuffer_alloc_chunks(struct block_device *blk, int num_chunks)
+{
+	int i;
+
+	if (!chunk_cache) {
+		chunk_cache = objcache_create("chunk", sizeof(struct chunk),
+					      0, 0);
+		chunk_data_cache = objcache_create("chunk_data", BUFSIZE,
+						   DMA_ALIGNMENT,
+						   NUM_CHUNKS_DEFAULT);
+	}
+
+	for (i = 0; i < num_chunks; i++) {
+		struct chunk *chunk = objcache_alloc(chunk_cache);
+
+		memset(chunk, 0, sizeof(*chunk));
+		chunk->data = objcache_alloc(chunk_data_cache);
+		chunk->num = i;
+		list_add_tail(&chunk->list, &blk->idle_blocks);
+	}
+}
+
+/*
+ * The size of the chunk cache is runtime tunable through the cache_size
+ * device parameter. Resizing drops the whole cache, so flush any dirty
+ * chunks back to the device before reallocating.
+ */
+static int block_cache_size_set(struct param_d *param, void *priv)
+{
+	struct block_device *blk = priv;
+	unsigned int num_chunks;
+	int ret;
+
+	num_chunks = max_t(unsigned int, blk->cache_size / BUFSIZE,
+			   NUM_CHUNKS_MIN);
+
+	ret = writebuffer_flush(blk);
+	if (ret < 0)
+		return ret;
+
+	writebuffer_free_chunks(blk);
+	writebuffer_alloc_chunks(blk, num_chunks);
+
+	blk->cache_size = num_chunks * BUFSIZE;
+
+	return 0;
+}
+
 static struct cdev_operations block_ops = {
 	.read	= block_op_read,
 #ifdef CONFIG_BLOCK_WRITE
@@ -451,7 +837,6 @@ int blockdevice_register(struct block_device *blk)
 {
 	loff_t size = (loff_t)blk->num_blocks * BLOCKSIZE(blk);
 	int ret;
-	int i;
 
 	blk->cdev.size = size;
 	blk->cdev.dev = blk->dev;
@@ -472,12 +857,11 @@ int blockdevice_register(struct block_device *blk)
 		return -ENOSYS;
 	}
 
-	for (i = 0; i < 8; i++) {
-		struct chunk *chunk = xzalloc(sizeof(*chunk));
-		chunk->data = dma_alloc(BUFSIZE);
-		chunk->num = i;
-		list_add_tail(&chunk->list, &blk->idle_blocks);
-	}
+	blk->cache_size = NUM_CHUNKS_DEFAULT * BUFSIZE;
+	writebuffer_alloc_chunks(blk, NUM_CHUNKS_DEFAULT);
+
+	dev_add_param_uint32(blk->dev, "cache_size", block_cache_size_set,
+			NULL, &blk->cache_size, "%u", blk);
 
 	/* TODO: We currently set this to ignore ERASE_TO_FLASH, but it could
 	 * be useful to propagate the enum erase_type down into the erase
@@ -503,19 +887,11 @@ int blockdevice_register(struct block_device *blk)
 
 int blockdevice_unregister(struct block_device *blk)
 {
-	struct chunk *chunk, *tmp;
-
 	writebuffer_flush(blk);
+	writebuffer_free_chunks(blk);
 
-	list_for_each_entry_safe(chunk, tmp, &blk->buffered_blocks, list) {
-		dma_free(chunk->data);
-		free(chunk);
-	}
-
-	list_for_each_entry_safe(chunk, tmp, &blk->idle_blocks, list) {
-		dma_free(chunk->data);
-		free(chunk);
-	}
+	if (blk->ra_buf)
+		dma_free(blk->ra_buf);
 
 	devfs_remove(&blk->cdev);
 	list_del(&blk->list);
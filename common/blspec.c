@@ -2,6 +2,7 @@
 #define pr_fmt(fmt)  "blspec: " fmt
 
 #include <environment.h>
+#include <arena.h>
 #include <globalvar.h>
 #include <firmware.h>
 #include <malloc.h>
@@ -97,8 +98,11 @@ static int blspec_boot(struct bootentry *be, int verbose, int dryrun)
 	const char *overlays;
 	const char *appendroot;
 	char *old_fws, *fws;
+	struct arena *arena;
 	struct bootm_data data = {};
 
+	arena = arena_push("blspec");
+
 	bootm_data_init_defaults(&data);
 	data.dryrun = max_t(int, dryrun, data.dryrun);
 	data.os_file = data.oftree_file = data.initrd_file = NULL;
@@ -115,16 +119,18 @@ static int blspec_boot(struct bootentry *be, int verbose, int dryrun)
 	else
 		abspath = "";
 
-	data.os_file = basprintf("%s/%s", abspath, linuximage);
+	data.os_file = arena_asprintf(arena, "%s/%s", abspath, linuximage);
 
 	if (devicetree)
-		data.oftree_file = basprintf("%s/%s", abspath, devicetree);
+		data.oftree_file = arena_asprintf(arena, "%s/%s", abspath,
+						  devicetree);
 
 	if (overlays)
 		of_register_fixup(blspec_overlay_fixup, entry);
 
 	if (initrd)
-		data.initrd_file = basprintf("%s/%s", abspath, initrd);
+		data.initrd_file = arena_asprintf(arena, "%s/%s", abspath,
+						  initrd);
 
 	globalvar_add_simple("linux.bootargs.dyn.bootentries", options);
 
@@ -149,11 +155,11 @@ static int blspec_boot(struct bootentry *be, int verbose, int dryrun)
 
 	old_fws = firmware_get_searchpath();
 	if (old_fws && *old_fws)
-		fws = basprintf("%s/lib/firmware:%s", abspath, old_fws);
+		fws = arena_asprintf(arena, "%s/lib/firmware:%s", abspath,
+				     old_fws);
 	else
-		fws = basprintf("%s/lib/firmware", abspath);
+		fws = arena_asprintf(arena, "%s/lib/firmware", abspath);
 	firmware_set_searchpath(fws);
-	free(fws);
 
 	ret = bootm_boot(&data);
 	if (ret)
@@ -167,9 +173,7 @@ static int blspec_boot(struct bootentry *be, int verbose, int dryrun)
 	free(old_fws);
 
 err_out:
-	free((char *)data.oftree_file);
-	free((char *)data.initrd_file);
-	free((char *)data.os_file);
+	arena_pop(arena);
 
 	return ret;
 }
@@ -304,6 +308,21 @@ static int blspec_have_entry(struct bootentries *bootentries, const char *path)
 	return 0;
 }
 
+/*
+ * The compatibility verdict depends only on the devicetree blob and the
+ * machine compatible, neither of which changes while the filesystem
+ * stays mounted. Remember it per filename for the session, otherwise
+ * bootchooser retry loops and repeated interactive boot attempts
+ * re-read every entry's devicetree on each scan.
+ */
+struct blspec_compat_result {
+	struct list_head list;
+	char *filename;
+	bool compatible;
+};
+
+static LIST_HEAD(blspec_compat_results);
+
 /*
  * entry_is_of_compatible - check if a bootspec entry is compatible with
  *                          the current machine.
@@ -314,6 +333,7 @@ static bool entry_is_of_compatible(struct blspec_entry *entry)
 {
 	const char *devicetree;
 	const char *abspath;
+	struct blspec_compat_result *res;
 	int ret;
 	struct device_node *barebox_root;
 	size_t size;
@@ -345,24 +365,31 @@ static bool entry_is_of_compatible(struct blspec_entry *entry)
 
 	filename = basprintf("%s/%s", abspath, devicetree);
 
-	fdt = read_file(filename, &size);
-	if (!fdt) {
-		ret = false;
-		goto out;
+	list_for_each_entry(res, &blspec_compat_results, list) {
+		if (!strcmp(res->filename, filename)) {
+			free(filename);
+			return res->compatible;
+		}
 	}
 
-	if (fdt_machine_is_compatible(fdt, size, compat)) {
-		ret = true;
-		goto out;
+	fdt = read_file(filename, &size);
+	if (!fdt) {
+		/* Don't cache this: the file may show up later */
+		free(filename);
+		return false;
 	}
 
-	pr_info("ignoring entry with incompatible devicetree: %s\n", devicetree);
-
-	ret = false;
+	ret = fdt_machine_is_compatible(fdt, size, compat);
+	if (!ret)
+		pr_info("ignoring entry with incompatible devicetree: %s\n",
+			devicetree);
 
-out:
 	free(fdt);
-	free(filename);
+
+	res = xzalloc(sizeof(*res));
+	res->filename = filename;
+	res->compatible = ret;
+	list_add_tail(&res->list, &blspec_compat_results);
 
 	return ret;
 }
@@ -0,0 +1,98 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+/*
+ * bootbudget.c - boot-time budget enforcement
+ *
+ * Budgets are watermarks on the time since cold boot: a stage is in
+ * budget when it finishes before its configured deadline. Overruns are
+ * logged and collected in the boot.budget_overrun globalvar so a test
+ * rig can fail a boot that got slower without parsing the log.
+ */
+
+#define pr_fmt(fmt) "bootbudget: " fmt
+
+#include <common.h>
+#include <bootbudget.h>
+#include <clock.h>
+#include <globalvar.h>
+#include <init.h>
+#include <magicvar.h>
+#include <xfuncs.h>
+#include <linux/math64.h>
+#include <linux/time.h>
+
+struct boot_budget {
+	const char *name;
+	unsigned int budget_ms;	/* 0 disables the check */
+	u64 watermark_ms;	/* time since boot when the stage finished */
+};
+
+static struct boot_budget boot_budgets[BOOT_BUDGET_MAX] = {
+	[BOOT_BUDGET_PROBE]	= { "probe", CONFIG_BOOT_BUDGET_PROBE_MS },
+	[BOOT_BUDGET_ENV]	= { "env", CONFIG_BOOT_BUDGET_ENV_MS },
+	[BOOT_BUDGET_BOOT]	= { "boot", CONFIG_BOOT_BUDGET_BOOT_MS },
+};
+
+static char *boot_budget_overrun;
+
+/**
+ * boot_budget_set - override a stage's budget from board code
+ * @stage: the stage to configure
+ * @budget_ms: deadline in milliseconds since cold boot, 0 disables
+ */
+void boot_budget_set(enum boot_budget_stage stage, unsigned int budget_ms)
+{
+	if (stage < BOOT_BUDGET_MAX)
+		boot_budgets[stage].budget_ms = budget_ms;
+}
+
+void boot_budget_checkpoint(enum boot_budget_stage stage)
+{
+	u64 now_ms = div_u64(get_time_ns(), NSEC_PER_MSEC);
+	struct boot_budget *budget;
+	char *overrun;
+
+	if (stage >= BOOT_BUDGET_MAX)
+		return;
+
+	budget = &boot_budgets[stage];
+	budget->watermark_ms = now_ms;
+
+	if (!budget->budget_ms || now_ms <= budget->budget_ms)
+		return;
+
+	pr_warn("stage %s finished at %llums, %llums over its %ums budget\n",
+		budget->name, now_ms, now_ms - budget->budget_ms,
+		budget->budget_ms);
+
+	overrun = boot_budget_overrun;
+	boot_budget_overrun = basprintf("%s%s%s", overrun ?: "",
+					overrun ? " " : "", budget->name);
+	free(overrun);
+}
+
+static int boot_budget_mark_probe(void)
+{
+	boot_budget_checkpoint(BOOT_BUDGET_PROBE);
+
+	return 0;
+}
+late_initcall(boot_budget_mark_probe);
+
+static int boot_budget_mark_env(void)
+{
+	boot_budget_checkpoint(BOOT_BUDGET_ENV);
+
+	return 0;
+}
+postenvironment_initcall(boot_budget_mark_env);
+
+static int boot_budget_globalvars(void)
+{
+	return globalvar_add_simple_string("boot.budget_overrun",
+					   &boot_budget_overrun);
+}
+device_initcall(boot_budget_globalvars);
+
+BAREBOX_MAGICVAR(global.boot.budget_overrun,
+		 "boot stages that exceeded their time budget, empty when all in budget");
@@ -52,6 +52,10 @@ struct bootchooser {
 	int refs;
 	bool attempts_locked;
 
+	/* the globalvars this instance was parsed from */
+	char *targets_spec;
+	char *prefix_spec;
+
 	int verbose;
 	int dryrun;
 };
@@ -339,13 +343,33 @@ static void bootchooser_reset_priorities(struct bootchooser *bc)
 
 static struct bootchooser *bootchooser;
 
+static void bootchooser_free(struct bootchooser *bc)
+{
+	struct bootchooser_target *target, *tmp;
+
+	list_for_each_entry_safe(target, tmp, &bc->targets, list) {
+		free(target->boot);
+		free(target->prefix);
+		free(target->state_prefix);
+		free_const(target->name);
+		free(target);
+	}
+
+	free(bc->targets_spec);
+	free(bc->prefix_spec);
+	free(bc->state_prefix);
+	free(bc);
+}
+
 /**
  * bootchooser_get - get a reference to the bootchooser
  *
  * When no bootchooser is initialized this function allocates the bootchooser
  * and initializes it with the different globalvars and state variables. The
- * bootchooser is returned. Subsequent calls will return a reference to the same
- * bootchooser.
+ * bootchooser is returned. Subsequent calls will return a reference to the
+ * same bootchooser, including calls made after the last reference was
+ * dropped: the parsed instance stays cached and is only rebuilt when the
+ * globalvars it was created from have changed in the meantime.
  */
 struct bootchooser *bootchooser_get(void)
 {
@@ -358,8 +382,21 @@ struct bootchooser *bootchooser_get(void)
 	uint32_t locked;
 
 	if (bootchooser) {
-		bootchooser->refs++;
-		return bootchooser;
+		if (bootchooser->refs ||
+		    (!strcmp(bootchooser->targets_spec, available_targets) &&
+		     !strcmp(bootchooser->prefix_spec, state_prefix))) {
+			if (bootchooser->last_chosen && last_boot_successful) {
+				bootchooser_target_set_attempts(
+					bootchooser->last_chosen, -1);
+				last_boot_successful = false;
+			}
+			bootchooser->refs++;
+			return bootchooser;
+		}
+
+		/* configuration changed, reparse from scratch */
+		bootchooser_free(bootchooser);
+		bootchooser = NULL;
 	}
 
 	bc = xzalloc(sizeof(*bc));
@@ -487,8 +524,10 @@ struct bootchooser *bootchooser_get(void)
 			pr_warn("Last booted target with id %d does not exist\n", last_chosen);
 	}
 
-	if (bc->last_chosen && last_boot_successful)
+	if (bc->last_chosen && last_boot_successful) {
 		bootchooser_target_set_attempts(bc->last_chosen, -1);
+		last_boot_successful = false;
+	}
 
 	if (disable_on_zero_attempts) {
 		bootchooser_for_each_target(bc, target) {
@@ -501,6 +540,9 @@ struct bootchooser *bootchooser_get(void)
 
 	}
 
+	bc->targets_spec = xstrdup(available_targets);
+	bc->prefix_spec = xstrdup(state_prefix);
+
 	bootchooser = bc;
 
 	bootchooser->refs = 1;
@@ -564,7 +606,9 @@ int bootchooser_save(struct bootchooser *bc)
  * @bc: The bootchooser instance
  *
  * This returns a reference to the bootchooser. If it is the last reference the
- * bootchooser is saved and the associated memory is freed.
+ * bootchooser is saved to the backing store. The parsed instance is kept
+ * around so the next bootchooser_get() doesn't have to reevaluate the target
+ * list.
  *
  * Return: 0 for success or a negative error code. An error can occur when
  *         bootchooser_save fails to write to the storage, nevertheless the
@@ -572,7 +616,6 @@ int bootchooser_save(struct bootchooser *bc)
  */
 int bootchooser_put(struct bootchooser *bc)
 {
-	struct bootchooser_target *target, *tmp;
 	int ret;
 
 	bc->refs--;
@@ -584,18 +627,6 @@ int bootchooser_put(struct bootchooser *bc)
 	if (ret)
 		pr_err("Failed to save bootchooser state: %pe\n", ERR_PTR(ret));
 
-	list_for_each_entry_safe(target, tmp, &bc->targets, list) {
-		free(target->boot);
-		free(target->prefix);
-		free(target->state_prefix);
-		free_const(target->name);
-		free(target);
-	}
-
-	free(bc);
-
-	bootchooser = NULL;
-
 	return ret;
 }
 
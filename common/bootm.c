@@ -1,8 +1,13 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include <common.h>
+#include <aio.h>
+#include <arena.h>
 #include <bootm.h>
 #include <bootm-overrides.h>
+#include <bootprof.h>
+#include <bootbudget.h>
+#include <clock.h>
 #include <fs.h>
 #include <malloc.h>
 #include <memory.h>
@@ -12,12 +17,32 @@
 #include <globalvar.h>
 #include <init.h>
 #include <environment.h>
+#include <fcntl.h>
 #include <linux/stat.h>
 #include <magicvar.h>
 #include <uncompress.h>
 #include <zero_page.h>
+#include <dma-devices.h>
+#include <linux/sizes.h>
 #include <security/config.h>
 
+/*
+ * Below this size the mapping overhead of a DMA engine offload outweighs
+ * the copy itself.
+ */
+#define BOOTM_DMA_COPY_MIN_SIZE	SZ_1M
+
+/*
+ * Copy a loaded image to its final location, offloading the copy to a DMA
+ * engine when one is available and the image is large enough to make that
+ * worthwhile.
+ */
+static void bootm_copy_image(void *dst, const void *src, size_t size)
+{
+	if (size < BOOTM_DMA_COPY_MIN_SIZE || dma_memcpy(dst, src, size))
+		memcpy(dst, src, size);
+}
+
 static LIST_HEAD(handler_list);
 static struct sconfig_notifier_block sconfig_notifier;
 
@@ -183,7 +208,8 @@ static inline bool image_is_uimage(struct image_data *data)
 	return IS_ENABLED(CONFIG_BOOTM_UIMAGE) && data->os;
 }
 
-static bool bootm_get_override(char **oldpath, const char *newpath)
+static bool bootm_get_override(struct arena *arena, char **oldpath,
+			       const char *newpath)
 {
 	if (!IS_ENABLED(CONFIG_BOOT_OVERRIDE))
 		return false;
@@ -193,8 +219,8 @@ static bool bootm_get_override(char **oldpath, const char *newpath)
 		return false;
 
 	if (oldpath && !streq_ptr(*oldpath, newpath)) {
-		free(*oldpath);
-		*oldpath = *newpath ? xstrdup(newpath) : NULL;
+		/* the replaced name stays in the arena until the boot ends */
+		*oldpath = *newpath ? arena_strdup(arena, newpath) : NULL;
 	}
 
 	return true;
@@ -212,7 +238,7 @@ static bool bootm_get_override(char **oldpath, const char *newpath)
  *
  * Return: 0 on success, negative error code otherwise
  */
-int bootm_load_os(struct image_data *data, unsigned long load_address)
+static int __bootm_load_os(struct image_data *data, unsigned long load_address)
 {
 	if (data->os_res)
 		return 0;
@@ -234,7 +260,12 @@ int bootm_load_os(struct image_data *data, unsigned long load_address)
 				(unsigned long long)load_address + kernel_size - 1);
 			return -ENOMEM;
 		}
-		zero_page_memcpy((void *)load_address, kernel, kernel_size);
+		if (zero_page_contains(load_address))
+			zero_page_memcpy((void *)load_address, kernel,
+					 kernel_size);
+		else
+			bootm_copy_image((void *)load_address, kernel,
+					 kernel_size);
 		return 0;
 	}
 
@@ -261,6 +292,18 @@ int bootm_load_os(struct image_data *data, unsigned long load_address)
 	return 0;
 }
 
+int bootm_load_os(struct image_data *data, unsigned long load_address)
+{
+	u64 start = get_time_ns();
+	int ret;
+
+	ret = __bootm_load_os(data, load_address);
+
+	bootprof_record(BOOTPROF_BOOTM, NULL, "load os", start);
+
+	return ret;
+}
+
 static bool fitconfig_has_ramdisk(struct image_data *data)
 {
 	if (!IS_ENABLED(CONFIG_FITIMAGE) || !data->os_fit)
@@ -282,11 +325,13 @@ static int bootm_open_initrd_uimage(struct image_data *data)
 			return -EINVAL;
 
 		if (bootm_get_verify_mode() > BOOTM_VERIFY_NONE) {
-			ret = uimage_verify(data->initrd);
-			if (ret) {
-				pr_err("Checking data crc failed with %pe\n",
-					ERR_PTR(ret));
-				return ret;
+			if (uimage_defer_verify(data->initrd)) {
+				ret = uimage_verify(data->initrd);
+				if (ret) {
+					pr_err("Checking data crc failed with %pe\n",
+						ERR_PTR(ret));
+					return ret;
+				}
 			}
 		}
 		uimage_print_contents(data->initrd);
@@ -310,16 +355,112 @@ static int bootm_open_initrd_uimage(struct image_data *data)
  *
  * Return: 0 on success, negative error code otherwise
  */
-const struct resource *
-bootm_load_initrd(struct image_data *data, unsigned long load_address)
+/*
+ * Companion images often live on different, slower media than the
+ * kernel (devicetree on SPI-NOR, initrd on eMMC). Their reads are
+ * submitted as aio requests before control passes to the image
+ * handler, so they proceed while the handler loads the kernel and the
+ * load time is bounded by the slowest medium instead of the sum.
+ */
+struct bootm_prefetch {
+	struct aio_request req;
+	int fd;
+	void *buf;
+	size_t size;
+	bool active;
+};
+
+static struct bootm_prefetch *bootm_prefetch_start(struct image_data *data,
+						   const char *file)
+{
+	struct bootm_prefetch *pf;
+	struct stat st;
+	int fd;
+
+	if (!IS_ENABLED(CONFIG_FS_AIO) || !file)
+		return NULL;
+
+	fd = open(file, O_RDONLY);
+	if (fd < 0)
+		return NULL;
+
+	/* the whole file is read at once, so its size must be known */
+	if (fstat(fd, &st) || !st.st_size || st.st_size == FILESIZE_MAX) {
+		close(fd);
+		return NULL;
+	}
+
+	pf = arena_zalloc(data->arena, sizeof(*pf));
+	pf->fd = fd;
+	pf->size = st.st_size;
+	pf->buf = malloc(pf->size);
+	if (!pf->buf) {
+		close(fd);
+		return NULL;
+	}
+
+	pf->req.fd = fd;
+	pf->req.buf = pf->buf;
+	pf->req.count = pf->size;
+	pf->req.offset = 0;
+
+	if (aio_read(&pf->req)) {
+		free(pf->buf);
+		close(fd);
+		return NULL;
+	}
+
+	pf->active = true;
+
+	return pf;
+}
+
+/*
+ * Collect the result of a prefetch. On success the file contents are
+ * returned and ownership of the buffer passes to the caller. Returns
+ * NULL when no prefetch is in flight or the read failed, in which case
+ * the caller falls back to the ordinary synchronous path.
+ */
+static void *bootm_prefetch_finish(struct bootm_prefetch *pf, size_t *size)
+{
+	void *buf = NULL;
+
+	if (!pf || !pf->active)
+		return NULL;
+
+	if (aio_wait(&pf->req) == (ssize_t)pf->size) {
+		buf = pf->buf;
+		*size = pf->size;
+	} else {
+		free(pf->buf);
+	}
+
+	close(pf->fd);
+	pf->active = false;
+
+	return buf;
+}
+
+static void bootm_prefetch_cancel(struct bootm_prefetch *pf)
+{
+	size_t size;
+
+	free(bootm_prefetch_finish(pf, &size));
+}
+
+static const struct resource *
+__bootm_load_initrd(struct image_data *data, unsigned long load_address)
 {
 	enum filetype type;
+	size_t size;
+	void *buf;
 	int ret;
 
 	if (!IS_ENABLED(CONFIG_BOOTM_INITRD))
 		return NULL;
 
-	if (bootm_get_override(&data->initrd_file, bootm_overrides.initrd_file))
+	if (bootm_get_override(data->arena, &data->initrd_file,
+			       bootm_overrides.initrd_file))
 		goto initrd_file;
 
 	if (data->initrd_res)
@@ -336,6 +477,26 @@ bootm_load_initrd(struct image_data *data, unsigned long load_address)
 					ERR_PTR(ret));
 			return ERR_PTR(ret);
 		}
+
+		/*
+		 * If the ramdisk data already sits at an address the kernel
+		 * can consume it from, hand it over in place instead of
+		 * copying it. load_address is the lowest address the arch
+		 * code considers safe, and the region request only succeeds
+		 * when the data lies outside every reserved region, so this
+		 * never hands out barebox' own heap. Falls back to the copy
+		 * otherwise.
+		 */
+		if ((unsigned long)initrd >= load_address) {
+			data->initrd_res = request_sdram_region("initrd",
+					(unsigned long)initrd, initrd_size,
+					MEMTYPE_LOADER_DATA, MEMATTRS_RW);
+			if (data->initrd_res) {
+				pr_info("Using initrd from FIT image in place\n");
+				goto done1;
+			}
+		}
+
 		data->initrd_res = request_sdram_region("initrd",
 				load_address, initrd_size,
 				MEMTYPE_LOADER_DATA, MEMATTRS_RW);
@@ -346,7 +507,7 @@ bootm_load_initrd(struct image_data *data, unsigned long load_address)
 				(unsigned long long)load_address + initrd_size - 1);
 			return ERR_PTR(-ENOMEM);
 		}
-		memcpy((void *)load_address, initrd, initrd_size);
+		bootm_copy_image((void *)load_address, initrd, initrd_size);
 		pr_info("Loaded initrd from FIT image\n");
 		goto done1;
 	}
@@ -355,6 +516,26 @@ initrd_file:
 	if (!data->initrd_file)
 		return NULL;
 
+	buf = bootm_prefetch_finish(data->initrd_prefetch, &size);
+	if (buf) {
+		type = file_detect_type(buf, size);
+
+		/* uimage initrds need the parsing path below */
+		if (type != filetype_uimage) {
+			data->initrd_res = request_sdram_region("initrd",
+					load_address, size,
+					MEMTYPE_LOADER_DATA, MEMATTRS_RW);
+			if (!data->initrd_res) {
+				free(buf);
+				return ERR_PTR(-ENOMEM);
+			}
+			bootm_copy_image((void *)load_address, buf, size);
+			free(buf);
+			goto done;
+		}
+		free(buf);
+	}
+
 	ret = file_name_detect_type(data->initrd_file, &type);
 	if (ret) {
 		pr_err("could not open initrd \"%s\": %pe\n", data->initrd_file, ERR_PTR(ret));
@@ -398,6 +579,19 @@ done1:
 	return data->initrd_res;
 }
 
+const struct resource *
+bootm_load_initrd(struct image_data *data, unsigned long load_address)
+{
+	const struct resource *res;
+	u64 start = get_time_ns();
+
+	res = __bootm_load_initrd(data, load_address);
+
+	bootprof_record(BOOTPROF_BOOTM, NULL, "load initrd", start);
+
+	return res;
+}
+
 static int bootm_open_oftree_uimage(struct image_data *data, size_t *size,
 				    struct fdt_header **fdt)
 {
@@ -471,7 +665,8 @@ void *bootm_get_devicetree(struct image_data *data)
 		return ERR_PTR(-ENOSYS);
 
 	from_fit = fitconfig_has_fdt(data);
-	if (bootm_get_override(&data->oftree_file, bootm_overrides.oftree_file))
+	if (bootm_get_override(data->arena, &data->oftree_file,
+			       bootm_overrides.oftree_file))
 		from_fit = false;
 
 	if (from_fit) {
@@ -485,27 +680,41 @@ void *bootm_get_devicetree(struct image_data *data)
 
 		data->of_root_node = of_unflatten_dtb(of_tree, of_size);
 	} else if (data->oftree_file) {
+		void *prefetched;
 		size_t size;
 
-		ret = file_name_detect_type(data->oftree_file, &type);
-		if (ret) {
-			pr_err("could not open device tree \"%s\": %pe\n", data->oftree_file,
-			       ERR_PTR(ret));
-			return ERR_PTR(ret);
+		prefetched = bootm_prefetch_finish(data->oftree_prefetch, &size);
+		if (prefetched) {
+			type = file_detect_type(prefetched, size);
+		} else {
+			ret = file_name_detect_type(data->oftree_file, &type);
+			if (ret) {
+				pr_err("could not open device tree \"%s\": %pe\n",
+				       data->oftree_file, ERR_PTR(ret));
+				return ERR_PTR(ret);
+			}
 		}
 
+		ret = 0;
+
 		switch (type) {
 		case filetype_uimage:
+			free(prefetched);
 			ret = bootm_open_oftree_uimage(data, &size, &oftree);
 			break;
 		case filetype_oftree:
 			pr_info("Loading devicetree from '%s'\n", data->oftree_file);
-			ret = read_file_2(data->oftree_file, &size, (void *)&oftree,
-					  FILESIZE_MAX);
+			if (prefetched)
+				oftree = prefetched;
+			else
+				ret = read_file_2(data->oftree_file, &size,
+						  (void *)&oftree, FILESIZE_MAX);
 			break;
 		case filetype_empty:
+			free(prefetched);
 			return NULL;
 		default:
+			free(prefetched);
 			return ERR_PTR(-EINVAL);
 		}
 
@@ -561,8 +770,8 @@ void *bootm_get_devicetree(struct image_data *data)
  *
  * Return: 0 on success, negative error code otherwise
  */
-int bootm_load_devicetree(struct image_data *data, void *fdt,
-			    unsigned long load_address)
+static int __bootm_load_devicetree(struct image_data *data, void *fdt,
+				   unsigned long load_address)
 {
 	int fdt_size;
 
@@ -592,6 +801,19 @@ int bootm_load_devicetree(struct image_data *data, void *fdt,
 	return 0;
 }
 
+int bootm_load_devicetree(struct image_data *data, void *fdt,
+			    unsigned long load_address)
+{
+	u64 start = get_time_ns();
+	int ret;
+
+	ret = __bootm_load_devicetree(data, fdt, load_address);
+
+	bootprof_record(BOOTPROF_BOOTM, NULL, "load oftree", start);
+
+	return ret;
+}
+
 int bootm_get_os_size(struct image_data *data)
 {
 	const char *os_file;
@@ -625,11 +847,17 @@ static int bootm_open_os_uimage(struct image_data *data)
 		return -EINVAL;
 
 	if (bootm_get_verify_mode() > BOOTM_VERIFY_NONE) {
-		ret = uimage_verify(data->os);
-		if (ret) {
-			pr_err("Checking data crc failed with %pe\n",
-					ERR_PTR(ret));
-			return ret;
+		/*
+		 * Prefer folding the crc in while the image streams to
+		 * RAM, which saves a separate read pass over storage.
+		 */
+		if (uimage_defer_verify(data->os)) {
+			ret = uimage_verify(data->os);
+			if (ret) {
+				pr_err("Checking data crc failed with %pe\n",
+						ERR_PTR(ret));
+				return ret;
+			}
 		}
 	}
 
@@ -731,14 +959,15 @@ static void bootm_print_info(struct image_data *data)
 		printf("OS image not yet relocated\n");
 }
 
-static int bootm_image_name_and_part(const char *name, char **filename, char **part)
+static int bootm_image_name_and_part(struct arena *arena, const char *name,
+				     char **filename, char **part)
 {
 	char *at, *ret;
 
 	if (!name || !*name)
 		return -EINVAL;
 
-	ret = xstrdup(name);
+	ret = arena_strdup(arena, name);
 
 	*filename = ret;
 	*part = NULL;
@@ -761,6 +990,8 @@ int bootm_boot(struct bootm_data *bootm_data)
 {
 	struct image_data *data;
 	struct image_handler *handler;
+	struct arena *arena;
+	u64 bootprof_start = get_time_ns();
 	int ret;
 	enum filetype os_type;
 	size_t size;
@@ -771,13 +1002,17 @@ int bootm_boot(struct bootm_data *bootm_data)
 		return -ENOENT;
 	}
 
-	data = xzalloc(sizeof(*data));
+	/* scope for the transient allocations of this boot attempt */
+	arena = arena_push("bootm");
 
-	bootm_image_name_and_part(bootm_data->os_file, &data->os_file, &data->os_part);
-	bootm_image_name_and_part(bootm_data->oftree_file, &data->oftree_file, &data->oftree_part);
-	bootm_image_name_and_part(bootm_data->initrd_file, &data->initrd_file, &data->initrd_part);
+	data = arena_zalloc(arena, sizeof(*data));
+	data->arena = arena;
+
+	bootm_image_name_and_part(arena, bootm_data->os_file, &data->os_file, &data->os_part);
+	bootm_image_name_and_part(arena, bootm_data->oftree_file, &data->oftree_file, &data->oftree_part);
+	bootm_image_name_and_part(arena, bootm_data->initrd_file, &data->initrd_file, &data->initrd_part);
 	if (bootm_data->tee_file)
-		data->tee_file = xstrdup(bootm_data->tee_file);
+		data->tee_file = arena_strdup(arena, bootm_data->tee_file);
 	data->verbose = bootm_data->verbose;
 	data->verify = bootm_data->verify;
 	data->force = bootm_data->force;
@@ -905,9 +1140,9 @@ int bootm_boot(struct bootm_data *bootm_data)
 			goto err_out;
 		}
 
-		machine_id_bootarg = basprintf("systemd.machine_id=%s", machine_id);
+		machine_id_bootarg = arena_asprintf(arena, "systemd.machine_id=%s",
+						    machine_id);
 		globalvar_add_simple("linux.bootargs.machine_id", machine_id_bootarg);
-		free(machine_id_bootarg);
 	}
 
 	if (bootm_data->provide_hostname) {
@@ -930,12 +1165,11 @@ int bootm_boot(struct bootm_data *bootm_data)
 		if (IS_ENABLED(CONFIG_SERIAL_NUMBER_FIXUP_SYSTEMD_HOSTNAME))
 			suffix = barebox_get_serial_number();
 
-		hostname_bootarg = basprintf("systemd.hostname=%s%s%s",
-					     hostname, suffix ? "-" : "",
-					     suffix ?: "");
+		hostname_bootarg = arena_asprintf(arena, "systemd.hostname=%s%s%s",
+						  hostname, suffix ? "-" : "",
+						  suffix ?: "");
 
 		globalvar_add_simple("linux.bootargs.hostname", hostname_bootarg);
-		free(hostname_bootarg);
 	}
 
 	pr_info("\nLoading %s '%s'", file_type_to_string(os_type),
@@ -965,20 +1199,33 @@ int bootm_boot(struct bootm_data *bootm_data)
 		printf("Passing control to %s handler\n", handler->name);
 	}
 
-	bootm_get_override(&data->oftree_file, bootm_overrides.oftree_file);
+	bootm_get_override(arena, &data->oftree_file, bootm_overrides.oftree_file);
 
-	if (bootm_get_override(&data->initrd_file, bootm_overrides.initrd_file)) {
+	if (bootm_get_override(arena, &data->initrd_file, bootm_overrides.initrd_file)) {
 		if (data->initrd_res) {
 			release_sdram_region(data->initrd_res);
 			data->initrd_res = NULL;
 		}
 	}
 
+	/*
+	 * Kick off the reads of the companion images now so they
+	 * proceed while the handler loads the kernel.
+	 */
+	data->initrd_prefetch = bootm_prefetch_start(data, data->initrd_file);
+	data->oftree_prefetch = bootm_prefetch_start(data, data->oftree_file);
+
+	bootprof_record(BOOTPROF_BOOTM, NULL, "prepare", bootprof_start);
+	/* last point we reliably reach before control passes to the OS */
+	boot_budget_checkpoint(BOOT_BUDGET_BOOT);
+
 	ret = handler->bootm(data);
 	if (data->dryrun)
 		pr_info("Dryrun. Aborted\n");
 
 err_out:
+	bootm_prefetch_cancel(data->initrd_prefetch);
+	bootm_prefetch_cancel(data->oftree_prefetch);
 	if (data->os_res)
 		release_sdram_region(data->os_res);
 	if (data->initrd_res)
@@ -1000,11 +1247,7 @@ err_out:
 	globalvar_remove("linux.bootargs.bootm.earlycon");
 	globalvar_remove("linux.bootargs.bootm.appendroot");
 	free(data->os_header);
-	free(data->os_file);
-	free(data->oftree_file);
-	free(data->initrd_file);
-	free(data->tee_file);
-	free(data);
+	arena_pop(arena);
 
 	return ret;
 }
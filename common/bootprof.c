@@ -0,0 +1,163 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+/*
+ * bootprof.c - low-overhead boot profiler
+ *
+ * Events are collected into a preallocated ring so that recording only
+ * costs a clock read and a few stores and can stay enabled. The
+ * bootprof command renders the ring as a table, optionally sorted by
+ * duration, or as a machine-readable trace that can be diffed between
+ * boots.
+ */
+
+#define pr_fmt(fmt) "bootprof: " fmt
+
+#include <common.h>
+#include <bootprof.h>
+#include <clock.h>
+#include <command.h>
+#include <complete.h>
+#include <getopt.h>
+#include <malloc.h>
+#include <qsort.h>
+#include <linux/math64.h>
+
+#define BOOTPROF_MAX_EVENTS	1024
+
+struct bootprof_event {
+	u64 start;		/* ns since boot */
+	u64 duration;		/* ns */
+	const void *func;	/* initcall, printed with %pS */
+	char name[24];		/* probe or bootm stage name */
+	u8 type;
+};
+
+static struct bootprof_event bootprof_events[BOOTPROF_MAX_EVENTS];
+static unsigned int bootprof_total;	/* events recorded so far */
+
+static const char * const bootprof_type_names[] = {
+	[BOOTPROF_INITCALL]	= "initcall",
+	[BOOTPROF_PROBE]	= "probe",
+	[BOOTPROF_BOOTM]	= "bootm",
+};
+
+void bootprof_record(enum bootprof_type type, const void *func,
+		     const char *name, u64 start)
+{
+	/* when the ring is full the oldest events are overwritten */
+	struct bootprof_event *ev =
+		&bootprof_events[bootprof_total % BOOTPROF_MAX_EVENTS];
+
+	ev->type = type;
+	ev->start = start;
+	ev->duration = get_time_ns() - start;
+	ev->func = func;
+	if (name)
+		snprintf(ev->name, sizeof(ev->name), "%s", name);
+	else
+		ev->name[0] = '\0';
+
+	bootprof_total++;
+}
+
+#if IS_ENABLED(CONFIG_CMD_BOOTPROF)
+
+static int bootprof_cmp_duration(const void *a, const void *b)
+{
+	const struct bootprof_event *ea = a, *eb = b;
+
+	if (ea->duration == eb->duration)
+		return 0;
+
+	return ea->duration > eb->duration ? -1 : 1;
+}
+
+static void bootprof_print_event(const struct bootprof_event *ev, bool raw)
+{
+	u64 start_us = div_u64(ev->start, 1000);
+	u64 duration_us = div_u64(ev->duration, 1000);
+	const char *type = bootprof_type_names[ev->type];
+
+	if (raw) {
+		/* one event per line: TYPE START_NS DURATION_NS NAME */
+		if (ev->func)
+			printf("%s %llu %llu %pS\n", type, ev->start,
+			       ev->duration, ev->func);
+		else
+			printf("%s %llu %llu %s\n", type, ev->start,
+			       ev->duration, ev->name);
+		return;
+	}
+
+	printf("%12llu %12llu  %-8s  ", start_us, duration_us, type);
+	if (ev->func)
+		printf("%pS\n", ev->func);
+	else
+		printf("%s\n", ev->name);
+}
+
+static int do_bootprof(int argc, char *argv[])
+{
+	struct bootprof_event *events;
+	unsigned int i, count, first;
+	bool sort = false, raw = false;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "sr")) > 0) {
+		switch (opt) {
+		case 's':
+			sort = true;
+			break;
+		case 'r':
+			raw = true;
+			break;
+		default:
+			return COMMAND_ERROR_USAGE;
+		}
+	}
+
+	count = min_t(unsigned int, bootprof_total, BOOTPROF_MAX_EVENTS);
+	first = bootprof_total - count;
+
+	/* copy out of the ring, in boot order */
+	events = xmalloc(count * sizeof(*events));
+	for (i = 0; i < count; i++)
+		events[i] = bootprof_events[(first + i) % BOOTPROF_MAX_EVENTS];
+
+	if (sort)
+		qsort(events, count, sizeof(*events), bootprof_cmp_duration);
+
+	if (!raw) {
+		if (bootprof_total > BOOTPROF_MAX_EVENTS)
+			printf("(%u oldest events overwritten)\n",
+			       bootprof_total - BOOTPROF_MAX_EVENTS);
+		printf("%12s %12s  %-8s  %s\n", "START(us)", "DURATION(us)",
+		       "TYPE", "NAME");
+	}
+
+	for (i = 0; i < count; i++)
+		bootprof_print_event(&events[i], raw);
+
+	free(events);
+
+	return 0;
+}
+
+BAREBOX_CMD_HELP_START(bootprof)
+BAREBOX_CMD_HELP_TEXT("Show boot profiling events (initcalls, probes, bootm stages)")
+BAREBOX_CMD_HELP_TEXT("")
+BAREBOX_CMD_HELP_TEXT("Options:")
+BAREBOX_CMD_HELP_OPT ("-s",  "sort by duration instead of boot order")
+BAREBOX_CMD_HELP_OPT ("-r",  "machine-readable trace: TYPE START_NS DURATION_NS NAME")
+BAREBOX_CMD_HELP_END
+
+BAREBOX_CMD_START(bootprof)
+	.cmd		= do_bootprof,
+	BAREBOX_CMD_DESC("show boot profiling events")
+	BAREBOX_CMD_OPTS("[-sr]")
+	BAREBOX_CMD_GROUP(CMD_GRP_INFO)
+	BAREBOX_CMD_COMPLETE(empty_complete)
+	BAREBOX_CMD_HELP(cmd_bootprof_help)
+BAREBOX_CMD_END
+
+#endif
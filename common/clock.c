@@ -75,6 +75,21 @@ uint64_t get_time_ns(void)
 }
 EXPORT_SYMBOL(get_time_ns);
 
+/**
+ * get_time_ns_coarse - get a cached timestamp in nanoseconds
+ *
+ * Returns the timestamp computed by the most recent get_time_ns() call
+ * without touching the clocksource. The cached value is refreshed by
+ * every precise get_time_ns() call, in particular once per poller
+ * cycle, so it is good enough for timeouts that are long compared to a
+ * scheduling pass, but never for delay loops.
+ */
+uint64_t get_time_ns_coarse(void)
+{
+	return time_ns;
+}
+EXPORT_SYMBOL(get_time_ns_coarse);
+
 /**
  * clocks_calc_mult_shift - calculate mult/shift factors for scaled math of clocks
  * @mult:       pointer to mult variable
@@ -176,6 +191,33 @@ int is_timeout(uint64_t start_ns, uint64_t time_offset_ns)
 }
 EXPORT_SYMBOL(is_timeout);
 
+/**
+ * is_timeout_coarse - timeout check mostly based on the cached timestamp
+ * @start_ns:		timeout start as returned by get_time_ns()
+ * @time_offset_ns:	timeout length in nanoseconds
+ *
+ * Like is_timeout(), but works on the cached timestamp where possible:
+ * the cache only ever lags behind the clocksource, so a deadline it
+ * reports as passed has certainly expired. While the deadline has not
+ * passed the clocksource is read on every 16th call only, to keep the
+ * check from starving when nothing else advances the cached time.
+ * Meant for hot loops whose timeout is much longer than one loop
+ * iteration, not for precise timing.
+ */
+int is_timeout_coarse(uint64_t start_ns, uint64_t time_offset_ns)
+{
+	static unsigned int defer;
+
+	if ((int64_t)(start_ns + time_offset_ns - time_ns) < 0)
+		return 1;
+
+	if (!(defer++ & 15))
+		return is_timeout(start_ns, time_offset_ns);
+
+	return 0;
+}
+EXPORT_SYMBOL(is_timeout_coarse);
+
 void ndelay(unsigned long nsecs)
 {
 	uint64_t start = get_time_ns();
@@ -198,6 +240,25 @@ void mdelay(unsigned long msecs)
 }
 EXPORT_SYMBOL(mdelay);
 
+/**
+ * udelay_yield - delay while letting other bthreads run
+ * @usecs:	delay in microseconds
+ *
+ * Like udelay(), but also switches to runnable bthreads for the
+ * duration of the delay, so a driver pacing a hardware poll loop can
+ * overlap the wait with computation in other threads. Not suitable
+ * for precise timing: scheduled work may extend the delay.
+ */
+void udelay_yield(unsigned long usecs)
+{
+	uint64_t start = get_time_ns();
+
+	do {
+		yield();
+	} while (!is_timeout_non_interruptible(start, usecs * USECOND));
+}
+EXPORT_SYMBOL(udelay_yield);
+
 void mdelay_non_interruptible(unsigned long msecs)
 {
 	uint64_t start = get_time_ns();
@@ -21,6 +21,26 @@
 LIST_HEAD(command_list);
 EXPORT_SYMBOL(command_list);
 
+/*
+ * The sorted command_list stays around for the help and completion code,
+ * which want commands in alphabetical order. Lookup by name as done for
+ * every command dispatch goes through this hash table instead of a
+ * linear scan.
+ */
+#define COMMAND_HASH_SIZE	64
+
+static struct hlist_head command_hash[COMMAND_HASH_SIZE];
+
+static struct hlist_head *command_hash_bucket(const char *name)
+{
+	unsigned int hash = 0;
+
+	while (*name)
+		hash = hash * 31 + *name++;
+
+	return &command_hash[hash % COMMAND_HASH_SIZE];
+}
+
 void barebox_cmd_usage(struct command *cmdtp)
 {
 	putchar('\n');
@@ -89,6 +109,7 @@ int register_command(struct command *cmd)
 	debug("register command %s\n", cmd->name);
 
 	list_add_sort(&cmd->list, &command_list, compare);
+	hlist_add_head(&cmd->hash, command_hash_bucket(cmd->name));
 
 	if (cmd->aliases) {
 		const char * const *aliases = cmd->aliases;
@@ -120,7 +141,7 @@ struct command *find_cmd (const char *cmd)
 {
 	struct command *cmdtp;
 
-	for_each_command(cmdtp)
+	hlist_for_each_entry(cmdtp, command_hash_bucket(cmd), hash)
 		if (!strcmp(cmd, cmdtp->name))
 			return cmdtp;
 
@@ -57,6 +57,8 @@ static int file_complete(struct string_list *sl, char *instr,
 		goto out;
 
 	while ((d = readdir(dir))) {
+		unsigned char d_type = d->d_type;
+
 		if (!strcmp(d->d_name, ".") || !strcmp(d->d_name, ".."))
 			continue;
 
@@ -65,10 +67,24 @@ static int file_complete(struct string_list *sl, char *instr,
 
 		strcpy(tmp, instr);
 		strcat(tmp, d->d_name + strlen(base));
-		if (!stat(tmp, &s) && S_ISDIR(s.st_mode)) {
+
+		/*
+		 * Most filesystems report the entry type along with the
+		 * name. Only symlinks and entries of unknown type need the
+		 * stat, which walks the full path again and can be
+		 * expensive on slow media.
+		 */
+		if (d_type == DT_UNKNOWN || d_type == DT_LNK) {
+			if (stat(tmp, &s))
+				s.st_mode = 0;
+			d_type = S_ISDIR(s.st_mode) ? DT_DIR :
+				 S_ISREG(s.st_mode) ? DT_REG : DT_UNKNOWN;
+		}
+
+		if (d_type == DT_DIR) {
 			strcat(tmp, "/");
 		} else {
-			if (exec && !S_ISREG(s.st_mode))
+			if (exec && d_type != DT_REG)
 				continue;
 			strcat(tmp, " ");
 		}
@@ -120,8 +136,13 @@ static int path_command_complete(struct string_list *sl, char *instr)
 				continue;
 
 			if (strstarts_escaped(d->d_name, instr)) {
+				if (d->d_type == DT_DIR)
+					continue;
+
 				strcpy(tmp, d->d_name);
-				if (!stat(tmp, &s) &&
+				if ((d->d_type == DT_UNKNOWN ||
+						d->d_type == DT_LNK) &&
+						!stat(tmp, &s) &&
 						S_ISDIR(s.st_mode))
 					continue;
 				else
@@ -611,30 +611,35 @@ void console_putc(unsigned int ch, char c)
 }
 EXPORT_SYMBOL(console_putc);
 
-int console_puts(unsigned int ch, const char *str)
+/*
+ * Like console_puts(), but with the length supplied by the caller.
+ * printf and friends know how much they formatted, so the string
+ * doesn't have to be scanned again here and in every console.
+ */
+int console_write(unsigned int ch, const char *str, size_t nbytes)
 {
 	struct console_device *cdev;
-	const char *s = str;
+	size_t i;
 	int n = 0;
 
 	if (initialized == CONSOLE_INIT_FULL) {
 		for_each_console(cdev) {
-			if (cdev->f_active & ch) {
-				n = cdev->puts(cdev, str, strlen(str));
-			}
+			if (cdev->f_active & ch)
+				n = cdev->puts(cdev, str, nbytes);
 		}
 		return n;
 	}
 
-	while (*s) {
-		if (*s == '\n')
-			n++;
+	for (i = 0; i < nbytes; i++)
+		console_putc(ch, str[i]);
 
-		console_putc(ch, *s);
-		n++;
-		s++;
-	}
-	return n;
+	return nbytes;
+}
+EXPORT_SYMBOL(console_write);
+
+int console_puts(unsigned int ch, const char *str)
+{
+	return console_write(ch, str, strlen(str));
 }
 EXPORT_SYMBOL(console_puts);
 
@@ -85,29 +85,60 @@ static void print_colored_log_level(unsigned int ch, const int level)
 	console_puts(ch, colored_log_level[level]);
 }
 
-static void pr_puts(int level, const char *str)
+/*
+ * Messages above the console loglevel are only worth formatting when
+ * they end up in the log buffer. Only when that is compiled out or
+ * disabled at runtime can they be dropped right away.
+ */
+static bool log_buffered(void)
+{
+	return IS_ENABLED(CONFIG_LOGBUF) && mem_malloc_is_initialized() &&
+		barebox_log_max_messages >= 0;
+}
+
+/* @msglen is the length of @str, which the callers know from formatting */
+static void pr_puts(int level, const char *str, size_t msglen)
 {
 	struct log_entry *log;
 
-	if (IS_ENABLED(CONFIG_LOGBUF) && mem_malloc_is_initialized()) {
-		if (barebox_log_max_messages > 0)
-			log_clean(barebox_log_max_messages - 1);
+	if (log_buffered()) {
+		/* rounding up improves the reuse rate of recycled entries */
+		int alloc = ALIGN(msglen + 1, 32);
 
-		if (barebox_log_max_messages >= 0) {
-			int msglen;
+		if (barebox_log_max_messages > 0)
+			log_clean(barebox_log_max_messages);
+
+		/*
+		 * Once the buffer is full every message evicts the oldest
+		 * one. Recycle its allocation instead of going through a
+		 * free()/malloc() pair per message.
+		 */
+		log = NULL;
+		if (barebox_log_max_messages > 0 &&
+		    barebox_logbuf_num_messages >= barebox_log_max_messages) {
+			log = list_first_entry(&barebox_logbuf,
+					       struct log_entry, list);
+			list_del(&log->list);
+			barebox_logbuf_num_messages--;
+			if (log->alloc < msglen + 1) {
+				free(log);
+				log = NULL;
+			}
+		}
 
-			msglen = strlen(str);
-			log = malloc(struct_size(log, msg, msglen + 1));
+		if (!log) {
+			log = malloc(struct_size(log, msg, alloc));
 			if (!log)
 				goto nolog;
+			log->alloc = alloc;
+		}
 
-			memcpy(log->msg, str, msglen + 1);
+		memcpy(log->msg, str, msglen + 1);
 
-			log->timestamp = get_time_ns();
-			log->level = level;
-			list_add_tail(&log->list, &barebox_logbuf);
-			barebox_logbuf_num_messages++;
-		}
+		log->timestamp = get_time_ns();
+		log->level = level;
+		list_add_tail(&log->list, &barebox_logbuf);
+		barebox_logbuf_num_messages++;
 	}
 
 	pstore_log(str);
@@ -117,7 +148,7 @@ nolog:
 		return;
 
 	print_colored_log_level(CONSOLE_STDERR, level);
-	console_puts(CONSOLE_STDERR, str);
+	console_write(CONSOLE_STDERR, str, msglen);
 }
 
 int pr_print(int level, const char *fmt, ...)
@@ -126,14 +157,15 @@ int pr_print(int level, const char *fmt, ...)
 	int i;
 	char printbuffer[CFG_PBSIZE];
 
-	if (!IS_ENABLED(CONFIG_LOGBUF) && level > barebox_loglevel)
+	if (level > barebox_loglevel && !log_buffered())
 		return 0;
 
 	va_start(args, fmt);
 	i = vsnprintf(printbuffer, sizeof(printbuffer), fmt, args);
 	va_end(args);
 
-	pr_puts(level, printbuffer);
+	pr_puts(level, printbuffer,
+		min_t(size_t, i, sizeof(printbuffer) - 1));
 
 	return i;
 }
@@ -146,7 +178,7 @@ int dev_printf(int level, const struct device *dev, const char *format, ...)
 	char printbuffer[CFG_PBSIZE];
 	size_t size = sizeof(printbuffer);
 
-	if (!IS_ENABLED(CONFIG_LOGBUF) && level > barebox_loglevel)
+	if (level > barebox_loglevel && !log_buffered())
 		return 0;
 
 	if (dev && dev->driver && dev->driver->name)
@@ -160,7 +192,7 @@ int dev_printf(int level, const struct device *dev, const char *format, ...)
 
 	va_end(args);
 
-	pr_puts(level, printbuffer);
+	pr_puts(level, printbuffer, min_t(size_t, ret, size - 1));
 
 	return ret;
 }
@@ -282,7 +314,8 @@ int printf(const char *fmt, ...)
 	va_end(args);
 
 	/* Print the string */
-	puts(printbuffer);
+	console_write(CONSOLE_STDOUT, printbuffer,
+		      min_t(size_t, i, sizeof(printbuffer) - 1));
 
 	return i;
 }
@@ -300,7 +333,8 @@ int vprintf(const char *fmt, va_list args)
 	i = vsnprintf(printbuffer, sizeof(printbuffer), fmt, args);
 
 	/* Print the string */
-	puts(printbuffer);
+	console_write(CONSOLE_STDOUT, printbuffer,
+		      min_t(size_t, i, sizeof(printbuffer) - 1));
 
 	return i;
 }
@@ -110,19 +110,11 @@ static int elf_segment_cmp(void *priv, struct list_head *a, struct list_head *b)
 static int load_elf_to_memory(struct elf_image *elf)
 {
 	void *dst;
-	int ret = 0, fd = -1;
+	int ret = 0;
 	u64 p_filesz, p_memsz, p_offset;
 	struct elf_segment *r;
 	struct list_head *list = &elf->list;
 
-	if (elf->filename) {
-		fd = open(elf->filename, O_RDONLY);
-		if (fd < 0) {
-			pr_err("could not open: %m\n");
-			return -errno;
-		}
-	}
-
 	zero_page_access();
 
 	list_for_each_entry(r, list, list) {
@@ -134,15 +126,38 @@ static int load_elf_to_memory(struct elf_image *elf)
 		pr_debug("Loading phdr offset 0x%llx to 0x%p (%llu bytes)\n",
 			 p_offset, dst, p_filesz);
 
-		if (fd >= 0) {
-			ret = lseek(fd, p_offset, SEEK_SET);
-			if (ret == -1) {
+		if (elf->fd >= 0) {
+			u64 offset = p_offset;
+			u64 remaining = p_filesz;
+			void *buf = dst;
+
+			/*
+			 * The start of the file up to elf->hdr_size is
+			 * already in hdr_buf, so serve any segment bytes
+			 * falling into that window from memory. This way the
+			 * descriptor only ever moves forward and the
+			 * remaining segment data streams directly into its
+			 * target address, without reopening the file and
+			 * transferring the beginning again.
+			 */
+			if (offset < elf->hdr_size) {
+				u64 n = min(elf->hdr_size - offset, remaining);
+
+				memcpy(buf, elf->hdr_buf + offset, n);
+				offset += n;
+				remaining -= n;
+				buf += n;
+			}
+
+			if (remaining &&
+			    lseek(elf->fd, offset, SEEK_SET) == -1) {
 				pr_err("lseek at offset 0x%llx failed\n",
-				       p_offset);
+				       offset);
+				ret = -errno;
 				goto out;
 			}
 
-			if (read_full(fd, dst, p_filesz) < 0) {
+			if (remaining && read_full(elf->fd, buf, remaining) < 0) {
 				pr_err("could not read elf segment: %m\n");
 				ret = -errno;
 				goto out;
@@ -158,9 +173,12 @@ static int load_elf_to_memory(struct elf_image *elf)
 out:
 	zero_page_faulting();
 
-	close(fd);
+	if (elf->fd >= 0) {
+		close(elf->fd);
+		elf->fd = -1;
+	}
 
-	return ret >= 0 ? 0 : ret;
+	return ret;
 }
 
 static int load_elf_image_segments(struct elf_image *elf)
@@ -227,6 +245,7 @@ static void elf_init_struct(struct elf_image *elf)
 	elf->low_addr = (void *) (unsigned long) -1;
 	elf->high_addr = 0;
 	elf->filename = NULL;
+	elf->fd = -1;
 }
 
 struct elf_image *elf_open_binary(void *buf)
@@ -255,7 +274,7 @@ struct elf_image *elf_open_binary(void *buf)
 static struct elf_image *elf_check_init(const char *filename)
 {
 	int ret, fd;
-	int hdr_size;
+	u64 hdr_size, buf_size;
 	struct elf64_hdr hdr;
 	struct elf_image *elf;
 
@@ -265,7 +284,12 @@ static struct elf_image *elf_check_init(const char *filename)
 
 	elf_init_struct(elf);
 
-	/* First pass is to read elf header only */
+	/*
+	 * Read the elf header and the program headers in a single forward
+	 * pass and keep the descriptor open for elf_load(): on transports
+	 * like tftp every open starts the transfer over, so the segments
+	 * are later streamed from the same descriptor instead.
+	 */
 	fd = open(filename, O_RDONLY);
 	if (fd < 0) {
 		pr_err("could not open: %m\n");
@@ -275,45 +299,34 @@ static struct elf_image *elf_check_init(const char *filename)
 
 	if (read_full(fd, &hdr, sizeof(hdr)) < 0) {
 		pr_err("could not read elf header: %m\n");
-		close(fd);
 		ret = -errno;
-		goto err_free_elf;
+		goto err_close_fd;
 	}
-	close(fd);
 
 	ret = elf_check_image(elf, &hdr);
 	if (ret)
-		goto err_free_elf;
+		goto err_close_fd;
 
 	hdr_size = elf_hdr_e_phoff(elf, &hdr) +
 		   elf_hdr_e_phnum(elf, &hdr) *
 		   elf_hdr_e_phentsize(elf, &hdr);
+	buf_size = max_t(u64, hdr_size, sizeof(hdr));
 
-	/* Second pass is to read the whole elf header and program headers */
-	elf->hdr_buf = malloc(hdr_size);
+	elf->hdr_buf = malloc(buf_size);
 	if (!elf->hdr_buf) {
 		ret = -ENOMEM;
-		goto err_free_elf;
+		goto err_close_fd;
 	}
 
-	/*
-	 * We must open the file again since some fs (tftp) do not support
-	 * backward lseek operations
-	 */
-	fd = open(filename, O_RDONLY);
-	if (fd < 0) {
-		pr_err("could not open: %m\n");
-		ret = -errno;
-		goto err_free_hdr_buf;
-	}
+	memcpy(elf->hdr_buf, &hdr, sizeof(hdr));
 
-	if (read_full(fd, elf->hdr_buf, hdr_size) < 0) {
+	if (buf_size > sizeof(hdr) &&
+	    read_full(fd, elf->hdr_buf + sizeof(hdr),
+		      buf_size - sizeof(hdr)) < 0) {
 		pr_err("could not read elf program headers: %m\n");
 		ret = -errno;
-		close(fd);
 		goto err_free_hdr_buf;
 	}
-	close(fd);
 
 	elf->filename = strdup(filename);
 	if (!elf->filename) {
@@ -321,12 +334,16 @@ static struct elf_image *elf_check_init(const char *filename)
 		goto err_free_hdr_buf;
 	}
 
+	elf->hdr_size = buf_size;
+	elf->fd = fd;
 	elf->entry = elf_hdr_e_entry(elf, elf->hdr_buf);
 
 	return elf;
 
 err_free_hdr_buf:
 	free(elf->hdr_buf);
+err_close_fd:
+	close(fd);
 err_free_elf:
 	free(elf);
 
@@ -347,6 +364,9 @@ void elf_close(struct elf_image *elf)
 {
 	elf_release_regions(elf);
 
+	if (elf->fd >= 0)
+		close(elf->fd);
+
 	if (elf->filename) {
 		free(elf->hdr_buf);
 		free_const(elf->filename);
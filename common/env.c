@@ -111,18 +111,48 @@ const char *var_name(struct variable_d *var)
 	return var->name;
 }
 
-static const char *getenv_raw(struct list_head *l, const char *name)
+/* djb2, good enough for short variable names */
+static unsigned int env_hash_str(const char *name)
 {
+	unsigned int hash = 5381;
+
+	while (*name)
+		hash = hash * 33 + (unsigned char)*name++;
+
+	return hash;
+}
+
+static struct hlist_head *env_hash_bucket(struct env_context *c,
+					  struct list_head *l,
+					  unsigned int hash)
+{
+	struct hlist_head *tbl = (l == &c->local) ? c->local_hash : c->global_hash;
+
+	return &tbl[hash & (ENV_HASH_SIZE - 1)];
+}
+
+static struct variable_d *env_lookup(struct env_context *c, struct list_head *l,
+				     const char *name)
+{
+	unsigned int hash = env_hash_str(name);
 	struct variable_d *v;
 
-	list_for_each_entry(v, l, list) {
-		if (!strcmp(var_name(v), name))
-			return var_val(v);
+	hlist_for_each_entry(v, env_hash_bucket(c, l, hash), hash_node) {
+		if (v->hash == hash && !strcmp(var_name(v), name))
+			return v;
 	}
 
 	return NULL;
 }
 
+static const char *getenv_raw(struct env_context *c, struct list_head *l,
+			      const char *name)
+{
+	struct variable_d *v = env_lookup(c, l, name);
+
+	return v ? var_val(v) : NULL;
+}
+
 static int getenv_raw_call(int (*fn)(struct variable_d *v, void *data),
 			   struct list_head *l, void *data)
 {
@@ -180,12 +210,12 @@ const char *getenv(const char *name)
 
 	c = context;
 
-	val = getenv_raw(&c->local, name);
+	val = getenv_raw(c, &c->local, name);
 	if (val)
 		return val;
 
 	while (c) {
-		val = getenv_raw(&c->global, name);
+		val = getenv_raw(c, &c->global, name);
 		if (val)
 			return val;
 		c = c->parent;
@@ -216,33 +246,34 @@ int envvar_for_each(int (*fn)(struct variable_d *v, void *data), void *data)
 }
 EXPORT_SYMBOL(envvar_for_each);
 
-static int setenv_raw(struct list_head *l, const char *name, const char *value)
+static int setenv_raw(struct env_context *c, struct list_head *l,
+		      const char *name, const char *value)
 {
 	struct variable_d *v;
 
-	list_for_each_entry(v, l, list) {
-		if (!strcmp(v->name, name)) {
-			if (value) {
-				free_const(v->data);
-				v->data = xstrdup_const(value);
-
-				return 0;
-			} else {
-				list_del(&v->list);
-				free_const(v->name);
-				free_const(v->data);
-				free(v);
-
-				return 0;
-			}
+	v = env_lookup(c, l, name);
+	if (v) {
+		if (value) {
+			free_const(v->data);
+			v->data = xstrdup_const(value);
+		} else {
+			list_del(&v->list);
+			hlist_del(&v->hash_node);
+			free_const(v->name);
+			free_const(v->data);
+			free(v);
 		}
+
+		return 0;
 	}
 
 	if (value) {
 		v = xzalloc(sizeof(*v));
 		v->name = xstrdup_const(name);
 		v->data = xstrdup_const(value);
+		v->hash = env_hash_str(name);
 		list_add_tail(&v->list, l);
+		hlist_add_head(&v->hash_node, env_hash_bucket(c, l, v->hash));
 	}
 
 	return 0;
@@ -308,12 +339,12 @@ int setenv(const char *_name, const char *value)
 		goto out;
 	}
 
-	if (getenv_raw(&context->global, name))
+	if (getenv_raw(context, &context->global, name))
 		list = &context->global;
 	else
 		list = &context->local;
 
-	ret = setenv_raw(list, name, value);
+	ret = setenv_raw(context, list, name, value);
 out:
 	free_const(name);
 
@@ -352,11 +383,11 @@ EXPORT_SYMBOL(pr_setenv);
 
 int export(const char *varname)
 {
-	const char *val = getenv_raw(&context->local, varname);
+	const char *val = getenv_raw(context, &context->local, varname);
 
 	if (val) {
-		setenv_raw(&context->global, varname, val);
-		setenv_raw(&context->local, varname, NULL);
+		setenv_raw(context, &context->global, varname, val);
+		setenv_raw(context, &context->local, varname, NULL);
 	}
 	return 0;
 }
@@ -384,7 +384,14 @@ int envfs_save(const char *filename, const char *dirname, unsigned flags)
 		goto out;
 	}
 
-	ret = erase(envfd, ERASE_SIZE_ALL, 0, ERASE_TO_WRITE);
+	size += sizeof(struct envfs_super);
+
+	/*
+	 * Only erase the range we are about to write. Flash drivers align
+	 * this up to full erase blocks and stale data beyond the new image
+	 * is ignored on load as the data length comes from the superblock.
+	 */
+	ret = erase(envfd, size, 0, ERASE_TO_WRITE);
 
 	/* ENOSYS and EOPNOTSUPP aren't errors here, many devices don't need it */
 	if (ret && errno != ENOSYS && errno != EOPNOTSUPP) {
@@ -392,8 +399,6 @@ int envfs_save(const char *filename, const char *dirname, unsigned flags)
 		goto out;
 	}
 
-	size += sizeof(struct envfs_super);
-
 	wbuf = buf;
 
 	while (size) {
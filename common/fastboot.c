@@ -23,6 +23,8 @@
 #include <command.h>
 #include <ioctl.h>
 #include <bbu.h>
+#include <bthread.h>
+#include <sched.h>
 #include <bootm.h>
 #include <fs.h>
 #include <init.h>
@@ -570,6 +572,153 @@ static int check_ubi(struct fastboot *fb, struct file_list_entry *fentry,
 	}
 }
 
+static int fastboot_sparse_write_chunk(struct fastboot *fb,
+				       struct file_list_entry *fentry,
+				       int fd, struct mtd_info *mtd,
+				       void *buf, size_t retlen, loff_t pos)
+{
+	int ret;
+
+	if (pos == 0) {
+		ret = check_ubi(fb, fentry, file_detect_type(buf, retlen));
+		if (ret < 0)
+			return ret;
+	}
+
+	if (fentry->flags & FILE_LIST_FLAG_UBI) {
+		if (!IS_ENABLED(CONFIG_UBIFORMAT))
+			return -ENOSYS;
+
+		if (pos == 0) {
+			ret = do_ubiformat(fb, mtd, NULL, 0);
+			if (ret)
+				return ret;
+		}
+
+		return ubiformat_write(mtd, buf, retlen, pos);
+	}
+
+	discard_range(fd, retlen, pos);
+
+	pos = lseek(fd, pos, SEEK_SET);
+	if (pos == -1)
+		return errno == EINVAL ? -ENOSPC : -errno;
+
+	ret = write_full(fd, buf, retlen);
+
+	return ret < 0 ? ret : 0;
+}
+
+#ifdef CONFIG_BTHREAD
+
+struct fastboot_sparse_buf {
+	void *data;
+	loff_t pos;
+	size_t len;
+	bool full;
+};
+
+struct fastboot_sparse_stream {
+	struct sparse_image_ctx *sparse;
+	struct fastboot_sparse_buf buf[2];
+	int bufsiz;
+	int ret;
+	bool eof;
+};
+
+/*
+ * Runs as a bthread: decode the next sparse chunk into whichever buffer
+ * is free while the main context writes the previous one out. The
+ * overlap comes from the device drivers rescheduling while they wait
+ * for their hardware, which hands control back to this thread.
+ */
+static void fastboot_sparse_fill_thread(void *data)
+{
+	struct fastboot_sparse_stream *stream = data;
+	int idx = 0;
+
+	while (!bthread_should_stop()) {
+		struct fastboot_sparse_buf *buf = &stream->buf[idx];
+		size_t retlen;
+		int ret;
+
+		/* bthread_should_stop() yielded for us */
+		if (buf->full)
+			continue;
+
+		ret = sparse_image_read(stream->sparse, buf->data, &buf->pos,
+					stream->bufsiz, &retlen);
+		if (ret) {
+			stream->ret = ret;
+			break;
+		}
+
+		if (!retlen) {
+			stream->eof = true;
+			break;
+		}
+
+		buf->len = retlen;
+		buf->full = true;
+		idx = 1 - idx;
+	}
+}
+
+static int fastboot_sparse_stream_flash(struct fastboot *fb,
+					struct file_list_entry *fentry,
+					struct sparse_image_ctx *sparse,
+					int fd, struct mtd_info *mtd,
+					void *buf, int bufsiz)
+{
+	struct fastboot_sparse_stream stream = {
+		.sparse = sparse,
+		.bufsiz = bufsiz,
+	};
+	struct bthread *filler;
+	int idx = 0, ret = 0;
+
+	stream.buf[0].data = buf;
+	stream.buf[1].data = malloc(bufsiz);
+	if (!stream.buf[1].data)
+		return -ENOMEM;
+
+	filler = bthread_run(fastboot_sparse_fill_thread, &stream,
+			     "fastboot-sparse");
+	if (!filler) {
+		ret = -ENOMEM;
+		goto out;
+	}
+
+	while (1) {
+		struct fastboot_sparse_buf *b = &stream.buf[idx];
+
+		while (!b->full) {
+			if (stream.eof || stream.ret)
+				goto drained;
+			resched();
+		}
+
+		ret = fastboot_sparse_write_chunk(fb, fentry, fd, mtd,
+						  b->data, b->len, b->pos);
+		if (ret)
+			break;
+
+		b->full = false;
+		idx = 1 - idx;
+	}
+drained:
+	if (!ret)
+		ret = stream.ret;
+
+	__bthread_stop(filler);
+out:
+	free(stream.buf[1].data);
+
+	return ret;
+}
+
+#endif /* CONFIG_BTHREAD */
+
 static int fastboot_handle_sparse(struct fastboot *fb,
 				  struct file_list_entry *fentry)
 {
@@ -624,6 +773,15 @@ static int fastboot_handle_sparse(struct fastboot *fb,
 		}
 	}
 
+#ifdef CONFIG_BTHREAD
+	/*
+	 * Decode the next chunk in a second buffer while the current one
+	 * is written out.
+	 */
+	ret = fastboot_sparse_stream_flash(fb, fentry, sparse, fd, mtd,
+					   buf, bufsiz);
+	goto out;
+#else
 	while (1) {
 		size_t retlen;
 		loff_t pos;
@@ -634,43 +792,14 @@ static int fastboot_handle_sparse(struct fastboot *fb,
 		if (!retlen)
 			break;
 
-		if (pos == 0) {
-			ret = check_ubi(fb, fentry, file_detect_type(buf, retlen));
-			if (ret < 0)
-				goto out;
-		}
-
-		if (fentry->flags & FILE_LIST_FLAG_UBI) {
-			if (!IS_ENABLED(CONFIG_UBIFORMAT)) {
-				ret = -ENOSYS;
-				goto out;
-			}
-
-			if (pos == 0) {
-				ret = do_ubiformat(fb, mtd, NULL, 0);
-				if (ret)
-					goto out;
-			}
-
-			ret = ubiformat_write(mtd, buf, retlen, pos);
-			if (ret)
-				goto out;
-		} else {
-			discard_range(fd, retlen, pos);
-
-			pos = lseek(fd, pos, SEEK_SET);
-			if (pos == -1) {
-				ret = errno == EINVAL ? -ENOSPC : -errno;
-				goto out;
-			}
-
-			ret = write_full(fd, buf, retlen);
-			if (ret < 0)
-				goto out;
-		}
+		ret = fastboot_sparse_write_chunk(fb, fentry, fd, mtd, buf,
+						  retlen, pos);
+		if (ret)
+			goto out;
 	}
 
 	ret = 0;
+#endif
 
 out:
 	free(buf);
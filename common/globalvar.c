@@ -382,7 +382,7 @@ static void device_param_print(struct device *dev)
 	struct param_d *param;
 
 	dev_for_each_param(dev, param) {
-		const char *p = dev_get_param(dev, param->name);
+		const char *p = param_get_value(param);
 		const char *nv = NULL;
 
 		if (IS_ENABLED(CONFIG_NVVAR) && dev != &nv_device)
@@ -421,7 +421,7 @@ char *globalvar_get_match(const char *match, const char *separator)
 
 	dev_for_each_param(&global_device, param) {
 		if (!strncmp(match, param->name, strlen(match))) {
-			const char *p = dev_get_param(&global_device, param->name);
+			const char *p = param_get_value(param);
 			if (val) {
 				char *new = basprintf("%s%s%s", val,
 							separator, p);
@@ -724,7 +724,7 @@ int nvvar_save(void)
 
 	dev_for_each_param(&nv_device, param) {
 		ret = __nv_save(TMPDIR "/nv", param->name,
-				dev_get_param(&nv_device, param->name));
+				param_get_value(param));
 		if (ret) {
 			pr_err("Cannot save NV var: %pe\n", ERR_PTR(ret));
 			goto out;
@@ -1790,17 +1790,25 @@ static int parse_string_outer(struct p_context *ctx, const char *s, int flag)
 {
 	struct in_str input;
 	char *p;
-	const char *cp;
+	size_t len;
 	int rcode;
 
 	if ( !s || !*s)
 		return 1;
 
-	cp = strchr(s, '\n');
-	if (!cp || *++cp) {
-		p = xmalloc(strlen(s) + 2);
-		strcpy(p, s);
-		strcat(p, "\n");
+	/*
+	 * The parser wants its input terminated by a newline. Scripts read
+	 * from a file end in one already, so only duplicate the string for
+	 * the (typically short) inputs which don't. This matters because
+	 * words containing variables are reparsed through here on every
+	 * execution, including each loop iteration.
+	 */
+	len = strlen(s);
+	if (s[len - 1] != '\n') {
+		p = xmalloc(len + 2);
+		memcpy(p, s, len);
+		p[len] = '\n';
+		p[len + 1] = '\0';
 		setup_string_in_str(&input, p);
 		rcode = parse_stream_outer(ctx, &input, flag);
 		free(p);
@@ -397,6 +397,17 @@ static int fit_verify_hash(struct fit_handle *handle, struct device_node *image,
 		ret = -EINVAL;
 	}
 
+	/*
+	 * The data property references the read-only FIT blob, which
+	 * cannot change for the lifetime of the handle, so a once
+	 * verified image stays verified and reopening it (e.g. on a
+	 * second boot attempt with a cached handle) need not hash it
+	 * again. The marker property vanishes with the unflattened
+	 * tree in fit_close().
+	 */
+	if (of_property_present(image, "$hash-verified"))
+		return 0;
+
 	hash = of_get_child_by_name(image, "hash-1");
 	if (!hash)
 		hash = of_get_child_by_name(image, "hash@1");
@@ -438,6 +449,7 @@ static int fit_verify_hash(struct fit_handle *handle, struct device_node *image,
 	} else {
 		if (handle->verbose)
 			pr_info("%pOF: hash OK\n", hash);
+		__of_new_property(image, "$hash-verified", NULL, 0);
 		ret = 0;
 	}
 
@@ -470,6 +482,9 @@ static int fit_image_verify_signature(struct fit_handle *handle,
 		ret = -EINVAL;
 	}
 
+	if (of_property_present(image, "$signature-verified"))
+		return 0;
+
 	sig_node = of_get_child_by_name(image, "signature-1");
 	if (!sig_node)
 		sig_node = of_get_child_by_name(image, "signature@1");
@@ -487,6 +502,8 @@ static int fit_image_verify_signature(struct fit_handle *handle,
 	digest_final(digest, hash);
 
 	ret = fit_check_signature(handle, sig_node, algo, hash);
+	if (!ret)
+		__of_new_property(image, "$signature-verified", NULL, 0);
 
 	free(hash);
 
@@ -733,6 +750,16 @@ int fit_config_verify_signature(struct fit_handle *handle, struct device_node *c
 		break;
 	}
 
+	/*
+	 * The signed regions live in the read-only FIT blob, so the
+	 * result of a successful check stays valid as long as the
+	 * handle (and with it the unflattened tree) is around. This
+	 * makes reopening a configuration on a cached handle as cheap
+	 * as a node lookup.
+	 */
+	if (of_property_present(conf_node, "$signature-verified"))
+		return 0;
+
 	for_each_child_of_node(conf_node, sig_node) {
 		if (!of_node_has_prefix(sig_node, "signature"))
 			continue;
@@ -750,6 +777,9 @@ int fit_config_verify_signature(struct fit_handle *handle, struct device_node *c
 		return ret;
 	}
 
+	if (!ret)
+		__of_new_property(conf_node, "$signature-verified", NULL, 0);
+
 	return ret;
 }
 
@@ -981,6 +1011,7 @@ struct fit_handle *fit_open_buf(const void *buf, size_t size, bool verbose,
 	handle->fit = buf;
 	handle->size = size;
 	handle->verify = verify;
+	handle->fd = -1;
 
 	refcount_set(&handle->users, 1);
 
@@ -1010,7 +1041,7 @@ struct fit_handle *fit_open(const char *_filename, bool verbose,
 {
 	struct fit_handle *handle;
 	char *filename;
-	int ret;
+	int fd, ret;
 
 	filename = canonicalize_path(AT_FDCWD, _filename);
 	if (!filename) {
@@ -1028,17 +1059,43 @@ struct fit_handle *fit_open(const char *_filename, bool verbose,
 
 	handle->verbose = verbose;
 	handle->verify = verify;
+	handle->fd = -1;
+
+	fd = open(filename, O_RDONLY);
+	if (fd >= 0) {
+		struct stat s;
+		void *map = memmap(fd, PROT_READ);
+
+		if (map != MAP_FAILED && !fstat(fd, &s) &&
+		    (max_size == FILESIZE_MAX || s.st_size <= max_size)) {
+			/*
+			 * XIP NOR and RAM backed media hand out the image
+			 * directly; verification and decompression then
+			 * read the source data in place instead of from
+			 * a heap copy.
+			 */
+			handle->fit = map;
+			handle->size = s.st_size;
+			handle->fd = fd;
+		} else {
+			close(fd);
+		}
+	}
 
-	ret = read_file_2(filename, &handle->size, &handle->fit_alloc,
-			  max_size);
-	if (ret && ret != -EFBIG) {
-		pr_err("unable to read %s: %pe\n", filename, ERR_PTR(ret));
-		free(handle);
-		free(filename);
-		return ERR_PTR(ret);
+	if (!handle->fit) {
+		ret = read_file_2(filename, &handle->size, &handle->fit_alloc,
+				  max_size);
+		if (ret && ret != -EFBIG) {
+			pr_err("unable to read %s: %pe\n", filename,
+			       ERR_PTR(ret));
+			free(handle);
+			free(filename);
+			return ERR_PTR(ret);
+		}
+
+		handle->fit = handle->fit_alloc;
 	}
 
-	handle->fit = handle->fit_alloc;
 	handle->filename = filename;
 
 	refcount_set(&handle->users, 1);
@@ -1064,6 +1121,9 @@ static void __fit_close(struct fit_handle *handle)
 	if (handle->filename)
 		list_del(&handle->entry);
 
+	if (handle->fd >= 0)
+		close(handle->fd);
+
 	free(handle->filename);
 	free(handle->fit_alloc);
 }
@@ -1108,6 +1168,7 @@ static int fuzz_fit(const u8 *data, size_t size)
 	handle.size = size;
 	handle.fit = data;
 	handle.fit_alloc = NULL;
+	handle.fd = -1;
 
 	ret = fit_do_open(&handle);
 	if (ret)
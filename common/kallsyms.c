@@ -6,15 +6,26 @@
 #include <asm/sections.h>
 
 /* These will be re-linked against their real values during the second link stage */
-extern const unsigned long kallsyms_addresses[] __attribute__((weak));
+extern const s32 kallsyms_offsets[] __attribute__((weak));
+extern const unsigned long kallsyms_relative_base __attribute__((weak));
 extern const unsigned long kallsyms_num_syms __attribute__((weak));
 extern const u8 kallsyms_names[] __attribute__((weak));
+extern const u8 kallsyms_seqs_of_names[] __attribute__((weak));
 
 extern const u8 kallsyms_token_table[] __attribute__((weak));
 extern const u16 kallsyms_token_index[] __attribute__((weak));
 
 extern const unsigned long kallsyms_markers[] __attribute__((weak));
 
+/*
+ * The addresses are stored as 32 bit offsets from a common base, which
+ * halves the table compared to one pointer per symbol on 64 bit targets.
+ */
+static unsigned long kallsyms_sym_address(unsigned long idx)
+{
+	return kallsyms_relative_base + (u32)kallsyms_offsets[idx];
+}
+
 static inline int is_kernel_text(unsigned long addr)
 {
 	if (addr >= (unsigned long)_stext && addr <= (unsigned long)_end)
@@ -88,18 +99,38 @@ static unsigned int get_symbol_offset(unsigned long pos)
 	return name - kallsyms_names;
 }
 
+/* Decode one entry of the table of symbol indices sorted by symbol name */
+static unsigned int kallsyms_seq_to_index(unsigned long seq)
+{
+	const u8 *entry = &kallsyms_seqs_of_names[3 * seq];
+
+	return (entry[0] << 16) | (entry[1] << 8) | entry[2];
+}
+
 /* Lookup the address for this symbol. Returns 0 if not found. */
 unsigned long kallsyms_lookup_name(const char *name)
 {
 	char namebuf[KSYM_NAME_LEN];
-	unsigned long i;
-	unsigned int off;
+	unsigned long low = 0, high = kallsyms_num_syms;
 
-	for (i = 0, off = 0; i < kallsyms_num_syms; i++) {
-		off = kallsyms_expand_symbol(off, namebuf);
+	/*
+	 * Binary search on the name-sorted index instead of decompressing
+	 * every symbol until one matches.
+	 */
+	while (low < high) {
+		unsigned long mid = low + (high - low) / 2;
+		unsigned int idx = kallsyms_seq_to_index(mid);
+		int diff;
 
-		if (strcmp(namebuf, name) == 0)
-			return kallsyms_addresses[i];
+		kallsyms_expand_symbol(get_symbol_offset(idx), namebuf);
+
+		diff = strcmp(name, namebuf);
+		if (!diff)
+			return kallsyms_sym_address(idx);
+		if (diff < 0)
+			high = mid;
+		else
+			low = mid + 1;
 	}
 
 	/* module kallsyms not yet supported */
@@ -114,15 +145,15 @@ static unsigned long get_symbol_pos(unsigned long addr,
 	unsigned long i, low, high, mid;
 
 	/* This kernel should never had been booted. */
-	BUG_ON(!kallsyms_addresses);
+	BUG_ON(!kallsyms_offsets);
 
-	/* Do a binary search on the sorted kallsyms_addresses array. */
+	/* Do a binary search on the sorted kallsyms_offsets array. */
 	low = 0;
 	high = kallsyms_num_syms;
 
 	while (high - low > 1) {
 		mid = low + (high - low) / 2;
-		if (kallsyms_addresses[mid] <= addr)
+		if (kallsyms_sym_address(mid) <= addr)
 			low = mid;
 		else
 			high = mid;
@@ -132,15 +163,15 @@ static unsigned long get_symbol_pos(unsigned long addr,
 	 * Search for the first aliased symbol. Aliased
 	 * symbols are symbols with the same address.
 	 */
-	while (low && kallsyms_addresses[low-1] == kallsyms_addresses[low])
+	while (low && kallsyms_sym_address(low - 1) == kallsyms_sym_address(low))
 		--low;
 
-	symbol_start = kallsyms_addresses[low];
+	symbol_start = kallsyms_sym_address(low);
 
 	/* Search for next non-aliased symbol. */
 	for (i = low + 1; i < kallsyms_num_syms; i++) {
-		if (kallsyms_addresses[i] > symbol_start) {
-			symbol_end = kallsyms_addresses[i];
+		if (kallsyms_sym_address(i) > symbol_start) {
+			symbol_end = kallsyms_sym_address(i);
 			break;
 		}
 	}
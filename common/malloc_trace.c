@@ -0,0 +1,205 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+/*
+ * malloc_trace.c - sampled allocation profiling by call site
+ *
+ * Every Nth allocation records its caller PC chain with the stack
+ * unwinder and is accounted to the matching call site. Frees of
+ * sampled blocks are subtracted again, so grouping the records by
+ * call site shows where the live bytes of a leaking session come
+ * from. All state lives in fixed-size static tables: sampling never
+ * allocates and the overhead is low enough to leave it enabled on
+ * long-running systems.
+ */
+
+#define pr_fmt(fmt) "malloc-trace: " fmt
+
+#include <common.h>
+#include <malloc.h>
+#include <printf.h>
+#include <linux/hash.h>
+#include <linux/log2.h>
+
+#define MALLOC_TRACE_DEPTH	8
+#define MALLOC_TRACE_SITES	64
+#define MALLOC_TRACE_RECORDS	1024
+#define MALLOC_TRACE_PROBES	8
+
+struct malloc_trace_site {
+	unsigned long pc[MALLOC_TRACE_DEPTH];
+	unsigned int nr_pc;
+	unsigned long live_bytes;
+	unsigned long live_count;
+	unsigned long total_bytes;
+	unsigned long total_count;
+};
+
+/* tracks one sampled block while it is live, hashed by its address */
+struct malloc_trace_record {
+	void *mem;
+	size_t bytes;
+	struct malloc_trace_site *site;
+};
+
+static struct malloc_trace_site trace_sites[MALLOC_TRACE_SITES];
+static unsigned int nr_trace_sites;
+static struct malloc_trace_record trace_records[MALLOC_TRACE_RECORDS];
+static unsigned int trace_interval;
+static unsigned int trace_countdown;
+static unsigned long trace_dropped;
+
+static struct malloc_trace_record *trace_record_find(void *mem, bool empty)
+{
+	unsigned int slot = hash_ptr(mem, ilog2(MALLOC_TRACE_RECORDS));
+	int i;
+
+	for (i = 0; i < MALLOC_TRACE_PROBES; i++) {
+		struct malloc_trace_record *rec = &trace_records[slot];
+
+		if (rec->mem == (empty ? NULL : mem))
+			return rec;
+
+		slot = (slot + 1) % MALLOC_TRACE_RECORDS;
+	}
+
+	return NULL;
+}
+
+static struct malloc_trace_site *trace_site_get(const unsigned long *pc,
+						unsigned int nr_pc)
+{
+	struct malloc_trace_site *site;
+	unsigned int i;
+
+	for (i = 0; i < nr_trace_sites; i++) {
+		site = &trace_sites[i];
+		if (site->nr_pc == nr_pc &&
+		    !memcmp(site->pc, pc, nr_pc * sizeof(*pc)))
+			return site;
+	}
+
+	if (nr_trace_sites == MALLOC_TRACE_SITES)
+		return NULL;
+
+	site = &trace_sites[nr_trace_sites++];
+	memcpy(site->pc, pc, nr_pc * sizeof(*pc));
+	site->nr_pc = nr_pc;
+
+	return site;
+}
+
+void malloc_trace_alloc(void *mem, size_t bytes)
+{
+	unsigned long pc[MALLOC_TRACE_DEPTH];
+	struct malloc_trace_record *rec;
+	struct malloc_trace_site *site;
+	unsigned int nr_pc;
+
+	if (!trace_interval || !mem)
+		return;
+
+	if (trace_countdown) {
+		trace_countdown--;
+		return;
+	}
+	trace_countdown = trace_interval - 1;
+
+	/* skip this function and the allocator entry point */
+	nr_pc = stack_save(pc, MALLOC_TRACE_DEPTH, 2);
+	if (!nr_pc)
+		return;
+
+	site = trace_site_get(pc, nr_pc);
+	rec = trace_record_find(mem, true);
+	if (!site || !rec) {
+		trace_dropped++;
+		return;
+	}
+
+	rec->mem = mem;
+	rec->bytes = bytes;
+	rec->site = site;
+
+	site->live_bytes += bytes;
+	site->live_count++;
+	site->total_bytes += bytes;
+	site->total_count++;
+}
+
+void malloc_trace_free(void *mem)
+{
+	struct malloc_trace_record *rec;
+
+	if (!nr_trace_sites || !mem)
+		return;
+
+	rec = trace_record_find(mem, false);
+	if (!rec)
+		return;
+
+	rec->site->live_bytes -= rec->bytes;
+	rec->site->live_count--;
+	rec->mem = NULL;
+}
+
+/**
+ * malloc_trace_enable - start sampling allocations
+ * @interval: record every @interval-th allocation, 0 disables tracing
+ *
+ * Enabling tracing discards all previously collected samples.
+ */
+void malloc_trace_enable(unsigned int interval)
+{
+	trace_interval = 0;
+
+	memset(trace_sites, 0, sizeof(trace_sites));
+	memset(trace_records, 0, sizeof(trace_records));
+	nr_trace_sites = 0;
+	trace_dropped = 0;
+	trace_countdown = 0;
+
+	trace_interval = interval;
+}
+
+void malloc_trace_report(void)
+{
+	bool reported[MALLOC_TRACE_SITES] = {};
+	unsigned int i, j;
+
+	if (!trace_interval) {
+		printf("allocation tracing is disabled, enable with -t\n");
+		return;
+	}
+
+	printf("sampling every %u. allocation, scale sampled sizes accordingly\n\n",
+	       trace_interval);
+
+	/* biggest live consumers first */
+	for (i = 0; i < nr_trace_sites; i++) {
+		struct malloc_trace_site *site = NULL;
+		unsigned int best = 0;
+
+		for (j = 0; j < nr_trace_sites; j++) {
+			if (reported[j])
+				continue;
+			if (!site || trace_sites[j].live_bytes > site->live_bytes) {
+				site = &trace_sites[j];
+				best = j;
+			}
+		}
+
+		if (!site)
+			break;
+		reported[best] = true;
+
+		printf("%lu bytes live in %lu samples (%lu bytes in %lu total):\n",
+		       site->live_bytes, site->live_count,
+		       site->total_bytes, site->total_count);
+		for (j = 0; j < site->nr_pc; j++)
+			printf("    [<%08lx>] %pS\n", site->pc[j],
+			       (void *)site->pc[j]);
+	}
+
+	if (trace_dropped)
+		printf("%lu samples dropped, tables full\n", trace_dropped);
+}
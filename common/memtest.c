@@ -359,10 +359,13 @@ static int update_progress(resource_size_t offset, unsigned flags)
 	return 0;
 }
 
+/* How many words to process between two checks for user interruption */
+#define MEMTEST_BATCH_WORDS	(SZ_4K / sizeof(resource_size_t))
+
 int mem_test_moving_inversions(resource_size_t _start, resource_size_t _end,
 			       unsigned flags)
 {
-	volatile resource_size_t *start, num_words, offset, temp, anti_pattern;
+	resource_size_t *start, num_words, offset, batch_end, temp, anti_pattern;
 	int ret;
 
 	_start = ALIGN(_start, sizeof(resource_size_t));
@@ -390,53 +393,72 @@ int mem_test_moving_inversions(resource_size_t _start, resource_size_t _end,
 	 *		as a zero and a one. The base address
 	 *		and the size of the region are
 	 *		selected by the caller.
+	 *
+	 * Unlike the bus integrity tests above, the pattern loops do not
+	 * depend on the ordering of the individual accesses, so they run
+	 * over plain pointers: this lets the compiler unroll and combine
+	 * the accesses into wide loads and stores, which is several times
+	 * faster than volatile word-at-a-time accesses. User interruption
+	 * and progress are polled once per batch for the same reason.
 	 */
 
 	/* Fill memory with a known pattern */
-	for (offset = 0; offset < num_words; offset++) {
+	for (offset = 0; offset < num_words;) {
+		batch_end = min(num_words, offset + MEMTEST_BATCH_WORDS);
+
+		for (; offset < batch_end; offset++)
+			start[offset] = offset + 1;
+
 		ret = update_progress(offset, flags);
 		if (ret)
 			return ret;
-		start[offset] = offset + 1;
 	}
 
 	/* Check each location and invert it for the second pass */
-	for (offset = 0; offset < num_words; offset++) {
-		ret = update_progress(num_words + offset, flags);
-		if (ret)
-			return ret;
+	for (offset = 0; offset < num_words;) {
+		batch_end = min(num_words, offset + MEMTEST_BATCH_WORDS);
 
-		temp = start[offset];
-		if (temp != (offset + 1)) {
-			printf("\n");
-			mem_test_report_failure("read/write",
-						(offset + 1),
-						temp, &start[offset]);
-			return -EIO;
+		for (; offset < batch_end; offset++) {
+			temp = start[offset];
+			if (temp != (offset + 1)) {
+				printf("\n");
+				mem_test_report_failure("read/write",
+							(offset + 1),
+							temp, &start[offset]);
+				return -EIO;
+			}
+
+			anti_pattern = ~(offset + 1);
+			start[offset] = anti_pattern;
 		}
 
-		anti_pattern = ~(offset + 1);
-		start[offset] = anti_pattern;
+		ret = update_progress(num_words + offset, flags);
+		if (ret)
+			return ret;
 	}
 
 	/* Check each location for the inverted pattern and zero it */
-	for (offset = 0; offset < num_words; offset++) {
-		ret = update_progress(2 * num_words + offset, flags);
-		if (ret)
-			return ret;
+	for (offset = 0; offset < num_words;) {
+		batch_end = min(num_words, offset + MEMTEST_BATCH_WORDS);
 
-		anti_pattern = ~(offset + 1);
-		temp = start[offset];
+		for (; offset < batch_end; offset++) {
+			anti_pattern = ~(offset + 1);
+			temp = start[offset];
 
-		if (temp != anti_pattern) {
-			printf("\n");
-			mem_test_report_failure("read/write",
-						anti_pattern,
-						temp, &start[offset]);
-			return -EIO;
+			if (temp != anti_pattern) {
+				printf("\n");
+				mem_test_report_failure("read/write",
+							anti_pattern,
+							temp, &start[offset]);
+				return -EIO;
+			}
+
+			start[offset] = 0;
 		}
 
-		start[offset] = 0;
+		ret = update_progress(2 * num_words + offset, flags);
+		if (ret)
+			return ret;
 	}
 	if (flags & MEMTEST_VERBOSE) {
 		show_progress(3 * num_words);
@@ -354,6 +354,18 @@ int of_register_set_status_fixup(const char *path, bool status)
 
 LIST_HEAD(of_fixup_list);
 
+/*
+ * Generation counter of the fixup results. It is incremented whenever
+ * something that could change the outcome of the registered fixups is
+ * modified and invalidates the cached fixed-up tree below.
+ */
+static unsigned int of_fixup_generation;
+
+void of_fix_tree_dirty(void)
+{
+	of_fixup_generation++;
+}
+
 static inline bool of_fixup_disabled(struct of_fixup *fixup)
 {
     return fixup->disabled;
@@ -368,6 +380,8 @@ int of_register_fixup(int (*fixup)(struct device_node *, void *), void *context)
 
 	list_add_tail(&of_fixup->list, &of_fixup_list);
 
+	of_fix_tree_dirty();
+
 	return 0;
 }
 
@@ -384,6 +398,7 @@ int of_unregister_fixup(int (*fixup)(struct device_node *, void *),
 		if (of_fixup->fixup == fixup && of_fixup->context == context) {
 			list_del(&of_fixup->list);
 			free(of_fixup);
+			of_fix_tree_dirty();
 			return 0;
 		}
 	}
@@ -413,6 +428,33 @@ void of_fix_tree(struct device_node *node)
 	}
 }
 
+/*
+ * Duplicating the tree, running all fixups and flattening the result takes
+ * hundreds of milliseconds on large SoC device trees, and bootchooser
+ * repeats it for every boot attempt. Since nearly all fixups are
+ * deterministic for the lifetime of a barebox instance, the most recent
+ * fixed-up tree is kept around in flattened form and reused as long as
+ * nothing observable by the fixups changed: the fixup list itself (tracked
+ * through the generation counter), the kernel command line and the overlay
+ * selection (compared through a snapshot of their values). Code with fixup
+ * inputs outside of these must call of_fix_tree_dirty() when its input
+ * changes.
+ */
+static struct fdt_header *fixed_fdt_cache;
+static const struct device_node *fixed_fdt_cache_node;
+static unsigned int fixed_fdt_cache_generation;
+static char *fixed_fdt_cache_env;
+
+static char *of_fixup_env_snapshot(void)
+{
+	return xasprintf("%s|%s|%s|%s|%s",
+			 linux_bootargs_get() ?: "",
+			 getenv("global.of.overlay.path") ?: "",
+			 getenv("global.of.overlay.pattern") ?: "",
+			 getenv("global.of.overlay.compatible") ?: "",
+			 getenv("global.of.overlay.filter") ?: "");
+}
+
 /*
  * Get the fdt. This function uses the fdt input pointer
  * if provided or the barebox internal devicetree if not.
@@ -422,6 +464,8 @@ struct fdt_header *of_get_flattened_tree(const struct device_node *node,
 {
 	struct fdt_header *fdt = NULL;
 	struct device_node *np = NULL;
+	const struct device_node *orig;
+	char *env = NULL;
 
 	if (!node) {
 		node = of_get_root_node();
@@ -429,20 +473,49 @@ struct fdt_header *of_get_flattened_tree(const struct device_node *node,
 			return NULL;
 	}
 
-	if (fixup)
+	orig = node;
+
+	if (fixup) {
+		env = of_fixup_env_snapshot();
+
+		if (fixed_fdt_cache && fixed_fdt_cache_node == orig &&
+		    fixed_fdt_cache_generation == of_fixup_generation &&
+		    !strcmp(fixed_fdt_cache_env, env)) {
+			free(env);
+			return xmemdup(fixed_fdt_cache,
+				       fdt32_to_cpu(fixed_fdt_cache->totalsize));
+		}
+
 		node = np = of_dup(node);
+	}
 
-	if (!node)
+	if (!node) {
+		free(env);
 		return NULL;
+	}
 
 	if (fixup)
 		of_fix_tree(np);
 
 	fdt = of_flatten_dtb((struct device_node *)node);
 
-	if (fixup)
+	if (fixup) {
 		of_delete_node(np);
 
+		if (fdt) {
+			free(fixed_fdt_cache);
+			free(fixed_fdt_cache_env);
+			fixed_fdt_cache = xmemdup(fdt,
+						  fdt32_to_cpu(fdt->totalsize));
+			fixed_fdt_cache_node = orig;
+			fixed_fdt_cache_generation = of_fixup_generation;
+			fixed_fdt_cache_env = env;
+			env = NULL;
+		}
+
+		free(env);
+	}
+
 	return fdt;
 }
 
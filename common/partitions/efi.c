@@ -167,7 +167,8 @@ static gpt_header *alloc_read_gpt_header(struct block_device *blk,
  *
  * lba is the logical block address of the GPT header to test
  * gpt is a GPT header ptr, filled on return.
- * ptes is a PTEs ptr, filled on return.
+ * ptes is a PTEs ptr, filled on return. May be NULL, in which case only
+ * the header is validated and the entry array is not read at all.
  *
  * Description: returns 1 if valid,  0 on error.
  * If valid, returns pointers to PTEs.
@@ -178,8 +179,6 @@ static int is_gpt_valid(struct block_device *blk, u64 lba,
 	u32 crc, origcrc, count;
 	u64 lastlba;
 
-	if (!ptes)
-		return 0;
 	if (!(*gpt = alloc_read_gpt_header(blk, lba)))
 		return 0;
 
@@ -232,6 +231,10 @@ static int is_gpt_valid(struct block_device *blk, u64 lba,
 		goto fail;
 	}
 
+	/* The caller only wanted the header checked */
+	if (!ptes)
+		return 1;
+
 	if (!(*ptes = alloc_read_gpt_entries(blk, *gpt)))
 		goto fail;
 
@@ -415,9 +418,16 @@ static int find_valid_gpt(void *buf, struct block_device *blk, gpt_header **gpt,
 	good_pgpt = is_gpt_valid(blk, GPT_PRIMARY_PARTITION_TABLE_LBA,
 				 &pgpt, &pptes);
 	if (good_pgpt)
+		/*
+		 * With a good primary the alternate's entry array is only
+		 * needed for the optional cross check, so don't read it
+		 * from the end of the disk otherwise.
+		 */
 		good_agpt = is_gpt_valid(blk,
 					 le64_to_cpu(pgpt->alternate_lba),
-					 &agpt, &aptes);
+					 &agpt,
+					 IS_ENABLED(CONFIG_PARTITION_DISK_EFI_GPT_COMPARE) ?
+					 &aptes : NULL);
 	if (!good_agpt && force_gpt)
 		good_agpt = is_gpt_valid(blk, lastlba, &agpt, &aptes);
 
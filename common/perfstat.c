@@ -0,0 +1,95 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+/*
+ * perfstat.c - lightweight hot-path event counters
+ *
+ * Subsystems define small static counter arrays that are incremented
+ * unconditionally on their hot paths; an increment is a load, an add
+ * and a store, so the counters are safe to ship enabled in production
+ * images. The perfstat command prints them and can snapshot and diff
+ * them to attribute activity to a particular operation.
+ */
+
+#include <common.h>
+#include <command.h>
+#include <complete.h>
+#include <getopt.h>
+#include <perfstat.h>
+#include <xfuncs.h>
+
+static LIST_HEAD(perfstat_groups);
+
+void perfstat_register_group(struct perfstat_group *group)
+{
+	list_add_tail(&group->list, &perfstat_groups);
+}
+
+#if IS_ENABLED(CONFIG_CMD_PERFSTAT)
+
+static void perfstat_snapshot(void)
+{
+	struct perfstat_group *group;
+	unsigned int i;
+
+	list_for_each_entry(group, &perfstat_groups, list) {
+		if (!group->snap)
+			group->snap = xzalloc(group->num *
+					      sizeof(*group->snap));
+		for (i = 0; i < group->num; i++)
+			group->snap[i] = group->counters[i].count;
+	}
+}
+
+static int do_perfstat(int argc, char *argv[])
+{
+	bool diff = false;
+	struct perfstat_group *group;
+	unsigned int i;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "sd")) > 0) {
+		switch (opt) {
+		case 's':
+			perfstat_snapshot();
+			return 0;
+		case 'd':
+			diff = true;
+			break;
+		default:
+			return COMMAND_ERROR_USAGE;
+		}
+	}
+
+	list_for_each_entry(group, &perfstat_groups, list) {
+		for (i = 0; i < group->num; i++) {
+			u64 count = group->counters[i].count;
+
+			if (diff && group->snap)
+				count -= group->snap[i];
+
+			printf("%s.%s: %llu\n", group->name,
+			       group->counters[i].name, count);
+		}
+	}
+
+	return 0;
+}
+
+BAREBOX_CMD_HELP_START(perfstat)
+BAREBOX_CMD_HELP_TEXT("Show hot-path event counters, one SUBSYSTEM.COUNTER: VALUE per line.")
+BAREBOX_CMD_HELP_TEXT("")
+BAREBOX_CMD_HELP_TEXT("Options:")
+BAREBOX_CMD_HELP_OPT ("-s",  "snapshot the current counter values")
+BAREBOX_CMD_HELP_OPT ("-d",  "show the difference to the last snapshot")
+BAREBOX_CMD_HELP_END
+
+BAREBOX_CMD_START(perfstat)
+	.cmd		= do_perfstat,
+	BAREBOX_CMD_DESC("show hot-path event counters")
+	BAREBOX_CMD_OPTS("[-sd]")
+	BAREBOX_CMD_GROUP(CMD_GRP_INFO)
+	BAREBOX_CMD_COMPLETE(empty_complete)
+	BAREBOX_CMD_HELP(cmd_perfstat_help)
+BAREBOX_CMD_END
+
+#endif
@@ -13,6 +13,7 @@
 #include <linux/ktime.h>
 #include <poller.h>
 #include <clock.h>
+#include <perfstat.h>
 #include <linux/ktime.h>
 
 /*
@@ -24,6 +25,15 @@
 static LIST_HEAD(poller_list);
 static int __poller_active;
 
+enum {
+	POLLER_PERFSTAT_ITERATIONS,
+};
+
+static DEFINE_PERFSTAT_GROUP(poller_perfstat, "poller",
+	[POLLER_PERFSTAT_ITERATIONS] = { .name = "iterations" },
+);
+PERFSTAT_GROUP_REGISTER(poller_perfstat);
+
 bool poller_active(void)
 {
 	return __poller_active;
@@ -65,6 +75,7 @@ static void poller_async_callback(struct poller_struct *poller)
 		return;
 
 	pa->active = 0;
+	pa->poller.deadline = U64_MAX;
 	pa->fn(pa->ctx);
 }
 
@@ -81,6 +92,7 @@ static void poller_async_callback(struct poller_struct *poller)
 int poller_async_cancel(struct poller_async *pa)
 {
 	pa->active = 0;
+	pa->poller.deadline = U64_MAX;
 
 	return 0;
 }
@@ -103,6 +115,7 @@ int poller_call_async(struct poller_async *pa, uint64_t delay_ns,
 	pa->end = get_time_ns() + delay_ns;
 	pa->fn = fn;
 	pa->active = 1;
+	pa->poller.deadline = pa->end;
 
 	return 0;
 }
@@ -111,6 +124,7 @@ int poller_async_register(struct poller_async *pa, const char *name)
 {
 	pa->poller.func = poller_async_callback;
 	pa->active = 0;
+	pa->poller.deadline = U64_MAX;
 
 	return poller_register(&pa->poller, name);
 }
@@ -123,13 +137,25 @@ int poller_async_unregister(struct poller_async *pa)
 void poller_call(void)
 {
 	struct poller_struct *poller, *tmp;
+	u64 now = get_time_ns();
 
 	__poller_active = 1;
+	perfstat_inc(poller_perfstat, POLLER_PERFSTAT_ITERATIONS);
 
 	list_for_each_entry_safe(poller, tmp, &poller_list, list) {
-		ktime_t start = ktime_get();
+		ktime_t start;
 		s64 duration_ms;
 
+		/*
+		 * Skip pollers that told us when their next work is due.
+		 * This saves the indirect call and the runtime measurement
+		 * for work that cannot have anything to do yet.
+		 */
+		if (poller->deadline && now < poller->deadline)
+			continue;
+
+		start = ktime_get();
+
 		poller->func(poller);
 
 		duration_ms = ktime_ms_delta(ktime_get(), start);
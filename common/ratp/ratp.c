@@ -513,6 +513,8 @@ int barebox_ratp(struct console_device *cdev)
 		goto out;
 
 	ctx->wq.fn = ratp_command_run;
+	/* console commands go before bulk work like fastboot downloads */
+	ctx->wq.prio = 1;
 	ctx->wq.cancel = ratp_work_cancel;
 	wq_register(&ctx->wq);
 	ctx->wq_registered = true;
@@ -22,6 +22,7 @@
 static int init_resource(struct resource *res, const char *name)
 {
 	INIT_LIST_HEAD(&res->children);
+	res->rb_children = RB_ROOT;
 	res->parent = NULL;
 	res->name = xstrdup_const(name);
 
@@ -38,6 +39,8 @@ struct resource *__request_region(struct resource *parent,
 				  resource_size_t start, resource_size_t end,
 				  const char *name, unsigned flags)
 {
+	struct rb_node **link = &parent->rb_children.rb_node;
+	struct rb_node *rb_parent = NULL, *next;
 	struct resource *r, *new;
 
 	if (end < start) {
@@ -58,25 +61,29 @@ struct resource *__request_region(struct resource *parent,
 	}
 
 	/*
-	 * We keep the list of child resources ordered which helps
-	 * us searching for conflicts here.
+	 * The child resources don't overlap, so the rbtree ordered by
+	 * start is enough to find a conflict without scanning them all.
 	 */
-	list_for_each_entry(r, &parent->children, sibling) {
-		if (end < r->start)
-			goto ok;
-		if (start > r->end)
-			continue;
-		res_dbg("request region(0x%08llx:0x%08llx): %s conflicts with 0x%08llx:0x%08llx (%s)\n",
-				(unsigned long long)start,
-				(unsigned long long)end,
-				name,
-				(unsigned long long)r->start,
-				(unsigned long long)r->end,
-				r->name);
-		return ERR_PTR(-EBUSY);
+	while (*link) {
+		rb_parent = *link;
+		r = rb_entry(rb_parent, struct resource, rb);
+
+		if (end < r->start) {
+			link = &rb_parent->rb_left;
+		} else if (start > r->end) {
+			link = &rb_parent->rb_right;
+		} else {
+			res_dbg("request region(0x%08llx:0x%08llx): %s conflicts with 0x%08llx:0x%08llx (%s)\n",
+					(unsigned long long)start,
+					(unsigned long long)end,
+					name,
+					(unsigned long long)r->start,
+					(unsigned long long)r->end,
+					r->name);
+			return ERR_PTR(-EBUSY);
+		}
 	}
 
-ok:
 	res_dbg("request region(0x%08llx:0x%08llx): success flags=0x%x\n",
 			(unsigned long long)start,
 			(unsigned long long)end, flags);
@@ -87,7 +94,16 @@ ok:
 	new->end = end;
 	new->parent = parent;
 	new->flags = flags;
-	list_add_tail(&new->sibling, &r->sibling);
+	rb_link_node(&new->rb, rb_parent, link);
+	rb_insert_color(&new->rb, &parent->rb_children);
+
+	/* keep the sibling list ordered by start, too */
+	next = rb_next(&new->rb);
+	if (next)
+		list_add_tail(&new->sibling,
+			      &rb_entry(next, struct resource, rb)->sibling);
+	else
+		list_add_tail(&new->sibling, &parent->children);
 
 	return new;
 }
@@ -100,6 +116,8 @@ int release_region(struct resource *res)
 	if (!list_empty(&res->children))
 		return -EBUSY;
 
+	if (res->parent)
+		rb_erase(&res->rb, &res->parent->rb_children);
 	list_del(&res->sibling);
 	free_const(res->name);
 	free(res);
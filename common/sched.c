@@ -24,3 +24,23 @@ void resched(void)
 
 	command_slice_release();
 }
+
+/*
+ * yield - give up the CPU while waiting on hardware
+ *
+ * resched() switches bthreads only while nothing holds the command
+ * slice, i.e. while barebox sits idle at the prompt. Driver wait
+ * loops run with the slice held, so during long I/O waits concurrent
+ * bthreads would starve. yield() switches to runnable bthreads
+ * explicitly: a wait loop cannot make progress by itself, so letting
+ * other threads overlap computation with the wait is safe as long as
+ * they do not reenter the waiting driver. Workqueues stay untouched,
+ * they may execute commands and must remain tied to the prompt.
+ */
+void yield(void)
+{
+	resched();
+
+	if (!poller_active())
+		bthread_reschedule();
+}
@@ -19,6 +19,8 @@
 #include <common.h>
 #include <shell.h>
 #include <init.h>
+#include <bootprof.h>
+#include <clock.h>
 #include <command.h>
 #include <malloc.h>
 #include <debug_ll.h>
@@ -398,8 +400,11 @@ void __noreturn start_barebox(void)
 
 	for (initcall = __barebox_initcalls_start;
 			initcall < __barebox_initcalls_end; initcall++) {
+		u64 start = get_time_ns();
+
 		pr_debug("initcall-> %pS\n", *initcall);
 		result = (*initcall)();
+		bootprof_record(BOOTPROF_INITCALL, *initcall, NULL, start);
 		if (result)
 			pr_err("initcall %pS failed: %pe\n", *initcall,
 					ERR_PTR(result));
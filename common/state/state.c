@@ -37,11 +37,15 @@
 static LIST_HEAD(state_list);
 
 /**
- * Save the state
+ * state_flush - write the state to the backend now
  * @param state
  * @return
+ *
+ * This writes the state out unconditionally of the deferred_save
+ * setting. It is the barrier that deferred saves rely on and runs for
+ * all states from the shutdown path before the kernel is started.
  */
-int state_save(struct state *state)
+int state_flush(struct state *state)
 {
 	void *buf;
 	ssize_t len;
@@ -84,6 +88,26 @@ out:
 	return ret;
 }
 
+/**
+ * Save the state
+ * @param state
+ * @return
+ *
+ * With the deferred_save device parameter set the state is only marked
+ * for writing and the backend write is delayed until state_flush() is
+ * called, which happens at the latest when barebox shuts down to start
+ * the kernel. This keeps frequent updates like the bootchooser attempt
+ * counters out of the critical boot path at the cost of losing them
+ * when power is cut before the handoff.
+ */
+int state_save(struct state *state)
+{
+	if (state->deferred_save)
+		return 0;
+
+	return state_flush(state);
+}
+
 /**
  * state_do_load - Loads a state from the backend
  * @param state The state that should be updated to contain the loaded data
@@ -200,6 +224,9 @@ static struct state *state_new(const char *name)
 	dev_add_param_bool(&state->dev, "save_on_shutdown", NULL, NULL,
 			   &state->save_on_shutdown, NULL);
 
+	dev_add_param_bool(&state->dev, "deferred_save", NULL, NULL,
+			   &state->deferred_save, NULL);
+
 	dev_add_param_bool(&state->dev, "init_from_defaults", state_set_deny, NULL,
 			   &state->init_from_defaults, NULL);
 
@@ -811,7 +838,7 @@ static void state_shutdown(void)
 
 	list_for_each_entry(state, &state_list, list) {
 		if (state->save_on_shutdown)
-			state_save(state);
+			state_flush(state);
 	}
 }
 predevshutdown_exitcall(state_shutdown);
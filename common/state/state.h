@@ -116,6 +116,7 @@ struct state {
 	unsigned int dirty;
 	unsigned int init_from_defaults;
 	unsigned int save_on_shutdown;
+	unsigned int deferred_save;
 
 	struct state_backend_format *format;
 	struct state_backend_storage storage;
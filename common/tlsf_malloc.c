@@ -14,12 +14,54 @@
 #include <linux/sizes.h>
 #include <linux/log2.h>
 
+#include <linux/bitops.h>
 #include <linux/kasan.h>
 #include <linux/list.h>
+#include <perfstat.h>
+
+enum {
+	MALLOC_PERFSTAT_CALLS,
+};
+
+static DEFINE_PERFSTAT_GROUP(malloc_perfstat, "malloc",
+	[MALLOC_PERFSTAT_CALLS] = { .name = "calls" },
+);
+PERFSTAT_GROUP_REGISTER(malloc_perfstat);
 
 tlsf_t tlsf_mem_pool;
 static void (*malloc_request_store)(size_t bytes);
 
+/*
+ * log2 size class allocation counters plus used bytes high watermark.
+ * Updating them costs a counter increment and a block header read, so
+ * they are always on.
+ */
+#define MALLOC_NUM_BUCKETS	32
+
+static unsigned long malloc_alloc_count[MALLOC_NUM_BUCKETS];
+static size_t malloc_used_bytes, malloc_peak_bytes;
+
+static void malloc_track_alloc(void *mem, size_t bytes)
+{
+	unsigned int bucket;
+
+	if (!mem)
+		return;
+
+	bucket = min_t(unsigned int, fls_long(bytes), MALLOC_NUM_BUCKETS - 1);
+	malloc_alloc_count[bucket]++;
+
+	malloc_used_bytes += tlsf_block_size(mem);
+	if (malloc_used_bytes > malloc_peak_bytes)
+		malloc_peak_bytes = malloc_used_bytes;
+}
+
+static void malloc_track_free(void *mem)
+{
+	if (mem)
+		malloc_used_bytes -= tlsf_block_size(mem);
+}
+
 struct pool_entry {
 	pool_t pool;
 	struct list_head list;
@@ -36,16 +78,23 @@ void *malloc(size_t bytes)
 {
 	void *mem;
 
+	perfstat_inc(malloc_perfstat, MALLOC_PERFSTAT_CALLS);
+
 	mem = tlsf_malloc(tlsf_mem_pool, bytes);
 	if (!mem)
 		errno = ENOMEM;
 
+	malloc_track_alloc(mem, bytes);
+	malloc_trace_alloc(mem, bytes);
+
 	return mem;
 }
 EXPORT_SYMBOL(malloc);
 
 void free(void *mem)
 {
+	malloc_track_free(mem);
+	malloc_trace_free(mem);
 	tlsf_free(tlsf_mem_pool, mem);
 }
 EXPORT_SYMBOL(free);
@@ -58,10 +107,19 @@ EXPORT_SYMBOL(malloc_usable_size);
 
 void *realloc(void *oldmem, size_t bytes)
 {
+	size_t oldsize = oldmem ? tlsf_block_size(oldmem) : 0;
 	void *mem = tlsf_realloc(tlsf_mem_pool, oldmem, bytes);
 	if (!mem)
 		errno = ENOMEM;
 
+	/* the old block is gone when a new one was returned or on free */
+	if (mem || !bytes) {
+		malloc_used_bytes -= oldsize;
+		malloc_trace_free(oldmem);
+	}
+	malloc_track_alloc(mem, bytes);
+	malloc_trace_alloc(mem, bytes);
+
 	return mem;
 }
 EXPORT_SYMBOL(realloc);
@@ -72,6 +130,9 @@ void *memalign(size_t alignment, size_t bytes)
 	if (!mem)
 		errno = ENOMEM;
 
+	malloc_track_alloc(mem, bytes);
+	malloc_trace_alloc(mem, bytes);
+
 	return mem;
 }
 EXPORT_SYMBOL(memalign);
@@ -79,30 +140,50 @@ EXPORT_SYMBOL(memalign);
 struct malloc_stats {
 	size_t free;
 	size_t used;
+	size_t max_free;
 };
 
 static void malloc_walker(void* ptr, size_t size, int used, void *user)
 {
 	struct malloc_stats *s = user;
 
-	if (used)
+	if (used) {
 		s->used += size;
-	else
+	} else {
 		s->free += size;
+		if (size > s->max_free)
+			s->max_free = size;
+	}
 }
 
 void malloc_stats(void)
 {
 	struct pool_entry *cur_pool;
 	struct malloc_stats s;
+	int i;
 
 	s.used = 0;
 	s.free = 0;
+	s.max_free = 0;
 
 	list_for_each_entry(cur_pool, &mem_pool_list, list)
 		tlsf_walk_pool(cur_pool->pool, malloc_walker, &s);
 
 	printf("used: %zu\nfree: %zu\n", s.used, s.free);
+	printf("peak used: %zu\n", malloc_peak_bytes);
+	printf("largest free block: %zu\n", s.max_free);
+
+	printf("allocations by request size:\n");
+	for (i = 0; i < MALLOC_NUM_BUCKETS; i++) {
+		if (!malloc_alloc_count[i])
+			continue;
+		if (i == 0)
+			printf("%10u - %-10u %lu\n", 0, 0,
+			       malloc_alloc_count[i]);
+		else
+			printf("%10lu - %-10lu %lu\n", 1UL << (i - 1),
+			       (1UL << i) - 1, malloc_alloc_count[i]);
+	}
 }
 
 void *malloc_add_pool(void *mem, size_t bytes)
@@ -174,11 +174,52 @@ static int mark_bad(struct ubiformat_args *args, struct mtd_info *mtd,
 	return consecutive_bad_check(args, eb);
 }
 
+/* Maximum number of eraseblocks erased ahead with a single driver call */
+#define ERASE_RUN_MAX	64
+
+/*
+ * Erase the eraseblocks ahead of the one currently flashed in runs of
+ * consecutive good blocks. One driver call per run amortizes the
+ * per-block call overhead, which adds up over the thousands of blocks
+ * erased during factory flashing. @erased_up_to tracks how far ahead
+ * the device has been erased; blocks below it are served without
+ * touching the flash again.
+ */
+static int erase_ahead(struct mtd_info *mtd, struct ubi_scan_info *si,
+		       int eb, int eb_cnt, int max_blocks, int *erased_up_to)
+{
+	int run = 1, err;
+
+	if (eb < *erased_up_to)
+		return 0;
+
+	while (eb + run < eb_cnt && run < min(ERASE_RUN_MAX, max_blocks) &&
+	       si->ec[eb + run] != EB_BAD)
+		run++;
+
+	err = mtd_peb_erase_range(mtd, eb, run);
+	if (!err) {
+		*erased_up_to = eb + run;
+		return 0;
+	}
+
+	/*
+	 * The failing block is somewhere in the run. Redo just this
+	 * block, so the caller's bad block handling sees the right one;
+	 * the rest of the run is retried when its turn comes.
+	 */
+	err = mtd_peb_erase(mtd, eb);
+	if (!err)
+		*erased_up_to = eb + 1;
+
+	return err;
+}
+
 static int flash_image(struct ubiformat_args *args, struct mtd_info *mtd,
 		       const struct ubigen_info *ui, struct ubi_scan_info *si)
 {
 	int fd = 0, img_ebs, eb, written_ebs = 0, ret = -1, eb_cnt;
-	int skip_data_read = 0;
+	int skip_data_read = 0, erased_up_to = 0;
 	off_t st_size;
 	char *buf = NULL;
 	uint64_t lastprint = 0;
@@ -242,7 +283,8 @@ static int flash_image(struct ubiformat_args *args, struct mtd_info *mtd,
 			normsg_cont("eraseblock %d: erase", eb);
 		}
 
-		err = mtd_peb_erase(mtd, eb);
+		err = erase_ahead(mtd, si, eb, eb_cnt, img_ebs - written_ebs,
+				  &erased_up_to);
 		if (err) {
 			if (!args->quiet)
 				printf("\n");
@@ -341,7 +383,7 @@ static int format(struct ubiformat_args *args, struct mtd_info *mtd,
 		  const struct ubigen_info *ui, struct ubi_scan_info *si,
 		  int start_eb, int novtbl)
 {
-	int eb, err, write_size, eb_cnt;
+	int eb, err, write_size, eb_cnt, erased_up_to = 0;
 	struct ubi_ec_hdr *hdr;
 	struct ubi_vtbl_record *vtbl;
 	int eb1 = -1, eb2 = -1;
@@ -385,7 +427,7 @@ static int format(struct ubiformat_args *args, struct mtd_info *mtd,
 			normsg_cont("eraseblock %d: erase", eb);
 		}
 
-		err = mtd_peb_erase(mtd, eb);
+		err = erase_ahead(mtd, si, eb, eb_cnt, eb_cnt, &erased_up_to);
 		if (err) {
 			if (!args->quiet)
 				printf("\n");
@@ -184,6 +184,15 @@ struct uimage_handle *uimage_open(const char *filename)
 	 */
 	handle->fd = fd;
 
+	/*
+	 * On media mapped into the address space (RAM-backed devfs, XIP
+	 * NOR) verification and loading can read the data in place
+	 * instead of going through a bounce buffer.
+	 */
+	handle->map = memmap(fd, PROT_READ);
+	if (handle->map == MAP_FAILED)
+		handle->map = NULL;
+
 	return handle;
 err_out:
 	close(fd);
@@ -217,10 +226,27 @@ void uimage_close(struct uimage_handle *handle)
 EXPORT_SYMBOL(uimage_close);
 
 static int uimage_fd;
+static u32 uimage_load_crc;
+static u32 uimage_load_crc_remain;
+static bool uimage_load_crc_active;
 
 static long uimage_fill(void *buf, unsigned long len)
 {
-	return read_full(uimage_fd, buf, len);
+	long ret = read_full(uimage_fd, buf, len);
+
+	/*
+	 * With deferred verification the crc is folded over the data as
+	 * it streams by, instead of a separate read pass. Cap at the
+	 * data area size as decompressors may read past the stream end.
+	 */
+	if (uimage_load_crc_active && ret > 0) {
+		u32 now = min_t(u32, ret, uimage_load_crc_remain);
+
+		uimage_load_crc = crc32(uimage_load_crc, buf, now);
+		uimage_load_crc_remain -= now;
+	}
+
+	return ret;
 }
 
 static int uncompress_copy(unsigned char *inbuf_unused, long len,
@@ -260,6 +286,18 @@ int uimage_verify(struct uimage_handle *handle)
 	loff_t off;
 	void *buf;
 
+	if (handle->map) {
+		crc = crc32(0, handle->map + sizeof(struct image_header),
+			    handle->header.ih_size);
+		if (crc != handle->header.ih_dcrc) {
+			printf("Bad Data CRC: 0x%08x != 0x%08x\n",
+					crc, handle->header.ih_dcrc);
+			return -EINVAL;
+		}
+
+		return 0;
+	}
+
 	off = sizeof(struct image_header);
 	if (lseek(handle->fd, off, SEEK_SET) != off)
 		return -errno;
@@ -293,6 +331,26 @@ err:
 }
 EXPORT_SYMBOL(uimage_verify);
 
+/*
+ * uimage_defer_verify - verify the data crc during uimage_load()
+ *
+ * Fold the data crc in while uimage_load() streams the image instead
+ * of reading the whole file once in advance, so verification comes
+ * essentially for free with the load. Only possible when a single data
+ * entry covers the whole data area. Returns 0 when the deferred mode
+ * could be enabled; the crc result is then reported by uimage_load().
+ */
+int uimage_defer_verify(struct uimage_handle *handle)
+{
+	if (handle->nb_data_entries != 1 || handle->data_offset)
+		return -ENOSYS;
+
+	handle->verify_deferred = true;
+
+	return 0;
+}
+EXPORT_SYMBOL(uimage_defer_verify);
+
 /*
  * Load a uimage, flushing output to flush function
  */
@@ -316,8 +374,6 @@ int uimage_load(struct uimage_handle *handle, unsigned int image_no,
 	iha = &handle->ihd[image_no];
 
 	off = iha->offset + handle->data_offset;
-	if (lseek(handle->fd, off, SEEK_SET) != off)
-		return -errno;
 
 	/* if ramdisk U-Boot expect to ignore the compression type */
 	if (hdr->ih_comp == IH_COMP_NONE || hdr->ih_type == IH_TYPE_RAMDISK)
@@ -325,11 +381,80 @@ int uimage_load(struct uimage_handle *handle, unsigned int image_no,
 	else
 		uncompress_fn = uncompress;
 
+	if (handle->map) {
+		unsigned char *data = handle->map + off;
+		long now;
+
+		/*
+		 * The medium is mapped into the address space, so flush
+		 * uncompressed data straight from the mapping resp. let
+		 * the decompressor read its input in place.
+		 */
+		if (uncompress_fn == uncompress_copy) {
+			now = flush(data, iha->len);
+			ret = now < 0 ? now : 0;
+		} else {
+			ret = uncompress(data, iha->len, NULL, flush,
+					 NULL, NULL, uncompress_err_stdout);
+		}
+
+		if (!ret && handle->verify_deferred) {
+			u32 crc = crc32(0, data, hdr->ih_size);
+
+			if (crc != hdr->ih_dcrc) {
+				printf("Bad Data CRC: 0x%08x != 0x%08x\n",
+						crc, hdr->ih_dcrc);
+				ret = -EINVAL;
+			}
+		}
+
+		return ret;
+	}
+
+	if (lseek(handle->fd, off, SEEK_SET) != off)
+		return -errno;
+
 	uimage_fd = handle->fd;
 
+	if (handle->verify_deferred) {
+		uimage_load_crc = 0;
+		uimage_load_crc_remain = hdr->ih_size;
+		uimage_load_crc_active = true;
+	}
+
 	ret = uncompress_fn(NULL, iha->len, uimage_fill, flush,
 				NULL, NULL,
 				uncompress_err_stdout);
+
+	if (handle->verify_deferred) {
+		/*
+		 * A decompressor may stop before the end of the data
+		 * area, e.g. when it is padded. Fold in whatever is
+		 * left before checking the crc.
+		 */
+		while (!ret && uimage_load_crc_remain) {
+			char buf[512];
+			int now = min_t(u32, uimage_load_crc_remain, sizeof(buf));
+
+			now = read(handle->fd, buf, now);
+			if (now <= 0) {
+				ret = now ? now : -EINVAL;
+				break;
+			}
+
+			uimage_load_crc = crc32(uimage_load_crc, buf, now);
+			uimage_load_crc_remain -= now;
+		}
+
+		uimage_load_crc_active = false;
+
+		if (!ret && uimage_load_crc != hdr->ih_dcrc) {
+			printf("Bad Data CRC: 0x%08x != 0x%08x\n",
+					uimage_load_crc, hdr->ih_dcrc);
+			ret = -EINVAL;
+		}
+	}
+
 	return ret;
 }
 EXPORT_SYMBOL(uimage_load);
@@ -1,5 +1,6 @@
 // SPDX-License-Identifier: GPL-2.0-only
 #include <common.h>
+#include <bthread.h>
 #include <work.h>
 
 static void wq_do_pending_work(struct work_queue *wq)
@@ -7,7 +8,11 @@ static void wq_do_pending_work(struct work_queue *wq)
 	struct work_struct *work, *tmp;
 
 	list_for_each_entry_safe(work, tmp, &wq->work, list) {
-		if (work->delayed && get_time_ns() < work->timeout)
+		/*
+		 * Delayed work is coarse grained anyway, the cached
+		 * timestamp is plenty accurate for it.
+		 */
+		if (work->delayed && get_time_ns_coarse() < work->timeout)
 			continue;
 
 		list_del(&work->list);
@@ -46,16 +51,65 @@ void wq_do_all_works(void)
  */
 void wq_register(struct work_queue *wq)
 {
+	struct work_queue *tmp;
+
 	INIT_LIST_HEAD(&wq->work);
+
+	list_for_each_entry(tmp, &work_queues, list) {
+		if (tmp->prio < wq->prio) {
+			list_add_tail(&wq->list, &tmp->list);
+			return;
+		}
+	}
+
 	list_add_tail(&wq->list, &work_queues);
 }
 
+static void wq_bthread(void *data)
+{
+	struct work_queue *wq = data;
+
+	while (!bthread_should_stop())
+		wq_do_pending_work(wq);
+}
+
+/**
+ * wq_register_bthread - register a work queue running on its own bthread
+ * @wq:    The work queue
+ *
+ * Pending work of this queue is run from a dedicated bthread instead of
+ * the shared wq_do_all_works() pass, so bulk work items proceed in the
+ * background without holding up the work of other queues.
+ */
+int wq_register_bthread(struct work_queue *wq)
+{
+	INIT_LIST_HEAD(&wq->work);
+	INIT_LIST_HEAD(&wq->list);
+
+	if (!IS_ENABLED(CONFIG_BTHREAD)) {
+		list_add_tail(&wq->list, &work_queues);
+		return 0;
+	}
+
+	wq->bthread = bthread_run(wq_bthread, wq, "wq");
+	if (!wq->bthread)
+		return -ENOMEM;
+
+	return 0;
+}
+
 /**
  * wq_unregister - unregister a work queue
  * @wq:    The work queue
  */
 void wq_unregister(struct work_queue *wq)
 {
+	if (wq->bthread) {
+		__bthread_stop(wq->bthread);
+		wq->bthread = NULL;
+	} else {
+		list_del(&wq->list);
+	}
+
 	wq_cancel_work(wq);
-	list_del(&wq->list);
 }
@@ -22,7 +22,7 @@
 #define STATIC static inline
 #endif
 
-static uint32_t crc_table[sizeof(uint32_t) * 256];
+static uint32_t crc_table[8][256];
 
 /*
   Generate a table for a byte-wise 32-bit CRC calculation on the polynomial:
@@ -56,7 +56,7 @@ static void make_crc_table(void)
 	/* terms of polynomial defining this crc (except x^32): */
 	static const char p[] = { 0, 1, 2, 4, 5, 7, 8, 10, 11, 12, 16, 22, 23, 26 };
 
-	if (crc_table[1])
+	if (crc_table[0][1])
 		return;
 
 	/* make exclusive-or pattern from polynomial (0xedb88320L) */
@@ -68,28 +68,118 @@ static void make_crc_table(void)
 		c = (uint32_t) n;
 		for (k = 0; k < 8; k++)
 			c = c & 1 ? poly ^ (c >> 1) : c >> 1;
-		crc_table[n] = c;
+		crc_table[0][n] = c;
+	}
+
+	/* derive the slice-by-8 tables from the byte-wise one */
+	for (n = 0; n < 256; n++) {
+		c = crc_table[0][n];
+		for (k = 1; k < 8; k++) {
+			c = crc_table[0][c & 0xff] ^ (c >> 8);
+			crc_table[k][n] = c;
+		}
 	}
 }
 
-#define DO1(buf) crc = crc_table[((int)crc ^ (*buf++)) & 0xff] ^ (crc >> 8);
+#define DO1(buf) crc = crc_table[0][((int)crc ^ (*buf++)) & 0xff] ^ (crc >> 8);
 #define DO2(buf)  DO1(buf); DO1(buf);
 #define DO4(buf)  DO2(buf); DO2(buf);
 #define DO8(buf)  DO4(buf); DO4(buf);
 
+#if defined(__BAREBOX__) && defined(__aarch64__)
+#include <asm/sysreg.h>
+
+static int crc32_have_hw(void)
+{
+	static int hw = -1;
+
+	if (hw < 0)
+		hw = !!(read_sysreg(ID_AA64ISAR0_EL1) &
+			ID_AA64ISAR0_EL1_CRC32_MASK);
+
+	return hw;
+}
+
+/*
+ * The ARMv8 CRC32 instructions implement exactly this reflected
+ * 0xedb88320 polynomial, one word or doubleword per cycle on most
+ * cores. Alignment is handled byte-wise as early code may run with
+ * the MMU off, where unaligned accesses fault.
+ */
+static uint32_t crc32_no_comp_hw(uint32_t crc, const unsigned char *buf,
+				 unsigned int len)
+{
+	while (len && ((unsigned long)buf & 7)) {
+		asm(".arch_extension crc\n"
+		    "crc32b %w0, %w0, %w1" : "+r" (crc) : "r" (*buf++));
+		len--;
+	}
+
+	while (len >= 8) {
+		asm(".arch_extension crc\n"
+		    "crc32x %w0, %w0, %x1"
+		    : "+r" (crc) : "r" (*(const uint64_t *)buf));
+		buf += 8;
+		len -= 8;
+	}
+
+	while (len--)
+		asm(".arch_extension crc\n"
+		    "crc32b %w0, %w0, %w1" : "+r" (crc) : "r" (*buf++));
+
+	return crc;
+}
+#else
+static inline int crc32_have_hw(void) { return 0; }
+static inline uint32_t crc32_no_comp_hw(uint32_t crc, const unsigned char *buf,
+					unsigned int len)
+{
+	return crc;
+}
+#endif
+
 /* No ones complement version. JFFS2 (and other things ?)
  * don't use ones compliment in their CRC calculations.
  */
 STATIC uint32_t crc32_no_comp(uint32_t crc, const void *_buf, unsigned int len)
 {
 	const unsigned char *buf = _buf;
+	static const union { uint32_t u; unsigned char c[4]; } endian = { 1 };
+
+	if (crc32_have_hw())
+		return crc32_no_comp_hw(crc, buf, len);
 
 	make_crc_table();
 
-	while (len >= 8) {
-		DO8(buf);
-		len -= 8;
+	/* align to enable word loads in the slice-by-8 loop */
+	while (len && ((unsigned long)buf & 3)) {
+		DO1(buf);
+		len--;
 	}
+
+	if (endian.c[0]) {	/* little endian slice-by-8 */
+		while (len >= 8) {
+			uint32_t q1 = crc ^ *(const uint32_t *)buf;
+			uint32_t q2 = *(const uint32_t *)(buf + 4);
+
+			crc = crc_table[7][q1 & 0xff] ^
+			      crc_table[6][(q1 >> 8) & 0xff] ^
+			      crc_table[5][(q1 >> 16) & 0xff] ^
+			      crc_table[4][q1 >> 24] ^
+			      crc_table[3][q2 & 0xff] ^
+			      crc_table[2][(q2 >> 8) & 0xff] ^
+			      crc_table[1][(q2 >> 16) & 0xff] ^
+			      crc_table[0][q2 >> 24];
+			buf += 8;
+			len -= 8;
+		}
+	} else {
+		while (len >= 8) {
+			DO8(buf);
+			len -= 8;
+		}
+	}
+
 	if (len)
 		do {
 			DO1(buf);
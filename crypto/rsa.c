@@ -177,7 +177,7 @@ static int is_public_exponent_bit_set(const struct rsa_public_key *key,
 static int pow_mod(const struct rsa_public_key *key, void *__inout)
 {
 	uint32_t *inout = __inout;
-	uint32_t *result, *ptr;
+	uint32_t *result, *ptr, *cur, *next;
 	uint i;
 	int j, k;
 	uint32_t val[RSA_MAX_KEY_BITS / 32], acc[RSA_MAX_KEY_BITS / 32], tmp[RSA_MAX_KEY_BITS / 32];
@@ -190,8 +190,6 @@ static int pow_mod(const struct rsa_public_key *key, void *__inout)
 		return -EINVAL;
 	}
 
-	result = tmp;  /* Re-use location. */
-
 	/* Convert from big endian byte array to little endian word array. */
 	for (i = 0, ptr = inout + key->len - 1; i < key->len; i++, ptr--)
 		val[i] = get_unaligned_be32(ptr);
@@ -210,27 +208,36 @@ static int pow_mod(const struct rsa_public_key *key, void *__inout)
 		return -EINVAL;
 	}
 
+	/*
+	 * Ping-pong between the two work buffers instead of copying the
+	 * intermediate result back after each squaring. For the usual
+	 * exponent 65537 nearly every iteration takes the zero-bit path,
+	 * so this saves a key-sized memcpy per squaring.
+	 */
+	cur = acc;
+	next = tmp;
+
 	/* the bit at e[k-1] is 1 by definition, so start with: C := M */
-	montgomery_mul(key, acc, val, key->rr); /* acc = a * RR / R mod n */
+	montgomery_mul(key, cur, val, key->rr); /* cur = a * RR / R mod n */
 	/* retain scaled version for intermediate use */
-	memcpy(a_scaled, acc, key->len * sizeof(a_scaled[0]));
+	memcpy(a_scaled, cur, key->len * sizeof(a_scaled[0]));
 
 	for (j = k - 2; j > 0; --j) {
-		montgomery_mul(key, tmp, acc, acc); /* tmp = acc^2 / R mod n */
+		montgomery_mul(key, next, cur, cur); /* next = cur^2 / R mod n */
 
 		if (is_public_exponent_bit_set(key, j)) {
-			/* acc = tmp * val / R mod n */
-			montgomery_mul(key, acc, tmp, a_scaled);
+			/* cur = next * val / R mod n */
+			montgomery_mul(key, cur, next, a_scaled);
 		} else {
-			/* e[j] == 0, copy tmp back to acc for next operation */
-			memcpy(acc, tmp, key->len * sizeof(acc[0]));
+			/* e[j] == 0, the squaring result is the new value */
+			swap(cur, next);
 		}
 	}
 
 	/* the bit at e[0] is always 1 */
-	montgomery_mul(key, tmp, acc, acc); /* tmp = acc^2 / R mod n */
-	montgomery_mul(key, acc, tmp, val); /* acc = tmp * a / R mod M */
-	memcpy(result, acc, key->len * sizeof(result[0]));
+	montgomery_mul(key, next, cur, cur); /* next = cur^2 / R mod n */
+	montgomery_mul(key, cur, next, val); /* cur = next * a / R mod M */
+	result = cur;
 
 	/* Make sure result < mod; result is at most 1x mod too large. */
 	if (greater_equal_modulus(key, result))
@@ -26,11 +26,14 @@
 #define AHCI_MAX_DATA_BYTE_COUNT  SZ_4M
 
 /*
- * Some controllers limit number of blocks they can read/write at once.
- * Contemporary SSD devices work much faster if the read/write size is aligned
- * to a power of 2.
+ * Maximum number of sectors per command, both encoded as 0 in the sector
+ * count field(s). The LBA48 maximum of 32MiB per command fits comfortably
+ * into the PRD table (AHCI_MAX_SG entries of AHCI_MAX_DATA_BYTE_COUNT
+ * each), so the transfer length per command is only bounded by the
+ * command set.
  */
-#define MAX_SATA_BLOCKS_READ_WRITE	0x80
+#define MAX_SATA_BLOCKS_LBA28	256
+#define MAX_SATA_BLOCKS_LBA48	65536
 
 /* Maximum timeouts for each event */
 #define WAIT_SPINUP	(10 * SECOND)
@@ -225,7 +228,8 @@ static int ahci_rw(struct ata_port *ata, void *rbuf, const void *wbuf,
 	while (num_blocks) {
 		int now;
 
-		now = min_t(blkcnt_t, MAX_SATA_BLOCKS_READ_WRITE, num_blocks);
+		now = min_t(blkcnt_t, lba48 ? MAX_SATA_BLOCKS_LBA48 :
+			    MAX_SATA_BLOCKS_LBA28, num_blocks);
 
 		fis[4] = (block >> 0) & 0xff;
 		fis[5] = (block >> 8) & 0xff;
@@ -233,15 +237,17 @@ static int ahci_rw(struct ata_port *ata, void *rbuf, const void *wbuf,
 
 		if (lba48) {
 			fis[7] = 1 << 6; /* device reg: set LBA mode */
-			fis[8] = ((block >> 24) & 0xff);
+			fis[8] = (block >> 24) & 0xff;
+			fis[9] = (block >> 32) & 0xff;
+			fis[10] = (block >> 40) & 0xff;
 			fis[3] = 0xe0; /* features */
 		} else {
 			fis[7] = ((block >> 24) & 0xf) | 0xe0;
 		}
 
-		/* Block (sector) count */
+		/* Block (sector) count, 0 means the maximum */
 		fis[12] = (now >> 0) & 0xff;
-		fis[13] = (now >> 8) & 0xff;
+		fis[13] = lba48 ? (now >> 8) & 0xff : 0;
 
 		ret = ahci_io(ahci, fis, sizeof(fis), rbuf, wbuf, now * SECTOR_SIZE);
 		if (ret)
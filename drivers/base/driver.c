@@ -13,9 +13,13 @@
 #define dev_err_probe dev_err_probe
 
 #include <common.h>
+#include <bootprof.h>
+#include <bthread.h>
+#include <clock.h>
 #include <command.h>
 #include <deep-probe.h>
 #include <driver.h>
+#include <sched.h>
 #include <malloc.h>
 #include <console.h>
 #include <linux/ctype.h>
@@ -118,6 +122,7 @@ static void dev_report_permanent_probe_deferral(struct device *dev)
 int device_probe(struct device *dev)
 {
 	static int depth = 0;
+	u64 start;
 	int ret;
 
 	ret = of_feature_controller_check(dev->of_node);
@@ -137,6 +142,8 @@ int device_probe(struct device *dev)
 
 	list_add(&dev->active, &active_device_list);
 
+	start = get_time_ns();
+
 	if (dev->bus->probe)
 		ret = dev->bus->probe(dev);
 	else if (dev->driver->probe)
@@ -144,6 +151,8 @@ int device_probe(struct device *dev)
 	else
 		ret = 0;
 
+	bootprof_record(BOOTPROF_PROBE, NULL, dev_name(dev), start);
+
 	depth--;
 
 	switch (ret) {
@@ -217,6 +226,69 @@ void device_detect_all(void)
 		device_detect(dev);
 }
 
+#ifdef CONFIG_ASYNC_PROBE
+static unsigned int async_probes;
+
+static void device_probe_threadfn(void *data)
+{
+	struct device *dev = data;
+
+	/*
+	 * device_probe() does the usual bookkeeping, but resetting
+	 * dev->driver on failure is up to match(), so mirror it here.
+	 * Devices that requested deferral are picked up again by
+	 * device_probe_deferred() once all threads have finished.
+	 */
+	if (device_probe(dev))
+		dev->driver = NULL;
+
+	async_probes--;
+	bthread_cancel(current);
+}
+
+/*
+ * Probe a device in a bthread, so that delay loops in the probe overlap
+ * with the remaining initcalls and with other threaded probes. Only
+ * drivers which opted in with probe_async are handled this way, and only
+ * on non deep-probe machines: deep probe relies on dependencies being
+ * fully probed on return of of_device_ensure_probed().
+ */
+static bool device_probe_threaded(struct device *dev)
+{
+	struct bthread *thread;
+
+	if (!dev->driver->probe_async)
+		return false;
+
+	if (deep_probe_is_supported())
+		return false;
+
+	thread = bthread_run(device_probe_threadfn, dev, "probe/%s",
+			     dev_name(dev));
+	if (!thread)
+		return false;
+
+	async_probes++;
+
+	return true;
+}
+
+static void device_probe_sync(void)
+{
+	while (async_probes)
+		resched();
+}
+#else
+static inline bool device_probe_threaded(struct device *dev)
+{
+	return false;
+}
+
+static inline void device_probe_sync(void)
+{
+}
+#endif
+
 static int match(struct driver *drv, struct device *dev)
 {
 	int ret;
@@ -228,9 +300,18 @@ static int match(struct driver *drv, struct device *dev)
 
 	if (!driver_match_device(drv, dev))
 		goto err_out;
+	if (device_probe_threaded(dev))
+		return 0;
 	ret = device_probe(dev);
-	if (ret)
+	if (ret) {
+		/*
+		 * The driver matched and only the probe deferred, so
+		 * remember it for the retry passes.
+		 */
+		if (ret == -EPROBE_DEFER)
+			dev->deferred_driver = drv;
 		goto err_out;
+	}
 
 	return 0;
 err_out:
@@ -381,6 +462,8 @@ static int device_probe_deferred(void)
 	struct driver *drv;
 	bool success;
 
+	device_probe_sync();
+
 	do {
 		success = false;
 
@@ -388,10 +471,26 @@ static int device_probe_deferred(void)
 			return 0;
 
 		list_for_each_entry_safe(dev, tmp, &deferred, active) {
+			struct driver *prev = dev->deferred_driver;
+
 			list_del(&dev->active);
 			INIT_LIST_HEAD(&dev->active);
 
 			dev_dbg(dev, "re-probe device\n");
+
+			/*
+			 * The matching driver is known from the pass that
+			 * deferred, so retry that one directly instead of
+			 * matching the device against every driver on the
+			 * bus again.
+			 */
+			if (prev) {
+				dev->deferred_driver = NULL;
+				if (!match(prev, dev))
+					success = true;
+				continue;
+			}
+
 			bus_for_each_driver(dev->bus, drv) {
 				if (match(drv, dev))
 					continue;
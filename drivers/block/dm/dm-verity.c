@@ -22,6 +22,8 @@
 #include <linux/bitops.h>
 #include <linux/hex.h>
 #include <linux/kstrtox.h>
+#include <linux/log2.h>
+#include <linux/sizes.h>
 
 #include "dm-target.h"
 
@@ -46,13 +48,22 @@ struct dm_verity {
 		unsigned long *trusted;
 		u8 *digest;
 
+		/* Direct-mapped cache of hash blocks, indexed by the
+		 * low bits of the hash block number. Covers the whole
+		 * tree when it fits into DM_VERITY_HCACHE_MAX_SIZE.
+		 */
 		struct {
 			u8 *data;
-			sector_t block;
-		} hblock;
+			sector_t *block;
+			unsigned int nr;
+			const u8 *cur;
+		} hcache;
 	} verify;
 };
 
+/* Upper bound on the memory spent on cached hash blocks. */
+#define DM_VERITY_HCACHE_MAX_SIZE SZ_1M
+
 static sector_t dm_verity_position_at_level(struct dm_verity *v, sector_t dblock,
 					    int level)
 {
@@ -87,21 +98,29 @@ static int dm_verity_set_digest(struct dm_verity *v, const void *buf, size_t buf
 
 static int dm_verity_set_hblock(struct dm_verity *v, sector_t hblock)
 {
+	unsigned int slot = hblock & (v->verify.hcache.nr - 1);
+	u8 *data = v->verify.hcache.data + ((size_t)slot << v->hdev.blk.bits);
 	int err;
 
-	if (v->verify.hblock.block == hblock)
+	v->verify.hcache.cur = data;
+
+	if (v->verify.hcache.block[slot] == hblock)
 		/* Requested block is already loaded. This is the
 		 * common scenario for sequential block checking once
 		 * the upper levels of hash blocks have been marked as
-		 * trusted.
+		 * trusted, and for jumps within the reach of the
+		 * cache.
 		 */
 		return 0;
 
-	err = dm_cdev_read(&v->hdev, v->verify.hblock.data, hblock, 1);
-	if (err)
+	err = dm_cdev_read(&v->hdev, data, hblock, 1);
+	if (err) {
+		/* The slot holds a partial read now, don't match it. */
+		v->verify.hcache.block[slot] = v->hdev.blk.num;
 		return err;
+	}
 
-	v->verify.hblock.block = hblock;
+	v->verify.hcache.block[slot] = hblock;
 	return 0;
 }
 
@@ -124,7 +143,7 @@ static int dm_verity_verify(struct dm_target *ti, const void *buf, sector_t dblo
 		if (err)
 			return err;
 
-		expected = v->verify.hblock.data + hoffs;
+		expected = v->verify.hcache.cur + hoffs;
 
 		if (memcmp(v->verify.digest, expected, v->digest_len)) {
 			dm_target_err_once(
@@ -149,7 +168,7 @@ static int dm_verity_verify(struct dm_target *ti, const void *buf, sector_t dblo
 		 * entire hblock, which then becomes the input when
 		 * checking the next level up.
 		 */
-		err = dm_verity_set_digest(v, v->verify.hblock.data,
+		err = dm_verity_set_digest(v, v->verify.hcache.cur,
 					   1 << v->hdev.blk.bits);
 		if (err)
 			return err;
@@ -333,7 +352,7 @@ static int dm_verity_cdev_init(struct dm_target *ti, struct dm_cdev *dmcdev,
 static int dm_verity_create(struct dm_target *ti, unsigned int argc, char **argv)
 {
 	struct dm_verity *v;
-	unsigned int ver;
+	unsigned int nr_slots, ver, i;
 	int err;
 
 	if (argc != 10) {
@@ -395,12 +414,24 @@ static int dm_verity_create(struct dm_target *ti, unsigned int argc, char **argv
 	if (err)
 		goto err;
 
-	/* Initialize this to a value larger than the largest possible
-	 * hash block lba to make sure that the first hash block read
-	 * in dm_verity_verify() always misses the cache.
+	/* Cache the whole hash tree if it fits into the size budget,
+	 * otherwise as many blocks as do. The slot count must be a
+	 * power of two, since hash block numbers map to slots by
+	 * masking. Slots start out tagged with a value larger than
+	 * the largest possible hash block lba to make sure the first
+	 * read of each slot always misses the cache.
 	 */
-	v->verify.hblock.block = v->hdev.blk.num;
-	v->verify.hblock.data = xmalloc(1 << v->hdev.blk.bits);
+	nr_slots = DM_VERITY_HCACHE_MAX_SIZE >> v->hdev.blk.bits;
+	if (v->hdev.blk.num && v->hdev.blk.num < nr_slots)
+		nr_slots = roundup_pow_of_two(v->hdev.blk.num);
+	if (!nr_slots)
+		nr_slots = 1;
+
+	v->verify.hcache.nr = nr_slots;
+	v->verify.hcache.data = xmalloc((size_t)nr_slots << v->hdev.blk.bits);
+	v->verify.hcache.block = xmalloc(nr_slots * sizeof(sector_t));
+	for (i = 0; i < nr_slots; i++)
+		v->verify.hcache.block[i] = v->hdev.blk.num;
 
 	v->verify.digest = xmalloc(v->digest_len);
 	v->verify.trusted = bitmap_xzalloc(v->hdev.blk.num);
@@ -427,7 +458,8 @@ static int dm_verity_destroy(struct dm_target *ti)
 	struct dm_verity *v = ti->private;
 
 	free(v->verify.digest);
-	free(v->verify.hblock.data);
+	free(v->verify.hcache.block);
+	free(v->verify.hcache.data);
 	free(v->verify.trusted);
 	free(v->salt);
 	free(v->root_digest);
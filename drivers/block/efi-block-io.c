@@ -15,28 +15,75 @@
 #include <efi/efi-payload.h>
 #include <efi/efi-device.h>
 #include <bootsource.h>
+#include <linux/sizes.h>
 
 #define EFI_BLOCK_IO_PROTOCOL_REVISION2 0x00020001
 #define EFI_BLOCK_IO_PROTOCOL_REVISION3 ((2<<16) | (31))
 
+/* transfer size used when a caller buffer has to be bounced */
+#define EFI_BIO_BOUNCE_SIZE	SZ_64K
+
 struct efi_bio_priv {
 	struct efi_block_io_protocol *protocol;
 	struct device *dev;
 	struct block_device blk;
 	u32 media_id;
+	u32 io_align;
+	void *bounce;
 };
 
+/*
+ * Small reads and writes are coalesced into chunk-sized transfers by the
+ * block layer cache, but large reads bypass the cache straight into the
+ * caller's buffer. That buffer does not necessarily meet the alignment
+ * the media requires, and several OEM firmwares fall back to a painfully
+ * slow single-sector path (or outright refuse) when it doesn't. Stage
+ * such transfers through a page-aligned bounce buffer instead.
+ */
+static bool efi_bio_aligned(struct efi_bio_priv *priv, const void *buffer)
+{
+	return priv->io_align <= 1 ||
+		!((uintptr_t)buffer & (priv->io_align - 1));
+}
+
+static void *efi_bio_bounce_buffer(struct efi_bio_priv *priv)
+{
+	if (!priv->bounce)
+		priv->bounce = xmemalign(PAGE_SIZE, EFI_BIO_BOUNCE_SIZE);
+
+	return priv->bounce;
+}
+
 static int efi_bio_read(struct block_device *blk, void *buffer, sector_t block,
 		blkcnt_t num_blocks)
 {
 	struct efi_bio_priv *priv = container_of(blk, struct efi_bio_priv, blk);
+	size_t len = (size_t)num_blocks << blk->blockbits;
 	efi_status_t efiret;
 
-	efiret = priv->protocol->read(priv->protocol, priv->media_id,
-			block, num_blocks * 512, buffer);
+	if (efi_bio_aligned(priv, buffer)) {
+		efiret = priv->protocol->read(priv->protocol, priv->media_id,
+				block, len, buffer);
+		if (EFI_ERROR(efiret))
+			return -efi_errno(efiret);
 
-	if (EFI_ERROR(efiret))
-		return -efi_errno(efiret);
+		return 0;
+	}
+
+	while (len) {
+		size_t now = min_t(size_t, len, EFI_BIO_BOUNCE_SIZE);
+
+		efiret = priv->protocol->read(priv->protocol, priv->media_id,
+				block, now, efi_bio_bounce_buffer(priv));
+		if (EFI_ERROR(efiret))
+			return -efi_errno(efiret);
+
+		memcpy(buffer, priv->bounce, now);
+
+		buffer += now;
+		block += now >> blk->blockbits;
+		len -= now;
+	}
 
 	return 0;
 }
@@ -45,12 +92,32 @@ static int efi_bio_write(struct block_device *blk,
 		const void *buffer, sector_t block, blkcnt_t num_blocks)
 {
 	struct efi_bio_priv *priv = container_of(blk, struct efi_bio_priv, blk);
+	size_t len = (size_t)num_blocks << blk->blockbits;
 	efi_status_t efiret;
 
-	efiret = priv->protocol->write(priv->protocol, priv->media_id,
-			block, num_blocks * 512, (void *)buffer);
-	if (EFI_ERROR(efiret))
-		return -efi_errno(efiret);
+	if (efi_bio_aligned(priv, buffer)) {
+		efiret = priv->protocol->write(priv->protocol, priv->media_id,
+				block, len, (void *)buffer);
+		if (EFI_ERROR(efiret))
+			return -efi_errno(efiret);
+
+		return 0;
+	}
+
+	while (len) {
+		size_t now = min_t(size_t, len, EFI_BIO_BOUNCE_SIZE);
+
+		memcpy(efi_bio_bounce_buffer(priv), buffer, now);
+
+		efiret = priv->protocol->write(priv->protocol, priv->media_id,
+				block, now, priv->bounce);
+		if (EFI_ERROR(efiret))
+			return -efi_errno(efiret);
+
+		buffer += now;
+		block += now >> blk->blockbits;
+		len -= now;
+	}
 
 	return 0;
 }
@@ -153,6 +220,7 @@ static int efi_bio_probe(struct efi_device *efidev)
 	priv->blk.type = BLK_TYPE_VIRTUAL;
 
 	priv->media_id = media->media_id;
+	priv->io_align = media->io_align;
 
 	if (efi_get_bootsource() == efidev)
 		bootsource_set_raw_instance(instance);
@@ -18,6 +18,25 @@
 
 static LIST_HEAD(clks);
 
+/*
+ * Clocks hashed by name. Parent resolution and the duplicate check on
+ * registration work by name, which on SoCs with many hundred clocks
+ * makes list scans quadratic in the number of clocks.
+ */
+#define CLK_HASH_SIZE	128
+
+static struct hlist_head clk_hash[CLK_HASH_SIZE];
+
+static struct hlist_head *clk_hash_bucket(const char *name)
+{
+	unsigned int hash = 5381;
+
+	while (*name)
+		hash = hash * 33 + (unsigned char)*name++;
+
+	return &clk_hash[hash & (CLK_HASH_SIZE - 1)];
+}
+
 bool clk_have_nonfixed_providers(void)
 {
 	struct clk *c;
@@ -280,7 +299,7 @@ struct clk *clk_lookup(const char *name)
 	if (!name)
 		return ERR_PTR(-ENODEV);
 
-	list_for_each_entry(c, &clks, list) {
+	hlist_for_each_entry(c, clk_hash_bucket(name), name_hash) {
 		if (!strcmp(c->name, name))
 			return c;
 	}
@@ -461,15 +480,15 @@ static int __bclk_register(struct clk *clk)
 	struct clk *c;
 	int ret;
 
-	list_for_each_entry(c, &clks, list) {
-		if (!strcmp(c->name, clk->name)) {
-			pr_err("%s clk %pC is already registered, skipping!\n",
-				__func__, clk);
-			return -EBUSY;
-		}
+	c = clk_lookup(clk->name);
+	if (!IS_ERR(c)) {
+		pr_err("%s clk %pC is already registered, skipping!\n",
+			__func__, clk);
+		return -EBUSY;
 	}
 
 	list_add_tail(&clk->list, &clks);
+	hlist_add_head(&clk->name_hash, clk_hash_bucket(clk->name));
 
 	if (clk->ops->init) {
 		ret = clk->ops->init(hw);
@@ -483,6 +502,7 @@ static int __bclk_register(struct clk *clk)
 	return 0;
 out:
 	list_del(&clk->list);
+	hlist_del(&clk->name_hash);
 
 	return ret;
 }
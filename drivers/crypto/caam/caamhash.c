@@ -0,0 +1,271 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * caam - Freescale FSL CAAM support for SHA digests
+ *
+ * Registers the MDHA as a high priority backend behind crypto/digest.c,
+ * so bulk hashing (bootm/FIT verification, the hash commands) runs on
+ * the accelerator instead of the CPU.
+ *
+ * The job ring in this driver completes jobs synchronously, which keeps
+ * the model simple: every digest_update() chunk becomes one job that
+ * DMAs the data straight from the caller's buffer. The MDHA running
+ * context (internal state plus message length) is stored back into the
+ * per-digest state after each job and reloaded by the next one, and
+ * partial blocks are buffered in software since intermediate jobs must
+ * feed the MDHA whole blocks.
+ */
+#include <common.h>
+#include <digest.h>
+#include <dma.h>
+#include <init.h>
+#include <crypto/sha.h>
+#include <crypto/internal.h>
+
+#include "regs.h"
+#include "intern.h"
+#include "desc_constr.h"
+#include "jr.h"
+#include "error.h"
+
+/* Running context: internal digest state plus 8 bytes of message length */
+#define HASH_MSG_LEN		8
+#define CAAM_HASH_MAX_CTX_LEN	(HASH_MSG_LEN + SHA256_DIGEST_SIZE)
+
+#define CAAM_HASH_MAX_BLOCK_SIZE	SHA256_BLOCK_SIZE
+
+/* header + load ctx + operation + ext fifo load + store ctx */
+#define CAAM_HASH_DESC_LEN	(5 * CAAM_CMD_SZ + 3 * CAAM_PTR_SZ)
+
+struct caam_hash_state {
+	u32 desc[CAAM_HASH_DESC_LEN / CAAM_CMD_SZ];
+	u8 ctx[CAAM_HASH_MAX_CTX_LEN];
+	u8 buf[CAAM_HASH_MAX_BLOCK_SIZE];
+	unsigned int buflen;
+	bool initialized;
+	int err;
+};
+
+struct caam_hash_algo {
+	struct digest_algo algo;
+	u32 alg_type;
+	unsigned int ctx_len;
+	unsigned int block_size;
+};
+
+static struct device *caam_hash_jrdev;
+
+static inline struct caam_hash_algo *to_caam_hash(struct digest *d)
+{
+	return container_of(d->algo, struct caam_hash_algo, algo);
+}
+
+static void caam_hash_job_done(struct device *jrdev, u32 *desc, u32 err,
+			       void *context)
+{
+	struct caam_hash_state *state = context;
+
+	if (err) {
+		caam_jr_strstatus(jrdev, err);
+		state->err = -EIO;
+	}
+}
+
+/*
+ * Run one MDHA job over @len bytes at @data in algorithm state @as,
+ * storing @out_len result bytes (running context or final digest) into
+ * the state's context buffer.
+ */
+static int caam_hash_run_job(struct caam_hash_algo *calg,
+			     struct caam_hash_state *state,
+			     const void *data, unsigned int len,
+			     u32 as, unsigned int out_len)
+{
+	struct device *jrdev = caam_hash_jrdev;
+	u32 *desc = state->desc;
+	int ret;
+
+	init_job_desc(desc, 0);
+
+	if (state->initialized) {
+		dma_sync_single_for_device(jrdev, (unsigned long)state->ctx,
+					   calg->ctx_len, DMA_TO_DEVICE);
+		append_load(desc, (dma_addr_t)(unsigned long)state->ctx,
+			    calg->ctx_len,
+			    LDST_CLASS_2_CCB | LDST_SRCDST_BYTE_CONTEXT);
+	}
+
+	append_operation(desc, calg->alg_type | OP_TYPE_CLASS2_ALG | as);
+
+	/*
+	 * Always use the extended length form so a single job covers
+	 * arbitrarily large updates, not just the 16 bit inline length.
+	 * A zero length load is valid and needed for empty messages.
+	 */
+	append_cmd(desc, CMD_FIFO_LOAD | FIFOLD_CLASS_CLASS2 |
+		   FIFOLD_TYPE_MSG | FIFOLD_TYPE_LAST2 | FIFOLDST_EXT);
+	append_ptr(desc, (dma_addr_t)(unsigned long)data);
+	append_cmd(desc, len);
+
+	append_store(desc, (dma_addr_t)(unsigned long)state->ctx, out_len,
+		     LDST_CLASS_2_CCB | LDST_SRCDST_BYTE_CONTEXT);
+
+	if (len)
+		dma_sync_single_for_device(jrdev, (unsigned long)data, len,
+					   DMA_TO_DEVICE);
+	dma_sync_single_for_device(jrdev, (unsigned long)desc,
+				   desc_bytes(desc), DMA_TO_DEVICE);
+
+	state->err = 0;
+
+	ret = caam_jr_enqueue(jrdev, desc, caam_hash_job_done, state);
+	if (ret)
+		return ret;
+
+	if (state->err)
+		return state->err;
+
+	dma_sync_single_for_cpu(jrdev, (unsigned long)state->ctx, out_len,
+				DMA_FROM_DEVICE);
+
+	state->initialized = true;
+
+	return 0;
+}
+
+static int caam_hash_init(struct digest *d)
+{
+	struct caam_hash_state *state = digest_ctx(d);
+
+	state->buflen = 0;
+	state->initialized = false;
+	state->err = 0;
+
+	return 0;
+}
+
+static int caam_hash_update(struct digest *d, const void *data,
+			    unsigned long len)
+{
+	struct caam_hash_algo *calg = to_caam_hash(d);
+	struct caam_hash_state *state = digest_ctx(d);
+	const unsigned int bs = calg->block_size;
+	unsigned int to_hash;
+	int ret;
+
+	/* Top up and flush a buffered partial block first */
+	if (state->buflen) {
+		unsigned int fill = min_t(unsigned long, bs - state->buflen,
+					  len);
+
+		memcpy(state->buf + state->buflen, data, fill);
+		state->buflen += fill;
+		data += fill;
+		len -= fill;
+
+		if (state->buflen < bs)
+			return 0;
+
+		ret = caam_hash_run_job(calg, state, state->buf, bs,
+					state->initialized ? OP_ALG_AS_UPDATE :
+							     OP_ALG_AS_INIT,
+					calg->ctx_len);
+		if (ret)
+			return ret;
+
+		state->buflen = 0;
+	}
+
+	/* Hash all whole blocks directly out of the caller's buffer */
+	to_hash = len - (len % bs);
+	if (to_hash) {
+		ret = caam_hash_run_job(calg, state, data, to_hash,
+					state->initialized ? OP_ALG_AS_UPDATE :
+							     OP_ALG_AS_INIT,
+					calg->ctx_len);
+		if (ret)
+			return ret;
+
+		data += to_hash;
+		len -= to_hash;
+	}
+
+	if (len) {
+		memcpy(state->buf, data, len);
+		state->buflen = len;
+	}
+
+	return 0;
+}
+
+static int caam_hash_final(struct digest *d, unsigned char *md)
+{
+	struct caam_hash_algo *calg = to_caam_hash(d);
+	struct caam_hash_state *state = digest_ctx(d);
+	int ret;
+
+	ret = caam_hash_run_job(calg, state, state->buf, state->buflen,
+				state->initialized ? OP_ALG_AS_FINALIZE :
+						     OP_ALG_AS_INITFINAL,
+				d->algo->length);
+	if (ret)
+		return ret;
+
+	memcpy(md, state->ctx, d->algo->length);
+
+	return 0;
+}
+
+/*
+ * @state_size is the MDHA internal digest state the running context
+ * carries between jobs. SHA-224 keeps the full SHA-256 sized state,
+ * only the final digest is truncated.
+ */
+#define CAAM_HASH_ALGO(sha, SHA, state_size)				\
+	{								\
+		.algo = {						\
+			.base = {					\
+				.name		= #sha,			\
+				.driver_name	= #sha "-caam",		\
+				.priority	= 150,			\
+				.algo		= HASH_ALGO_##SHA,	\
+			},						\
+			.init	= caam_hash_init,			\
+			.update	= caam_hash_update,			\
+			.final	= caam_hash_final,			\
+			.digest	= digest_generic_digest,		\
+			.verify	= digest_generic_verify,		\
+			.length	= SHA##_DIGEST_SIZE,			\
+			.ctx_length = sizeof(struct caam_hash_state),	\
+		},							\
+		.alg_type	= OP_ALG_ALGSEL_##SHA,			\
+		.ctx_len	= HASH_MSG_LEN + state_size,		\
+		.block_size	= SHA##_BLOCK_SIZE,			\
+	}
+
+static struct caam_hash_algo caam_hash_algos[] = {
+	CAAM_HASH_ALGO(sha1, SHA1, SHA1_DIGEST_SIZE),
+	CAAM_HASH_ALGO(sha224, SHA224, SHA256_DIGEST_SIZE),
+	CAAM_HASH_ALGO(sha256, SHA256, SHA256_DIGEST_SIZE),
+};
+
+int caam_hash_probe(struct device *dev, struct device *jrdev)
+{
+	int i, ret;
+
+	caam_hash_jrdev = jrdev;
+
+	for (i = 0; i < ARRAY_SIZE(caam_hash_algos); i++) {
+		struct caam_hash_algo *calg = &caam_hash_algos[i];
+
+		ret = digest_algo_register(&calg->algo);
+		if (ret) {
+			dev_err(dev, "failed to register %s: %pe\n",
+				calg->algo.base.driver_name, ERR_PTR(ret));
+			return ret;
+		}
+	}
+
+	dev_info(dev, "registered sha1/sha224/sha256 digests\n");
+
+	return 0;
+}
@@ -665,6 +665,15 @@ static int caam_probe(struct device *dev)
 		}
 	}
 
+	if (IS_ENABLED(CONFIG_CRYPTO_DEV_FSL_CAAM_HASH)) {
+		ret = caam_hash_probe(dev, ctrlpriv->jrpdev[0]);
+		if (ret) {
+			dev_err(dev, "failed to instantiate hash device");
+			caam_remove(dev);
+			return ret;
+		}
+	}
+
 	if (IS_ENABLED(CONFIG_BLOBGEN)) {
 		ret = caam_blob_gen_probe(dev, ctrlpriv->jrpdev[0]);
 		if (ret) {
@@ -89,6 +89,7 @@ struct caam_drv_private {
 };
 
 int caam_rng_probe(struct device *dev, struct device *jrdev);
+int caam_hash_probe(struct device *dev, struct device *jrdev);
 int caam_blob_gen_probe(struct device *dev, struct device *jrdev);
 int caam_jr_probe(struct device *dev);
 #endif /* INTERN_H */
@@ -258,6 +258,41 @@ static int compute_dimm_parameters(struct fsl_ddr_controller *c,
 	return ret;
 }
 
+/*
+ * DIMMs with identical SPD content behind controllers running at the
+ * same clock derive identical parameters, so they only need to be
+ * computed once. Returns the parameters of an already computed
+ * identical DIMM, or NULL if this is the first of its kind.
+ */
+static const struct dimm_params *
+fsl_ddr_find_computed_params(struct fsl_ddr_info *pinfo,
+			     unsigned int ctrl, unsigned int slot)
+{
+	struct fsl_ddr_controller *c = &pinfo->c[ctrl];
+	const struct spd_eeprom *spd = &c->spd_installed_dimms[slot];
+	unsigned int mclk_ps = get_memory_clk_period_ps(c);
+	unsigned int i, j;
+
+	for (i = 0; i <= ctrl; i++) {
+		struct fsl_ddr_controller *o = &pinfo->c[i];
+		unsigned int nslots = i == ctrl ? slot : o->dimm_slots_per_ctrl;
+
+		if (!o->spd_installed_dimms)
+			continue;
+
+		if (get_memory_clk_period_ps(o) != mclk_ps)
+			continue;
+
+		for (j = 0; j < nslots; j++) {
+			if (!memcmp(spd, &o->spd_installed_dimms[j],
+				    sizeof(*spd)))
+				return &o->dimm_params[j];
+		}
+	}
+
+	return NULL;
+}
+
 static unsigned long long fsl_ddr_compute(struct fsl_ddr_info *pinfo)
 {
 	unsigned int i, j;
@@ -276,6 +311,13 @@ static unsigned long long fsl_ddr_compute(struct fsl_ddr_info *pinfo)
 		for (j = 0; j < c->dimm_slots_per_ctrl; j++) {
 			struct spd_eeprom *spd = &c->spd_installed_dimms[j];
 			struct dimm_params *pdimm = &c->dimm_params[j];
+			const struct dimm_params *computed;
+
+			computed = fsl_ddr_find_computed_params(pinfo, i, j);
+			if (computed) {
+				*pdimm = *computed;
+				continue;
+			}
 
 			retval = compute_dimm_parameters(c, spd, pdimm);
 			if (retval == 2) {
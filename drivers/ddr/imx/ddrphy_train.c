@@ -10,6 +10,13 @@
 #include <soc/imx8m/ddr.h>
 #include <firmware.h>
 
+/*
+ * ddrphy_trained_csr(_num) is only deprecated for board code; the restore
+ * path below consumes timings produced by dram_config_save()
+ */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+
 static const u16 *lpddr4_imem_1d;
 static size_t lpddr4_imem_1d_size;
 static const u16 *lpddr4_dmem_1d;
@@ -127,6 +134,21 @@ int ddr_cfg_phy(struct dram_controller *dram, struct dram_timing_info *dram_timi
 		dram_cfg++;
 	}
 
+	/*
+	 * A timing without frequency setpoint messages carries the results
+	 * of an earlier training run in ddrphy_trained_csr, e.g. a blob
+	 * produced by dram_config_save() and kept across a warm reset.
+	 * Restore those instead of running the training firmware, which
+	 * saves the 60-100ms the firmware takes per boot. When the
+	 * restored state turns out to be stale, callers have to fall back
+	 * to a full timing including training setpoints.
+	 */
+	if (!dram_timing->fsp_msg_num) {
+		ddrphy_trained_csr_restore(dram, dram_timing->ddrphy_trained_csr,
+					   dram_timing->ddrphy_trained_csr_num);
+		goto pie;
+	}
+
 	/* load the frequency setpoint message block config */
 	fsp_msg = dram_timing->fsp_msg;
 	for (i = 0; i < dram_timing->fsp_msg_num; i++) {
@@ -180,6 +202,7 @@ int ddr_cfg_phy(struct dram_controller *dram, struct dram_timing_info *dram_timi
 		fsp_msg++;
 	}
 
+pie:
 	/* Load PHY Init Engine Image */
 	dram_cfg = dram_timing->ddrphy_pie;
 	num = dram_timing->ddrphy_pie_num;
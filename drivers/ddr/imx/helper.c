@@ -34,6 +34,23 @@ void ddrphy_trained_csr_save(struct dram_controller *dram, struct dram_cfg_param
 	dwc_ddrphy_apb_wr(dram, 0xd0000, 0x1);
 }
 
+void ddrphy_trained_csr_restore(struct dram_controller *dram, struct dram_cfg_param *ddrphy_csr,
+				unsigned int num)
+{
+	int i = 0;
+
+	/* enable the ddrphy apb */
+	dwc_ddrphy_apb_wr(dram, 0xd0000, 0x0);
+	dwc_ddrphy_apb_wr(dram, 0xc0080, 0x3);
+	for (i = 0; i < num; i++) {
+		dwc_ddrphy_apb_wr(dram, ddrphy_csr->reg, ddrphy_csr->val);
+		ddrphy_csr++;
+	}
+	/* disable the ddrphy apb */
+	dwc_ddrphy_apb_wr(dram, 0xc0080, 0x2);
+	dwc_ddrphy_apb_wr(dram, 0xd0000, 0x1);
+}
+
 void *dram_config_save(struct dram_controller *dram, struct dram_timing_info *timing_info,
 		      unsigned long saved_timing_base)
 {
@@ -46,6 +63,13 @@ void *dram_config_save(struct dram_controller *dram, struct dram_timing_info *ti
 	saved_timing->ddrphy_trained_csr_num = ddrphy_trained_csr_num;
 	saved_timing->ddrphy_pie_num = timing_info->ddrphy_pie_num;
 
+	/*
+	 * The training messages are not saved: ddr_cfg_phy() consumers of
+	 * this blob restore the trained CSRs instead of training again
+	 */
+	saved_timing->fsp_msg = NULL;
+	saved_timing->fsp_msg_num = 0;
+
 	/* save the fsp table */
 	for (i = 0; i < 4; i++)
 		saved_timing->fsp_table[i] = timing_info->fsp_table[i];
@@ -512,7 +512,9 @@ int imx8m_ddr_init(struct dram_controller *dram, struct dram_timing_info *dram_t
 	reg32_write(0x303A00EC, 0x0000ffff); /* PGC_CPU_MAPPING */
 	reg32setbit(0x303A00F8, 5); /* PU_PGC_SW_PUP_REQ */
 
-	initial_drate = dram_timing->fsp_msg[0].drate;
+	/* without training setpoints (trained CSR restore), boot at setpoint 0 */
+	initial_drate = dram_timing->fsp_msg_num ?
+		dram_timing->fsp_msg[0].drate : dram_timing->fsp_table[0];
 	/* default to the frequency point 0 clock */
 	dram->set_dfi_clk(dram, initial_drate);
 
@@ -590,8 +592,14 @@ int imx8m_ddr_init(struct dram_controller *dram, struct dram_timing_info *dram_t
 	/* Step15: Set SWCTL.sw_done to 0 */
 	reg32_write(DDRC_SWCTL(0), 0x00000000);
 
-	/* Apply rank-to-rank workaround */
-	update_umctl2_rank_space_setting(dram_timing->fsp_msg_num - 1, dram->ddrc_type);
+	/*
+	 * Apply rank-to-rank workaround. The CDD values it needs are read
+	 * back from the message block during training, so there is nothing
+	 * to apply when a trained CSR restore skipped the training run.
+	 */
+	if (dram_timing->fsp_msg_num)
+		update_umctl2_rank_space_setting(dram_timing->fsp_msg_num - 1,
+						 dram->ddrc_type);
 
 	/* Step16: Set DFIMISC.dfi_init_start to 1 */
 	setbits_le32(DDRC_DFIMISC(0), (0x1 << 5));
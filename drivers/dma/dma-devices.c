@@ -202,6 +202,43 @@ int dma_get_cfg(struct dma *dma, u32 cfg_id, void **cfg_data)
 	return ops->get_cfg(dma, cfg_id, cfg_data);
 }
 
+int dma_memcpy(void *dst, const void *src, size_t len)
+{
+	const struct dma_device_ops *ops = NULL;
+	struct dma_device *dmad;
+	dma_addr_t dma_dst, dma_src;
+	struct device *dev;
+	int ret;
+
+	list_for_each_entry(dmad, &dma_devices, list) {
+		if (dmad->ops->transfer) {
+			ops = dmad->ops;
+			dev = dmad->dev;
+			break;
+		}
+	}
+
+	if (!ops)
+		return -ENODEV;
+
+	dma_src = dma_map_single(dev, (void *)src, len, DMA_TO_DEVICE);
+	if (dma_mapping_error(dev, dma_src))
+		return -EFAULT;
+
+	dma_dst = dma_map_single(dev, dst, len, DMA_FROM_DEVICE);
+	if (dma_mapping_error(dev, dma_dst)) {
+		dma_unmap_single(dev, dma_src, len, DMA_TO_DEVICE);
+		return -EFAULT;
+	}
+
+	ret = ops->transfer(dev, DMA_MEM_TO_MEM, dma_dst, dma_src, len);
+
+	dma_unmap_single(dev, dma_dst, len, DMA_FROM_DEVICE);
+	dma_unmap_single(dev, dma_src, len, DMA_TO_DEVICE);
+
+	return ret;
+}
+
 int dma_device_register(struct dma_device *dmad)
 {
 	list_add_tail(&dmad->list, &dma_devices);
@@ -1,8 +1,18 @@
 /* SPDX-License-Identifier: GPL-2.0-only */
 #include <dma.h>
 #include <driver.h>
+#include <linux/scatterlist.h>
 #include "debug.h"
 
+/*
+ * Buffers served from the uncached coherent pool need no cache
+ * maintenance, no matter what the mapping direction is.
+ */
+static bool dma_needs_sync(struct device *dev, void *ptr)
+{
+	return !dev_is_dma_coherent(dev) && !dma_pool_contains(ptr);
+}
+
 void *dma_alloc(size_t size)
 {
 	return xmemalign(DMA_ALIGNMENT, ALIGN(size, DMA_ALIGNMENT));
@@ -28,7 +38,7 @@ void dma_sync_single_for_cpu(struct device *dev, dma_addr_t address,
 
 	debug_dma_sync_single_for_cpu(dev, address, size, dir);
 
-	if (!dev_is_dma_coherent(dev))
+	if (dma_needs_sync(dev, ptr))
 		arch_sync_dma_for_cpu(ptr, size, dir);
 }
 EXPORT_SYMBOL(dma_sync_single_for_cpu);
@@ -40,7 +50,7 @@ void dma_sync_single_for_device(struct device *dev, dma_addr_t address,
 
 	debug_dma_sync_single_for_device(dev, address, size, dir);
 
-	if (!dev_is_dma_coherent(dev))
+	if (dma_needs_sync(dev, ptr))
 		arch_sync_dma_for_device(ptr, size, dir);
 }
 EXPORT_SYMBOL(dma_sync_single_for_device);
@@ -52,7 +62,7 @@ dma_addr_t dma_map_single(struct device *dev, void *ptr,
 
 	debug_dma_map(dev, ptr, size, dir, dma_addr);
 
-	if (!dev_is_dma_coherent(dev))
+	if (dma_needs_sync(dev, ptr))
 		arch_sync_dma_for_device(ptr, size, dir);
 
 	return dma_addr;
@@ -68,3 +78,77 @@ void dma_unmap_single(struct device *dev, dma_addr_t dma_addr,
 	debug_dma_unmap(dev, dma_addr, size, dir);
 }
 EXPORT_SYMBOL(dma_unmap_single);
+
+/*
+ * Batched variants for drivers that hand multiple ranges to the device
+ * in one request, e.g. a descriptor ring plus its data buffers. The
+ * coherence check is done once per call and ranges served from the
+ * uncached pool are skipped without further per-range overhead.
+ */
+int dma_map_sg(struct device *dev, struct scatterlist *sgl, int nents,
+	       enum dma_data_direction dir)
+{
+	bool sync = !dev_is_dma_coherent(dev);
+	struct scatterlist *sg;
+	int i;
+
+	for_each_sg(sgl, sg, nents, i) {
+		debug_dma_map(dev, sg->address, sg->length, dir,
+			      cpu_to_dma(dev, sg->address));
+
+		if (sync && !dma_pool_contains(sg->address))
+			arch_sync_dma_for_device(sg->address, sg->length, dir);
+	}
+
+	return nents;
+}
+EXPORT_SYMBOL(dma_map_sg);
+
+void dma_unmap_sg(struct device *dev, struct scatterlist *sgl, int nents,
+		  enum dma_data_direction dir)
+{
+	bool sync = !dev_is_dma_coherent(dev);
+	struct scatterlist *sg;
+	int i;
+
+	for_each_sg(sgl, sg, nents, i) {
+		if (sync && !dma_pool_contains(sg->address))
+			arch_sync_dma_for_cpu(sg->address, sg->length, dir);
+
+		debug_dma_unmap(dev, cpu_to_dma(dev, sg->address),
+				sg->length, dir);
+	}
+}
+EXPORT_SYMBOL(dma_unmap_sg);
+
+void dma_sync_sg_for_cpu(struct device *dev, struct scatterlist *sgl,
+			 int nents, enum dma_data_direction dir)
+{
+	struct scatterlist *sg;
+	int i;
+
+	if (dev_is_dma_coherent(dev))
+		return;
+
+	for_each_sg(sgl, sg, nents, i) {
+		if (!dma_pool_contains(sg->address))
+			arch_sync_dma_for_cpu(sg->address, sg->length, dir);
+	}
+}
+EXPORT_SYMBOL(dma_sync_sg_for_cpu);
+
+void dma_sync_sg_for_device(struct device *dev, struct scatterlist *sgl,
+			    int nents, enum dma_data_direction dir)
+{
+	struct scatterlist *sg;
+	int i;
+
+	if (dev_is_dma_coherent(dev))
+		return;
+
+	for_each_sg(sgl, sg, nents, i) {
+		if (!dma_pool_contains(sg->address))
+			arch_sync_dma_for_device(sg->address, sg->length, dir);
+	}
+}
+EXPORT_SYMBOL(dma_sync_sg_for_device);
@@ -0,0 +1,89 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+/*
+ * pool.c - dedicated pool for DMA-coherent allocations
+ *
+ * Coherent buffers are usually small and frequent: descriptor rings and
+ * bounce buffers for MCI, NVMe and ethernet controllers. Serving them
+ * from the main heap fragments it with page-aligned holes and costs a
+ * cache flush plus page table walk per allocation. Instead, a region is
+ * remapped uncached once at init and managed by a separate TLSF
+ * instance, so allocations are O(1) and need no per-buffer attribute
+ * setup.
+ */
+
+#define pr_fmt(fmt) "dma-pool: " fmt
+
+#include <common.h>
+#include <dma.h>
+#include <init.h>
+#include <tlsf.h>
+
+static tlsf_t dma_pool;
+static void *dma_pool_base;
+static dma_addr_t dma_pool_dma_base;
+static size_t dma_pool_size;
+
+void *dma_pool_alloc_coherent(size_t size, dma_addr_t *dma_handle)
+{
+	size_t align = size >= PAGE_SIZE ? PAGE_SIZE : DMA_ALIGNMENT;
+	void *mem;
+
+	if (!dma_pool)
+		return NULL;
+
+	mem = tlsf_memalign(dma_pool, align, size);
+	if (!mem) {
+		pr_debug("pool exhausted for %zu byte allocation\n", size);
+		return NULL;
+	}
+
+	if (dma_handle)
+		*dma_handle = dma_pool_dma_base + (mem - dma_pool_base);
+
+	memset(mem, 0, size);
+
+	return mem;
+}
+
+bool dma_pool_contains(const void *mem)
+{
+	return dma_pool && mem >= dma_pool_base &&
+	       mem < dma_pool_base + dma_pool_size;
+}
+
+bool dma_pool_free_coherent(void *mem)
+{
+	if (!dma_pool_contains(mem))
+		return false;
+
+	tlsf_free(dma_pool, mem);
+
+	return true;
+}
+
+static int dma_pool_init(void)
+{
+	size_t size = CONFIG_DMA_COHERENT_POOL_SIZE;
+	void *mem;
+
+	/*
+	 * The pool is not set up yet at this point, so the backing region
+	 * is served by the regular uncached-remap allocation path.
+	 */
+	mem = dma_alloc_coherent(DMA_DEVICE_BROKEN, size, &dma_pool_dma_base);
+	if (!mem)
+		return -ENOMEM;
+
+	dma_pool = tlsf_create_with_pool(mem, size);
+	if (!dma_pool)
+		return -EINVAL;
+
+	dma_pool_base = mem;
+	dma_pool_size = size;
+
+	pr_debug("%zu byte uncached pool at 0x%p\n", size, mem);
+
+	return 0;
+}
+postmmu_initcall(dma_pool_init);
@@ -38,6 +38,7 @@ struct fw_cfg {
 	loff_t next_read_offset;
 	u32 sel;
 	bool is_mmio;
+	bool has_dma;
 	struct fw_cfg_dma_access __iomem *acc_virt;
 	dma_addr_t acc_dma;
 };
@@ -122,10 +123,11 @@ static void fw_cfg_data_read(struct fw_cfg *fw_cfg, void *address, size_t remain
 	fw_cfg_data_read_sized(fw_cfg, &remaining, &address, u8);
 }
 
-static void fw_cfg_do_dma(struct fw_cfg *fw_cfg, dma_addr_t address,
-			  u32 count, u32 control)
+static int fw_cfg_do_dma(struct fw_cfg *fw_cfg, dma_addr_t address,
+			 u32 count, u32 control)
 {
 	struct fw_cfg_dma_access __iomem *acc = fw_cfg->acc_virt;
+	u32 status;
 
 	acc->address = cpu_to_be64(address);
 	acc->length = cpu_to_be32(count);
@@ -133,8 +135,40 @@ static void fw_cfg_do_dma(struct fw_cfg *fw_cfg, dma_addr_t address,
 
 	iowrite64be(fw_cfg->acc_dma, fw_cfg->reg_dma);
 
-	while (ioread32be(&acc->control) & ~FW_CFG_DMA_CTL_ERROR)
+	while ((status = ioread32be(&acc->control)) & ~FW_CFG_DMA_CTL_ERROR)
 		;
+
+	return status & FW_CFG_DMA_CTL_ERROR ? -EIO : 0;
+}
+
+/* read the current item at the current offset in one bulk DMA transfer */
+static int fw_cfg_read_dma(struct fw_cfg *fw_cfg, void *buf, size_t count)
+{
+	struct device *dev = fw_cfg->cdev.dev;
+	void *dma_buf;
+	dma_addr_t mapping;
+	int ret;
+
+	dma_buf = dma_alloc(count);
+	if (!dma_buf)
+		return -ENOMEM;
+
+	mapping = dma_map_single(dev, dma_buf, count, DMA_FROM_DEVICE);
+	if (dma_mapping_error(dev, mapping)) {
+		ret = -EFAULT;
+		goto free_buf;
+	}
+
+	ret = fw_cfg_do_dma(fw_cfg, mapping, count, FW_CFG_DMA_CTL_READ);
+
+	dma_unmap_single(dev, mapping, count, DMA_FROM_DEVICE);
+
+	if (!ret)
+		memcpy(buf, dma_buf, count);
+free_buf:
+	dma_free(dma_buf);
+
+	return ret;
 }
 
 static ssize_t fw_cfg_read(struct cdev *cdev, void *buf, size_t count,
@@ -164,9 +198,18 @@ static ssize_t fw_cfg_read(struct cdev *cdev, void *buf, size_t count,
 		fw_cfg_do_dma(fw_cfg, DMA_ERROR_CODE, pos,
 			      FW_CFG_DMA_CTL_SKIP | selector);
 
-	fw_cfg_data_read(fw_cfg, buf, count, rdsize);
+	if (fw_cfg->has_dma) {
+		if (!fw_cfg_read_dma(fw_cfg, buf, count))
+			goto out;
+
+		/* stream position is unknown after a failed transfer */
+		fw_cfg_do_dma(fw_cfg, DMA_ERROR_CODE, pos,
+			      FW_CFG_DMA_CTL_SKIP | selector);
+	}
 
-	fw_cfg->next_read_offset += count;
+	fw_cfg_data_read(fw_cfg, buf, count, rdsize);
+out:
+	fw_cfg->next_read_offset = pos + count;
 	return count;
 }
 
@@ -193,11 +236,10 @@ static ssize_t fw_cfg_write(struct cdev *cdev, const void *buf, size_t count,
 
 	fw_cfg->next_read_offset = 0;
 
-	fw_cfg_do_dma(fw_cfg, DMA_ERROR_CODE, pos, FW_CFG_DMA_CTL_SKIP |
-		      FW_CFG_DMA_CTL_SELECT | fw_cfg->sel << 16);
-
-	fw_cfg_do_dma(fw_cfg, mapping, count, FW_CFG_DMA_CTL_WRITE |
-		      FW_CFG_DMA_CTL_SELECT | fw_cfg->sel << 16);
+	ret = fw_cfg_do_dma(fw_cfg, DMA_ERROR_CODE, pos, FW_CFG_DMA_CTL_SKIP |
+			    FW_CFG_DMA_CTL_SELECT | fw_cfg->sel << 16);
+	if (!ret)
+		ret = fw_cfg_do_dma(fw_cfg, mapping, count, FW_CFG_DMA_CTL_WRITE);
 
 	dma_unmap_single(dev, mapping, count, DMA_FROM_DEVICE);
 free_buf:
@@ -225,6 +267,7 @@ static int fw_cfg_probe(struct device *dev)
 	struct resource *parent_res, *iores;
 	char sig[FW_CFG_SIG_SIZE];
 	struct fw_cfg *fw_cfg;
+	__le32 id;
 	int ret;
 
 	fw_cfg = xzalloc(sizeof(*fw_cfg));
@@ -263,6 +306,11 @@ static int fw_cfg_probe(struct device *dev)
 	fw_cfg->acc_virt = dma_alloc_coherent(DMA_DEVICE_BROKEN,
 					      sizeof(*fw_cfg->acc_virt), &fw_cfg->acc_dma);
 
+	/* the revision item advertises whether the DMA interface exists */
+	fw_cfg->sel = FW_CFG_ID;
+	fw_cfg_read(&fw_cfg->cdev, &id, sizeof(id), 0, 0);
+	fw_cfg->has_dma = le32_to_cpu(id) & FW_CFG_VERSION_DMA;
+
 	fw_cfg->cdev.name = "fw_cfg";
 	fw_cfg->cdev.flags = DEVFS_IS_CHARACTER_DEV;
 	fw_cfg->cdev.size = 0;
@@ -16,6 +16,7 @@
 #include <common.h>
 #include <init.h>
 #include <dma.h>
+#include <linux/sizes.h>
 #include <mach/zynqmp/zynqmp-pcap.h>
 #include <mach/zynq/zynq-pcap.h>
 
@@ -249,9 +250,24 @@ static int fpgamgr_program_write_buf(struct firmware_handler *fh,
 	 * Buffer the chunks here and handle it in close()
 	 */
 
-	mgr->buf = realloc(mgr->buf, mgr->size + size);
-	if (!mgr->buf)
-		return -ENOBUFS;
+	if (mgr->size + size > mgr->capacity) {
+		/*
+		 * Grow the staging buffer geometrically. Resizing it to fit
+		 * every single chunk moved the already collected part of a
+		 * multi-megabyte bitstream around once per 4K of input.
+		 */
+		size_t capacity = max_t(size_t, mgr->capacity * 2, SZ_1M);
+		char *tmp;
+
+		capacity = max_t(size_t, capacity, mgr->size + size);
+
+		tmp = realloc(mgr->buf, capacity);
+		if (!tmp)
+			return -ENOBUFS;
+
+		mgr->buf = tmp;
+		mgr->capacity = capacity;
+	}
 
 	memcpy(&(mgr->buf[mgr->size]), buf, size);
 	mgr->size += size;
@@ -264,6 +280,7 @@ static int fpgamgr_program_start(struct firmware_handler *fh)
 	struct fpgamgr *mgr = container_of(fh, struct fpgamgr, fh);
 
 	mgr->size = 0;
+	mgr->capacity = 0;
 	mgr->buf = NULL;
 
 	return 0;
@@ -110,6 +110,68 @@ static int bgpio_get(struct gpio_chip *gc, unsigned int gpio)
 	return !!(bgc->read_reg(bgc->reg_dat) & bgpio_line2mask(bgc, gpio));
 }
 
+/*
+ * This assumes that the bits in the GPIO register are in native endianness.
+ */
+static int bgpio_get_multiple(struct gpio_chip *gc, unsigned long *mask,
+			      unsigned long *bits)
+{
+	struct bgpio_chip *bgc = to_bgpio_chip(gc);
+
+	*bits &= ~*mask;
+	*bits |= bgc->read_reg(bgc->reg_dat) & *mask;
+
+	return 0;
+}
+
+/*
+ * With big endian mirrored bit order it becomes more tedious.
+ */
+static int bgpio_get_multiple_be(struct gpio_chip *gc, unsigned long *mask,
+				 unsigned long *bits)
+{
+	struct bgpio_chip *bgc = to_bgpio_chip(gc);
+	unsigned long readmask = 0;
+	unsigned long val;
+	int bit;
+
+	*bits &= ~*mask;
+
+	/* Create a mirrored mask */
+	for_each_set_bit(bit, mask, bgc->bits)
+		readmask |= bgpio_line2mask(bgc, bit);
+
+	/* Read the register */
+	val = bgc->read_reg(bgc->reg_dat) & readmask;
+
+	/* Mirror the result into the "bits" result */
+	for_each_set_bit(bit, &val, bgc->bits)
+		*bits |= bgpio_line2mask(bgc, bit);
+
+	return 0;
+}
+
+static int bgpio_get_set_multiple(struct gpio_chip *gc, unsigned long *mask,
+				  unsigned long *bits)
+{
+	struct bgpio_chip *bgc = to_bgpio_chip(gc);
+	unsigned long get_mask = 0;
+	unsigned long set_mask = 0;
+
+	/* Make sure we first clear any bits that are zero when we read the register */
+	*bits &= ~*mask;
+
+	set_mask = *mask & bgc->dir;
+	get_mask = *mask & ~bgc->dir;
+
+	if (set_mask)
+		*bits |= bgc->read_reg(bgc->reg_set) & set_mask;
+	if (get_mask)
+		*bits |= bgc->read_reg(bgc->reg_dat) & get_mask;
+
+	return 0;
+}
+
 static void bgpio_set_none(struct gpio_chip *gc, unsigned int gpio, int val)
 {
 }
@@ -152,6 +214,70 @@ static void bgpio_set_set(struct gpio_chip *gc, unsigned int gpio, int val)
 	bgc->write_reg(bgc->reg_set, bgc->data);
 }
 
+static void bgpio_multiple_get_masks(struct bgpio_chip *bgc,
+				     unsigned long *mask, unsigned long *bits,
+				     unsigned long *set_mask,
+				     unsigned long *clear_mask)
+{
+	int i;
+
+	*set_mask = 0;
+	*clear_mask = 0;
+
+	for_each_set_bit(i, mask, bgc->bits) {
+		if (test_bit(i, bits))
+			*set_mask |= bgpio_line2mask(bgc, i);
+		else
+			*clear_mask |= bgpio_line2mask(bgc, i);
+	}
+}
+
+static void bgpio_set_multiple_single_reg(struct bgpio_chip *bgc,
+					  unsigned long *mask,
+					  unsigned long *bits,
+					  void __iomem *reg)
+{
+	unsigned long set_mask, clear_mask;
+
+	bgpio_multiple_get_masks(bgc, mask, bits, &set_mask, &clear_mask);
+
+	bgc->data |= set_mask;
+	bgc->data &= ~clear_mask;
+
+	bgc->write_reg(reg, bgc->data);
+}
+
+static void bgpio_set_multiple(struct gpio_chip *gc, unsigned long *mask,
+			       unsigned long *bits)
+{
+	struct bgpio_chip *bgc = to_bgpio_chip(gc);
+
+	bgpio_set_multiple_single_reg(bgc, mask, bits, bgc->reg_dat);
+}
+
+static void bgpio_set_multiple_set(struct gpio_chip *gc, unsigned long *mask,
+				   unsigned long *bits)
+{
+	struct bgpio_chip *bgc = to_bgpio_chip(gc);
+
+	bgpio_set_multiple_single_reg(bgc, mask, bits, bgc->reg_set);
+}
+
+static void bgpio_set_multiple_with_clear(struct gpio_chip *gc,
+					  unsigned long *mask,
+					  unsigned long *bits)
+{
+	struct bgpio_chip *bgc = to_bgpio_chip(gc);
+	unsigned long set_mask, clear_mask;
+
+	bgpio_multiple_get_masks(bgc, mask, bits, &set_mask, &clear_mask);
+
+	if (set_mask)
+		bgc->write_reg(bgc->reg_set, set_mask);
+	if (clear_mask)
+		bgc->write_reg(bgc->reg_clr, clear_mask);
+}
+
 static int bgpio_simple_dir_in(struct gpio_chip *gc, unsigned int gpio)
 {
 	return 0;
@@ -325,19 +451,37 @@ static int bgpio_setup_io(struct bgpio_chip *bgc,
 		bgc->reg_set = set;
 		bgc->reg_clr = clr;
 		ops->set = bgpio_set_with_clear;
+		ops->set_multiple = bgpio_set_multiple_with_clear;
 	} else if (set && !clr) {
 		bgc->reg_set = set;
 		ops->set = bgpio_set_set;
+		ops->set_multiple = bgpio_set_multiple_set;
 	} else if (flags & BGPIOF_NO_OUTPUT) {
 		ops->set = bgpio_set_none;
 	} else {
 		ops->set = bgpio_set;
+		ops->set_multiple = bgpio_set_multiple;
 	}
 
-	if (!(flags & BGPIOF_UNREADABLE_REG_SET) && (flags & BGPIOF_READ_OUTPUT_REG_SET))
+	if (!(flags & BGPIOF_UNREADABLE_REG_SET) &&
+	    (flags & BGPIOF_READ_OUTPUT_REG_SET)) {
 		ops->get = bgpio_get_set;
-	else
+		if (!bgc->be_bits)
+			ops->get_multiple = bgpio_get_set_multiple;
+		/*
+		 * We deliberately avoid assigning the ->get_multiple() call
+		 * for big endian mirrored registers which are ALSO reflecting
+		 * their value in the set register when used as output. It is
+		 * simply too much complexity, let the GPIO core fall back to
+		 * reading each line individually in that fringe case.
+		 */
+	} else {
 		ops->get = bgpio_get;
+		if (bgc->be_bits)
+			ops->get_multiple = bgpio_get_multiple_be;
+		else
+			ops->get_multiple = bgpio_get_multiple;
+	}
 
 	return 0;
 }
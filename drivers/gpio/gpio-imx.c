@@ -57,6 +57,22 @@ static void imx_gpio_set_value(struct gpio_chip *chip, unsigned gpio, int value)
 	writel(val, base + imxgpio->regs->dr);
 }
 
+static void imx_gpio_set_multiple(struct gpio_chip *chip, unsigned long *mask,
+				  unsigned long *bits)
+{
+	struct imx_gpio_chip *imxgpio = container_of(chip, struct imx_gpio_chip, chip);
+	void __iomem *base = imxgpio->base;
+	u32 val;
+
+	if (!base)
+		return;
+
+	val = readl(base + imxgpio->regs->dr);
+	val &= ~*mask;
+	val |= *bits & *mask;
+	writel(val, base + imxgpio->regs->dr);
+}
+
 static int imx_gpio_direction_input(struct gpio_chip *chip, unsigned gpio)
 {
 	struct imx_gpio_chip *imxgpio = container_of(chip, struct imx_gpio_chip, chip);
@@ -112,11 +128,39 @@ static int imx_gpio_get_value(struct gpio_chip *chip, unsigned gpio)
 	return val & (1 << gpio) ? 1 : 0;
 }
 
+static int imx_gpio_get_multiple(struct gpio_chip *chip, unsigned long *mask,
+				 unsigned long *bits)
+{
+	struct imx_gpio_chip *imxgpio = container_of(chip, struct imx_gpio_chip, chip);
+	void __iomem *base = imxgpio->base;
+	u32 gdir, val = 0;
+	u32 in_mask, out_mask;
+
+	if (!base)
+		return -EINVAL;
+
+	/* inputs are sampled from PSR, outputs read back from DR */
+	gdir = readl(base + imxgpio->regs->gdir);
+	in_mask = *mask & ~gdir;
+	out_mask = *mask & gdir;
+
+	if (in_mask)
+		val |= readl(base + imxgpio->regs->psr) & in_mask;
+	if (out_mask)
+		val |= readl(base + imxgpio->regs->dr) & out_mask;
+
+	*bits = val;
+
+	return 0;
+}
+
 static struct gpio_ops imx_gpio_ops = {
 	.direction_input = imx_gpio_direction_input,
 	.direction_output = imx_gpio_direction_output,
 	.get = imx_gpio_get_value,
 	.set = imx_gpio_set_value,
+	.get_multiple = imx_gpio_get_multiple,
+	.set_multiple = imx_gpio_set_multiple,
 	.get_direction = imx_get_direction,
 };
 
@@ -10,6 +10,7 @@
 #include <linux/gpio/consumer.h>
 #include <linux/pinctrl/pinconf-generic.h>
 #include <linux/overflow.h>
+#include <linux/bitmap.h>
 #include <errno.h>
 #include <malloc.h>
 
@@ -315,6 +316,75 @@ void gpio_set_value(unsigned gpio, int value)
 }
 EXPORT_SYMBOL(gpio_set_value);
 
+/**
+ * gpio_set_multiple() - assign the raw values of several gpios at once
+ * @gpios: array of gpio numbers whose values will be assigned
+ * @values: array of values to assign, one per gpio
+ * @ngpio: number of gpios in both arrays
+ *
+ * Set the raw value of multiple GPIOs. Lines belonging to the same
+ * controller are written with a single register access where the
+ * controller implements the set_multiple op, so they switch
+ * simultaneously. Lines on controllers without the op are set one by
+ * one in array order.
+ */
+int gpio_set_multiple(const unsigned *gpios, const int *values,
+		      unsigned int ngpio)
+{
+	unsigned int i, j;
+
+	for (i = 0; i < ngpio; i++) {
+		struct gpio_desc *desc = gpio_to_desc(gpios[i]);
+		DECLARE_BITMAP(mask, ARCH_NR_GPIOS);
+		DECLARE_BITMAP(bits, ARCH_NR_GPIOS);
+		struct gpio_chip *chip;
+		int ret;
+
+		if (!desc)
+			return -ENODEV;
+
+		ret = gpio_ensure_requested(desc, gpios[i]);
+		if (ret)
+			return ret;
+
+		chip = desc->chip;
+		if (!chip->ops->set_multiple) {
+			gpiod_set_raw_value(desc, values[i]);
+			continue;
+		}
+
+		/* this chip was already handled at its first line */
+		for (j = 0; j < i; j++)
+			if (gpio_desc[gpios[j]].chip == chip)
+				break;
+		if (j < i)
+			continue;
+
+		bitmap_zero(mask, chip->ngpio);
+		bitmap_zero(bits, chip->ngpio);
+
+		for (j = i; j < ngpio; j++) {
+			struct gpio_desc *d = gpio_to_desc(gpios[j]);
+
+			if (!d || d->chip != chip)
+				continue;
+
+			ret = gpio_ensure_requested(d, gpios[j]);
+			if (ret)
+				return ret;
+
+			__set_bit(gpiodesc_chip_offset(d), mask);
+			if (values[j])
+				__set_bit(gpiodesc_chip_offset(d), bits);
+		}
+
+		chip->ops->set_multiple(chip, mask, bits);
+	}
+
+	return 0;
+}
+EXPORT_SYMBOL(gpio_set_multiple);
+
 /**
  * gpiod_set_value() - assign a gpio's value
  * @desc: gpio whose value will be assigned
@@ -375,6 +445,85 @@ int gpio_get_value(unsigned gpio)
 }
 EXPORT_SYMBOL(gpio_get_value);
 
+/**
+ * gpio_get_multiple() - return the raw values of several gpios at once
+ * @gpios: array of gpio numbers whose values will be returned
+ * @values: array the values are returned in, one per gpio
+ * @ngpio: number of gpios in both arrays
+ *
+ * Read the raw value of multiple GPIOs. Lines belonging to the same
+ * controller are sampled with a single register access where the
+ * controller implements the get_multiple op, so the returned values
+ * form a consistent snapshot. Lines on controllers without the op are
+ * read one by one in array order.
+ */
+int gpio_get_multiple(const unsigned *gpios, int *values, unsigned int ngpio)
+{
+	unsigned int i, j;
+
+	for (i = 0; i < ngpio; i++) {
+		struct gpio_desc *desc = gpio_to_desc(gpios[i]);
+		DECLARE_BITMAP(mask, ARCH_NR_GPIOS);
+		DECLARE_BITMAP(bits, ARCH_NR_GPIOS);
+		struct gpio_chip *chip;
+		int ret;
+
+		if (!desc)
+			return -ENODEV;
+
+		ret = gpio_ensure_requested(desc, gpios[i]);
+		if (ret)
+			return ret;
+
+		chip = desc->chip;
+		if (!chip->ops->get_multiple) {
+			ret = gpiod_get_raw_value(desc);
+			if (ret < 0)
+				return ret;
+			values[i] = ret;
+			continue;
+		}
+
+		/* this chip was already handled at its first line */
+		for (j = 0; j < i; j++)
+			if (gpio_desc[gpios[j]].chip == chip)
+				break;
+		if (j < i)
+			continue;
+
+		bitmap_zero(mask, chip->ngpio);
+		bitmap_zero(bits, chip->ngpio);
+
+		for (j = i; j < ngpio; j++) {
+			struct gpio_desc *d = gpio_to_desc(gpios[j]);
+
+			if (!d || d->chip != chip)
+				continue;
+
+			ret = gpio_ensure_requested(d, gpios[j]);
+			if (ret)
+				return ret;
+
+			__set_bit(gpiodesc_chip_offset(d), mask);
+		}
+
+		ret = chip->ops->get_multiple(chip, mask, bits);
+		if (ret)
+			return ret;
+
+		for (j = i; j < ngpio; j++) {
+			struct gpio_desc *d = gpio_to_desc(gpios[j]);
+
+			if (d && d->chip == chip)
+				values[j] = test_bit(gpiodesc_chip_offset(d),
+						     bits);
+		}
+	}
+
+	return 0;
+}
+EXPORT_SYMBOL(gpio_get_multiple);
+
 /**
  * gpiod_get_value() - return a gpio's value
  * @desc: gpio whose value will be returned
@@ -34,6 +34,7 @@
 #define DW_IC_CON_MASTER		(1 << 0)
 #define DW_IC_CON_SPEED_STD		(1 << 1)
 #define DW_IC_CON_SPEED_FAST		(1 << 2)
+#define DW_IC_CON_RESTART_EN		(1 << 5)
 #define DW_IC_CON_SLAVE_DISABLE		(1 << 6)
 
 #define DW_IC_TAR			0x4
@@ -202,7 +203,7 @@ i2c_dw_scl_lcnt(uint32_t ic_clk, uint32_t tLOW, uint32_t tf, int offset)
 	return ((ic_clk * (tLOW + tf) + 500000) / 1000000) - 1 + offset;
 }
 
-static void i2c_dw_setup_timings(struct dw_i2c_dev *dw)
+static void i2c_dw_setup_timings(struct dw_i2c_dev *dw, unsigned int bitrate)
 {
 	uint32_t hcnt, lcnt;
 	u32 reg;
@@ -226,15 +227,28 @@ static void i2c_dw_setup_timings(struct dw_i2c_dev *dw)
 	writel(hcnt, dw->base + DW_IC_SS_SCL_HCNT);
 	writel(lcnt, dw->base + DW_IC_SS_SCL_LCNT);
 
-	hcnt = i2c_dw_scl_hcnt(input_clock_khz,
-			       600,	/* tHD;STA = tHIGH = 0.6 us */
-			       sda_falling_time,
-			       0,	/* 0: DW default, 1: Ideal */
-			       0);	/* No offset */
-	lcnt = i2c_dw_scl_lcnt(input_clock_khz,
-			       1300,	/* tLOW = 1.3 us */
-			       scl_falling_time,
-			       0);	/* No offset */
+	if (bitrate >= 1000000) {
+		/* Fast-mode Plus */
+		hcnt = i2c_dw_scl_hcnt(input_clock_khz,
+				       260,	/* tHD;STA = tHIGH = 0.26 us */
+				       sda_falling_time,
+				       0,	/* 0: DW default, 1: Ideal */
+				       0);	/* No offset */
+		lcnt = i2c_dw_scl_lcnt(input_clock_khz,
+				       500,	/* tLOW = 0.5 us */
+				       scl_falling_time,
+				       0);	/* No offset */
+	} else {
+		hcnt = i2c_dw_scl_hcnt(input_clock_khz,
+				       600,	/* tHD;STA = tHIGH = 0.6 us */
+				       sda_falling_time,
+				       0,	/* 0: DW default, 1: Ideal */
+				       0);	/* No offset */
+		lcnt = i2c_dw_scl_lcnt(input_clock_khz,
+				       1300,	/* tLOW = 1.3 us */
+				       scl_falling_time,
+				       0);	/* No offset */
+	}
 
 	writel(hcnt, dw->base + DW_IC_FS_SCL_HCNT);
 	writel(lcnt, dw->base + DW_IC_FS_SCL_LCNT);
@@ -330,7 +344,7 @@ static void i2c_dw_abort_rx(struct dw_i2c_dev *dw)
 }
 
 static int i2c_dw_read(struct dw_i2c_dev *dw,
-		       const struct i2c_msg *msg)
+		       const struct i2c_msg *msg, bool stop)
 {
 	int i;
 	for (i = 0; i < msg->len; i++) {
@@ -338,7 +352,7 @@ static int i2c_dw_read(struct dw_i2c_dev *dw,
 		const bool last_byte = i == msg->len - 1;
 		uint32_t ic_cmd_data = DW_IC_DATA_CMD_CMD;
 
-		if (last_byte)
+		if (last_byte && stop)
 			ic_cmd_data |= DW_IC_DATA_CMD_STOP;
 
 		writel(ic_cmd_data, dw->base + DW_IC_DATA_CMD);
@@ -356,7 +370,7 @@ static int i2c_dw_read(struct dw_i2c_dev *dw,
 }
 
 static int i2c_dw_write(struct dw_i2c_dev *dw,
-			const struct i2c_msg *msg)
+			const struct i2c_msg *msg, bool stop)
 {
 	int i;
 	uint32_t ic_int_stat;
@@ -379,7 +393,7 @@ static int i2c_dw_write(struct dw_i2c_dev *dw,
 
 		ic_cmd_data = msg->buf[i];
 
-		if (last_byte)
+		if (last_byte && stop)
 			ic_cmd_data |= DW_IC_DATA_CMD_STOP;
 
 		writel(ic_cmd_data, dw->base + DW_IC_DATA_CMD);
@@ -459,24 +473,37 @@ static int i2c_dw_xfer(struct i2c_adapter *adapter,
 	struct dw_i2c_dev *dw = to_dw_i2c_dev(adapter);
 
 	for (i = 0; i < num; i++) {
+		/*
+		 * Messages to the same target are queued back to back; the
+		 * controller then inserts a repeated start on direction
+		 * changes instead of a stop/start pair. A stop is only
+		 * issued on the last message or before an address change.
+		 */
+		const bool stop = i == num - 1 ||
+			msgs[i + 1].addr != msgs[i].addr;
+
 		if (msgs[i].flags & I2C_M_DATA_ONLY)
 			return -ENOTSUPP;
 
-		ret = i2c_dw_set_address(dw, msgs[i].addr);
-		if (ret < 0)
-			break;
+		if (i == 0 || msgs[i].addr != msgs[i - 1].addr) {
+			ret = i2c_dw_set_address(dw, msgs[i].addr);
+			if (ret < 0)
+				break;
+		}
 
 		if (msgs[i].flags & I2C_M_RD)
-			ret = i2c_dw_read(dw, &msgs[i]);
+			ret = i2c_dw_read(dw, &msgs[i], stop);
 		else
-			ret = i2c_dw_write(dw, &msgs[i]);
+			ret = i2c_dw_write(dw, &msgs[i], stop);
 
 		if (ret < 0)
 			break;
 
-		ret = i2c_dw_finish_xfer(dw);
-		if (ret < 0)
-			break;
+		if (stop) {
+			ret = i2c_dw_finish_xfer(dw);
+			if (ret < 0)
+				break;
+		}
 	}
 
 	if (ret == -EIO) {
@@ -545,10 +572,13 @@ static int i2c_dw_probe(struct device *pdev)
 
 	i2c_dw_enable(dw, false);
 
-	if (IS_ENABLED(CONFIG_COMMON_CLK))
-		i2c_dw_setup_timings(dw);
+	bitrate = DW_I2C_BIT_RATE;
+	of_property_read_u32(pdev->of_node, "clock-frequency", &bitrate);
+	if (pdata && pdata->bitrate)
+		bitrate = pdata->bitrate;
 
-	bitrate = (pdata && pdata->bitrate) ? pdata->bitrate : DW_I2C_BIT_RATE;
+	if (IS_ENABLED(CONFIG_COMMON_CLK))
+		i2c_dw_setup_timings(dw, bitrate);
 
 	/*
 	 * We have to clear 'ic_10bitaddr_master' in 'ic_tar'
@@ -559,6 +589,8 @@ static int i2c_dw_probe(struct device *pdev)
 	writel(0, dw->base + DW_IC_TAR);
 
 	switch (bitrate) {
+	case 1000000:
+		/* Fast-mode Plus reuses the fast-mode counter registers */
 	case 400000:
 		ic_con = DW_IC_CON_SPEED_FAST;
 		break;
@@ -571,7 +603,8 @@ static int i2c_dw_probe(struct device *pdev)
 		break;
 	}
 
-	ic_con |= DW_IC_CON_MASTER | DW_IC_CON_SLAVE_DISABLE;
+	ic_con |= DW_IC_CON_MASTER | DW_IC_CON_SLAVE_DISABLE |
+		DW_IC_CON_RESTART_EN;
 
 	writel(ic_con, dw->base + DW_IC_CON);
 
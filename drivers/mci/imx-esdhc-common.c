@@ -289,9 +289,17 @@ void esdhc_populate_sdhci(struct fsl_esdhc_host *host)
 	}
 }
 
+/*
+ * In PBL, the SDMA path is usable as well: buffers are accessed
+ * uncached before the MMU is set up in barebox_arm_entry, so no cache
+ * maintenance is needed and dma_map_single() degrades to virt_to_phys().
+ * Only the ADMA descriptor chain is unavailable, as there is no
+ * coherent allocator; sdhci_setup_data_dma() falls back to SDMA with
+ * boundary restarts then.
+ */
 static bool esdhc_use_pio_mode(void)
 {
-	return IN_PBL || IS_ENABLED(CONFIG_MCI_IMX_ESDHC_PIO);
+	return IS_ENABLED(CONFIG_MCI_IMX_ESDHC_PIO);
 }
 
 static int esdhc_setup_data(struct fsl_esdhc_host *host, struct mci_data *data,
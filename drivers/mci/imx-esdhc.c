@@ -281,9 +281,12 @@ static void usdhc_set_timing(struct fsl_esdhc_host *host, enum mci_timing timing
 	u32 mixctrl;
 
 	mixctrl = sdhci_read32(&host->sdhci, IMX_SDHCI_MIXCTRL);
-	mixctrl &= ~MIX_CTRL_DDREN;
+	mixctrl &= ~(MIX_CTRL_DDREN | MIX_CTRL_HS400_EN);
 
 	switch (timing) {
+	case MMC_TIMING_MMC_HS400:
+		mixctrl |= MIX_CTRL_HS400_EN;
+		fallthrough;
 	case MMC_TIMING_UHS_DDR50:
 	case MMC_TIMING_MMC_DDR52:
 		mixctrl |= MIX_CTRL_DDREN;
@@ -317,6 +320,34 @@ static void usdhc_set_timing(struct fsl_esdhc_host *host, enum mci_timing timing
 	host->sdhci.timing = timing;
 }
 
+/*
+ * The strobe DLL samples the returned data strobe in HS400 mode. It has
+ * to be re-locked whenever the card clock changes, so this is called
+ * after the clock is configured for HS400 operation.
+ */
+static void usdhc_set_strobe_dll(struct fsl_esdhc_host *host)
+{
+	u32 val;
+
+	/* force a reset on strobe dll */
+	sdhci_write32(&host->sdhci, IMX_SDHCI_STROBE_DLL_CTRL,
+		      IMX_SDHCI_STROBE_DLL_CTRL_RESET);
+
+	/* enable strobe dll with the default slave delay target */
+	sdhci_write32(&host->sdhci, IMX_SDHCI_STROBE_DLL_CTRL,
+		      IMX_SDHCI_STROBE_DLL_CTRL_ENABLE |
+		      IMX_SDHCI_STROBE_DLL_CTRL_SLV_DLY_TARGET_DEFAULT <<
+		      IMX_SDHCI_STROBE_DLL_CTRL_SLV_DLY_TARGET_SHIFT);
+
+	/* wait for the REF and SLV locks */
+	if (esdhc_poll(host, IMX_SDHCI_STROBE_DLL_STATUS, val,
+		       (val & (IMX_SDHCI_STROBE_DLL_STS_REF_LOCK |
+			       IMX_SDHCI_STROBE_DLL_STS_SLV_LOCK)) ==
+		       (IMX_SDHCI_STROBE_DLL_STS_REF_LOCK |
+			IMX_SDHCI_STROBE_DLL_STS_SLV_LOCK), 50 * USECOND))
+		dev_warn(host->dev, "strobe DLL failed to lock\n");
+}
+
 static void layerscape_set_timing(struct fsl_esdhc_host *host, enum mci_timing timing)
 {
 	esdhc_clrbits32(host, SDHCI_CLOCK_CONTROL__TIMEOUT_CONTROL__SOFTWARE_RESET,
@@ -367,6 +398,11 @@ static void esdhc_set_ios(struct mci_host *mci, struct mci_ios *ios)
 	if (!ios->clock || mci->actual_clock != ios->clock || ddr_changed)
 		set_sysctl(mci, ios->clock, mci_timing_is_ddr(ios->timing));
 
+	/* lock the strobe dll once the bus runs at full HS400 speed */
+	if (esdhc_is_usdhc(host) && ios->timing == MMC_TIMING_MMC_HS400 &&
+	    ios->clock >= 100000000)
+		usdhc_set_strobe_dll(host);
+
 	sdhci_set_drv_type(&host->sdhci, ios->drv_type);
 
 	/* Set the bus width */
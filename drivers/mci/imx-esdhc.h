@@ -64,6 +64,14 @@
 #define IMX_SDHCI_DLL_CTRL	0x60
 #define  IMX_SDHCI_DLL_CTRL_OVERRIDE_VAL_SHIFT	9
 #define  IMX_SDHCI_DLL_CTRL_OVERRIDE_EN_SHIFT	8
+#define IMX_SDHCI_STROBE_DLL_CTRL	0x70
+#define  IMX_SDHCI_STROBE_DLL_CTRL_ENABLE	BIT(0)
+#define  IMX_SDHCI_STROBE_DLL_CTRL_RESET	BIT(1)
+#define  IMX_SDHCI_STROBE_DLL_CTRL_SLV_DLY_TARGET_DEFAULT	7
+#define  IMX_SDHCI_STROBE_DLL_CTRL_SLV_DLY_TARGET_SHIFT	3
+#define IMX_SDHCI_STROBE_DLL_STATUS	0x74
+#define  IMX_SDHCI_STROBE_DLL_STS_REF_LOCK	BIT(1)
+#define  IMX_SDHCI_STROBE_DLL_STS_SLV_LOCK	BIT(0)
 #define IMX_SDHCI_MIX_CTRL_FBCLK_SEL	BIT(25)
 
 /* pltfm-specific */
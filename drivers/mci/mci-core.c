@@ -241,7 +241,7 @@ static int mci_poll_until_ready(struct mci *mci, int timeout_ms)
 			return -ETIMEDOUT;
 		}
 
-		udelay(1000);
+		udelay_yield(1000);
 	}
 
 	dev_dbg(&mci->dev, "Ready polling took %ums\n", retries);
@@ -479,7 +479,7 @@ static int sd_send_op_cond(struct mci *mci)
 			dev_dbg(&mci->dev, "SD operation condition set failed: %d\n", err);
 			return err;
 		}
-		udelay(1000);
+		udelay_yield(1000);
 
 		if (mmc_host_is_spi(host))
 			busy = cmd.response[0] & R1_SPI_IDLE;
@@ -536,7 +536,7 @@ static int mmc_send_op_cond(struct mci *mci)
 			return err;
 		}
 
-		udelay(1000);
+		udelay_yield(1000);
 	} while (!(cmd.response[0] & OCR_BUSY) && timeout--);
 
 	if (timeout <= 0) {
@@ -1737,6 +1737,7 @@ static void mmc_select_max_dtr(struct mci *mci)
 	u32 caps = mci->card_caps;
 	unsigned int hs_max_dtr = 0;
 	unsigned int hs200_max_dtr = 0;
+	unsigned int hs400_max_dtr = 0;
 	unsigned int avail_type = 0;
 
 	if ((caps & MMC_CAP_MMC_HIGHSPEED) &&
@@ -1763,7 +1764,34 @@ static void mmc_select_max_dtr(struct mci *mci)
 		avail_type |= EXT_CSD_CARD_TYPE_HS200_1_2V;
 	}
 
+	/* HS400 is entered from tuned HS200 state, so it implies HS200 */
+	if ((caps2 & MMC_CAP2_HS400_1_8V) &&
+	    (card_type & EXT_CSD_CARD_TYPE_HS400_1_8V)) {
+		hs200_max_dtr = MMC_HS200_MAX_DTR;
+		hs400_max_dtr = MMC_HS400_MAX_DTR;
+		avail_type |= EXT_CSD_CARD_TYPE_HS200_1_8V |
+			      EXT_CSD_CARD_TYPE_HS400_1_8V;
+	}
+
+	if ((caps2 & MMC_CAP2_HS400_1_2V) &&
+	    (card_type & EXT_CSD_CARD_TYPE_HS400_1_2V)) {
+		hs200_max_dtr = MMC_HS200_MAX_DTR;
+		hs400_max_dtr = MMC_HS400_MAX_DTR;
+		avail_type |= EXT_CSD_CARD_TYPE_HS200_1_2V |
+			      EXT_CSD_CARD_TYPE_HS400_1_2V;
+	}
+
+	/* HS400 needs all eight data lines */
+	if (!(mci->host->host_caps & MMC_CAP_8_BIT_DATA))
+		avail_type &= ~EXT_CSD_CARD_TYPE_HS400;
+
+	if (mci->host->max_timing < MCI_TIMING_CAP_HS400)
+		avail_type &= ~EXT_CSD_CARD_TYPE_HS400;
+	if (mci->host->max_timing < MCI_TIMING_CAP_HS200)
+		avail_type &= ~EXT_CSD_CARD_TYPE_HS200;
+
 	mci->host->hs200_max_dtr = hs200_max_dtr;
+	mci->host->hs400_max_dtr = hs400_max_dtr;
 	mci->host->hs_max_dtr = hs_max_dtr;
 	mci->host->mmc_avail_type = avail_type;
 }
@@ -1848,6 +1876,69 @@ err:
 	return err;
 }
 
+/*
+ * Switch to HS400 mode. The card must already be in tuned HS200 state
+ * on an 8 bit bus. Per the eMMC spec the bus first drops back to high
+ * speed timing, the bus width switches to 8 bit DDR and only then may
+ * the HS400 timing be selected and the clock be raised again.
+ */
+static int mmc_select_hs400(struct mci *mci)
+{
+	struct mci_host *host = mci->host;
+	int err;
+	u8 val;
+
+	if (!(host->mmc_avail_type & EXT_CSD_CARD_TYPE_HS400) ||
+	    host->ios.bus_width != MMC_BUS_WIDTH_8)
+		return 0;
+
+	err = mci_switch(mci, EXT_CSD_HS_TIMING, EXT_CSD_TIMING_HS);
+	if (err) {
+		dev_err(&mci->dev, "switch to high-speed from hs200 failed, error %d\n",
+			err);
+		return err;
+	}
+
+	mci_set_timing(mci, MMC_TIMING_MMC_HS);
+	mci_set_clock(mci, host->hs_max_dtr);
+
+	err = mci_switch_status(mci, true);
+	if (err)
+		goto out_err;
+
+	err = mci_switch(mci, EXT_CSD_BUS_WIDTH, EXT_CSD_DDR_BUS_WIDTH_8);
+	if (err) {
+		dev_err(&mci->dev, "switch to 8 bit DDR bus width for hs400 failed, error %d\n",
+			err);
+		return err;
+	}
+
+	val = EXT_CSD_TIMING_HS400 |
+	      (host->drive_strength << EXT_CSD_DRV_STR_SHIFT);
+	err = mci_switch(mci, EXT_CSD_HS_TIMING, val);
+	if (err) {
+		dev_err(&mci->dev, "switch to hs400 failed, error %d\n", err);
+		return err;
+	}
+
+	mci_set_timing(mci, MMC_TIMING_MMC_HS400);
+	mci_set_clock(mci, host->hs400_max_dtr);
+
+	err = mci_switch_status(mci, true);
+	if (err)
+		goto out_err;
+
+	/* Block length is fixed to 512 bytes while in DDR mode */
+	mci->read_bl_len = SECTOR_SIZE;
+	mci->write_bl_len = SECTOR_SIZE;
+
+	return 0;
+
+out_err:
+	dev_err(&mci->dev, "%s failed, error %d\n", __func__, err);
+	return err;
+}
+
 /*
  * Set the bus speed for the selected speed mode.
  */
@@ -1855,7 +1946,10 @@ static void mmc_set_bus_speed(struct mci *mci)
 {
 	unsigned int max_dtr = (unsigned int)-1;
 
-	if (mmc_card_hs200(mci) &&
+	if (mmc_card_hs400(mci) &&
+		max_dtr > mci->host->hs400_max_dtr)
+		max_dtr = mci->host->hs400_max_dtr;
+	else if (mmc_card_hs200(mci) &&
 		max_dtr > mci->host->hs200_max_dtr)
 		max_dtr = mci->host->hs200_max_dtr;
 	else if (mmc_card_hs(mci) && max_dtr > mci->host->hs_max_dtr)
@@ -1925,8 +2019,11 @@ static int mci_startup_mmc(struct mci *mci)
 
 		if (mmc_card_hs200(mci)) {
 			ret = mmc_hs200_tuning(mci);
+			if (!ret)
+				ret = mmc_select_hs400(mci);
 			if (!ret) {
-				dev_dbg(&mci->dev, "HS200 tuning succeeded\n");
+				dev_dbg(&mci->dev, "switched to %s mode\n",
+					mci_timing_tostr(host->ios.timing));
 				return 0;
 			}
 
@@ -2729,6 +2826,12 @@ static int mci_set_boot_ack(struct param_d *param, void *priv)
 			  EXT_CSD_PARTITION_CONFIG, mci->ext_csd_part_config);
 }
 
+static const char * const mci_timing_cap_names[] = {
+	[MCI_TIMING_CAP_DDR52] = "ddr52",
+	[MCI_TIMING_CAP_HS200] = "hs200",
+	[MCI_TIMING_CAP_HS400] = "hs400",
+};
+
 static const char *mci_boot_names[] = {
 	"disabled",
 	"boot0",
@@ -3101,6 +3204,12 @@ int mci_register(struct mci_host *host)
 	dev_add_param_bool(&mci->dev, "probe", mci_set_probe, NULL,
 			   &mci->probe, mci);
 
+	host->max_timing = MCI_TIMING_CAP_HS400;
+	if (IS_ENABLED(CONFIG_MCI_TUNING) && !(host->caps2 & MMC_CAP2_NO_MMC))
+		dev_add_param_enum(&mci->dev, "max_timing", NULL, NULL,
+				   &host->max_timing, mci_timing_cap_names,
+				   ARRAY_SIZE(mci_timing_cap_names), mci);
+
 	if (IS_ENABLED(CONFIG_MCI_INFO))
 		devinfo_add(&mci->dev, mci_info);
 
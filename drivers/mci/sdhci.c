@@ -5,6 +5,7 @@
 #include <mci.h>
 #include <io.h>
 #include <dma.h>
+#include <sched.h>
 #include <linux/bitfield.h>
 
 #include "sdhci.h"
@@ -397,6 +398,80 @@ static void sdhci_set_sdma_addr(struct sdhci *host, dma_addr_t addr)
 		sdhci_write32(host, SDHCI_DMA_ADDRESS, addr);
 }
 
+/*
+ * ADMA2 descriptor: attribute/length word followed by the buffer address.
+ * 32-bit descriptors are 8 bytes long, 64-bit descriptors grow to 12 bytes
+ * and to 16 bytes in Version 4 mode. The table is written to coherent
+ * memory, so no cache maintenance is needed before kicking off a transfer.
+ */
+struct sdhci_adma2_desc {
+	__le16 attr;
+	__le16 len;
+	__le32 addr_lo;
+	__le32 addr_hi;
+} __packed;
+
+#define SDHCI_ADMA2_ATTR_VALID		BIT(0)
+#define SDHCI_ADMA2_ATTR_END		BIT(1)
+#define SDHCI_ADMA2_ATTR_ACT_TRAN	(0x2 << 4)
+
+/* Keep the 16-bit length field a multiple of the 4-byte alignment rule */
+#define SDHCI_ADMA2_MAX_LEN		65532
+
+/*
+ * The block count register limits a single request to 65535 blocks of
+ * up to 512 bytes, so this covers the largest transfer the core can
+ * hand us, plus slack for the trailing descriptor.
+ */
+#define SDHCI_ADMA2_MAX_DESCS	(DIV_ROUND_UP(65535 * 512, SDHCI_ADMA2_MAX_LEN) + 1)
+
+static unsigned int sdhci_adma2_desc_sz(struct sdhci *host)
+{
+	if (!(host->flags & SDHCI_USE_64_BIT_DMA))
+		return 8;
+
+	return host->v4_mode ? 16 : 12;
+}
+
+static int sdhci_setup_adma_table(struct sdhci *host, dma_addr_t dma,
+				  unsigned int nbytes)
+{
+	unsigned int desc_sz = sdhci_adma2_desc_sz(host);
+	void *p;
+
+	if (!host->adma_table) {
+		host->adma_table = dma_alloc_coherent(sdhci_dev(host),
+				SDHCI_ADMA2_MAX_DESCS * sizeof(struct sdhci_adma2_desc),
+				&host->adma_addr);
+		if (!host->adma_table)
+			return -ENOMEM;
+	}
+
+	p = host->adma_table;
+
+	while (nbytes) {
+		struct sdhci_adma2_desc *desc = p;
+		unsigned int len = min_t(unsigned int, nbytes,
+					 SDHCI_ADMA2_MAX_LEN);
+		u16 attr = SDHCI_ADMA2_ATTR_ACT_TRAN | SDHCI_ADMA2_ATTR_VALID;
+
+		if (len == nbytes)
+			attr |= SDHCI_ADMA2_ATTR_END;
+
+		desc->attr = cpu_to_le16(attr);
+		desc->len = cpu_to_le16(len);
+		desc->addr_lo = cpu_to_le32(lower_32_bits(dma));
+		if (host->flags & SDHCI_USE_64_BIT_DMA)
+			desc->addr_hi = cpu_to_le32(upper_32_bits(dma));
+
+		dma += len;
+		nbytes -= len;
+		p += desc_sz;
+	}
+
+	return 0;
+}
+
 #ifdef __PBL__
 /*
  * Stubs to make timeout logic below work in PBL
@@ -432,6 +507,8 @@ int sdhci_wait_for_done(struct sdhci *sdhci, u32 mask)
 				"SDHCI timeout while waiting for done\n");
 			return -ETIMEDOUT;
 		}
+
+		yield();
 	} while ((stat & mask) != mask);
 
 	return 0;
@@ -457,6 +534,9 @@ static void sdhci_config_dma(struct sdhci *host)
 	ctrl = sdhci_read8(host, SDHCI_HOST_CONTROL);
 	/* Note if DMA Select is zero then SDMA is selected */
 	ctrl &= ~SDHCI_CTRL_DMA_MASK;
+	if (host->adma_in_use)
+		ctrl |= host->flags & SDHCI_USE_64_BIT_DMA ?
+			SDHCI_CTRL_ADMA64 : SDHCI_CTRL_ADMA32;
 	sdhci_write8(host, SDHCI_HOST_CONTROL, ctrl);
 
 	if (host->flags & SDHCI_USE_64_BIT_DMA) {
@@ -504,8 +584,21 @@ void sdhci_setup_data_dma(struct sdhci *sdhci, struct mci_data *data,
 		return;
 	}
 
+	/*
+	 * A descriptor chain makes the whole request one hardware
+	 * operation, while SDMA stops at every 512K boundary and waits
+	 * for software to restart it. Fall back to SDMA if the table
+	 * cannot be allocated.
+	 */
+	sdhci->adma_in_use = !IN_PBL && sdhci->flags & SDHCI_USE_ADMA &&
+		!sdhci_setup_adma_table(sdhci, *dma, nbytes);
+
 	sdhci_config_dma(sdhci);
-	sdhci_set_sdma_addr(sdhci, *dma);
+
+	if (sdhci->adma_in_use)
+		sdhci_set_adma_addr(sdhci, sdhci->adma_addr);
+	else
+		sdhci_set_sdma_addr(sdhci, *dma);
 }
 
 void sdhci_teardown_data(struct sdhci *sdhci,
@@ -575,10 +668,12 @@ int sdhci_transfer_data_dma(struct sdhci *sdhci, struct mci_cmd *cmd,
 		if (irqstat & SDHCI_INT_DMA) {
 			/*
 			 * DMA engine has stopped on buffer boundary. Acknowledge
-			 * the interrupt and kick the DMA engine again.
+			 * the interrupt and kick the DMA engine again. ADMA
+			 * walks its descriptor chain without stopping.
 			 */
 			sdhci_write32(sdhci, SDHCI_INT_STATUS, SDHCI_INT_DMA);
-			sdhci_set_sdma_addr(sdhci, ALIGN(dma, SDHCI_DEFAULT_BOUNDARY_SIZE));
+			if (!sdhci->adma_in_use)
+				sdhci_set_sdma_addr(sdhci, ALIGN(dma, SDHCI_DEFAULT_BOUNDARY_SIZE));
 		}
 
 		if (irqstat & irqcheck)
@@ -1028,6 +1123,9 @@ int sdhci_setup_host(struct sdhci *host)
 	if (sdhci_can_64bit_dma(host))
 		host->flags |= SDHCI_USE_64_BIT_DMA;
 
+	if (host->caps & SDHCI_CAN_DO_ADMA2)
+		host->flags |= SDHCI_USE_ADMA;
+
 	if (host->quirks2 & SDHCI_QUIRK2_NO_1_8_V) {
 		host->caps1 &= ~(SDHCI_SUPPORT_SDR104 | SDHCI_SUPPORT_SDR50 |
 				 SDHCI_SUPPORT_DDR50);
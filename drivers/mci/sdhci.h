@@ -259,6 +259,9 @@ struct sdhci {
 	u32 caps1;	/* CAPABILITY_1 */
 	bool read_caps;	/* Capability flags have been read */
 	u32 sdma_boundary;
+	void *adma_table;	/* ADMA2 descriptor table */
+	dma_addr_t adma_addr;	/* Bus address of adma_table */
+	bool adma_in_use;	/* Current request uses ADMA */
 
 	unsigned int		tuning_count;	/* Timer count for re-tuning */
 	unsigned int		tuning_mode;	/* Re-tuning mode supported by host */
@@ -19,6 +19,7 @@
 #include <ioctl.h>
 #include <nand.h>
 #include <errno.h>
+#include <poller.h>
 #include <of.h>
 
 #include "mtd.h"
@@ -318,6 +319,7 @@ int mtd_lock(struct mtd_info *mtd, loff_t ofs, uint64_t len)
 		return -EINVAL;
 	if (!len)
 		return 0;
+	mtd_erase_async_finish(mtd);
 	return mtd->_lock(mtd, ofs, len);
 }
 
@@ -329,6 +331,7 @@ int mtd_unlock(struct mtd_info *mtd, loff_t ofs, uint64_t len)
 		return -EINVAL;
 	if (!len)
 		return 0;
+	mtd_erase_async_finish(mtd);
 	return mtd->_unlock(mtd, ofs, len);
 }
 
@@ -350,10 +353,12 @@ int mtd_block_markbad(struct mtd_info *mtd, loff_t ofs)
 	if (ofs < 0 || ofs >= mtd->size)
 		return -EINVAL;
 
-	if (mtd->_block_markbad)
+	if (mtd->_block_markbad) {
+		mtd_erase_async_finish(mtd);
 		ret = mtd->_block_markbad(mtd, ofs);
-	else
+	} else {
 		ret = -ENOSYS;
+	}
 
 	return ret;
 }
@@ -370,6 +375,368 @@ int mtd_block_markgood(struct mtd_info *mtd, loff_t ofs)
 	return ret;
 }
 
+#ifdef CONFIG_MTD_READ_CACHE
+
+/* number of most recently read pages kept per device */
+#define MTD_PAGE_CACHE_PAGES	4
+
+struct mtd_page_entry {
+	loff_t offset;
+	u64 last_use;
+	bool valid;
+	void *buf;
+};
+
+struct mtd_page_cache {
+	u64 use_count;
+	struct mtd_page_entry entries[MTD_PAGE_CACHE_PAGES];
+};
+
+/*
+ * Only paged devices benefit from the cache, and only small reads go
+ * through it: metadata walks like the UBIFS index re-read the same
+ * pages over and over, while large sequential reads are best left to
+ * the driver, which may use sequential cached reads for them.
+ */
+static bool mtd_page_cache_usable(struct mtd_info *mtd, size_t len)
+{
+	return mtd->writesize > 1 && len <= 2 * mtd->writesize;
+}
+
+static struct mtd_page_cache *mtd_page_cache_get(struct mtd_info *mtd)
+{
+	struct mtd_page_cache *cache = mtd->page_cache;
+	int i;
+
+	if (cache)
+		return cache;
+
+	cache = xzalloc(sizeof(*cache));
+	for (i = 0; i < MTD_PAGE_CACHE_PAGES; i++)
+		cache->entries[i].buf = xmalloc(mtd->writesize);
+
+	mtd->page_cache = cache;
+
+	return cache;
+}
+
+static void mtd_page_cache_drop(struct mtd_info *mtd, loff_t offset, u64 len)
+{
+	struct mtd_page_cache *cache = mtd->page_cache;
+	int i;
+
+	if (!cache)
+		return;
+
+	for (i = 0; i < MTD_PAGE_CACHE_PAGES; i++) {
+		struct mtd_page_entry *entry = &cache->entries[i];
+
+		if (entry->valid && entry->offset < offset + len &&
+		    entry->offset + mtd->writesize > offset)
+			entry->valid = false;
+	}
+}
+
+static void mtd_page_cache_free(struct mtd_info *mtd)
+{
+	struct mtd_page_cache *cache = mtd->page_cache;
+	int i;
+
+	if (!cache)
+		return;
+
+	for (i = 0; i < MTD_PAGE_CACHE_PAGES; i++)
+		free(cache->entries[i].buf);
+	free(cache);
+	mtd->page_cache = NULL;
+}
+
+static int mtd_page_cache_read(struct mtd_info *mtd, loff_t from, size_t len,
+			       size_t *retlen, u_char *buf)
+{
+	struct mtd_page_cache *cache = mtd_page_cache_get(mtd);
+	int ret = 0;
+
+	*retlen = 0;
+
+	while (len) {
+		u64 tmp = from;
+		u32 in_page = do_div(tmp, mtd->writesize);
+		loff_t page_off = from - in_page;
+		size_t now = min_t(size_t, len, mtd->writesize - in_page);
+		struct mtd_page_entry *entry = NULL, *lru = NULL;
+		int i;
+
+		for (i = 0; i < MTD_PAGE_CACHE_PAGES; i++) {
+			struct mtd_page_entry *e = &cache->entries[i];
+
+			if (e->valid && e->offset == page_off) {
+				entry = e;
+				break;
+			}
+			if (!lru || (lru->valid &&
+				     (!e->valid || e->last_use < lru->last_use)))
+				lru = e;
+		}
+
+		if (!entry) {
+			struct mtd_oob_ops ops = {
+				.len = mtd->writesize,
+				.datbuf = lru->buf,
+			};
+
+			lru->valid = false;
+
+			ret = mtd_read_oob(mtd, page_off, &ops);
+			if (ret < 0 && ret != -EUCLEAN)
+				return ret;
+
+			entry = lru;
+			entry->offset = page_off;
+			/*
+			 * Don't cache pages with excessive bitflips, so
+			 * that scrubbing logic above us keeps seeing them.
+			 */
+			entry->valid = ret != -EUCLEAN;
+		}
+
+		entry->last_use = ++cache->use_count;
+		memcpy(buf, entry->buf + in_page, now);
+
+		buf += now;
+		from += now;
+		len -= now;
+		*retlen += now;
+	}
+
+	return ret;
+}
+
+#else
+
+static bool mtd_page_cache_usable(struct mtd_info *mtd, size_t len)
+{
+	return false;
+}
+
+static void mtd_page_cache_drop(struct mtd_info *mtd, loff_t offset, u64 len)
+{
+}
+
+static void mtd_page_cache_free(struct mtd_info *mtd)
+{
+}
+
+static int mtd_page_cache_read(struct mtd_info *mtd, loff_t from, size_t len,
+			       size_t *retlen, u_char *buf)
+{
+	return -ENOSYS;
+}
+
+#endif /* CONFIG_MTD_READ_CACHE */
+
+#ifdef CONFIG_MTD_ERASE_ASYNC
+
+/*
+ * Background erase. The flash chips execute erase autonomously, so a
+ * caller that has other work to do (fetching an image from the network,
+ * erasing a second chip) can start the erase and let a poller drive it
+ * forward one eraseblock per invocation. The chip is idle between steps
+ * and every foreground mtd operation waits for pending background work
+ * on the range it touches, so ordering is preserved.
+ *
+ * At most one background erase is in flight at any time.
+ */
+static struct mtd_erase_async {
+	struct poller_struct poller;
+	struct mtd_info *mtd;
+	loff_t addr;
+	loff_t end;
+	int ret;
+} mtd_erase_async_state;
+
+/*
+ * Nonzero while a foreground operation is inside a driver callback.
+ * The poller must not issue erase commands then: it runs from the
+ * is_timeout() calls in the very wait loops of those operations.
+ */
+static unsigned int mtd_driver_active;
+
+static void mtd_driver_get(void)
+{
+	mtd_driver_active++;
+}
+
+static void mtd_driver_put(void)
+{
+	mtd_driver_active--;
+}
+
+static void mtd_erase_async_step(struct mtd_erase_async *async)
+{
+	struct mtd_info *mtd = async->mtd;
+	struct erase_info erase = {
+		.mtd = mtd,
+		.addr = async->addr,
+		.len = mtd->erasesize,
+	};
+	int ret;
+
+	if (mtd->_block_isbad && mtd->_block_isbad(mtd, async->addr) > 0) {
+		printf("Skipping bad block at 0x%08llx\n", async->addr);
+	} else {
+		mtd_page_cache_drop(mtd, erase.addr, erase.len);
+
+		ret = mtd->_erase(mtd, &erase);
+		if (ret) {
+			if (!async->ret)
+				async->ret = ret;
+			/* don't carry on erasing after an error */
+			async->addr = async->end;
+			return;
+		}
+	}
+
+	async->addr += mtd->erasesize;
+}
+
+static void mtd_erase_async_done(struct mtd_erase_async *async)
+{
+	poller_unregister(&async->poller);
+	async->mtd = NULL;
+}
+
+static void mtd_erase_async_poller(struct poller_struct *poller)
+{
+	struct mtd_erase_async *async =
+		container_of(poller, struct mtd_erase_async, poller);
+
+	if (mtd_driver_active)
+		return;
+
+	if (async->addr < async->end)
+		mtd_erase_async_step(async);
+
+	if (async->addr >= async->end)
+		mtd_erase_async_done(async);
+}
+
+/**
+ * mtd_erase_async_finish - wait for a background erase to complete
+ * @mtd: mtd device, or NULL for whatever erase is pending
+ *
+ * Return: the first error encountered by the background erase, 0 if it
+ * succeeded or none was pending.
+ */
+int mtd_erase_async_finish(struct mtd_info *mtd)
+{
+	struct mtd_erase_async *async = &mtd_erase_async_state;
+	int ret;
+
+	if (!async->mtd || (mtd && async->mtd != mtd))
+		return 0;
+
+	while (async->addr < async->end)
+		mtd_erase_async_step(async);
+
+	mtd_erase_async_done(async);
+
+	ret = async->ret;
+	async->ret = 0;
+
+	return ret;
+}
+
+/*
+ * Foreground accesses must not overtake the background erase on the
+ * range they touch. The erase proceeds in address order, so stepping
+ * until it has passed the end of the accessed range is enough.
+ */
+static int mtd_erase_async_wait_range(struct mtd_info *mtd, loff_t addr,
+				      loff_t len)
+{
+	struct mtd_erase_async *async = &mtd_erase_async_state;
+
+	if (async->mtd != mtd || addr + len <= async->addr ||
+	    addr >= async->end)
+		return 0;
+
+	while (async->addr < async->end && async->addr < addr + len)
+		mtd_erase_async_step(async);
+
+	if (async->addr >= async->end)
+		mtd_erase_async_done(async);
+
+	return async->ret;
+}
+
+/**
+ * mtd_erase_async - erase a region in the background
+ * @mtd: mtd device
+ * @addr: start of the region, rounded down to eraseblock alignment
+ * @len: length of the region, rounded up to eraseblock alignment
+ *
+ * Starts the erase and returns without waiting for completion. Bad
+ * blocks are skipped. Any previously pending background erase is
+ * finished first; its error, if any, is dropped, so callers that care
+ * must call mtd_erase_async_finish() themselves.
+ *
+ * Return: 0 when the erase was started (or completed), a negative
+ * error code otherwise.
+ */
+int mtd_erase_async(struct mtd_info *mtd, loff_t addr, loff_t len)
+{
+	struct mtd_erase_async *async = &mtd_erase_async_state;
+	loff_t ofs;
+
+	mtd_erase_async_finish(NULL);
+
+	if (!IS_ENABLED(CONFIG_MTD_WRITE))
+		return -ENOSYS;
+	if (mtd->flags & MTD_NO_ERASE)
+		return -EOPNOTSUPP;
+	if (!(mtd->flags & MTD_WRITEABLE))
+		return -EROFS;
+	if (addr >= mtd->size || len > mtd->size - addr)
+		return -EINVAL;
+	if (!len)
+		return 0;
+
+	/* multiple erase regions are rare, don't bother */
+	if (mtd->numeraseregions) {
+		struct erase_info erase = {
+			.mtd = mtd,
+			.addr = addr,
+			.len = len,
+		};
+
+		return mtd_erase(mtd, &erase);
+	}
+
+	ofs = mtd_erase_round_down(addr, mtd->erasesize);
+	len = mtd_erase_round_up(addr + len, mtd->erasesize) - ofs;
+
+	async->mtd = mtd;
+	async->addr = ofs;
+	async->end = ofs + len;
+	async->ret = 0;
+	async->poller.func = mtd_erase_async_poller;
+
+	return poller_register(&async->poller, "mtderase");
+}
+
+#else /* CONFIG_MTD_ERASE_ASYNC */
+
+static inline void mtd_driver_get(void) {}
+static inline void mtd_driver_put(void) {}
+static inline int mtd_erase_async_wait_range(struct mtd_info *mtd, loff_t addr,
+					     loff_t len)
+{
+	return 0;
+}
+
+#endif /* CONFIG_MTD_ERASE_ASYNC */
+
 int mtd_read(struct mtd_info *mtd, loff_t from, size_t len, size_t *retlen,
 	     u_char *buf)
 {
@@ -382,8 +749,15 @@ int mtd_read(struct mtd_info *mtd, loff_t from, size_t len, size_t *retlen,
 	if (from < 0 || from >= mtd->size || len > mtd->size - from)
 		return -EINVAL;
 
-	if (len)
-		ret = mtd_read_oob(mtd, from, &ops);
+	if (!len) {
+		*retlen = 0;
+		return 0;
+	}
+
+	if (mtd_page_cache_usable(mtd, len))
+		return mtd_page_cache_read(mtd, from, len, retlen, buf);
+
+	ret = mtd_read_oob(mtd, from, &ops);
 
 	*retlen = ops.retlen;
 	return ret;
@@ -403,11 +777,20 @@ int mtd_write_oob(struct mtd_info *mtd, loff_t to,
 	if (!mtd->_write_oob && (!mtd->_write || ops->oobbuf))
 		return -EOPNOTSUPP;
 
+	ret = mtd_erase_async_wait_range(mtd, to, ops->len ?: 1);
+	if (ret)
+		return ret;
+
+	/* conservatively drop the pages even when the write fails */
+	mtd_page_cache_drop(mtd, to, ops->len ?: 1);
+
+	mtd_driver_get();
 	if (mtd->_write_oob)
 		ret = mtd->_write_oob(mtd, to, ops);
 	else
 		ret = mtd->_write(mtd, to, ops->len, &ops->retlen,
 				     ops->datbuf);
+	mtd_driver_put();
 
 	return ret;
 }
@@ -434,6 +817,8 @@ int mtd_write(struct mtd_info *mtd, loff_t to, size_t len, size_t *retlen,
 
 int mtd_erase(struct mtd_info *mtd, struct erase_info *instr)
 {
+	int ret;
+
 	if (instr->addr >= mtd->size || instr->len > mtd->size - instr->addr)
 		return -EINVAL;
 	if (!IS_ENABLED(CONFIG_MTD_WRITE))
@@ -444,7 +829,17 @@ int mtd_erase(struct mtd_info *mtd, struct erase_info *instr)
 	if (!instr->len)
 		return 0;
 
-	return mtd->_erase(mtd, instr);
+	ret = mtd_erase_async_wait_range(mtd, instr->addr, instr->len);
+	if (ret)
+		return ret;
+
+	mtd_page_cache_drop(mtd, instr->addr, instr->len);
+
+	mtd_driver_get();
+	ret = mtd->_erase(mtd, instr);
+	mtd_driver_put();
+
+	return ret;
 }
 
 int mtd_read_oob(struct mtd_info *mtd, loff_t from, struct mtd_oob_ops *ops)
@@ -457,17 +852,23 @@ int mtd_read_oob(struct mtd_info *mtd, loff_t from, struct mtd_oob_ops *ops)
 	if (!mtd->_read_oob && (!mtd->_read || ops->oobbuf))
 		return -EOPNOTSUPP;
 
+	ret_code = mtd_erase_async_wait_range(mtd, from, ops->len ?: 1);
+	if (ret_code)
+		return ret_code;
+
 	/*
 	 * In cases where ops->datbuf != NULL, mtd->_read_oob() has semantics
 	 * similar to mtd->_read(), returning a non-negative integer
 	 * representing max bitflips. In other cases, mtd->_read_oob() may
 	 * return -EUCLEAN. In all cases, perform similar logic to mtd_read().
 	 */
+	mtd_driver_get();
 	if (mtd->_read_oob)
 		ret_code = mtd->_read_oob(mtd, from, ops);
 	else
 		ret_code = mtd->_read(mtd, from, ops->len, &ops->retlen,
 				    ops->datbuf);
+	mtd_driver_put();
 
 	if (unlikely(ret_code < 0))
 		return ret_code;
@@ -769,6 +1170,7 @@ int del_mtd_device(struct mtd_info *mtd)
 	devfs_remove(&mtd->cdev);
 	if (mtd->cdev_bb)
 		mtd_del_bb(mtd);
+	mtd_page_cache_free(mtd);
 	unregister_device(&mtd->dev);
 	free(mtd->param_size.value);
 	free(mtd->cdev.name);
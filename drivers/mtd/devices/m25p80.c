@@ -29,6 +29,7 @@
 
 struct m25p {
 	struct spi_mem		*spimem;
+	struct spi_mem_dirmap_desc *rdesc;
 	struct spi_nor		spi_nor;
 	struct mtd_info		mtd;
 	u8			command[MAX_CMD_SIZE];
@@ -109,6 +110,33 @@ static int m25p80_read(struct spi_nor *nor, loff_t from, size_t len,
 	size_t remaining = len;
 	int ret;
 
+	/*
+	 * Prefer the direct mapping if one could be created: on controllers
+	 * which memory map the flash this is a plain copy from the mapped
+	 * window without any per-transfer command setup. On all other
+	 * controllers the descriptor transparently falls back to exec_op.
+	 */
+	if (flash->rdesc) {
+		ssize_t nbytes;
+
+		while (remaining) {
+			nbytes = spi_mem_dirmap_read(flash->rdesc, from,
+						     remaining, buf);
+			if (nbytes < 0)
+				return nbytes;
+			if (!nbytes)
+				return -EIO;
+
+			from += nbytes;
+			buf += nbytes;
+			remaining -= nbytes;
+		}
+
+		*retlen = len;
+
+		return 0;
+	}
+
 	op.cmd.buswidth = spi_nor_get_protocol_inst_nbits(nor->read_proto);
 	op.addr.buswidth = spi_nor_get_protocol_addr_nbits(nor->read_proto);
 	op.dummy.buswidth = op.addr.buswidth;
@@ -200,6 +228,42 @@ static const struct platform_device_id m25p_ids[] = {
  * matches what the READ command supports, at least until this driver
  * understands FAST_READ (for clocks over 25 MHz).
  */
+/*
+ * Create a direct mapping descriptor for the (Fast) Read command selected by
+ * spi_nor_scan(). Controllers which can map the flash into the address space
+ * serve reads straight from the mapped window; for everybody else the
+ * descriptor degrades to spi_mem_exec_op() internally, so failure to create
+ * one is not fatal.
+ */
+static void m25p80_create_read_dirmap(struct m25p *flash)
+{
+	struct spi_nor *nor = &flash->spi_nor;
+	struct spi_mem_dirmap_info info = {
+		.op_tmpl = SPI_MEM_OP(SPI_MEM_OP_CMD(nor->read_opcode, 1),
+				      SPI_MEM_OP_ADDR(nor->addr_width, 0, 1),
+				      SPI_MEM_OP_DUMMY(nor->read_dummy, 1),
+				      SPI_MEM_OP_DATA_IN(0, NULL, 1)),
+		.offset = 0,
+		.length = nor->mtd->size,
+	};
+	struct spi_mem_op *op = &info.op_tmpl;
+	struct spi_mem_dirmap_desc *desc;
+
+	op->cmd.buswidth = spi_nor_get_protocol_inst_nbits(nor->read_proto);
+	op->addr.buswidth = spi_nor_get_protocol_addr_nbits(nor->read_proto);
+	op->dummy.buswidth = op->addr.buswidth;
+	op->data.buswidth = spi_nor_get_protocol_data_nbits(nor->read_proto);
+
+	/* convert the dummy cycles to the number of bytes */
+	op->dummy.nbytes = (nor->read_dummy * op->dummy.buswidth) / 8;
+
+	desc = spi_mem_dirmap_create(flash->spimem, &info);
+	if (IS_ERR(desc))
+		return;
+
+	flash->rdesc = desc;
+}
+
 static int m25p_probe(struct device *dev)
 {
 	struct spi_device *spi = (struct spi_device *)dev->type_data;
@@ -234,11 +298,20 @@ static int m25p_probe(struct device *dev)
 	flash->mtd.dev.parent = &spi->dev;
 	flash->spimem = spimem;
 
-	if (spi->mode & SPI_RX_QUAD)
+	if (spi->mode & SPI_RX_QUAD) {
 		hwcaps.mask |= SNOR_HWCAPS_READ_1_1_4;
-	else if (spi->mode & SPI_RX_DUAL)
+
+		if (spi->mode & SPI_TX_QUAD)
+			hwcaps.mask |= (SNOR_HWCAPS_READ_1_4_4 |
+					SNOR_HWCAPS_PP_1_1_4 |
+					SNOR_HWCAPS_PP_1_4_4);
+	} else if (spi->mode & SPI_RX_DUAL) {
 		hwcaps.mask |= SNOR_HWCAPS_READ_1_1_2;
 
+		if (spi->mode & SPI_TX_DUAL)
+			hwcaps.mask |= SNOR_HWCAPS_READ_1_2_2;
+	}
+
 	dev->priv = (void *)flash;
 
 	if (dev->id_entry)
@@ -253,6 +326,8 @@ static int m25p_probe(struct device *dev)
 	if (ret)
 		return ret;
 
+	m25p80_create_read_dirmap(flash);
+
 	device_id = DEVICE_ID_SINGLE;
 	if (dev->of_node)
 		flash_name = of_alias_get(dev->of_node);
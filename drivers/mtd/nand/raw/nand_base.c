@@ -626,7 +626,7 @@ int nand_soft_waitrdy(struct nand_chip *chip, unsigned long timeout_ms)
 		 * use this as polling delay before doing something smarter (ie.
 		 * deriving a delay from the timeout value, timeout_ms/ratio).
 		 */
-		udelay(10);
+		udelay_yield(10);
 	} while (!is_timeout(start, timeout_ms * MSECOND));
 
 	/*
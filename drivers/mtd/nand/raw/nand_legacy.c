@@ -25,6 +25,7 @@
 #include <io.h>
 #include <malloc.h>
 #include <module.h>
+#include <sched.h>
 
 #include "internals.h"
 
@@ -198,6 +199,7 @@ void nand_wait_ready(struct nand_chip *chip)
 	do {
 		if (chip->legacy.dev_ready(chip))
 			return;
+		yield();
 	} while (!is_timeout(start, 400 * MSECOND));
 
 	if (!chip->legacy.dev_ready(chip))
@@ -227,6 +229,7 @@ static void nand_wait_status_ready(struct nand_chip *chip, unsigned long timeo)
 
 		if (status & NAND_STATUS_READY)
 			break;
+		yield();
 	} while (!is_timeout(start, timeo * MSECOND));
 };
 
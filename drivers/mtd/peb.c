@@ -599,6 +599,48 @@ int mtd_peb_erase(struct mtd_info *mtd, int pnum)
 	return 0;
 }
 
+/**
+ * mtd_peb_erase_range - erase a range of physical eraseblocks
+ * @mtd: mtd device
+ * @pnum: first physical eraseblock number
+ * @count: number of consecutive eraseblocks to erase
+ *
+ * Erase @count consecutive eraseblocks with a single call into the
+ * driver, which amortizes the per-block call overhead compared to
+ * erasing them one by one. The caller must make sure the range does
+ * not contain bad blocks. If erasing the range fails, the caller
+ * should fall back to erasing the blocks individually to identify the
+ * failing block.
+ */
+int mtd_peb_erase_range(struct mtd_info *mtd, int pnum, int count)
+{
+	struct erase_info ei = {};
+	int i, ret;
+
+	if (count <= 0)
+		return -EINVAL;
+
+	if (!mtd_peb_valid(mtd, pnum) || !mtd_peb_valid(mtd, pnum + count - 1))
+		return -EINVAL;
+
+	dev_dbg(&mtd->dev, "erase PEBs %d-%d\n", pnum, pnum + count - 1);
+
+	/* The debug modes need the per-block checks of mtd_peb_erase() */
+	if (IS_ENABLED(CONFIG_MTD_PEB_DEBUG)) {
+		for (i = 0; i < count; i++) {
+			ret = mtd_peb_erase(mtd, pnum + i);
+			if (ret)
+				return ret;
+		}
+		return 0;
+	}
+
+	ei.addr = (loff_t)pnum * mtd->erasesize;
+	ei.len = (uint64_t)count * mtd->erasesize;
+
+	return mtd_erase(mtd, &ei);
+}
+
 /* Patterns to write to a physical eraseblock when torturing it */
 static uint8_t patterns[] = {0xa5, 0x5a, 0x0};
 
@@ -729,22 +771,22 @@ int mtd_peb_create_bitflips(struct mtd_info *mtd, int pnum, int offset,
 		goto err;
 	}
 
+	/*
+	 * Read the whole block including OOB in one batched call; the NAND
+	 * base advances through the pages internally without a separate
+	 * command sequence per data/OOB pair.
+	 */
 	ops.mode = MTD_OPS_RAW;
 	ops.ooboffs = 0;
-	ops.len = mtd->writesize;
-	ops.ooblen = mtd->oobsize;
-
-	for (i = 0; i < pages_per_block; i++) {
-		loff_t offs = (loff_t)pnum * mtd->erasesize + i * (loff_t)mtd->writesize;
-
-		ops.datbuf = buf + i * mtd->writesize;
-		ops.oobbuf = oobbuf + i * mtd->oobsize;
-
-		ret = mtd_read_oob(mtd, offs, &ops);
-		if (ret) {
-			dev_err(&mtd->dev, "Cannot read raw data at 0x%08llx\n", offs);
-			goto err;
-		}
+	ops.len = pages_per_block * mtd->writesize;
+	ops.ooblen = pages_per_block * mtd->oobsize;
+	ops.datbuf = buf;
+	ops.oobbuf = oobbuf;
+
+	ret = mtd_read_oob(mtd, (loff_t)pnum * mtd->erasesize, &ops);
+	if (ret) {
+		dev_err(&mtd->dev, "Cannot read raw data from PEB %d\n", pnum);
+		goto err;
 	}
 
 	if (random)
@@ -777,17 +819,10 @@ int mtd_peb_create_bitflips(struct mtd_info *mtd, int pnum, int offset,
 		goto err;
 	}
 
-	for (i = 0; i < pages_per_block; i++) {
-		loff_t offs = (loff_t)pnum * mtd->erasesize + i * (loff_t)mtd->writesize;
-
-		ops.datbuf = buf + i * mtd->writesize;
-		ops.oobbuf = oobbuf + i * mtd->oobsize;
-
-		ret = mtd_write_oob(mtd, offs, &ops);
-		if (ret) {
-			dev_err(&mtd->dev, "Cannot write page at 0x%08llx\n", offs);
-			goto err;
-		}
+	ret = mtd_write_oob(mtd, (loff_t)pnum * mtd->erasesize, &ops);
+	if (ret) {
+		dev_err(&mtd->dev, "Cannot write back PEB %d\n", pnum);
+		goto err;
 	}
 
 	ret = 0;
@@ -0,0 +1,178 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Erase counter histogram and wear analytics for attached UBI devices.
+ *
+ * Attach already reads the EC header of every PEB, so all numbers
+ * printed here come from the in-memory wear-leveling entries and cost
+ * no additional flash I/O.
+ */
+#include <common.h>
+#include <command.h>
+#include <getopt.h>
+#include <environment.h>
+#include <linux/math64.h>
+#include "ubi.h"
+
+/* decade buckets: 0-9, 10-99, ..., last one is open ended */
+#define UBI_HEALTH_BUCKETS	7
+#define UBI_HEALTH_WORST_MAX	16
+
+static void ubi_health_print(struct ubi_device *ubi, int worst_num)
+{
+	unsigned int hist[UBI_HEALTH_BUCKETS] = {};
+	struct ubi_wl_entry *worst[UBI_HEALTH_WORST_MAX];
+	int nworst = 0, known = 0;
+	int min_ec = INT_MAX, max_ec = 0;
+	unsigned long long ec_sum = 0, limit;
+	int pnum, i, j;
+
+	for (pnum = 0; pnum < ubi->peb_count; pnum++) {
+		struct ubi_wl_entry *e = ubi->lookuptbl[pnum];
+		int bucket = 0;
+
+		if (!e)
+			continue;	/* bad or reserved PEB */
+
+		known++;
+		ec_sum += e->ec;
+		min_ec = min(min_ec, e->ec);
+		max_ec = max(max_ec, e->ec);
+
+		for (j = e->ec; j >= 10 && bucket < UBI_HEALTH_BUCKETS - 1;
+		     j /= 10)
+			bucket++;
+		hist[bucket]++;
+
+		/* keep a small list of the most worn PEBs, sorted by EC */
+		for (i = 0; i < nworst; i++)
+			if (e->ec > worst[i]->ec)
+				break;
+		if (i < worst_num) {
+			if (nworst < worst_num)
+				nworst++;
+			memmove(&worst[i + 1], &worst[i],
+				(nworst - 1 - i) * sizeof(worst[0]));
+			worst[i] = e;
+		}
+	}
+
+	printf("UBI device %d (%s):\n", ubi->ubi_num, ubi->mtd->name);
+	printf("  PEBs: %d total, %d with known erase counter, %d bad\n",
+	       ubi->peb_count, known, ubi->bad_peb_count);
+
+	if (!known)
+		return;
+
+	printf("  erase counters: min %d, mean %llu, max %d\n",
+	       min_ec, div_u64(ec_sum, known), max_ec);
+
+	printf("  erase counter histogram:\n");
+	limit = 10;
+	for (i = 0; i < UBI_HEALTH_BUCKETS; i++, limit *= 10) {
+		if (i == UBI_HEALTH_BUCKETS - 1)
+			printf("    >= %9llu: %u\n", limit / 10, hist[i]);
+		else
+			printf("     < %9llu: %u\n", limit, hist[i]);
+	}
+
+	printf("  most worn PEBs:\n");
+	for (i = 0; i < nworst; i++)
+		printf("    PEB %5d: %d erases\n",
+		       worst[i]->pnum, worst[i]->ec);
+}
+
+/*
+ * Remember the bad PEB count in @var and print the growth since the
+ * value stored there previously. Pointing @var at a variable of a state
+ * device ("state.badpebs") persists it across reboots.
+ */
+static int ubi_health_track(struct ubi_device *ubi, const char *var)
+{
+	const char *old = getenv(var);
+	char *val;
+	int ret;
+
+	if (old && *old) {
+		int prev = simple_strtol(old, NULL, 0);
+
+		printf("  bad PEB growth: %d (%d -> %d)\n",
+		       ubi->bad_peb_count - prev, prev, ubi->bad_peb_count);
+	}
+
+	val = basprintf("%d", ubi->bad_peb_count);
+	ret = setenv(var, val);
+	free(val);
+
+	return ret;
+}
+
+static int do_ubihealth(int argc, char *argv[])
+{
+	const char *trackvar = NULL;
+	int opt, i, found = 0, ret = 0;
+	int worst_num = 5;
+	int ubi_num = -1;
+
+	while ((opt = getopt(argc, argv, "n:s:")) > 0) {
+		switch (opt) {
+		case 'n':
+			worst_num = simple_strtoul(optarg, NULL, 0);
+			if (worst_num > UBI_HEALTH_WORST_MAX)
+				worst_num = UBI_HEALTH_WORST_MAX;
+			break;
+		case 's':
+			trackvar = optarg;
+			break;
+		default:
+			return COMMAND_ERROR_USAGE;
+		}
+	}
+
+	if (argc > optind)
+		ubi_num = simple_strtoul(argv[optind], NULL, 0);
+
+	for (i = 0; i < UBI_MAX_DEVICES; i++) {
+		struct ubi_device *ubi;
+
+		if (ubi_num >= 0 && i != ubi_num)
+			continue;
+
+		ubi = ubi_get_device(i);
+		if (!ubi)
+			continue;
+
+		found++;
+		ubi_health_print(ubi, worst_num);
+		if (trackvar)
+			ret = ubi_health_track(ubi, trackvar);
+
+		ubi_put_device(ubi);
+	}
+
+	if (!found) {
+		printf("no UBI device attached\n");
+		return COMMAND_ERROR;
+	}
+
+	return ret ? COMMAND_ERROR : 0;
+}
+
+BAREBOX_CMD_HELP_START(ubihealth)
+BAREBOX_CMD_HELP_TEXT("Print erase counter statistics of attached UBI devices:")
+BAREBOX_CMD_HELP_TEXT("a histogram of the per-PEB erase counters, the most worn")
+BAREBOX_CMD_HELP_TEXT("blocks and the bad block count.")
+BAREBOX_CMD_HELP_TEXT("")
+BAREBOX_CMD_HELP_TEXT("Options:")
+BAREBOX_CMD_HELP_OPT("-n NUM", "number of most worn PEBs to list (default 5)")
+BAREBOX_CMD_HELP_OPT("-s VAR", "store the bad PEB count in variable VAR and print")
+BAREBOX_CMD_HELP_OPT("", "the growth since the previously stored value. Use a")
+BAREBOX_CMD_HELP_OPT("", "state variable (e.g. state.badpebs) to persist it")
+BAREBOX_CMD_HELP_END
+
+BAREBOX_CMD_START(ubihealth)
+	.cmd		= do_ubihealth,
+	BAREBOX_CMD_DESC("show UBI wear statistics")
+	BAREBOX_CMD_OPTS("[-ns] [UBINUM]")
+	BAREBOX_CMD_GROUP(CMD_GRP_INFO)
+	BAREBOX_CMD_HELP(cmd_ubihealth_help)
+BAREBOX_CMD_END
@@ -747,10 +747,10 @@ static int eqos_send(struct eth_device *edev, void *packet, int length)
 static void eqos_recv(struct eth_device *edev)
 {
 	struct eqos *eqos = edev->priv;
-	struct eqos_desc *rx_wbf_desc, *rx_rf_desc;
+	struct eqos_desc *rx_wbf_desc, *rx_rf_desc = NULL;
 	dma_addr_t dma;
 	void *frame;
-	int length;
+	int length, received = 0;
 
 	/* We have two types of RX descriptors at some pointer: Read and
 	 * Write-Back:
@@ -763,38 +763,47 @@ static void eqos_recv(struct eth_device *edev)
 	 * given in the "Receive Normal Descriptor (Write-Back Format)"
 	 */
 
-	/* Write-Back Format RX descriptor */
-	rx_wbf_desc = &eqos->rx_descs[eqos->rx_currdescnum];
-	if (readl(&rx_wbf_desc->des3) & EQOS_DESC3_OWN)
-		return;
+	while (received < EQOS_DESCRIPTORS_RX) {
+		/* Write-Back Format RX descriptor */
+		rx_wbf_desc = &eqos->rx_descs[eqos->rx_currdescnum];
+		if (readl(&rx_wbf_desc->des3) & EQOS_DESC3_OWN)
+			break;
 
-	dma = eqos->dma_rx_buf[eqos->rx_currdescnum];
-	frame = phys_to_virt(dma);
-	length = rx_wbf_desc->des3 & 0x7fff;
-
-	dma_sync_single_for_cpu(edev->parent, (unsigned long)frame,
-				length, DMA_FROM_DEVICE);
-	net_receive(edev, frame, length);
-	dma_sync_single_for_device(edev->parent, (unsigned long)frame,
-				   length, DMA_FROM_DEVICE);
-
-	/* Read Format RX descriptor */
-	rx_rf_desc = &eqos->rx_descs[eqos->rx_currdescnum];
-	rx_rf_desc->des0 = dma;
-	rx_rf_desc->des1 = 0;
-	rx_rf_desc->des2 = 0;
-	/*
-	 * Make sure that if HW sees the _OWN write below, it will see all the
-	 * writes to the rest of the descriptor too.
-	 */
-	rx_rf_desc->des3 |= EQOS_DESC3_BUF1V;
-	rx_rf_desc->des3 |= EQOS_DESC3_OWN;
-	barrier();
+		dma = eqos->dma_rx_buf[eqos->rx_currdescnum];
+		frame = phys_to_virt(dma);
+		length = rx_wbf_desc->des3 & 0x7fff;
 
-	writel((ulong)rx_rf_desc, &eqos->dma_regs->ch0_rxdesc_tail_pointer);
+		dma_sync_single_for_cpu(edev->parent, (unsigned long)frame,
+					length, DMA_FROM_DEVICE);
+		net_receive(edev, frame, length);
+		dma_sync_single_for_device(edev->parent, (unsigned long)frame,
+					   length, DMA_FROM_DEVICE);
 
-	eqos->rx_currdescnum++;
-	eqos->rx_currdescnum %= EQOS_DESCRIPTORS_RX;
+		/* Read Format RX descriptor */
+		rx_rf_desc = &eqos->rx_descs[eqos->rx_currdescnum];
+		rx_rf_desc->des0 = dma;
+		rx_rf_desc->des1 = 0;
+		rx_rf_desc->des2 = 0;
+		/*
+		 * Make sure that if HW sees the _OWN write below, it will see
+		 * all the writes to the rest of the descriptor too.
+		 */
+		rx_rf_desc->des3 |= EQOS_DESC3_BUF1V;
+		rx_rf_desc->des3 |= EQOS_DESC3_OWN;
+		barrier();
+
+		eqos->rx_currdescnum++;
+		eqos->rx_currdescnum %= EQOS_DESCRIPTORS_RX;
+		received++;
+	}
+
+	/*
+	 * A single tail pointer write hands the whole batch of refilled
+	 * descriptors back to the DMA, instead of ringing the doorbell
+	 * once per frame.
+	 */
+	if (rx_rf_desc)
+		writel((ulong)rx_rf_desc, &eqos->dma_regs->ch0_rxdesc_tail_pointer);
 }
 
 static int eqos_init_resources(struct eqos *eqos)
@@ -212,15 +212,10 @@ static int dsa_port_send(struct eth_device *edev, void *packet, int length)
 
 static void dsa_port_recv(struct eth_device *edev)
 {
-	struct dsa_port *dp = edev->priv;
-	int length;
-
-	if (!dp->rx_buf_length)
-		return;
-
-	net_receive(edev, dp->rx_buf, dp->rx_buf_length);
-	length = dp->rx_buf_length;
-	dp->rx_buf_length = 0;
+	/*
+	 * Nothing to do here: frames arrive through the master interface
+	 * and are dispatched to the right port from dsa_rx_preprocessor().
+	 */
 }
 
 static int dsa_ether_set_ethaddr(struct eth_device *edev,
@@ -272,14 +267,6 @@ static int dsa_switch_register_edev(struct dsa_switch *ds,
 
 	dp = dsa_port_alloc(ds, dn, port);
 
-	/* DMA is done on buffer in receive ring allocated by network
-	 * driver. This is then copied into this buffer, so we don't
-	 * strictly need to use dma_alloc() here, unlike ds->tx_buf.
-	 * We do it anyway as we don't want DSA buffers to be subtly
-	 * different to that of a directly used network interface.
-	 */
-	dp->rx_buf = dma_alloc(DSA_PKTSIZE);
-
 	edev = &dp->edev;
 	edev->priv = dp;
 	edev->parent = dp->dev;
@@ -317,14 +304,13 @@ static int dsa_rx_preprocessor(struct eth_device *edev, unsigned char **packet,
 	if (!dp)
 		return 0;
 
-	if (*length > DSA_PKTSIZE)
-		return -ENOMEM;
-
-	if (dp->rx_buf_length)
-		return -EIO;
-
-	memcpy(dp->rx_buf, *packet, *length);
-	dp->rx_buf_length = *length;
+	/*
+	 * The tag has been parsed in place, so the frame can be handed to
+	 * the port's interface right away while the master driver still
+	 * owns the buffer - the whole stack processes it synchronously.
+	 */
+	if (dp->edev.active)
+		net_receive(&dp->edev, *packet, *length);
 
 	return -ENOMSG;
 }
@@ -2186,13 +2186,20 @@ struct e1000_hw {
 	dma_addr_t tx_base_phys;
 	struct e1000_rx_desc *rx_base;
 	dma_addr_t rx_base_phys;
-	unsigned char *packet;
-	dma_addr_t packet_dma;
+	unsigned char *rx_pkts;
+	dma_addr_t rx_pkts_dma;
 
 	int tx_tail;
 	int rx_tail, rx_last;
 };
 
+/* Number of descriptors in the receive/transmit rings */
+#define E1000_NUM_RX_DESC	64
+#define E1000_NUM_TX_DESC	8
+
+/* Per descriptor receive buffer size, must match RCTL_SZ_2048 */
+#define E1000_RX_BUFFER_SIZE	2048
+
 void e1000_write_reg(struct e1000_hw *hw, uint32_t reg,
 		     uint32_t value);
 uint32_t e1000_read_reg(struct e1000_hw *hw, uint32_t reg);
@@ -3232,24 +3232,33 @@ static int e1000_sw_init(struct eth_device *edev)
 	return E1000_SUCCESS;
 }
 
-static int e1000_bd_next_index(int index)
+static int e1000_bd_next_index(int index, int num)
 {
-	return (index + 1) % 8;
+	return (index + 1) % num;
 }
 
 static void e1000_fill_rx(struct e1000_hw *hw)
 {
-	struct e1000_rx_desc *rd = &hw->rx_base[hw->rx_tail];
+	/*
+	 * Post all free descriptors, each with its own buffer. One slot is
+	 * left unused so a full ring (RDH == RDT) can be told apart from an
+	 * empty one.
+	 */
+	while (e1000_bd_next_index(hw->rx_tail, E1000_NUM_RX_DESC) !=
+	       hw->rx_last) {
+		struct e1000_rx_desc *rd = &hw->rx_base[hw->rx_tail];
 
-	hw->rx_last = hw->rx_tail;
-	hw->rx_tail = e1000_bd_next_index(hw->rx_tail);
+		writeq(hw->rx_pkts_dma + hw->rx_tail * E1000_RX_BUFFER_SIZE,
+		       &rd->buffer_addr);
+		writew(0, &rd->length);
+		writew(0, &rd->csum);
+		writeb(0, &rd->status);
+		writeb(0, &rd->errors);
+		writew(0, &rd->special);
 
-	writeq(hw->packet_dma, &rd->buffer_addr);
-	writew(0, &rd->length);
-	writew(0, &rd->csum);
-	writeb(0, &rd->status);
-	writeb(0, &rd->errors);
-	writew(0, &rd->special);
+		hw->rx_tail = e1000_bd_next_index(hw->rx_tail,
+						  E1000_NUM_RX_DESC);
+	}
 
 	e1000_write_reg(hw, E1000_RDT, hw->rx_tail);
 }
@@ -3271,7 +3280,8 @@ static void e1000_configure_tx(struct e1000_hw *hw)
 	e1000_write_reg(hw, E1000_TDBAL, lower_32_bits(tx_base));
 	e1000_write_reg(hw, E1000_TDBAH, upper_32_bits(tx_base));
 
-	e1000_write_reg(hw, E1000_TDLEN, 128);
+	e1000_write_reg(hw, E1000_TDLEN,
+			E1000_NUM_TX_DESC * sizeof(struct e1000_tx_desc));
 
 	/* Setup the HW Tx Head and Tail descriptor pointers */
 	e1000_write_reg(hw, E1000_TDH, 0);
@@ -3388,6 +3398,7 @@ static void e1000_configure_rx(struct e1000_hw *hw)
 	const unsigned long rx_base = (unsigned long)hw->rx_base_phys;
 
 	hw->rx_tail = 0;
+	hw->rx_last = 0;
 	/* make sure receives are disabled while setting up the descriptors */
 	rctl = e1000_read_reg(hw, E1000_RCTL);
 	e1000_write_reg(hw, E1000_RCTL, rctl & ~E1000_RCTL_EN);
@@ -3410,7 +3421,8 @@ static void e1000_configure_rx(struct e1000_hw *hw)
 	e1000_write_reg(hw, E1000_RDBAL, lower_32_bits(rx_base));
 	e1000_write_reg(hw, E1000_RDBAH, upper_32_bits(rx_base));
 
-	e1000_write_reg(hw, E1000_RDLEN, 128);
+	e1000_write_reg(hw, E1000_RDLEN,
+			E1000_NUM_RX_DESC * sizeof(struct e1000_rx_desc));
 
 	/* Setup the HW Rx Head and Tail Descriptor Pointers */
 	e1000_write_reg(hw, E1000_RDH, 0);
@@ -3432,20 +3444,29 @@ static void e1000_configure_rx(struct e1000_hw *hw)
 static void e1000_poll(struct eth_device *edev)
 {
 	struct e1000_hw *hw = edev->priv;
-	struct e1000_rx_desc *rd = &hw->rx_base[hw->rx_last];
+	bool processed = false;
 
-	if (readb(&rd->status) & E1000_RXD_STAT_DD) {
+	/* Hand over every completed descriptor before refilling the ring */
+	while (readb(&hw->rx_base[hw->rx_last].status) & E1000_RXD_STAT_DD) {
+		struct e1000_rx_desc *rd = &hw->rx_base[hw->rx_last];
 		const uint16_t len = readw(&rd->length);
+		const dma_addr_t dma = hw->rx_pkts_dma +
+			hw->rx_last * E1000_RX_BUFFER_SIZE;
 
-		dma_sync_single_for_cpu(hw->dev, hw->packet_dma, len,
-					DMA_FROM_DEVICE);
+		dma_sync_single_for_cpu(hw->dev, dma, len, DMA_FROM_DEVICE);
 
-		net_receive(edev, hw->packet, len);
+		net_receive(edev, &hw->rx_pkts[hw->rx_last * E1000_RX_BUFFER_SIZE],
+			    len);
 
-		dma_sync_single_for_device(hw->dev, hw->packet_dma, len,
-					   DMA_FROM_DEVICE);
-		e1000_fill_rx(hw);
+		dma_sync_single_for_device(hw->dev, dma, len, DMA_FROM_DEVICE);
+
+		hw->rx_last = e1000_bd_next_index(hw->rx_last,
+						  E1000_NUM_RX_DESC);
+		processed = true;
 	}
+
+	if (processed)
+		e1000_fill_rx(hw);
 }
 
 static int e1000_transmit(struct eth_device *edev, void *txpacket, int length)
@@ -3456,7 +3477,7 @@ static int e1000_transmit(struct eth_device *edev, void *txpacket, int length)
 	uint32_t stat;
 	int ret;
 
-	hw->tx_tail = e1000_bd_next_index(hw->tx_tail);
+	hw->tx_tail = e1000_bd_next_index(hw->tx_tail, E1000_NUM_TX_DESC);
 
 	writel(hw->txd_cmd | length, &txp->lower.data);
 	writel(0, &txp->upper.data);
@@ -3592,9 +3613,11 @@ static int e1000_probe(struct pci_dev *pdev, const struct pci_device_id *id)
 	hw = xzalloc(sizeof(*hw));
 
 	hw->tx_base = dma_alloc_coherent(DMA_DEVICE_BROKEN,
-					 16 * sizeof(*hw->tx_base), &hw->tx_base_phys);
+					 E1000_NUM_TX_DESC * sizeof(*hw->tx_base),
+					 &hw->tx_base_phys);
 	hw->rx_base = dma_alloc_coherent(DMA_DEVICE_BROKEN,
-					 16 * sizeof(*hw->rx_base), &hw->rx_base_phys);
+					 E1000_NUM_RX_DESC * sizeof(*hw->rx_base),
+					 &hw->rx_base_phys);
 
 	edev = &hw->edev;
 
@@ -3603,10 +3626,11 @@ static int e1000_probe(struct pci_dev *pdev, const struct pci_device_id *id)
 	pdev->dev.priv = hw;
 	edev->priv = hw;
 
-	hw->packet = dma_alloc(PAGE_SIZE);
-	hw->packet_dma = dma_map_single(hw->dev, hw->packet, PAGE_SIZE,
-					DMA_FROM_DEVICE);
-	if (dma_mapping_error(hw->dev, hw->packet_dma))
+	hw->rx_pkts = dma_alloc(E1000_NUM_RX_DESC * E1000_RX_BUFFER_SIZE);
+	hw->rx_pkts_dma = dma_map_single(hw->dev, hw->rx_pkts,
+					 E1000_NUM_RX_DESC * E1000_RX_BUFFER_SIZE,
+					 DMA_FROM_DEVICE);
+	if (dma_mapping_error(hw->dev, hw->rx_pkts_dma))
 		return -EFAULT;
 
 	hw->hw_addr = pci_iomap(pdev, 0);
@@ -525,16 +525,16 @@ static int fec_send(struct eth_device *dev, void *eth_data, int data_length)
 }
 
 /**
- * Pull one frame from the card
+ * Pull all pending frames from the card
  * @param[in] dev Our ethernet device to handle
- * @return Length of packet read
  */
 static void fec_recv(struct eth_device *dev)
 {
 	struct fec_priv *fec = (struct fec_priv *)dev->priv;
-	struct buffer_descriptor __iomem *rbd = &fec->rbd_base[fec->rbd_index];
+	struct buffer_descriptor __iomem *rbd;
 	uint32_t ievent;
 	int len = 0;
+	int received = 0;
 	uint16_t bd_status;
 
 	/*
@@ -569,50 +569,65 @@ static void fec_recv(struct eth_device *dev)
 	}
 
 	/*
-	 * ensure reading the right buffer status
+	 * Drain all frames the ring currently holds in one go. During
+	 * bursts, e.g. a full TFTP window, several frames arrive back to
+	 * back and pulling only one per poll loses the tail of the burst
+	 * once the ring is full.
 	 */
-	bd_status = readw(&rbd->status);
+	while (received < FEC_RBD_NUM) {
+		rbd = &fec->rbd_base[fec->rbd_index];
 
-	if (bd_status & FEC_RBD_EMPTY)
-		return;
-
-	if (bd_status & FEC_RBD_ERR) {
-		dev_warn(&dev->dev, "error frame: 0x%p 0x%08x\n",
-			 rbd, bd_status);
-	} else if (bd_status & FEC_RBD_LAST) {
-		const uint16_t data_length = readw(&rbd->data_length);
-
-		if (data_length - 4 > 14) {
-			void *frame = phys_to_virt(readl(&rbd->data_pointer));
-			/*
-			 * Sync the data for CPU so that endianness
-			 * fixup and net_receive below would get
-			 * proper data
-			 */
-			dma_sync_single_for_cpu(fec->dev, (unsigned long)frame,
-						data_length,
-						DMA_FROM_DEVICE);
-			if (fec_is_imx28(fec))
-				imx28_fix_endianess_rd(frame,
-						       (data_length + 3) >> 2);
-
-			/*
-			 * Get buffer address and size
-			 */
-			len = data_length - 4;
-			net_receive(dev, frame, len);
-			dma_sync_single_for_device(fec->dev, (unsigned long)frame,
-						   data_length,
-						   DMA_FROM_DEVICE);
+		/*
+		 * ensure reading the right buffer status
+		 */
+		bd_status = readw(&rbd->status);
+
+		if (bd_status & FEC_RBD_EMPTY)
+			break;
+
+		if (bd_status & FEC_RBD_ERR) {
+			dev_warn(&dev->dev, "error frame: 0x%p 0x%08x\n",
+				 rbd, bd_status);
+		} else if (bd_status & FEC_RBD_LAST) {
+			const uint16_t data_length = readw(&rbd->data_length);
+
+			if (data_length - 4 > 14) {
+				void *frame = phys_to_virt(readl(&rbd->data_pointer));
+				/*
+				 * Sync the data for CPU so that endianness
+				 * fixup and net_receive below would get
+				 * proper data
+				 */
+				dma_sync_single_for_cpu(fec->dev, (unsigned long)frame,
+							data_length,
+							DMA_FROM_DEVICE);
+				if (fec_is_imx28(fec))
+					imx28_fix_endianess_rd(frame,
+							       (data_length + 3) >> 2);
+
+				/*
+				 * Get buffer address and size
+				 */
+				len = data_length - 4;
+				net_receive(dev, frame, len);
+				dma_sync_single_for_device(fec->dev, (unsigned long)frame,
+							   data_length,
+							   DMA_FROM_DEVICE);
+			}
 		}
+		/*
+		 * free the current buffer and move forward to the next one
+		 */
+		fec_rbd_clean(fec->rbd_index == (FEC_RBD_NUM - 1) ? 1 : 0, rbd);
+		fec->rbd_index = (fec->rbd_index + 1) % FEC_RBD_NUM;
+		received++;
 	}
+
 	/*
-	 * free the current buffer, restart the engine
-	 * and move forward to the next buffer
+	 * restart the engine once for the whole batch
 	 */
-	fec_rbd_clean(fec->rbd_index == (FEC_RBD_NUM - 1) ? 1 : 0, rbd);
-	fec_rx_task_enable(fec);
-	fec->rbd_index = (fec->rbd_index + 1) % FEC_RBD_NUM;
+	if (received)
+		fec_rx_task_enable(fec);
 }
 
 static int fec_alloc_receive_packets(struct fec_priv *fec, int count, int size)
@@ -13,8 +13,12 @@
 #include <linux/virtio_ring.h>
 #include <uapi/linux/virtio_net.h>
 
-/* Amount of buffers to keep in the RX virtqueue */
-#define VIRTIO_NET_NUM_RX_BUFS	32
+/*
+ * Upper bound on the amount of buffers to keep in the RX virtqueue. The
+ * ring is filled up to the size the device negotiated, capped here so a
+ * device advertising a huge ring doesn't eat the malloc pool.
+ */
+#define VIRTIO_NET_MAX_RX_BUFS	256
 
 /*
  * This value comes from the VirtIO spec: 1500 for maximum packet size,
@@ -31,7 +35,8 @@ struct virtio_net_priv {
 		};
 	};
 
-	char rx_buff[VIRTIO_NET_NUM_RX_BUFS][VIRTIO_NET_RX_BUF_SIZE];
+	char *rx_buff;
+	unsigned int num_rx_bufs;
 	bool rx_running;
 	int net_hdr_len;
 	struct eth_device edev;
@@ -52,12 +57,12 @@ static int virtio_net_start(struct eth_device *edev)
 	if (!priv->rx_running) {
 
 		/* setup the receive buffer address */
-		for (i = 0; i < VIRTIO_NET_NUM_RX_BUFS; i++) {
-			/* receive buffer length is always 1526 */
-			sg.length = VIRTIO_NET_RX_BUF_SIZE;
+		for (i = 0; i < priv->num_rx_bufs; i++) {
+			char *buf = &priv->rx_buff[i * VIRTIO_NET_RX_BUF_SIZE];
 
-			sg_init_one(&sg, priv->rx_buff[i], VIRTIO_NET_RX_BUF_SIZE);
-			virtqueue_add_inbuf(priv->rx_vq, &sg, 1, priv->rx_buff[i]);
+			/* receive buffer length is always 1526 */
+			sg_init_one(&sg, buf, VIRTIO_NET_RX_BUF_SIZE);
+			virtqueue_add_inbuf(priv->rx_vq, &sg, 1, buf);
 		}
 
 		virtqueue_kick(priv->rx_vq);
@@ -104,20 +109,25 @@ static void virtio_net_recv(struct eth_device *edev)
 	struct scatterlist sg;
 	unsigned int len;
 	void *buf, *addr;
+	bool processed = false;
 
-	addr = virtqueue_get_buf(priv->rx_vq, &len);
-	if (!addr)
-		return;
+	/* Drain everything the device has completed since the last poll */
+	while ((addr = virtqueue_get_buf(priv->rx_vq, &len))) {
+		sg_init_one(&sg, addr, VIRTIO_NET_RX_BUF_SIZE);
 
-	sg_init_one(&sg, addr, VIRTIO_NET_RX_BUF_SIZE);
+		buf = sg.address + priv->net_hdr_len;
+		len -= priv->net_hdr_len;
 
-	buf = sg.address + priv->net_hdr_len;
-	len -= priv->net_hdr_len;
+		net_receive(edev, buf, len);
 
-	net_receive(edev, buf, len);
+		/* Put the buffer back to the rx ring */
+		virtqueue_add_inbuf(priv->rx_vq, &sg, 1, addr);
+		processed = true;
+	}
 
-	/* Put the buffer back to the rx ring */
-	virtqueue_add_inbuf(priv->rx_vq, &sg, 1, addr);
+	/* One notification for the whole batch of recycled buffers */
+	if (processed)
+		virtqueue_kick(priv->rx_vq);
 }
 
 static void virtio_net_stop(struct eth_device *dev)
@@ -192,6 +202,15 @@ static int virtio_net_probe(struct virtio_device *vdev)
 	if (ret < 0)
 		return ret;
 
+	/*
+	 * Keep the RX ring full instead of posting a handful of buffers
+	 * into a much deeper negotiated ring.
+	 */
+	priv->num_rx_bufs = min_t(unsigned int,
+				  virtqueue_get_vring_size(priv->rx_vq),
+				  VIRTIO_NET_MAX_RX_BUFS);
+	priv->rx_buff = xzalloc(priv->num_rx_bufs * VIRTIO_NET_RX_BUF_SIZE);
+
 	priv->vdev = vdev;
 
 	edev = &priv->edev;
@@ -216,6 +235,7 @@ static void virtio_net_remove(struct virtio_device *vdev)
 	eth_unregister(&priv->edev);
 	vdev->config->del_vqs(vdev);
 
+	free(priv->rx_buff);
 	free(priv);
 }
 
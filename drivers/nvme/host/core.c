@@ -159,20 +159,37 @@ int nvme_set_queue_count(struct nvme_ctrl *ctrl, int *count)
 }
 EXPORT_SYMBOL_GPL(nvme_set_queue_count);
 
+/**
+ * nvme_ctrl_ready - single non-blocking controller readiness check
+ * @ctrl: the controller
+ * @enabled: the CSTS.RDY state to check for
+ *
+ * Returns 1 when CSTS.RDY matches @enabled, 0 when it does not (yet) and
+ * a negative error code when the controller is gone.
+ */
+int nvme_ctrl_ready(struct nvme_ctrl *ctrl, bool enabled)
+{
+	u32 csts, bit = enabled ? NVME_CSTS_RDY : 0;
+	int ret;
+
+	ret = ctrl->ops->reg_read32(ctrl, NVME_REG_CSTS, &csts);
+	if (ret)
+		return ret;
+	if (csts == ~0)
+		return -ENODEV;
+
+	return (csts & NVME_CSTS_RDY) == bit;
+}
+EXPORT_SYMBOL_GPL(nvme_ctrl_ready);
+
 static int nvme_wait_ready(struct nvme_ctrl *ctrl, u64 cap, bool enabled)
 {
 	uint64_t start = get_time_ns();
 	uint64_t timeout =
 		((NVME_CAP_TIMEOUT(cap) + 1) * HZ / 2);
-	u32 csts, bit = enabled ? NVME_CSTS_RDY : 0;
 	int ret;
 
-	while ((ret = ctrl->ops->reg_read32(ctrl, NVME_REG_CSTS, &csts)) == 0) {
-		if (csts == ~0)
-			return -ENODEV;
-		if ((csts & NVME_CSTS_RDY) == bit)
-			break;
-
+	while ((ret = nvme_ctrl_ready(ctrl, enabled)) == 0) {
 		mdelay(100);
 
 		if (is_timeout(start, timeout)) {
@@ -183,7 +200,7 @@ static int nvme_wait_ready(struct nvme_ctrl *ctrl, u64 cap, bool enabled)
 		}
 	}
 
-	return ret;
+	return ret < 0 ? ret : 0;
 }
 
 static int nvme_identify_ns_list(struct nvme_ctrl *dev, unsigned nsid, __le32 *ns_list)
@@ -306,6 +323,61 @@ static void nvme_setup_flush(struct nvme_ns *ns, struct nvme_command *cmnd)
 	cmnd->common.nsid = cpu_to_le32(ns->head->ns_id);
 }
 
+/*
+ * Split a transfer into commands of at most NVME_BATCH_MAX_SIZE and
+ * keep up to max_batch of them in flight at once, so the controller
+ * can overlap their latencies instead of serving one command at a
+ * time.
+ */
+static int nvme_submit_batch_rw(struct nvme_ns *ns, struct nvme_command *cmnd,
+				void *buffer, sector_t block,
+				blkcnt_t num_blocks)
+{
+	const u32 chunk_blocks = min_t(u32,
+			NVME_BATCH_MAX_SIZE >> ns->lba_shift,
+			ns->ctrl->max_hw_sectors >> (ns->lba_shift - 9));
+	struct nvme_ctrl *ctrl = ns->ctrl;
+	struct nvme_command *cmds;
+	struct nvme_request *reqs;
+	int ret = 0;
+
+	cmds = calloc(ctrl->max_batch, sizeof(*cmds));
+	reqs = calloc(ctrl->max_batch, sizeof(*reqs));
+	if (!cmds || !reqs) {
+		ret = -ENOMEM;
+		goto out;
+	}
+
+	while (num_blocks && !ret) {
+		int nr = 0;
+
+		while (num_blocks && nr < ctrl->max_batch) {
+			const u32 chunk = min_t(blkcnt_t, num_blocks,
+						chunk_blocks);
+
+			memcpy(&cmds[nr], cmnd, sizeof(*cmnd));
+			nvme_setup_rw(ns, &cmds[nr], block, chunk);
+
+			memset(&reqs[nr], 0, sizeof(reqs[nr]));
+			reqs[nr].cmd = &cmds[nr];
+			reqs[nr].buffer = buffer;
+			reqs[nr].buffer_len = chunk << ns->lba_shift;
+
+			buffer += chunk << ns->lba_shift;
+			block += chunk;
+			num_blocks -= chunk;
+			nr++;
+		}
+
+		ret = ctrl->ops->submit_io_batch(ctrl, reqs, nr);
+	}
+out:
+	free(cmds);
+	free(reqs);
+
+	return ret;
+}
+
 static int nvme_submit_sync_rw(struct nvme_ns *ns, struct nvme_command *cmnd,
 			       void *buffer, sector_t block, blkcnt_t num_blocks)
 {
@@ -317,6 +389,21 @@ static int nvme_submit_sync_rw(struct nvme_ns *ns, struct nvme_command *cmnd,
 		ns->ctrl->max_hw_sectors >> (ns->lba_shift - 9);
 	int ret;
 
+	if (ns->ctrl->ops->submit_io_batch && ns->ctrl->max_batch > 1 &&
+	    num_blocks > NVME_BATCH_MAX_SIZE >> ns->lba_shift) {
+		ret = nvme_submit_batch_rw(ns, cmnd, buffer, block,
+					   num_blocks);
+		if (ret) {
+			dev_err(ns->ctrl->dev,
+				"batched I/O failed: block: %llu, num blocks: %llu, status code type: %xh, status code %02xh\n",
+				block, num_blocks, (ret >> 8) & 0xf,
+				ret & 0xff);
+			return -EIO;
+		}
+
+		return 0;
+	}
+
 	if (num_blocks > max_hw_sectors) {
 		while (num_blocks) {
 			const u32 chunk = min_t(blkcnt_t, num_blocks,
@@ -530,14 +617,20 @@ EXPORT_SYMBOL_GPL(nvme_start_ctrl);
  * bits', but doing so may cause the device to complete commands to the
  * admin queue ... and we don't know what memory that might be pointing at!
  */
-int nvme_disable_ctrl(struct nvme_ctrl *ctrl, u64 cap)
+int nvme_disable_ctrl_start(struct nvme_ctrl *ctrl)
 {
-	int ret;
-
 	ctrl->ctrl_config &= ~NVME_CC_SHN_MASK;
 	ctrl->ctrl_config &= ~NVME_CC_ENABLE;
 
-	ret = ctrl->ops->reg_write32(ctrl, NVME_REG_CC, ctrl->ctrl_config);
+	return ctrl->ops->reg_write32(ctrl, NVME_REG_CC, ctrl->ctrl_config);
+}
+EXPORT_SYMBOL_GPL(nvme_disable_ctrl_start);
+
+int nvme_disable_ctrl(struct nvme_ctrl *ctrl, u64 cap)
+{
+	int ret;
+
+	ret = nvme_disable_ctrl_start(ctrl);
 	if (ret)
 		return ret;
 
@@ -545,7 +638,7 @@ int nvme_disable_ctrl(struct nvme_ctrl *ctrl, u64 cap)
 }
 EXPORT_SYMBOL_GPL(nvme_disable_ctrl);
 
-int nvme_enable_ctrl(struct nvme_ctrl *ctrl, u64 cap)
+int nvme_enable_ctrl_start(struct nvme_ctrl *ctrl, u64 cap)
 {
 	/*
 	 * Default to a 4K page size, with the intention to update this
@@ -553,7 +646,6 @@ int nvme_enable_ctrl(struct nvme_ctrl *ctrl, u64 cap)
 	 * kernel and IO page sizes.
 	 */
 	unsigned dev_page_min = NVME_CAP_MPSMIN(cap) + 12, page_shift = 12;
-	int ret;
 
 	if (page_shift < dev_page_min) {
 		dev_err(ctrl->dev,
@@ -570,7 +662,15 @@ int nvme_enable_ctrl(struct nvme_ctrl *ctrl, u64 cap)
 	ctrl->ctrl_config |= NVME_CC_IOSQES | NVME_CC_IOCQES;
 	ctrl->ctrl_config |= NVME_CC_ENABLE;
 
-	ret = ctrl->ops->reg_write32(ctrl, NVME_REG_CC, ctrl->ctrl_config);
+	return ctrl->ops->reg_write32(ctrl, NVME_REG_CC, ctrl->ctrl_config);
+}
+EXPORT_SYMBOL_GPL(nvme_enable_ctrl_start);
+
+int nvme_enable_ctrl(struct nvme_ctrl *ctrl, u64 cap)
+{
+	int ret;
+
+	ret = nvme_enable_ctrl_start(ctrl, cap);
 	if (ret)
 		return ret;
 	return nvme_wait_ready(ctrl, cap, true);
@@ -7,6 +7,7 @@
 #define _NVME_H
 
 #include <linux/nvme.h>
+#include <linux/sizes.h>
 #include <dma.h>
 #include <block.h>
 
@@ -26,8 +27,20 @@ struct nvme_request {
 	unsigned int buffer_len;
 	dma_addr_t buffer_dma_addr;
 	enum dma_data_direction dma_dir;
+
+	/* PRP list describing the data buffer, if it spans enough pages */
+	__le64 *prp_list;
+	dma_addr_t prp_dma;
+	unsigned int prp_size;
 };
 
+/*
+ * Largest single command the batched I/O path generates. Kept moderate
+ * so the PRP lists of a whole batch stay small; bigger transfers are
+ * what the batching itself is for.
+ */
+#define NVME_BATCH_MAX_SIZE	SZ_256K
+
 struct nvme_ctrl {
 	const struct nvme_ctrl_ops *ops;
 	struct device *dev;
@@ -38,6 +51,7 @@ struct nvme_ctrl {
 	u64 cap;
 	u32 page_size;
 	u32 max_hw_sectors;
+	u32 max_batch;	/* commands per I/O batch, 0 or 1 means no batching */
 	u32 vs;
 };
 
@@ -78,17 +92,15 @@ struct nvme_ctrl_ops {
 			       void *buffer,
 			       unsigned bufflen,
 			       unsigned timeout, int qid);
+	/*
+	 * Submit several I/O commands at once and wait for all of them
+	 * to complete. The commands are made visible to the controller
+	 * with a single doorbell write, so they can overlap in flight.
+	 */
+	int (*submit_io_batch)(struct nvme_ctrl *ctrl,
+			       struct nvme_request *reqs, int nr);
 };
 
-static inline bool nvme_ctrl_ready(struct nvme_ctrl *ctrl)
-{
-	u32 val = 0;
-
-	if (ctrl->ops->reg_read32(ctrl, NVME_REG_CSTS, &val))
-		return false;
-	return val & NVME_CSTS_RDY;
-}
-
 static inline u64 nvme_block_nr(struct nvme_ns *ns, sector_t sector)
 {
 	return (sector >> (ns->lba_shift - 9));
@@ -101,7 +113,10 @@ static inline void nvme_end_request(struct nvme_request *rq, __le16 status,
 	rq->result = result;
 }
 
+int nvme_ctrl_ready(struct nvme_ctrl *ctrl, bool enabled);
+int nvme_disable_ctrl_start(struct nvme_ctrl *ctrl);
 int nvme_disable_ctrl(struct nvme_ctrl *ctrl, u64 cap);
+int nvme_enable_ctrl_start(struct nvme_ctrl *ctrl, u64 cap);
 int nvme_enable_ctrl(struct nvme_ctrl *ctrl, u64 cap);
 int nvme_shutdown_ctrl(struct nvme_ctrl *ctrl);
 int nvme_init_ctrl(struct nvme_ctrl *ctrl, struct device *dev,
@@ -4,7 +4,9 @@
 #include <init.h>
 #include <io.h>
 #include <io-64-nonatomic-lo-hi.h>
+#include <linux/log2.h>
 #include <linux/pci.h>
+#include <poller.h>
 
 #include <dma.h>
 
@@ -15,7 +17,7 @@
 
 #define NVME_MAX_KB_SZ	4096
 
-static int io_queue_depth = 2;
+static int io_queue_depth = 16;
 
 struct nvme_dev;
 
@@ -25,7 +27,7 @@ struct nvme_dev;
  */
 struct nvme_queue {
 	struct nvme_dev *dev;
-	struct nvme_request *req;
+	struct nvme_request **reqs;	/* in-flight requests, indexed by tag */
 	struct nvme_command *sq_cmds;
 	volatile struct nvme_completion *cqes;
 	dma_addr_t sq_dma_addr;
@@ -40,6 +42,17 @@ struct nvme_queue {
 	u16 counter;
 };
 
+/*
+ * Controller bring-up is completed asynchronously from the poller, so
+ * the probe doesn't have to block on the controller reset.
+ */
+enum nvme_reset_state {
+	NVME_RESET_DISABLING,
+	NVME_RESET_ENABLING,
+	NVME_RESET_DONE,
+	NVME_RESET_FAILED,
+};
+
 /*
  * Represents an NVM Express device.  Each nvme_dev is a PCI function.
  */
@@ -54,9 +67,9 @@ struct nvme_dev {
 	void __iomem *bar;
 	bool subsystem;
 	struct nvme_ctrl ctrl;
-	__le64 *prp_pool;
-	unsigned int prp_pool_size;
-	dma_addr_t prp_dma;
+	struct poller_struct poller;
+	enum nvme_reset_state reset_state;
+	u64 reset_start;
 };
 
 static inline struct nvme_dev *to_nvme_dev(struct nvme_ctrl *ctrl)
@@ -65,7 +78,7 @@ static inline struct nvme_dev *to_nvme_dev(struct nvme_ctrl *ctrl)
 }
 
 static int nvme_pci_setup_prps(struct nvme_dev *dev,
-			       const struct nvme_request *req,
+			       struct nvme_request *req,
 			       struct nvme_rw_command *cmnd)
 {
 	int length = req->buffer_len;
@@ -91,19 +104,21 @@ static int nvme_pci_setup_prps(struct nvme_dev *dev,
 		goto done;
 	}
 
+	/*
+	 * Every request carries its own PRP list, so several commands
+	 * can be in flight at once. Reserve room for the chain link
+	 * entry consumed whenever the list crosses into another page.
+	 */
 	nprps = DIV_ROUND_UP(length, page_size);
-	if (nprps > dev->prp_pool_size) {
-		dma_free_coherent(DMA_DEVICE_BROKEN,
-				  dev->prp_pool, dev->prp_dma,
-				  dev->prp_pool_size * sizeof(u64));
-		dev->prp_pool_size = nprps;
-		dev->prp_pool = dma_alloc_coherent(DMA_DEVICE_BROKEN,
-						   nprps * sizeof(u64),
-						   &dev->prp_dma);
-	}
+	req->prp_size = (nprps + DIV_ROUND_UP(nprps, (page_size >> 3) - 1)) *
+			sizeof(u64);
+	req->prp_list = dma_alloc_coherent(DMA_DEVICE_BROKEN, req->prp_size,
+					   &req->prp_dma);
+	if (!req->prp_list)
+		return -ENOMEM;
 
-	prp_list = dev->prp_pool;
-	prp_dma  = dev->prp_dma;
+	prp_list = req->prp_list;
+	prp_dma  = req->prp_dma;
 
 	i = 0;
 	for (;;) {
@@ -145,6 +160,12 @@ static int nvme_map_data(struct nvme_dev *dev, struct nvme_request *req)
 
 static void nvme_unmap_data(struct nvme_dev *dev, struct nvme_request *req)
 {
+	if (req->prp_list) {
+		dma_free_coherent(DMA_DEVICE_BROKEN, req->prp_list,
+				  req->prp_dma, req->prp_size);
+		req->prp_list = NULL;
+	}
+
 	if (!req->buffer || !req->buffer_len)
 		return;
 
@@ -171,6 +192,7 @@ static int nvme_alloc_queue(struct nvme_dev *dev, int qid, int depth)
 	if (!nvmeq->sq_cmds)
 		goto free_cqdma;
 
+	nvmeq->reqs = xzalloc(depth * sizeof(*nvmeq->reqs));
 	nvmeq->dev = dev;
 	nvmeq->cq_head = 0;
 	nvmeq->cq_phase = 1;
@@ -285,19 +307,38 @@ release_cq:
 }
 
 /**
- * nvme_submit_cmd() - Copy a command into a queue and ring the doorbell
+ * nvme_sq_copy_cmd() - Copy a command into the submission queue
  * @nvmeq: The queue to use
  * @cmd: The command to send
+ *
+ * The command only becomes visible to the controller once the doorbell
+ * is written with nvme_write_sq_db(), so several commands can be queued
+ * up before ringing it once.
  */
-static void nvme_submit_cmd(struct nvme_queue *nvmeq, struct nvme_command *cmd)
+static void nvme_sq_copy_cmd(struct nvme_queue *nvmeq, struct nvme_command *cmd)
 {
 	memcpy(&nvmeq->sq_cmds[nvmeq->sq_tail], cmd, sizeof(*cmd));
 
 	if (++nvmeq->sq_tail == nvmeq->q_depth)
 		nvmeq->sq_tail = 0;
+}
+
+static inline void nvme_write_sq_db(struct nvme_queue *nvmeq)
+{
 	writel(nvmeq->sq_tail, nvmeq->q_db);
 }
 
+/**
+ * nvme_submit_cmd() - Copy a command into a queue and ring the doorbell
+ * @nvmeq: The queue to use
+ * @cmd: The command to send
+ */
+static void nvme_submit_cmd(struct nvme_queue *nvmeq, struct nvme_command *cmd)
+{
+	nvme_sq_copy_cmd(nvmeq, cmd);
+	nvme_write_sq_db(nvmeq);
+}
+
 /* We read the CQE phase first to check if the rest of the entry is valid */
 static inline bool nvme_cqe_pending(struct nvme_queue *nvmeq)
 {
@@ -315,7 +356,7 @@ static inline void nvme_ring_cq_doorbell(struct nvme_queue *nvmeq)
 static inline void nvme_handle_cqe(struct nvme_queue *nvmeq, u16 idx)
 {
 	volatile struct nvme_completion *cqe = &nvmeq->cqes[idx];
-	struct nvme_request *req = nvmeq->req;
+	struct nvme_request *req;
 
 	if (unlikely(cqe->command_id >= nvmeq->q_depth)) {
 		dev_warn(nvmeq->dev->ctrl.dev,
@@ -324,9 +365,11 @@ static inline void nvme_handle_cqe(struct nvme_queue *nvmeq, u16 idx)
 		return;
 	}
 
-	if (WARN_ON(cqe->command_id != req->cmd->common.command_id))
+	req = nvmeq->reqs[cqe->command_id];
+	if (WARN_ON(!req || cqe->command_id != req->cmd->common.command_id))
 		return;
 
+	nvmeq->reqs[cqe->command_id] = NULL;
 	nvme_end_request(req, cqe->status, cqe->result);
 }
 
@@ -443,11 +486,11 @@ static int nvme_pci_submit_sync_cmd(struct nvme_ctrl *ctrl,
 		return ret;
 	}
 
+	nvmeq->reqs[tag] = &req;
 	nvme_submit_cmd(nvmeq, cmd);
 
-	nvmeq->req = &req;
 	ret = wait_on_timeout(timeout, nvme_poll(nvmeq, tag));
-	nvmeq->req = NULL;
+	nvmeq->reqs[tag] = NULL;
 
 	nvme_unmap_data(dev, &req);
 
@@ -457,11 +500,97 @@ static int nvme_pci_submit_sync_cmd(struct nvme_ctrl *ctrl,
 	return ret ?: req.status;
 }
 
-static int nvme_pci_configure_admin_queue(struct nvme_dev *dev)
+static bool nvme_poll_batch_done(struct nvme_queue *nvmeq,
+				 struct nvme_request *reqs, int nr)
+{
+	int i;
+
+	nvme_poll(nvmeq, -1);
+
+	for (i = 0; i < nr; i++) {
+		if (nvmeq->reqs[reqs[i].cmd->common.command_id])
+			return false;
+	}
+
+	return true;
+}
+
+static int nvme_pci_submit_io_batch(struct nvme_ctrl *ctrl,
+				    struct nvme_request *reqs, int nr)
+{
+	struct nvme_dev *dev = to_nvme_dev(ctrl);
+	struct nvme_queue *nvmeq = &dev->queues[NVME_QID_IO];
+	const u16 old_counter = nvmeq->counter;
+	const u16 old_sq_tail = nvmeq->sq_tail;
+	int i, ret;
+
+	/* one slot must stay free to tell a full ring from an empty one */
+	if (nr < 1 || nr >= nvmeq->q_depth)
+		return -EINVAL;
+
+	for (i = 0; i < nr; i++) {
+		struct nvme_request *req = &reqs[i];
+		const u16 tag = nvmeq->counter++ & (nvmeq->q_depth - 1);
+
+		switch (req->cmd->rw.opcode) {
+		case nvme_cmd_write:
+			req->dma_dir = DMA_TO_DEVICE;
+			break;
+		case nvme_cmd_read:
+			req->dma_dir = DMA_FROM_DEVICE;
+			break;
+		default:
+			ret = -EINVAL;
+			goto out_unwind;
+		}
+
+		req->cmd->common.command_id = tag;
+
+		ret = nvme_map_data(dev, req);
+		if (ret) {
+			dev_err(dev->dev, "Failed to map request data\n");
+			goto out_unwind;
+		}
+
+		nvmeq->reqs[tag] = req;
+		nvme_sq_copy_cmd(nvmeq, req->cmd);
+	}
+
+	/* a single doorbell write makes the whole batch visible */
+	nvme_write_sq_db(nvmeq);
+
+	ret = wait_on_timeout(ADMIN_TIMEOUT,
+			      nvme_poll_batch_done(nvmeq, reqs, nr));
+
+	for (i = 0; i < nr; i++) {
+		nvmeq->reqs[reqs[i].cmd->common.command_id] = NULL;
+		nvme_unmap_data(dev, &reqs[i]);
+		if (!ret && reqs[i].status)
+			ret = reqs[i].status;
+	}
+
+	return ret;
+
+out_unwind:
+	while (--i >= 0) {
+		nvmeq->reqs[reqs[i].cmd->common.command_id] = NULL;
+		nvme_unmap_data(dev, &reqs[i]);
+	}
+
+	/* nothing was made visible to the controller yet */
+	nvmeq->counter = old_counter;
+	nvmeq->sq_tail = old_sq_tail;
+
+	return ret;
+}
+
+/*
+ * Initiate the controller reset: request disabling the controller and
+ * note the time, but don't wait for CSTS.RDY to follow.
+ */
+static int nvme_reset_start(struct nvme_dev *dev)
 {
 	int result;
-	u32 aqa;
-	struct nvme_queue *nvmeq;
 
 	dev->subsystem = readl(dev->bar + NVME_REG_VS) >= NVME_VS(1, 1, 0) ?
 				NVME_CAP_NSSRC(dev->ctrl.cap) : 0;
@@ -470,29 +599,28 @@ static int nvme_pci_configure_admin_queue(struct nvme_dev *dev)
 	    (readl(dev->bar + NVME_REG_CSTS) & NVME_CSTS_NSSRO))
 		writel(NVME_CSTS_NSSRO, dev->bar + NVME_REG_CSTS);
 
-	result = nvme_disable_ctrl(&dev->ctrl, dev->ctrl.cap);
+	result = nvme_disable_ctrl_start(&dev->ctrl);
 	if (result < 0)
 		return result;
 
-	result = nvme_alloc_queue(dev, NVME_QID_ADMIN, NVME_AQ_DEPTH);
-	if (result)
-		return result;
-
-	nvmeq = &dev->queues[NVME_QID_ADMIN];
-	aqa = nvmeq->q_depth - 1;
-	aqa |= aqa << 16;
+	dev->reset_state = NVME_RESET_DISABLING;
+	dev->reset_start = get_time_ns();
 
-	writel(aqa, dev->bar + NVME_REG_AQA);
-	writeq(nvmeq->sq_dma_addr, dev->bar + NVME_REG_ASQ);
-	writeq(nvmeq->cq_dma_addr, dev->bar + NVME_REG_ACQ);
-
-	result = nvme_enable_ctrl(&dev->ctrl, dev->ctrl.cap);
-	if (result)
-		return result;
+	return 0;
+}
 
-	nvme_init_queue(nvmeq, NVME_QID_ADMIN);
+/* CAP.TO is in units of 500ms */
+static u64 nvme_reset_timeout(struct nvme_dev *dev)
+{
+	return (NVME_CAP_TIMEOUT(dev->ctrl.cap) + 1) * HZ / 2;
+}
 
-	return result;
+static void nvme_reset_fail(struct nvme_dev *dev, int err)
+{
+	dev_err(dev->ctrl.dev, "controller bring-up failed: %pe\n",
+		ERR_PTR(err));
+	dev->reset_state = NVME_RESET_FAILED;
+	poller_unregister(&dev->poller);
 }
 
 static int nvme_create_io_queues(struct nvme_dev *dev)
@@ -553,43 +681,136 @@ static int nvme_pci_enable(struct nvme_dev *dev)
 
 	dev->q_depth = min_t(int, NVME_CAP_MQES(dev->ctrl.cap) + 1,
 			     io_queue_depth);
+	/* tags are assigned by masking a running counter */
+	dev->q_depth = rounddown_pow_of_two(dev->q_depth);
+	dev->ctrl.max_batch = dev->q_depth - 1;
 	dev->db_stride = 1 << NVME_CAP_STRIDE(dev->ctrl.cap);
 	dev->dbs = dev->bar + 4096;
 
 	return 0;
 }
 
-static void nvme_reset_work(struct nvme_dev *dev)
+/*
+ * Advance the controller bring-up as far as it can go without waiting.
+ * Called periodically from the poller and, when the device is needed
+ * before the poller got it done, repeatedly from nvme_pci_detect().
+ */
+static void nvme_reset_step(struct nvme_dev *dev)
 {
-	int result = -ENODEV;
+	struct nvme_queue *nvmeq;
+	int result;
+	u32 aqa;
 
-	result = nvme_pci_enable(dev);
-	if (result)
-		goto out;
+	switch (dev->reset_state) {
+	case NVME_RESET_DISABLING:
+		result = nvme_ctrl_ready(&dev->ctrl, false);
+		if (result < 0) {
+			nvme_reset_fail(dev, result);
+			return;
+		}
+		if (!result) {
+			if (is_timeout_non_interruptible(dev->reset_start,
+							 nvme_reset_timeout(dev)))
+				nvme_reset_fail(dev, -ETIMEDOUT);
+			return;
+		}
 
-	result = nvme_pci_configure_admin_queue(dev);
-	if (result)
-		goto out;
+		result = nvme_alloc_queue(dev, NVME_QID_ADMIN, NVME_AQ_DEPTH);
+		if (result) {
+			nvme_reset_fail(dev, result);
+			return;
+		}
 
-	/*
-	 * Limit the max command size to prevent iod->sg allocations going
-	 * over a single page.
-	 */
-	dev->ctrl.max_hw_sectors = NVME_MAX_KB_SZ << 1;
+		nvmeq = &dev->queues[NVME_QID_ADMIN];
+		aqa = nvmeq->q_depth - 1;
+		aqa |= aqa << 16;
 
-	result = nvme_init_identify(&dev->ctrl);
-	if (result)
-		goto out;
+		writel(aqa, dev->bar + NVME_REG_AQA);
+		writeq(nvmeq->sq_dma_addr, dev->bar + NVME_REG_ASQ);
+		writeq(nvmeq->cq_dma_addr, dev->bar + NVME_REG_ACQ);
+
+		result = nvme_enable_ctrl_start(&dev->ctrl, dev->ctrl.cap);
+		if (result) {
+			nvme_reset_fail(dev, result);
+			return;
+		}
+
+		dev->reset_state = NVME_RESET_ENABLING;
+		dev->reset_start = get_time_ns();
+		return;
+
+	case NVME_RESET_ENABLING:
+		result = nvme_ctrl_ready(&dev->ctrl, true);
+		if (result < 0) {
+			nvme_reset_fail(dev, result);
+			return;
+		}
+		if (!result) {
+			if (is_timeout_non_interruptible(dev->reset_start,
+							 nvme_reset_timeout(dev)))
+				nvme_reset_fail(dev, -ETIMEDOUT);
+			return;
+		}
+
+		/*
+		 * The remaining steps are synchronous admin commands whose
+		 * waits run the pollers, so take this poller out and mark
+		 * the bring-up done before issuing them.
+		 */
+		dev->reset_state = NVME_RESET_DONE;
+		poller_unregister(&dev->poller);
+
+		nvme_init_queue(&dev->queues[NVME_QID_ADMIN], NVME_QID_ADMIN);
+
+		/*
+		 * Limit the max command size to prevent iod->sg allocations
+		 * going over a single page.
+		 */
+		dev->ctrl.max_hw_sectors = NVME_MAX_KB_SZ << 1;
+
+		result = nvme_init_identify(&dev->ctrl);
+		if (result) {
+			dev->reset_state = NVME_RESET_FAILED;
+			return;
+		}
+
+		result = nvme_setup_io_queues(dev);
+		if (result) {
+			dev_err(dev->ctrl.dev, "IO queues not created\n");
+			dev->reset_state = NVME_RESET_FAILED;
+			return;
+		}
+
+		nvme_start_ctrl(&dev->ctrl);
+		return;
+
+	default:
+		return;
+	}
+}
+
+static void nvme_reset_poll(struct poller_struct *poller)
+{
+	struct nvme_dev *dev = container_of(poller, struct nvme_dev, poller);
+
+	nvme_reset_step(dev);
+}
+
+/*
+ * The device is needed right now, so finish whatever is left of the
+ * bring-up synchronously. Registers the namespaces before returning.
+ */
+static int nvme_pci_detect(struct device *pci_dev)
+{
+	struct nvme_dev *dev = pci_dev->priv;
 
-	result = nvme_setup_io_queues(dev);
-	if (result) {
-		dev_err(dev->ctrl.dev, "IO queues not created\n");
-		goto out;
+	while (dev->reset_state == NVME_RESET_DISABLING ||
+	       dev->reset_state == NVME_RESET_ENABLING) {
+		nvme_reset_step(dev);
+		mdelay(1);
 	}
 
-	nvme_start_ctrl(&dev->ctrl);
-out:
-	return;
+	return dev->reset_state == NVME_RESET_DONE ? 0 : -ENODEV;
 }
 
 static int nvme_pci_reg_read32(struct nvme_ctrl *ctrl, u32 off, u32 *val)
@@ -615,6 +836,7 @@ static const struct nvme_ctrl_ops nvme_pci_ctrl_ops = {
 	.reg_write32		= nvme_pci_reg_write32,
 	.reg_read64		= nvme_pci_reg_read64,
 	.submit_sync_cmd	= nvme_pci_submit_sync_cmd,
+	.submit_io_batch	= nvme_pci_submit_io_batch,
 };
 
 static void nvme_dev_map(struct nvme_dev *dev)
@@ -671,9 +893,24 @@ static int nvme_probe(struct pci_dev *pdev, const struct pci_device_id *id)
 	if (result)
 		return result;
 
-	nvme_reset_work(dev);
+	result = nvme_pci_enable(dev);
+	if (result)
+		return result;
+
+	result = nvme_reset_start(dev);
+	if (result)
+		return result;
 
-	return 0;
+	/*
+	 * The controller reset can take hundreds of milliseconds. Let the
+	 * rest of the boot proceed in the meantime and finish the bring-up
+	 * from the poller; opening the device before then finishes it
+	 * synchronously through the detect hook.
+	 */
+	dev->poller.func = nvme_reset_poll;
+	pdev->dev.detect = nvme_pci_detect;
+
+	return poller_register(&dev->poller, "nvme-reset");
 }
 
 static void nvme_remove(struct pci_dev *pdev)
@@ -683,6 +920,10 @@ static void nvme_remove(struct pci_dev *pdev)
 
 	u32 csts = readl(dev->bar + NVME_REG_CSTS);
 
+	if (dev->reset_state == NVME_RESET_DISABLING ||
+	    dev->reset_state == NVME_RESET_ENABLING)
+		poller_unregister(&dev->poller);
+
 	dead = !!((csts & NVME_CSTS_CFS) || !(csts & NVME_CSTS_RDY));
 
 	if (!dead && dev->ctrl.queue_count > 0) {
@@ -10,6 +10,7 @@
 #include <libbb.h>
 #include <malloc.h>
 #include <of.h>
+#include <linux/sizes.h>
 #include <linux/nvmem-consumer.h>
 #include <linux/nvmem-provider.h>
 
@@ -39,6 +40,62 @@ struct nvmem_cell {
 
 DEFINE_DEV_CLASS(nvmem_class, "nvmem");
 
+/*
+ * Don't shadow devices bigger than this. The cache is meant for small
+ * EEPROMs and fuse banks that are read cell by cell, not for nvmem
+ * devices backed by big storage partitions.
+ */
+#define NVMEM_SHADOW_MAX_SIZE	SZ_64K
+
+/*
+ * Cell reads typically come in bursts of a few bytes each (MAC addresses,
+ * serial numbers, calibration data) and on I2C EEPROMs each one is a slow
+ * bus transaction. Read the whole device once on first access and serve
+ * subsequent reads from the shadow copy.
+ */
+static int nvmem_reg_read(struct nvmem_device *nvmem, unsigned int offset,
+			  void *buf, size_t bytes)
+{
+	int rc;
+
+	if (!nvmem->shadow && !nvmem->shadow_failed &&
+	    nvmem->size && nvmem->size <= NVMEM_SHADOW_MAX_SIZE) {
+		void *shadow = kzalloc(nvmem->size, GFP_KERNEL);
+
+		rc = nvmem->reg_read(nvmem->priv, 0, shadow, nvmem->size);
+		if (rc < 0) {
+			/* Fall back to direct reads, but only try once */
+			kfree(shadow);
+			nvmem->shadow_failed = true;
+		} else {
+			nvmem->shadow = shadow;
+		}
+	}
+
+	if (nvmem->shadow) {
+		memcpy(buf, nvmem->shadow + offset, bytes);
+		return 0;
+	}
+
+	return nvmem->reg_read(nvmem->priv, offset, buf, bytes);
+}
+
+static int nvmem_reg_write(struct nvmem_device *nvmem, unsigned int offset,
+			   const void *buf, size_t bytes)
+{
+	int rc;
+
+	rc = nvmem->reg_write(nvmem->priv, offset, buf, bytes);
+	if (rc < 0)
+		return rc;
+
+	/* Keep the shadow copy in sync with the device */
+	if (nvmem->shadow)
+		memcpy(nvmem->shadow + offset, buf, bytes);
+
+	return rc;
+}
+
 void nvmem_devices_print(void)
 {
 	struct nvmem_device *dev;
@@ -864,7 +921,7 @@ static int __nvmem_cell_read(struct nvmem_device *nvmem,
 {
 	int rc;
 
-	rc = nvmem->reg_read(nvmem->priv, cell->offset, buf, cell->raw_len);
+	rc = nvmem_reg_read(nvmem, cell->offset, buf, cell->raw_len);
 	if (rc < 0)
 		return rc;
 
@@ -939,7 +996,7 @@ static inline const void *nvmem_cell_prepare_write_buffer(struct nvmem_cell_entr
 		*b <<= bit_offset;
 
 		/* setup the first byte with lsb bits from nvmem */
-		rc = nvmem->reg_read(nvmem->priv, cell->offset, &v, 1);
+		rc = nvmem_reg_read(nvmem, cell->offset, &v, 1);
 		if (rc < 0)
 			return ERR_PTR(rc);
 
@@ -959,8 +1016,8 @@ static inline const void *nvmem_cell_prepare_write_buffer(struct nvmem_cell_entr
 	/* if it's not end on byte boundary */
 	if ((nbits + bit_offset) % BITS_PER_BYTE) {
 		/* setup the last byte with msb bits from nvmem */
-		rc = nvmem->reg_read(nvmem->priv, cell->offset + cell->bytes - 1,
-				      &v, 1);
+		rc = nvmem_reg_read(nvmem, cell->offset + cell->bytes - 1,
+				     &v, 1);
 		if (rc < 0)
 			return ERR_PTR(rc);
 
@@ -994,7 +1051,7 @@ static int __nvmem_cell_entry_write(struct nvmem_cell_entry *cell, const void *b
 			return PTR_ERR(buf);
 	}
 
-	rc = nvmem->reg_write(nvmem->priv, cell->offset, buf, cell->bytes);
+	rc = nvmem_reg_write(nvmem, cell->offset, buf, cell->bytes);
 
 	/* free the tmp buffer */
 	if (cell->bit_offset || cell->nbits)
@@ -1105,7 +1162,7 @@ int nvmem_device_read(struct nvmem_device *nvmem,
 	if (!bytes)
 		return 0;
 
-	rc = nvmem->reg_read(nvmem->priv, offset, buf, bytes);
+	rc = nvmem_reg_read(nvmem, offset, buf, bytes);
 
 	if (rc < 0)
 		return rc;
@@ -1139,7 +1196,7 @@ int nvmem_device_write(struct nvmem_device *nvmem,
 	if (!bytes)
 		return 0;
 
-	rc = nvmem->reg_write(nvmem->priv, offset, buf, bytes);
+	rc = nvmem_reg_write(nvmem, offset, buf, bytes);
 
 	if (rc < 0)
 		return rc;
@@ -19,6 +19,9 @@ struct nvmem_device {
 	bool			read_only;
 	struct cdev		cdev;
 	void			*priv;
+	/* whole-device shadow copy, populated on first read */
+	void			*shadow;
+	bool			shadow_failed;
 	struct nvmem_layout	*layout;
 	struct list_head	cells;
 	void (*fixup_dt_cell_info)(struct nvmem_device *nvmem,
@@ -22,9 +22,88 @@
 #include <linux/clk.h>
 #include <linux/ctype.h>
 #include <linux/err.h>
+#include <linux/hash.h>
 
 static struct device_node *root_node;
 
+/*
+ * Node and property names repeat massively across a tree ("reg",
+ * "clocks", "status", ...). Instead of duplicating each occurrence into
+ * the heap, equal names share a single interned copy, allocated from an
+ * arena that grows in page-sized chunks. The arena is intentionally
+ * never freed: the set of distinct names is small and shared by all
+ * trees ever unflattened, so deleting a tree just drops the references.
+ */
+#define OF_NAME_HASH_SIZE	64
+
+struct of_name {
+	struct hlist_node hash;
+	char str[];
+};
+
+struct of_name_chunk {
+	struct list_head list;
+	unsigned int used;
+	char mem[SZ_4K];
+};
+
+static LIST_HEAD(of_name_chunks);
+static struct hlist_head of_name_hash[OF_NAME_HASH_SIZE];
+
+static struct hlist_head *of_name_bucket(const char *name)
+{
+	unsigned int hash = 5381;
+
+	while (*name)
+		hash = hash * 33 + (unsigned char)*name++;
+
+	return &of_name_hash[hash & (OF_NAME_HASH_SIZE - 1)];
+}
+
+static const char *of_intern_name(const char *name)
+{
+	struct hlist_head *bucket = of_name_bucket(name);
+	size_t size = ALIGN(sizeof(struct of_name) + strlen(name) + 1,
+			    sizeof(long));
+	struct of_name_chunk *chunk;
+	struct of_name *n;
+
+	hlist_for_each_entry(n, bucket, hash) {
+		if (!strcmp(n->str, name))
+			return n->str;
+	}
+
+	/* outlandishly long names are not worth interning */
+	if (size > sizeof(chunk->mem))
+		return xstrdup_const(name);
+
+	chunk = list_first_entry_or_null(&of_name_chunks,
+					 struct of_name_chunk, list);
+	if (!chunk || chunk->used + size > sizeof(chunk->mem)) {
+		chunk = xzalloc(sizeof(*chunk));
+		list_add(&chunk->list, &of_name_chunks);
+	}
+
+	n = (struct of_name *)(chunk->mem + chunk->used);
+	chunk->used += size;
+	strcpy(n->str, name);
+	hlist_add_head(&n->hash, bucket);
+
+	return n->str;
+}
+
+static void of_free_name(const char *name)
+{
+	struct of_name_chunk *chunk;
+
+	list_for_each_entry(chunk, &of_name_chunks, list) {
+		if (name >= chunk->mem && name < chunk->mem + sizeof(chunk->mem))
+			return;
+	}
+
+	free_const(name);
+}
+
 /**
  * of_node_has_prefix - Test if a node name has a given prefix
  * @np: The node name to test
@@ -426,6 +505,41 @@ struct device_node *of_find_node_by_alias(struct device_node *root, const char *
 }
 EXPORT_SYMBOL_GPL(of_find_node_by_alias);
 
+/*
+ * The phandle cache avoids walking the whole tree for the phandle
+ * resolutions done on every clock, pinctrl or regulator reference during
+ * probe. It only caches nodes of the internal tree: lookups in other trees
+ * are rare and keep using the tree walk. Stale entries are cheap to detect
+ * since every hit is verified against the node's phandle, so the cache only
+ * has to be cleaned when nodes are deleted or the internal tree is replaced.
+ */
+#define OF_PHANDLE_CACHE_BITS	7
+#define OF_PHANDLE_CACHE_SZ	BIT(OF_PHANDLE_CACHE_BITS)
+
+static struct device_node *phandle_cache[OF_PHANDLE_CACHE_SZ];
+
+static unsigned int of_phandle_cache_hash(phandle handle)
+{
+	return hash_32(handle, OF_PHANDLE_CACHE_BITS);
+}
+
+static void of_phandle_cache_delete_node(struct device_node *node)
+{
+	unsigned int i;
+
+	if (!node->phandle)
+		return;
+
+	i = of_phandle_cache_hash(node->phandle);
+	if (phandle_cache[i] == node)
+		phandle_cache[i] = NULL;
+}
+
+static void of_phandle_cache_invalidate(void)
+{
+	memset(phandle_cache, 0, sizeof(phandle_cache));
+}
+
 /*
  * of_find_node_by_phandle_from - Find a node given a phandle from given
  * root node.
@@ -437,10 +551,28 @@ struct device_node *of_find_node_by_phandle_from(phandle phandle,
 		struct device_node *root)
 {
 	struct device_node *node;
+	bool cacheable;
+	unsigned int i;
+
+	if (!phandle)
+		return NULL;
+
+	cacheable = !root || root == root_node;
+	i = of_phandle_cache_hash(phandle);
 
-	of_tree_for_each_node_from(node, root)
-		if (node->phandle == phandle)
+	if (cacheable) {
+		node = phandle_cache[i];
+		if (node && node->phandle == phandle)
 			return node;
+	}
+
+	of_tree_for_each_node_from(node, root) {
+		if (node->phandle == phandle) {
+			if (cacheable)
+				phandle_cache[i] = node;
+			return node;
+		}
+	}
 
 	return NULL;
 }
@@ -2077,6 +2209,8 @@ int of_set_root_node(struct device_node *node)
 	if (node && root_node)
 		return -EBUSY;
 
+	of_phandle_cache_invalidate();
+
 	root_node = node;
 
 	of_chosen = of_find_node_by_path("/chosen");
@@ -2585,12 +2719,22 @@ struct device_node *of_new_node(struct device_node *parent, const char *name)
 	INIT_LIST_HEAD(&node->properties);
 
 	if (parent) {
-		node->name = xstrdup_const(name);
-		node->full_name = basprintf("%pOF/%s",
-					      node->parent, name);
+		/*
+		 * open-coded "%pOF/%s": unflattening a dtb creates every
+		 * node through here and the printf machinery is
+		 * measurably more expensive than the plain concatenation
+		 */
+		size_t pathlen = strlen(parent->full_name);
+		size_t namelen = strlen(name);
+
+		node->name = of_intern_name(name);
+		node->full_name = xmalloc(pathlen + 1 + namelen + 1);
+		memcpy(node->full_name, parent->full_name, pathlen);
+		node->full_name[pathlen] = '/';
+		memcpy(node->full_name + pathlen + 1, name, namelen + 1);
 		list_add(&node->list, &parent->list);
 	} else {
-		node->name = xstrdup_const("");
+		node->name = of_intern_name("");
 		node->full_name = xstrdup("");
 		INIT_LIST_HEAD(&node->list);
 	}
@@ -2604,7 +2748,7 @@ struct property *__of_new_property(struct device_node *node, const char *name,
 	struct property *prop;
 
 	prop = xzalloc(sizeof(*prop));
-	prop->name = xstrdup_const(name);
+	prop->name = of_intern_name(name);
 	prop->length = len;
 	prop->value = data;
 
@@ -2657,7 +2801,7 @@ struct property *of_new_property_const(struct device_node *node, const char *nam
 	struct property *prop;
 
 	prop = xzalloc(sizeof(*prop));
-	prop->name = xstrdup(name);
+	prop->name = of_intern_name(name);
 	prop->length = len;
 	prop->value_const = data;
 
@@ -2673,7 +2817,7 @@ void of_delete_property(struct property *pp)
 
 	list_del(&pp->list);
 
-	free_const(pp->name);
+	of_free_name(pp->name);
 	free(pp->value);
 	free(pp);
 }
@@ -2689,8 +2833,8 @@ struct property *of_rename_property(struct device_node *np,
 
 	of_property_write_bool(np, new_name, false);
 
-	free_const(pp->name);
-	pp->name = xstrdup(new_name);
+	of_free_name(pp->name);
+	pp->name = of_intern_name(new_name);
 	return pp;
 }
 
@@ -3077,7 +3221,9 @@ void of_delete_node(struct device_node *node)
 		list_del(&node->list);
 	}
 
-	free_const(node->name);
+	of_phandle_cache_delete_node(node);
+
+	of_free_name(node->name);
 	free(node->full_name);
 	free(node);
 }
@@ -114,8 +114,58 @@ static int pcs_set_state(struct pinctrl_device *pdev, struct device_node *np)
 	return 0;
 }
 
+static int pcs_resolve_group(struct pinctrl_device *pdev,
+			     struct device_node *np,
+			     struct pinctrl_reg_write **writes,
+			     unsigned int *nwrites)
+{
+	struct pinctrl_single *pcs = container_of(pdev, struct pinctrl_single, pinctrl);
+	struct pinctrl_reg_write *run;
+	unsigned size = 0, index = 0, n = 0;
+	const __be32 *mux;
+
+	/*
+	 * bits-per-mux groups need read-modify-write and narrow registers
+	 * can't be replayed with 32bit writes, keep using set_state there.
+	 */
+	if (pcs->bits_per_mux || pcs->width != 32)
+		return -ENOTSUPP;
+
+	mux = of_get_property(np, "pinctrl-single,pins", &size);
+
+	size /= sizeof(*mux);	/* Number of elements in array */
+
+	if (!mux || !size || (size % (pcs->args_count + 1))) {
+		dev_err(pcs->pinctrl.dev, "bad data for mux %pOF\n", np);
+		return -EINVAL;
+	}
+
+	run = xmalloc((size / (pcs->args_count + 1)) * sizeof(*run));
+
+	while (index < size) {
+		unsigned int offset, val;
+
+		offset = be32_to_cpup(mux + index++);
+		val = be32_to_cpup(mux + index++);
+		if (pcs->args_count > 1) {
+			val |= be32_to_cpup(mux + index);
+			index += pcs->args_count - 1;
+		}
+
+		run[n].addr = pcs->base + offset;
+		run[n].val = val;
+		n++;
+	}
+
+	*writes = run;
+	*nwrites = n;
+
+	return 0;
+}
+
 static struct pinctrl_ops pcs_ops = {
 	.set_state = pcs_set_state,
+	.resolve_group = pcs_resolve_group,
 };
 
 int pinctrl_single_probe(struct device *dev)
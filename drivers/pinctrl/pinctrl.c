@@ -6,6 +6,7 @@
  */
 #include <common.h>
 #include <malloc.h>
+#include <io.h>
 #include <pinctrl.h>
 #include <linux/overflow.h>
 #include <errno.h>
@@ -76,6 +77,71 @@ int pinctrl_gpio_get_direction(unsigned pin)
 	return pinctrl->ops->get_direction(pinctrl, pin);
 }
 
+struct pinctrl_group_cache {
+	struct device_node *np;
+	struct pinctrl_device *pdev;
+	struct pinctrl_reg_write *writes;
+	unsigned int nwrites;
+	struct list_head list;
+};
+
+static LIST_HEAD(pinctrl_group_cache_list);
+
+static int pinctrl_apply_group(struct pinctrl_device *pdev,
+			       struct device_node *np)
+{
+	struct pinctrl_group_cache *cache;
+	unsigned int i;
+	int ret;
+
+	if (!pdev->ops->resolve_group)
+		return pdev->ops->set_state(pdev, np);
+
+	list_for_each_entry(cache, &pinctrl_group_cache_list, list)
+		if (cache->np == np)
+			goto apply;
+
+	cache = xzalloc(sizeof(*cache));
+	cache->np = np;
+	cache->pdev = pdev;
+
+	ret = pdev->ops->resolve_group(pdev, np, &cache->writes,
+				       &cache->nwrites);
+	if (ret && ret != -ENOTSUPP) {
+		free(cache);
+		return ret;
+	}
+
+	/*
+	 * Groups the driver can't resolve are cached with an empty run, so
+	 * the fallback decision isn't re-evaluated on every apply either.
+	 */
+	list_add(&cache->list, &pinctrl_group_cache_list);
+
+apply:
+	if (!cache->writes)
+		return pdev->ops->set_state(pdev, np);
+
+	for (i = 0; i < cache->nwrites; i++)
+		writel(cache->writes[i].val, cache->writes[i].addr);
+
+	return 0;
+}
+
+static void pinctrl_drop_group_cache(struct pinctrl_device *pdev)
+{
+	struct pinctrl_group_cache *cache, *tmp;
+
+	list_for_each_entry_safe(cache, tmp, &pinctrl_group_cache_list, list) {
+		if (cache->pdev != pdev)
+			continue;
+
+		list_del(&cache->list);
+		free(cache->writes);
+		free(cache);
+	}
+}
+
 static struct pinctrl_device *find_pinctrl(struct device_node *node)
 {
 	struct pinctrl_device *pdev;
@@ -104,7 +170,7 @@ static int pinctrl_config_one(struct device_node *for_node, struct device_node *
 
 	pdev = find_pinctrl(pinctrl_node);
 	if (pdev)
-		return pdev->ops->set_state(pdev, np);
+		return pinctrl_apply_group(pdev, np);
 	else
 		return -ENODEV;
 }
@@ -276,6 +342,7 @@ int pinctrl_register(struct pinctrl_device *pdev)
 
 void pinctrl_unregister(struct pinctrl_device *pdev)
 {
+	pinctrl_drop_group_cache(pdev);
 	list_del(&pdev->list);
 }
 
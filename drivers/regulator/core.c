@@ -112,8 +112,18 @@ static int regulator_set_voltage_rdev(struct regulator_dev *rdev,
 		if (ret >= 0) {
 			best_val = ops->list_voltage(rdev, ret);
 			if (min_uV <= best_val && max_uV >= best_val) {
+				/*
+				 * Don't touch the hardware when it's already
+				 * at the requested voltage. On I2C PMICs this
+				 * saves a bus transaction per call.
+				 */
+				if (rdev->last_uv && rdev->last_uv == best_val)
+					return 0;
+
 				selector = ret;
 				ret = ops->set_voltage_sel(rdev, selector);
+				if (!ret)
+					rdev->last_uv = best_val;
 			} else {
 				ret = -EINVAL;
 			}
@@ -129,13 +139,20 @@ static int regulator_get_voltage_rdev(struct regulator_dev *rdev)
 {
 	int sel, ret;
 
+	if (rdev->last_uv > 0)
+		return rdev->last_uv;
+
 	if (rdev->desc->ops->get_voltage_sel) {
 		sel = rdev->desc->ops->get_voltage_sel(rdev);
 		if (sel < 0)
 			return sel;
 		ret = rdev->desc->ops->list_voltage(rdev, sel);
+		if (ret > 0)
+			rdev->last_uv = ret;
 	} else if (rdev->desc->ops->get_voltage) {
 		ret = rdev->desc->ops->get_voltage(rdev);
+		if (ret > 0)
+			rdev->last_uv = ret;
 	} else if (rdev->desc->ops->list_voltage) {
 		ret = rdev->desc->ops->list_voltage(rdev, 0);
 	} else if (rdev->desc->fixed_uV && (rdev->desc->n_voltages == 1)) {
@@ -622,6 +639,10 @@ int regulator_is_enabled(struct regulator *r)
 	if (r->rdev->always_on)
 		return 1;
 
+	/* We enabled it ourselves, no need to ask the hardware */
+	if (r->rdev->enable_count)
+		return 1;
+
 	if (r->rdev->desc->ops->is_enabled)
 		return r->rdev->desc->ops->is_enabled(r->rdev);
 
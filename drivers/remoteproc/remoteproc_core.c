@@ -17,9 +17,12 @@
 #include <common.h>
 #include <firmware.h>
 #include <linux/remoteproc.h>
+#include <linux/sizes.h>
 
 #include "remoteproc_internal.h"
 
+#define RPROC_FW_BUF_SIZE	SZ_4M
+
 void *rproc_da_to_va(struct rproc *rproc, u64 da, int len)
 {
 	void *ptr;
@@ -61,7 +64,15 @@ static int rproc_firmware_start(struct firmware_handler *fh)
 {
 	struct rproc *rproc = container_of(fh, struct rproc, fh);
 
-	rproc->fw_buf = kzalloc((4096 * 1024), GFP_KERNEL);
+	/*
+	 * No kzalloc here: the buffer is filled up to fw_buf_ofs, which is
+	 * all rproc_firmware_finish() hands on, so clearing all of it up
+	 * front would just add a multi-megabyte memset to every load.
+	 */
+	rproc->fw_buf = kmalloc(RPROC_FW_BUF_SIZE, GFP_KERNEL);
+	if (!rproc->fw_buf)
+		return -ENOMEM;
+
 	rproc->fw_buf_ofs = 0;
 	return 0;
 }
@@ -71,11 +82,15 @@ static int rproc_firmware_write_buf(struct firmware_handler *fh, const void *buf
 {
 	struct rproc *rproc = container_of(fh, struct rproc, fh);
 
-	if (rproc->fw_buf_ofs + size > (4096 * 1024)) {
+	if (rproc->fw_buf_ofs + size > RPROC_FW_BUF_SIZE)
 		return -ENOMEM;
-	}
 
-	memcpy_toio(rproc->fw_buf + rproc->fw_buf_ofs, buf, size);
+	/*
+	 * The staging buffer is plain heap memory, so use the optimized
+	 * memcpy instead of the word-wise IO accessors. Only the segment
+	 * loader copying into TCM has to go through memcpy_toio().
+	 */
+	memcpy(rproc->fw_buf + rproc->fw_buf_ofs, buf, size);
 	rproc->fw_buf_ofs += size;
 
 	return 0;
@@ -73,11 +73,9 @@ int rproc_elf_load_segments(struct rproc *rproc, const struct firmware *fw)
 			memcpy_toio(ptr, elf_data + phdr->p_offset, filesz);
 
 		/*
-		 * Zero out remaining memory for this segment.
-		 *
-		 * This isn't strictly required since dma_alloc_coherent already
-		 * did this for us. albeit harmless, we may consider removing
-		 * this.
+		 * Zero out remaining memory for this segment. Unlike Linux,
+		 * the target memory is not cleared at allocation time, so
+		 * this is what clears the remote processor's BSS.
 		 */
 		if (memsz > filesz)
 			memset_io(ptr + filesz, 0, memsz - filesz);
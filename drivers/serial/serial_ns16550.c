@@ -302,6 +302,51 @@ static void ns16550_putc(struct console_device *cdev, char c)
 	}
 }
 
+/* TX FIFO depth of a 16550A, the 16450 runs with the FIFO disabled */
+#define NS16550_FIFO_SIZE	16
+
+/**
+ * @brief Write a string to the serial port
+ *
+ * @param[in] cdev pointer to console device
+ * @param[in] s string to write
+ * @param[in] nbytes number of bytes to write
+ *
+ * Waits for transmitter readiness once per FIFO-sized burst instead of
+ * once per character, which saves most of the LSR polling overhead of
+ * the putc path at high baud rates.
+ *
+ * @return number of bytes written
+ */
+static int ns16550_puts(struct console_device *cdev, const char *s,
+			size_t nbytes)
+{
+	struct ns16550_priv *priv = to_ns16550_priv(cdev);
+	size_t i = 0;
+	int room;
+
+	while (i < nbytes) {
+		/* wait until the FIFO has fully drained */
+		while ((ns16550_read(cdev, lsr) & (LSR_THRE)) != (LSR_THRE))
+			;
+
+		room = (priv->fcrval & FCR_FIFO_EN) ? NS16550_FIFO_SIZE : 1;
+
+		while (room > 0 && i < nbytes) {
+			if (s[i] == '\n') {
+				if (room < 2)
+					break;
+				ns16550_write(cdev, '\r', thr);
+				room--;
+			}
+			ns16550_write(cdev, s[i++], thr);
+			room--;
+		}
+	}
+
+	return i;
+}
+
 /**
  * @brief Retrieve a character from serial port
  *
@@ -548,6 +593,9 @@ static int ns16550_probe(struct device *dev)
 	cdev->dev = dev;
 	cdev->tstc = ns16550_tstc;
 	cdev->putc = ns16550_putc;
+	/* RS485 needs the per-character RTS handshake of putc */
+	if (!priv->rs485_mode)
+		cdev->puts = ns16550_puts;
 	cdev->getc = ns16550_getc;
 	cdev->setbrg = priv->plat.clock ? ns16550_setbaudrate : NULL;
 	cdev->flush = ns16550_flush;
@@ -348,8 +348,10 @@ out:
 	return ret;
 }
 
-static int stm32_spi_transfer_one(struct stm32_spi_priv *priv,
-				  struct spi_transfer *t)
+static int stm32_spi_transfer_chunk(struct stm32_spi_priv *priv,
+				    struct spi_transfer *t,
+				    const void *tx_buf, void *rx_buf,
+				    unsigned int len)
 {
 	struct device *dev = priv->master.dev;
 	u32 sr;
@@ -359,21 +361,18 @@ static int stm32_spi_transfer_one(struct stm32_spi_priv *priv,
 	int nb_words;
 
 	if (t->bits_per_word <= 8)
-		nb_words = t->len;
+		nb_words = len;
 	else if (t->bits_per_word <= 16)
-		nb_words = DIV_ROUND_UP(t->len * 8, 16);
+		nb_words = DIV_ROUND_UP(len * 8, 16);
 	else
-		nb_words = DIV_ROUND_UP(t->len * 8, 32);
+		nb_words = DIV_ROUND_UP(len * 8, 32);
 
-	if (nb_words <= SPI_CR2_TSIZE)
-		writel(nb_words, priv->base + STM32_SPI_CR2);
-	else
-		return -EMSGSIZE;
+	writel(nb_words, priv->base + STM32_SPI_CR2);
 
-	priv->tx_buf = t->tx_buf;
-	priv->rx_buf = t->rx_buf;
-	priv->tx_len = priv->tx_buf ? t->len : 0;
-	priv->rx_len = priv->rx_buf ? t->len : 0;
+	priv->tx_buf = tx_buf;
+	priv->rx_buf = rx_buf;
+	priv->tx_len = priv->tx_buf ? len : 0;
+	priv->rx_len = priv->rx_buf ? len : 0;
 
 	mode = SPI_FULL_DUPLEX;
 	if (!priv->tx_buf)
@@ -381,10 +380,10 @@ static int stm32_spi_transfer_one(struct stm32_spi_priv *priv,
 	else if (!priv->rx_buf)
 		mode = SPI_SIMPLEX_TX;
 
-	if (priv->cur_xferlen != t->len || priv->cur_mode != mode ||
+	if (priv->cur_xferlen != len || priv->cur_mode != mode ||
 	    priv->cur_bpw != t->bits_per_word) {
 		priv->cur_mode = mode;
-		priv->cur_xferlen = t->len;
+		priv->cur_xferlen = len;
 		priv->cur_bpw = t->bits_per_word;
 
 		/* Disable the SPI hardware to unlock CFG1/CFG2 registers */
@@ -393,7 +392,7 @@ static int stm32_spi_transfer_one(struct stm32_spi_priv *priv,
 		clrsetbits_le32(priv->base + STM32_SPI_CFG2, SPI_CFG2_COMM,
 				mode << SPI_CFG2_COMM_SHIFT);
 
-		stm32_spi_set_fthlv(priv, t->len);
+		stm32_spi_set_fthlv(priv, len);
 
 		clrsetbits_le32(priv->base + STM32_SPI_CFG1, SPI_CFG1_DSIZE,
 				priv->cur_bpw - 1);
@@ -456,6 +455,44 @@ static int stm32_spi_transfer_one(struct stm32_spi_priv *priv,
 	return xfer_status;
 }
 
+static int stm32_spi_transfer_one(struct stm32_spi_priv *priv,
+				  struct spi_transfer *t)
+{
+	unsigned int bytes_per_word, max_chunk, done = 0;
+	int ret;
+
+	if (t->bits_per_word <= 8)
+		bytes_per_word = 1;
+	else if (t->bits_per_word <= 16)
+		bytes_per_word = 2;
+	else
+		bytes_per_word = 4;
+
+	/*
+	 * The transfer size counter is limited to SPI_CR2_TSIZE words.
+	 * Split longer transfers into maximum sized chunks; the gpio
+	 * chip select stays asserted across them, so big flash reads
+	 * stream through in one bus transaction.
+	 */
+	max_chunk = SPI_CR2_TSIZE * bytes_per_word;
+
+	while (done < t->len) {
+		unsigned int len = min_t(unsigned int, t->len - done,
+					 max_chunk);
+
+		ret = stm32_spi_transfer_chunk(priv, t,
+					       t->tx_buf ? t->tx_buf + done : NULL,
+					       t->rx_buf ? t->rx_buf + done : NULL,
+					       len);
+		if (ret)
+			return ret;
+
+		done += len;
+	}
+
+	return 0;
+}
+
 static int stm32_spi_transfer(struct spi_device *spi, struct spi_message *mesg)
 {
 	struct stm32_spi_priv *priv = to_stm32_spi_priv(spi->master);
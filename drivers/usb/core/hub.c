@@ -406,6 +406,8 @@ remove:
 	free(usb_scan);
 }
 
+static bool scan_deferred;
+
 static int usb_device_list_scan(void)
 {
 	struct usb_device_scan *usb_scan;
@@ -413,7 +415,7 @@ static int usb_device_list_scan(void)
 	static int running;
 
 	/* Only run this loop once for each controller */
-	if (running)
+	if (running || scan_deferred)
 		return 0;
 
 	running = 1;
@@ -441,6 +443,22 @@ out:
 	return 0;
 }
 
+/*
+ * While the deferral is active, ports added to the scanning list just stay
+ * queued with their settle timers running. usb_rescan() uses this to power
+ * on the root hubs of all controllers before draining the list, so the
+ * power-good and connect timeouts of all buses elapse concurrently instead
+ * of one controller after the other. Dropping the deferral drains whatever
+ * has been queued in the meantime.
+ */
+void usb_hub_defer_scan(bool defer)
+{
+	scan_deferred = defer;
+
+	if (!defer)
+		usb_device_list_scan();
+}
+
 static int usb_hub_configure(struct usb_device *dev)
 {
 	unsigned char *buffer, *bitmap;
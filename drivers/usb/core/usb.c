@@ -653,12 +653,22 @@ int usb_rescan(void)
 
 	pr_info("USB: scanning bus for devices...\n");
 
+	/*
+	 * Power on and queue the root ports of all controllers before
+	 * draining the scanning list, so the mandated settle delays of
+	 * the buses overlap and the total scan time is bounded by the
+	 * slowest device instead of the sum over all controllers.
+	 */
+	usb_hub_defer_scan(true);
+
 	list_for_each_entry(host, &usb_host_list, list) {
 		ret = usb_host_detect(host);
 		if (ret)
 			continue;
 	}
 
+	usb_hub_defer_scan(false);
+
 	pr_info("%d USB Device(s) found\n", dev_count);
 
 	if (IS_ENABLED(CONFIG_USB_OTGDEV)) {
@@ -513,7 +513,13 @@ static int dfu_status(struct usb_function *f, const struct usb_ctrlrequest *ctrl
 	dstat->bStatus = dfu->dfu_status;
 	dstat->bState  = dfu->dfu_state;
 	dstat->iString = 0;
-	dstat->bwPollTimeout[0] = 10;
+	/*
+	 * Downloaded blocks are only staged on the work queue and written
+	 * out while the host is busy sending the next one, so there is no
+	 * operation in progress the host would have to wait out before
+	 * polling the status again.
+	 */
+	dstat->bwPollTimeout[0] = 0;
 	dstat->bwPollTimeout[1] = 0;
 	dstat->bwPollTimeout[2] = 0;
 
@@ -545,9 +551,14 @@ static void dn_complete(struct usb_ep *ep, struct usb_request *req)
 	struct f_dfu		*dfu = req->context;
 	struct dfu_work *dw;
 
-	dw = xzalloc(sizeof(*dw));
+	/*
+	 * This runs once per downloaded block, so don't zero the embedded
+	 * staging buffer just to copy over it right away.
+	 */
+	dw = xmalloc(sizeof(*dw));
 	dw->dfu = dfu;
 	dw->task = dfu_do_write;
+	dw->rbuf = NULL;
 	dw->len = min_t(unsigned int, req->length, CONFIG_USBD_DFU_XFER_SIZE);
 	memcpy(dw->wbuf, req->buf, dw->len);
 	wq_queue_work(&dfu->wq, &dw->work);
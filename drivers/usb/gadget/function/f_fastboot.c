@@ -33,6 +33,14 @@
 
 #define EP_BUFFER_SIZE			4096
 
+/*
+ * Number of requests kept queued on the OUT endpoint during a download.
+ * With a single request the host is NAKed while the completion handler
+ * runs, with several the controller keeps receiving the next chunk in
+ * the meantime.
+ */
+#define FASTBOOT_DL_REQS		4
+
 struct f_fastboot {
 	struct fastboot fastboot;
 	struct usb_function func;
@@ -41,6 +49,9 @@ struct f_fastboot {
 	struct usb_ep *in_ep, *out_ep;
 	struct usb_request *out_req;
 	struct work_queue wq;
+
+	/* download bytes handed to the UDC so far */
+	unsigned int dl_queued;
 };
 
 static inline struct f_fastboot *func_to_fastboot(struct usb_function *f)
@@ -447,8 +458,7 @@ static int fastboot_write_usb(struct fastboot *fb, const char *buffer, unsigned
 
 static int rx_bytes_expected(struct f_fastboot *f_fb)
 {
-	int remaining = f_fb->fastboot.download_size
-		      - f_fb->fastboot.download_bytes;
+	int remaining = f_fb->fastboot.download_size - f_fb->dl_queued;
 
 	if (remaining >= EP_BUFFER_SIZE)
 		return EP_BUFFER_SIZE;
@@ -456,6 +466,22 @@ static int rx_bytes_expected(struct f_fastboot *f_fb)
 	return ALIGN(remaining, f_fb->out_ep->maxpacket);
 }
 
+static int fastboot_queue_dl_req(struct f_fastboot *f_fb,
+				 struct usb_request *req)
+{
+	unsigned int remaining = f_fb->fastboot.download_size - f_fb->dl_queued;
+	int ret;
+
+	req->length = rx_bytes_expected(f_fb);
+	req->actual = 0;
+
+	ret = usb_ep_queue(f_fb->out_ep, req);
+	if (!ret)
+		f_fb->dl_queued += min_t(unsigned int, remaining, EP_BUFFER_SIZE);
+
+	return ret;
+}
+
 static void rx_handler_dl_image(struct usb_ep *ep, struct usb_request *req)
 {
 	struct f_fastboot *f_fb = req->context;
@@ -464,6 +490,7 @@ static void rx_handler_dl_image(struct usb_ep *ep, struct usb_request *req)
 
 	if (req->status != 0) {
 		pr_err("Bad status: %d\n", req->status);
+		fastboot_free_request(ep, req);
 		return;
 	}
 
@@ -472,30 +499,64 @@ static void rx_handler_dl_image(struct usb_ep *ep, struct usb_request *req)
 	if (ret < 0) {
 		fastboot_tx_print(&f_fb->fastboot, FASTBOOT_MSG_FAIL,
 				  "%pe", ERR_PTR(ret));
+		fastboot_free_request(ep, req);
 		return;
 	}
 
-	req->length = rx_bytes_expected(f_fb);
+	/* Keep the request queued behind the others while data remains */
+	if (f_fb->dl_queued < f_fb->fastboot.download_size) {
+		if (fastboot_queue_dl_req(f_fb, req))
+			fastboot_free_request(ep, req);
+		return;
+	}
 
-	/* Check if transfer is done */
-	if (f_fb->fastboot.download_bytes >= f_fb->fastboot.download_size) {
-		req->complete = rx_handler_command;
-		req->length = EP_BUFFER_SIZE;
+	fastboot_free_request(ep, req);
 
+	/* Check if transfer is done */
+	if (f_fb->fastboot.download_bytes >= f_fb->fastboot.download_size)
 		fastboot_download_finished(&f_fb->fastboot);
-	}
-
-	req->actual = 0;
-	usb_ep_queue(ep, req);
 }
 
 static void fastboot_start_download_usb(struct fastboot *fb)
 {
 	struct f_fastboot *f_fb = container_of(fb, struct f_fastboot, fastboot);
-	struct usb_request *req = f_fb->out_req;
+	int i;
+
+	f_fb->dl_queued = 0;
+
+	/*
+	 * Queue several requests so the controller can receive the next
+	 * chunk while the completion handler writes out the previous one.
+	 * The completions arrive in queueing order, and out_req, which the
+	 * work function queues once the download command returns, stays
+	 * behind them to pick up the next command.
+	 */
+	for (i = 0; i < FASTBOOT_DL_REQS && f_fb->dl_queued < fb->download_size;
+	     i++) {
+		struct usb_request *req;
+
+		req = fastboot_alloc_request(f_fb->out_ep);
+		if (!req) {
+			if (i)
+				break;
+			fastboot_tx_print(fb, FASTBOOT_MSG_FAIL,
+					  "not enough memory");
+			return;
+		}
+
+		req->complete = rx_handler_dl_image;
+		req->context = f_fb;
+
+		if (fastboot_queue_dl_req(f_fb, req)) {
+			fastboot_free_request(f_fb->out_ep, req);
+			if (i)
+				break;
+			fastboot_tx_print(fb, FASTBOOT_MSG_FAIL,
+					  "internal error");
+			return;
+		}
+	}
 
-	req->complete = rx_handler_dl_image;
-	req->length = rx_bytes_expected(f_fb);
 	fastboot_start_download_generic(fb);
 }
 
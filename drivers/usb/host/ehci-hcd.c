@@ -65,7 +65,17 @@ struct int_queue {
 #define to_ehci(ptr) container_of(ptr, struct ehci_host, host)
 
 #define NUM_QH	2
-#define NUM_TD	3
+/*
+ * Bulk transfers are chained over several qTDs, so one submission can move
+ * much more than the five buffer pages a single qTD addresses. Each qTD is
+ * good for at least 16k with an arbitrarily aligned buffer; control
+ * transfers use at most three of them (SETUP/DATA/STATUS).
+ */
+#define NUM_TD	8
+
+/* what one qTD can take starting at the given buffer address */
+#define QTD_CAPACITY(addr) \
+	(5 * SZ_4K - ((addr) & (SZ_4K - 1)))
 
 static struct descriptor {
 	struct usb_hub_descriptor hub;
@@ -242,14 +252,9 @@ static int ehci_td_buffer(struct qTD *td, dma_addr_t addr, size_t sz)
 	return 0;
 }
 
-static int ehci_prepare_qtd(struct device *dev,
-			    struct qTD *td, uint32_t token,
-			    void *buffer, size_t length,
-			    dma_addr_t *buffer_dma,
-			    enum dma_data_direction dma_direction)
+static int ehci_init_qtd(struct qTD *td, uint32_t token,
+			 dma_addr_t addr, size_t length)
 {
-	int ret;
-
 	td->qt_next = cpu_to_hc32(QT_NEXT_TERMINATE);
 	td->qt_altnext = cpu_to_hc32(QT_NEXT_TERMINATE);
 	token |= QT_TOKEN_TOTALBYTES(length) |
@@ -257,20 +262,32 @@ static int ehci_prepare_qtd(struct device *dev,
 		QT_TOKEN_STATUS(QT_TOKEN_STATUS_ACTIVE);
 	td->qt_token = cpu_to_hc32(token);
 
+	if (length)
+		return ehci_td_buffer(td, addr, length);
+
+	memzero32(td->qt_buffer, sizeof(td->qt_buffer));
+
+	return 0;
+}
+
+static int ehci_prepare_qtd(struct device *dev,
+			    struct qTD *td, uint32_t token,
+			    void *buffer, size_t length,
+			    dma_addr_t *buffer_dma,
+			    enum dma_data_direction dma_direction)
+{
+	dma_addr_t addr = 0;
+
 	if (length) {
 		*buffer_dma = dma_map_single(dev, buffer, length,
 					     dma_direction);
 		if (dma_mapping_error(dev, *buffer_dma))
 			return -EFAULT;
 
-		ret = ehci_td_buffer(td, *buffer_dma, length);
-		if (ret)
-			return ret;
-	} else {
-		memzero32(td->qt_buffer, sizeof(td->qt_buffer));
+		addr = *buffer_dma;
 	}
 
-	return 0;
+	return ehci_init_qtd(td, token, addr, length);
 }
 
 static int ehci_enable_async_schedule(struct ehci_host *ehci, bool enable)
@@ -307,6 +324,7 @@ ehci_submit_async(struct usb_device *dev, unsigned long pipe, void *buffer,
 	uint32_t toggle;
 	bool c;
 	int ret;
+	int bulk_tds = 0;
 	uint64_t start, timeout_val;
 
 
@@ -375,41 +393,90 @@ ehci_submit_async(struct usb_device *dev, unsigned long pipe, void *buffer,
 		toggle = 1;
 	}
 
-	if (length > 0 || req == NULL) {
-		enum dma_data_direction dir;
-		unsigned int pid;
-
+	if (req != NULL && length > 0) {
 		td = &ehci->td[1];
 
-		if (dir_in) {
-			dir = DMA_FROM_DEVICE;
-			pid = QT_TOKEN_PID_IN;
-		} else {
-			dir = DMA_TO_DEVICE;
-			pid = QT_TOKEN_PID_OUT;
-		}
-
 		ret = ehci_prepare_qtd(ehci->dev,
 				       td, QT_TOKEN_DT(toggle) |
 				       /*
-					* We only want this qTD to
-					* generate an interrupt if
-					* this is a BULK
-					* request. Otherwise, we'll
-					* rely on following status
-					* stage qTD's IOC to notify us
-					* that transfer is complete
+					* No IOC here, we'll rely on the
+					* following status stage qTD's IOC to
+					* notify us that the transfer is
+					* complete
 					*/
-				       QT_TOKEN_IOC(req == NULL) |
-				       QT_TOKEN_PID(pid),
+				       QT_TOKEN_IOC(0) |
+				       QT_TOKEN_PID(dir_in ?
+						    QT_TOKEN_PID_IN :
+						    QT_TOKEN_PID_OUT),
 				       buffer, length,
-				       &buffer_dma, dir);
+				       &buffer_dma,
+				       dir_in ? DMA_FROM_DEVICE : DMA_TO_DEVICE);
 		if (ret) {
 			dev_err(ehci->dev, "unable construct DATA td\n");
 			return ret;
 		}
 		*tdp = cpu_to_hc32(ehci_td_dma(ehci, td));
 		tdp = &td->qt_next;
+	} else if (req == NULL) {
+		enum dma_data_direction dir =
+			dir_in ? DMA_FROM_DEVICE : DMA_TO_DEVICE;
+		unsigned int pid = dir_in ? QT_TOKEN_PID_IN : QT_TOKEN_PID_OUT;
+		int maxpacket = usb_maxpacket(dev, pipe);
+		size_t remaining = length;
+		dma_addr_t addr = 0;
+
+		if (length) {
+			buffer_dma = dma_map_single(ehci->dev, buffer, length,
+						    dir);
+			if (dma_mapping_error(ehci->dev, buffer_dma))
+				return -EFAULT;
+
+			addr = buffer_dma;
+		}
+
+		/*
+		 * Chain the bulk data over as many qTDs as it needs. The
+		 * controller walks the whole chain on its own, so the bus
+		 * stays busy from the first to the last packet regardless
+		 * of the transfer size.
+		 */
+		do {
+			size_t xfr_bytes = min_t(size_t, remaining,
+						 QTD_CAPACITY(addr));
+
+			if (bulk_tds == NUM_TD) {
+				dev_err(ehci->dev,
+					"bulk transfer of %d bytes exceeds %d qTDs\n",
+					length, NUM_TD);
+				ret = -EMSGSIZE;
+				goto err_unmap;
+			}
+
+			/*
+			 * All but the last qTD must end on a packet boundary,
+			 * otherwise the data toggle falls out of step with
+			 * the device.
+			 */
+			if (xfr_bytes < remaining)
+				xfr_bytes = rounddown(xfr_bytes, maxpacket);
+
+			td = &ehci->td[bulk_tds];
+
+			ret = ehci_init_qtd(td, QT_TOKEN_DT(toggle) |
+					    QT_TOKEN_IOC(xfr_bytes == remaining) |
+					    QT_TOKEN_PID(pid),
+					    addr, xfr_bytes);
+			if (ret)
+				goto err_unmap;
+
+			*tdp = cpu_to_hc32(ehci_td_dma(ehci, td));
+			tdp = &td->qt_next;
+
+			toggle ^= DIV_ROUND_UP(xfr_bytes, maxpacket) & 1;
+			addr += xfr_bytes;
+			remaining -= xfr_bytes;
+			bulk_tds++;
+		} while (remaining > 0);
 	}
 
 	if (req) {
@@ -440,14 +507,35 @@ ehci_submit_async(struct usb_device *dev, unsigned long pipe, void *buffer,
 	timeout_val = timeout_ms * MSECOND;
 	start = get_time_ns();
 	vtd = td;
-	do {
+	for (;;) {
 		token = hc32_to_cpu(vtd->qt_token);
+		if (!(token & QT_TOKEN_STATUS_ACTIVE))
+			break;
+
+		/*
+		 * A short packet or a halt stops the controller from
+		 * advancing through the bulk qTD chain, so the final qTD
+		 * polled above never retires. Both conditions show up in
+		 * the QH overlay: a halt directly, a short packet as a
+		 * retired overlay that still has bytes outstanding. In
+		 * between two qTDs the overlay is transiently inactive
+		 * with a zero byte count, which must not end the wait.
+		 */
+		if (req == NULL) {
+			uint32_t ovl = hc32_to_cpu(qh->qt_token);
+
+			if (!(ovl & QT_TOKEN_STATUS_ACTIVE) &&
+			    ((ovl & QT_TOKEN_STATUS_HALTED) ||
+			     QT_TOKEN_GET_TOTALBYTES(ovl)))
+				break;
+		}
+
 		if (is_timeout_non_interruptible(start, timeout_val)) {
 			ehci_enable_async_schedule(ehci, false);
 			ehci_writel(&qh->qt_token, 0);
 			return -ETIMEDOUT;
 		}
-	} while (token & QT_TOKEN_STATUS_ACTIVE);
+	}
 
 	if (req)
 		dma_unmap_single(ehci->dev, req_dma, sizeof(*req),
@@ -504,9 +592,32 @@ ehci_submit_async(struct usb_device *dev, unsigned long pipe, void *buffer,
 
 		break;
 	}
-	dev->act_len = length - QT_TOKEN_GET_TOTALBYTES(token);
+
+	if (req == NULL) {
+		int i;
+
+		/*
+		 * The controller writes the result back into each retired
+		 * qTD; qTDs it never reached still carry their full byte
+		 * count, so summing the residues over the whole chain gives
+		 * the number of bytes actually moved.
+		 */
+		dev->act_len = length;
+		for (i = 0; i < bulk_tds; i++) {
+			token = hc32_to_cpu(ehci->td[i].qt_token);
+			dev->act_len -= QT_TOKEN_GET_TOTALBYTES(token);
+		}
+	} else {
+		dev->act_len = length - QT_TOKEN_GET_TOTALBYTES(token);
+	}
 
 	return 0;
+
+err_unmap:
+	if (length)
+		dma_unmap_single(ehci->dev, buffer_dma, length,
+				 dir_in ? DMA_FROM_DEVICE : DMA_TO_DEVICE);
+	return ret;
 }
 
 #if defined(CONFIG_MACH_EFIKA_MX_SMARTBOOK) && defined(CONFIG_USB_ULPI)
@@ -1385,6 +1496,11 @@ struct ehci_host *ehci_register(struct device *dev, struct ehci_data *data)
 	host->submit_int_msg = submit_int_msg;
 	host->submit_control_msg = submit_control_msg;
 	host->submit_bulk_msg = submit_bulk_msg;
+	/*
+	 * Each of the NUM_TD qTDs is good for at least 16k even with an
+	 * arbitrarily aligned buffer and maxpacket rounding.
+	 */
+	host->max_transfer = NUM_TD * SZ_16K;
 
 	if (ehci->flags & EHCI_HAS_TT) {
 		ehci_reset(ehci);
@@ -24,6 +24,7 @@
 #include <init.h>
 #include <io.h>
 #include <linux/err.h>
+#include <linux/sizes.h>
 #include <linux/usb/usb.h>
 #include <linux/usb/xhci.h>
 #include <asm/unaligned.h>
@@ -1390,6 +1391,8 @@ int xhci_register(struct xhci_ctrl *ctrl)
 	host->submit_bulk_msg = xhci_submit_bulk_msg;
 	host->alloc_device = xhci_alloc_device;
 	host->update_hub_device = xhci_update_hub_device;
+	/* xhci_bulk_tx() bounces through a 64 KiB aligned buffer */
+	host->max_transfer = SZ_64K;
 
 	ret = xhci_reset(ctrl);
 	if (ret)
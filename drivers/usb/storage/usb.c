@@ -266,6 +266,11 @@ static int usb_stor_io_10(struct us_blk_dev *usb_blkdev, u8 opcode,
  * Disk driver interface
  ***********************************************************************/
 
+/*
+ * Default data phase limit for host controllers which don't state their
+ * capability. It matches what a single EHCI qTD can address with an
+ * arbitrarily aligned buffer.
+ */
 #define US_MAX_IO_BLK 32
 
 /* Read / write a chunk of sectors on media */
@@ -278,14 +283,18 @@ static int usb_stor_blk_io(struct block_device *disk_dev,
 						   blk);
 	struct us_data *us = pblk_dev->us;
 	struct device *dev = &us->pusb_dev->dev;
+	blkcnt_t max_blocks = US_MAX_IO_BLK;
 	int result;
 
-	/* ensure unit ready */
-	dev_dbg(dev, "Testing for unit ready\n");
-	if (usb_stor_test_unit_ready(pblk_dev, 0)) {
-		dev_dbg(dev, "Device NOT ready\n");
-		return -EIO;
-	}
+	/*
+	 * Issue the biggest commands the host controller accepts: every
+	 * CBW/CSW cycle costs several bulk round trips, so fewer, larger
+	 * data phases directly cut the per-sector overhead.
+	 */
+	if (us->pusb_dev->host->max_transfer)
+		max_blocks = min_t(blkcnt_t,
+				   us->pusb_dev->host->max_transfer >> SECTOR_SHIFT,
+				   0xffff);
 
 	/* read / write the requested data */
 	dev_dbg(dev, "%s %llu block(s), starting from %llu\n",
@@ -293,7 +302,7 @@ static int usb_stor_blk_io(struct block_device *disk_dev,
 		sector_count, sector_start);
 
 	while (sector_count > 0) {
-		u16 n = min_t(blkcnt_t, sector_count, US_MAX_IO_BLK);
+		u16 n = min_t(blkcnt_t, sector_count, max_blocks);
 
 		if (disk_dev->num_blocks > 0xffffffff) {
 			result = usb_stor_io_16(pblk_dev,
@@ -29,6 +29,9 @@ static int fb_ioctl(struct cdev* cdev, unsigned int req, void *data)
 	case FBIO_DISABLE:
 		ret = fb_disable(info);
 		break;
+	case FBIO_FLIP:
+		ret = fb_flip(info);
+		break;
 	default:
 		return -ENOSYS;
 	}
@@ -66,6 +69,37 @@ void fb_flush(struct fb_info *info)
 		info->fbops->fb_flush(info);
 }
 
+/**
+ * fb_flip - make the offscreen render buffer the visible one
+ * @info:	The framebuffer to flip
+ *
+ * Swaps the visible buffer and the second scanout buffer a driver has
+ * provided in screen_base_back, so a fully rendered frame becomes
+ * visible at once instead of being copied over the scanned-out buffer.
+ * Afterwards rendering continues in the previously visible buffer,
+ * which still holds the frame before the one just flipped in, so
+ * callers are expected to redraw the whole screen each frame. With the
+ * software shadow buffer enabled flipping is pointless and not done.
+ *
+ * Return: 0 on success, -ENOSYS when the driver can't flip
+ */
+int fb_flip(struct fb_info *info)
+{
+	int ret;
+
+	if (!info->screen_base_back || !info->fbops->fb_flip ||
+	    info->screen_base_shadow)
+		return -ENOSYS;
+
+	swap(info->screen_base, info->screen_base_back);
+
+	ret = info->fbops->fb_flip(info);
+	if (ret)
+		swap(info->screen_base, info->screen_base_back);
+
+	return ret;
+}
+
 static void fb_release_shadowfb(struct fb_info *info)
 {
 	free(info->screen_base_shadow);
@@ -279,8 +313,11 @@ static void fb_info(struct device *dev)
 
 void *fb_get_screen_base(struct fb_info *info)
 {
-	return info->screen_base_shadow ?
-		info->screen_base_shadow : info->screen_base;
+	if (info->screen_base_shadow)
+		return info->screen_base_shadow;
+	if (info->screen_base_back)
+		return info->screen_base_back;
+	return info->screen_base;
 }
 
 static int fb_set_shadowfb(struct param_d *p, void *priv)
@@ -76,8 +76,55 @@ struct fbc_priv {
 
 	int active;
 	int in_console;
+
+	/*
+	 * While processing a whole string the screen updates are
+	 * accumulated into one dirty rectangle which is blitted and
+	 * flushed once at the end instead of once per character.
+	 */
+	bool batch;
+	struct {
+		int x1, y1, x2, y2;
+	} dirty;
+
+	/*
+	 * Glyphs prerendered to framebuffer pixels for the current
+	 * font/color/depth combination, so drawing a character is a
+	 * row-wise memcpy instead of expanding the 1bpp font bitmap
+	 * pixel by pixel every time.
+	 */
+	struct {
+		const struct font_desc *font;
+		u32 color, bgcolor;
+		int bpp;
+		unsigned int tile_size;
+		u8 *tiles;
+		u8 valid[256];
+	} glyphs;
 };
 
+static void dirty_reset(struct fbc_priv *priv)
+{
+	priv->dirty.x1 = priv->fb->xres;
+	priv->dirty.y1 = priv->fb->yres;
+	priv->dirty.x2 = 0;
+	priv->dirty.y2 = 0;
+}
+
+static void fbc_blit(struct fbc_priv *priv, int startx, int starty,
+		     int width, int height)
+{
+	if (priv->batch) {
+		priv->dirty.x1 = min(priv->dirty.x1, startx);
+		priv->dirty.y1 = min(priv->dirty.y1, starty);
+		priv->dirty.x2 = max(priv->dirty.x2, startx + width);
+		priv->dirty.y2 = max(priv->dirty.y2, starty + height);
+		return;
+	}
+
+	gu_screen_blit_area(priv->sc, startx, starty, width, height);
+}
+
 static int fbc_getc(struct console_device *cdev)
 {
 	return 0;
@@ -109,8 +156,7 @@ static void cls(struct fbc_priv *priv)
 			adr += priv->fb->line_length;
 		}
 	}
-	gu_screen_blit_area(priv->sc, priv->margin.left, priv->margin.top,
-			    width, height);
+	fbc_blit(priv, priv->margin.left, priv->margin.top, width, height);
 }
 
 struct rgb {
@@ -136,6 +182,61 @@ static struct rgb colors[] = {
 	[BRIGHT + WHITE]	= { 255, 255, 255 },
 };
 
+static const u8 *glyph_get(struct fbc_priv *priv, int c, u32 color, u32 bgcolor)
+{
+	struct fb_info *fb = priv->fb;
+	int bpp = fb->bits_per_pixel >> 3;
+	unsigned int tile_size = priv->font->width * bpp * priv->font->height;
+	const u8 *inbuf;
+	u8 *tile;
+	int i, j;
+
+	if (priv->glyphs.font != priv->font || priv->glyphs.color != color ||
+	    priv->glyphs.bgcolor != bgcolor || priv->glyphs.bpp != bpp) {
+		if (priv->glyphs.tile_size != tile_size) {
+			free(priv->glyphs.tiles);
+			priv->glyphs.tiles = xmalloc(tile_size *
+						     ARRAY_SIZE(priv->glyphs.valid));
+			priv->glyphs.tile_size = tile_size;
+		}
+		memset(priv->glyphs.valid, 0, sizeof(priv->glyphs.valid));
+		priv->glyphs.font = priv->font;
+		priv->glyphs.color = color;
+		priv->glyphs.bgcolor = bgcolor;
+		priv->glyphs.bpp = bpp;
+	}
+
+	c = (unsigned char)c;
+
+	tile = priv->glyphs.tiles + c * tile_size;
+	if (priv->glyphs.valid[c])
+		return tile;
+
+	inbuf = priv->font->data + find_font_index(priv->font, c);
+
+	for (i = 0; i < priv->font->height; i++) {
+		u8 mask = 0x80;
+
+		for (j = 0; j < priv->font->width; j++) {
+			if (!mask) {
+				inbuf++;
+				mask = 0x80;
+			}
+
+			gu_set_pixel(fb, tile + (i * priv->font->width + j) * bpp,
+				     (*inbuf & mask) ? color : bgcolor);
+
+			mask >>= 1;
+		}
+
+		inbuf++;
+	}
+
+	priv->glyphs.valid[c] = 1;
+
+	return tile;
+}
+
 static void drawchar(struct fbc_priv *priv, int x, int y, int c)
 {
 	void *buf;
@@ -170,6 +271,28 @@ static void drawchar(struct fbc_priv *priv, int x, int y, int c)
 	rgb = &colors[bgcolor];
 	bgcolor = gu_rgb_to_pixel(priv->fb, rgb->r, rgb->g, rgb->b, 0x0);
 
+	/*
+	 * Unrotated glyphs are contiguous per row, so they can be
+	 * copied straight from the prerendered tile. The rotated
+	 * orientations keep the pixel-stepping path below.
+	 */
+	if (priv->rotation == FBCONSOLE_ROTATE_0) {
+		const u8 *tile = glyph_get(priv, c, color, bgcolor);
+		int rowlen = priv->font->width * bpp;
+
+		adr = buf;
+		adr += (priv->margin.left + x * priv->font->width) * bpp;
+		adr += (priv->margin.top + y * priv->font->height) * line_length;
+
+		for (i = 0; i < priv->font->height; i++) {
+			memcpy(adr, tile, rowlen);
+			tile += rowlen;
+			adr += line_length;
+		}
+
+		return;
+	}
+
 	adr = buf;
 
 	switch (priv->rotation) {
@@ -270,7 +393,7 @@ static void fb_blit_area(struct fbc_priv *priv, int x, int y)
 		return;
 	}
 
-	gu_screen_blit_area(priv->sc, startx, starty, width, height);
+	fbc_blit(priv, startx, starty, width, height);
 }
 
 static void video_invertchar(struct fbc_priv *priv, int x, int y)
@@ -432,8 +555,7 @@ static void fb_scroll_up(struct fbc_priv *priv)
 		break;
 	}
 
-	gu_screen_blit_area(priv->sc, priv->margin.left, priv->margin.top,
-			    width, height);
+	fbc_blit(priv, priv->margin.left, priv->margin.top, width, height);
 }
 
 static void printchar(struct fbc_priv *priv, int c)
@@ -607,16 +729,8 @@ static void fbc_parse_csi(struct fbc_priv *priv)
 	}
 }
 
-static void fbc_putc(struct console_device *cdev, char c)
+static void fbc_process(struct fbc_priv *priv, char c)
 {
-	struct fbc_priv *priv = container_of(cdev,
-					struct fbc_priv, cdev);
-	struct fb_info *fb = priv->fb;
-
-	if (priv->in_console)
-		return;
-	priv->in_console = 1;
-
 	switch (priv->state) {
 	case LIT:
 		switch (c) {
@@ -669,9 +783,57 @@ static void fbc_putc(struct console_device *cdev, char c)
 		break;
 
 	}
+}
+
+static void fbc_putc(struct console_device *cdev, char c)
+{
+	struct fbc_priv *priv = container_of(cdev,
+					struct fbc_priv, cdev);
+
+	if (priv->in_console)
+		return;
+	priv->in_console = 1;
+
+	fbc_process(priv, c);
+
 	priv->in_console = 0;
 
-	fb_flush(fb);
+	fb_flush(priv->fb);
+}
+
+static int fbc_puts(struct console_device *cdev, const char *s, size_t nbytes)
+{
+	struct fbc_priv *priv = container_of(cdev,
+					struct fbc_priv, cdev);
+	size_t i;
+
+	if (priv->in_console)
+		return nbytes;
+	priv->in_console = 1;
+
+	priv->batch = true;
+	dirty_reset(priv);
+
+	for (i = 0; i < nbytes; i++) {
+		/* the per-character fallback inserts this for us */
+		if (s[i] == '\n')
+			fbc_process(priv, '\r');
+
+		fbc_process(priv, s[i]);
+	}
+
+	priv->batch = false;
+
+	if (priv->dirty.x2 > priv->dirty.x1)
+		gu_screen_blit_area(priv->sc, priv->dirty.x1, priv->dirty.y1,
+				    priv->dirty.x2 - priv->dirty.x1,
+				    priv->dirty.y2 - priv->dirty.y1);
+
+	priv->in_console = 0;
+
+	fb_flush(priv->fb);
+
+	return nbytes;
 }
 
 static int setup_font(struct fbc_priv *priv)
@@ -841,6 +1003,7 @@ int register_fbconsole(struct fb_info *fb)
 	cdev->dev = &fb->dev;
 	cdev->tstc = fbc_tstc;
 	cdev->putc = fbc_putc;
+	cdev->puts = fbc_puts;
 	cdev->getc = fbc_getc;
 	cdev->devname = basprintf("fbconsole%s", fbname);
 	cdev->devid = DEVICE_ID_SINGLE;
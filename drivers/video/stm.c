@@ -345,6 +345,14 @@ static int stmfb_activate_var(struct fb_info *fb_info)
 		if (!fb_info->screen_base)
 			return -ENOMEM;
 		fbi->memory_size = size;
+
+		/*
+		 * A second scanout buffer allows tear-free page flips.
+		 * Losing it is no error, we just fall back to single
+		 * buffering then.
+		 */
+		fb_info->screen_base_back = dma_alloc_writecombine(DMA_DEVICE_BROKEN,
+								   size, DMA_ADDRESS_BROKEN);
 	}
 
 	/** @todo ensure HCLK is active at this point of time! */
@@ -490,6 +498,21 @@ static int stmfb_activate_var(struct fb_info *fb_info)
 	return 0;
 }
 
+static int stmfb_flip(struct fb_info *fb_info)
+{
+	struct imxfb_info *fbi = fb_info->priv;
+
+	/*
+	 * NEXT_BUF is latched into CUR_BUF at the end of the current
+	 * frame, so the buffer switch is synchronized to the vertical
+	 * refresh by the hardware.
+	 */
+	writel((uintptr_t)fb_info->screen_base,
+	       fbi->base + fbi->devdata->next_buf);
+
+	return 0;
+}
+
 /*
  * There is only one video hardware instance available.
  * It makes no sense to dynamically allocate this data
@@ -498,6 +521,7 @@ static struct fb_ops imxfb_ops = {
 	.fb_activate_var = stmfb_activate_var,
 	.fb_enable = stmfb_enable_controller,
 	.fb_disable = stmfb_disable_controller,
+	.fb_flip = stmfb_flip,
 };
 
 static struct imxfb_info fbi = {
@@ -58,6 +58,27 @@ static void vring_unmap_one(struct virtqueue *vq,
 		       DMA_FROM_DEVICE : DMA_TO_DEVICE);
 }
 
+/*
+ * Allocate an indirect descriptor table with the entries already chained
+ * together, like the free list of the ring itself.
+ */
+static struct vring_desc *alloc_indirect(struct virtqueue *vq,
+					 unsigned int total_sg)
+{
+	struct vring_desc *desc;
+	unsigned int i;
+
+	desc = memalign(VRING_DESC_ALIGN_SIZE,
+			total_sg * sizeof(struct vring_desc));
+	if (!desc)
+		return NULL;
+
+	for (i = 0; i < total_sg; i++)
+		desc[i].next = cpu_to_virtio16(vq->vdev, i + 1);
+
+	return desc;
+}
+
 int virtqueue_add_sgs(struct virtqueue *vq, struct scatterlist *sgs[],
 		      unsigned int out_sgs, unsigned int in_sgs,
 		      void *data)
@@ -66,6 +87,7 @@ int virtqueue_add_sgs(struct virtqueue *vq, struct scatterlist *sgs[],
 	unsigned int total_sg = out_sgs + in_sgs;
 	struct scatterlist *sg;
 	unsigned int i, err_idx, n, avail, descs_used, uninitialized_var(prev);
+	bool indirect;
 	int head;
 
 	WARN_ON(total_sg == 0);
@@ -73,9 +95,23 @@ int virtqueue_add_sgs(struct virtqueue *vq, struct scatterlist *sgs[],
 
 	head = vq->free_head;
 
-	desc = vq->vring.desc;
-	i = head;
-	descs_used = total_sg;
+	if (virtio_has_feature(vq->vdev, VIRTIO_RING_F_INDIRECT_DESC) &&
+	    total_sg > 1)
+		desc = alloc_indirect(vq, total_sg);
+	else
+		desc = NULL;
+
+	if (desc) {
+		/* The whole chain occupies a single ring slot */
+		indirect = true;
+		i = 0;
+		descs_used = 1;
+	} else {
+		indirect = false;
+		desc = vq->vring.desc;
+		i = head;
+		descs_used = total_sg;
+	}
 
 	if (vq->num_free < descs_used) {
 		vq_debug(vq, "Can't add buf len %i - avail = %i\n",
@@ -87,6 +123,8 @@ int virtqueue_add_sgs(struct virtqueue *vq, struct scatterlist *sgs[],
 		 */
 		if (out_sgs)
 			virtio_notify(vq->vdev, vq);
+		if (indirect)
+			free(desc);
 		return -ENOSPC;
 	}
 
@@ -125,14 +163,34 @@ int virtqueue_add_sgs(struct virtqueue *vq, struct scatterlist *sgs[],
 	/* Last one doesn't continue */
 	desc[prev].flags &= cpu_to_virtio16(vq->vdev, ~VRING_DESC_F_NEXT);
 
+	if (indirect) {
+		/* Point the ring descriptor at the table */
+		dma_addr_t addr = dma_map_single(vring_dma_dev(vq), desc,
+				total_sg * sizeof(struct vring_desc),
+				DMA_TO_DEVICE);
+		if (vring_mapping_error(vq, addr))
+			goto unmap_release;
+
+		vq->vring.desc[head].flags = cpu_to_virtio16(vq->vdev,
+						VRING_DESC_F_INDIRECT);
+		vq->vring.desc[head].addr = cpu_to_virtio64(vq->vdev, addr);
+		vq->vring.desc[head].len = cpu_to_virtio32(vq->vdev,
+				total_sg * sizeof(struct vring_desc));
+	}
+
 	/* We're using some buffers from the free list. */
 	vq->num_free -= descs_used;
 
 	/* Update free pointer */
-	vq->free_head = i;
+	if (indirect)
+		vq->free_head = virtio16_to_cpu(vq->vdev,
+						vq->vring.desc[head].next);
+	else
+		vq->free_head = i;
 
-	/* Store token. */
+	/* Store token and the indirect table, if any. */
 	vq->desc_state[head].data = data;
+	vq->desc_state[head].indir_desc = indirect ? desc : NULL;
 
 	/*
 	 * Put entry in available array (but don't update avail->idx
@@ -161,6 +219,7 @@ int virtqueue_add_sgs(struct virtqueue *vq, struct scatterlist *sgs[],
 
 unmap_release:
 	err_idx = i;
+	i = indirect ? 0 : head;
 
 	for (n = 0; n < total_sg; n++) {
 		if (i == err_idx)
@@ -169,6 +228,9 @@ unmap_release:
 		i = virtio16_to_cpu(vq->vdev, desc[i].next);
 	}
 
+	if (indirect)
+		free(desc);
+
 	return -ENOMEM;
 
 }
@@ -207,6 +269,7 @@ void virtqueue_kick(struct virtqueue *vq)
 
 static void detach_buf(struct virtqueue *vq, unsigned int head)
 {
+	struct vring_desc *indir_desc = vq->desc_state[head].indir_desc;
 	unsigned int i;
 	__virtio16 nextflag = cpu_to_virtio16(vq->vdev, VRING_DESC_F_NEXT);
 
@@ -228,6 +291,16 @@ static void detach_buf(struct virtqueue *vq, unsigned int head)
 
 	/* Plus final descriptor */
 	vq->num_free++;
+
+	if (indir_desc) {
+		u32 len = virtio32_to_cpu(vq->vdev, vq->vring.desc[head].len);
+
+		for (i = 0; i < len / sizeof(struct vring_desc); i++)
+			vring_unmap_one(vq, &indir_desc[i]);
+
+		free(indir_desc);
+		vq->desc_state[head].indir_desc = NULL;
+	}
 }
 
 static inline bool more_used(const struct virtqueue *vq)
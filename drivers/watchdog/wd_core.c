@@ -91,22 +91,43 @@ static int watchdog_set_priority(struct param_d *param, void *priv)
 	return 0;
 }
 
+static void watchdog_poller_start(struct watchdog *wd);
+
 static int watchdog_set_cur(struct param_d *param, void *priv)
 {
 	struct watchdog *wd = priv;
+	int ret;
+
+	ret = watchdog_set_timeout(wd, wd->timeout_cur);
+	if (ret)
+		return ret;
 
-	return watchdog_set_timeout(wd, wd->timeout_cur);
+	/* the ping interval is derived from the timeout, so reschedule */
+	if (IS_ENABLED(CONFIG_WATCHDOG_POLLER) && wd->poller_enable)
+		watchdog_poller_start(wd);
+
+	return 0;
 }
 
 static void watchdog_poller_cb(void *priv);
 
 static void watchdog_poller_start(struct watchdog *wd)
 {
-	watchdog_ping(wd);
+	uint64_t interval = 500 * MSECOND;
 
-	poller_call_async(&wd->poller, 500 * MSECOND,
-			watchdog_poller_cb, wd);
+	watchdog_ping(wd);
 
+	/*
+	 * Ping again once half of the configured timeout has elapsed
+	 * instead of on a fixed fast tick. The poller deadline then keeps
+	 * the watchdog out of tight I/O loops entirely while still leaving
+	 * half the timeout as safety margin.
+	 */
+	if (wd->timeout_cur)
+		interval = max_t(uint64_t, interval,
+				 (uint64_t)wd->timeout_cur * SECOND / 2);
+
+	poller_call_async(&wd->poller, interval, watchdog_poller_cb, wd);
 }
 
 static void watchdog_poller_cb(void *priv)
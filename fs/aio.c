@@ -0,0 +1,117 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * aio.c - asynchronous file I/O on top of the VFS
+ *
+ * Requests are handed to a short-lived bthread that performs the
+ * ordinary synchronous VFS call. The overlap comes from the driver
+ * wait loops: they yield() back to the submitter while the hardware
+ * works, so the caller can process one buffer while the next one is
+ * transferred. On drivers that never yield a request simply completes
+ * synchronously during the first wait.
+ */
+
+#include <common.h>
+#include <aio.h>
+#include <bthread.h>
+#include <errno.h>
+#include <fs.h>
+#include <sched.h>
+
+static void aio_read_thread(void *data)
+{
+	struct aio_request *req = data;
+
+	req->ret = pread(req->fd, req->buf, req->count, req->offset);
+	req->done = true;
+
+	if (req->complete)
+		req->complete(req);
+}
+
+static void aio_write_thread(void *data)
+{
+	struct aio_request *req = data;
+
+	req->ret = pwrite(req->fd, req->buf, req->count, req->offset);
+	req->done = true;
+
+	if (req->complete)
+		req->complete(req);
+}
+
+static int aio_submit(struct aio_request *req, void (*threadfn)(void *))
+{
+	req->done = false;
+	req->ret = -EINPROGRESS;
+
+	req->bthread = bthread_run(threadfn, req, "aio.%d", req->fd);
+	if (!req->bthread)
+		return -ENOMEM;
+
+	/*
+	 * The worker runs to completion regardless; marking it canceled
+	 * up front makes the scheduler reclaim it afterwards, so
+	 * completion-callback users need not wait on the request.
+	 */
+	bthread_cancel(req->bthread);
+
+	return 0;
+}
+
+/**
+ * aio_read - submit an asynchronous read
+ * @req: the request, filled in by the caller
+ *
+ * Returns 0 if the request was submitted, a negative error code
+ * otherwise. Completion is signalled through req->complete and
+ * aio_is_done()/aio_wait().
+ */
+int aio_read(struct aio_request *req)
+{
+	return aio_submit(req, aio_read_thread);
+}
+EXPORT_SYMBOL(aio_read);
+
+/**
+ * aio_write - submit an asynchronous write
+ * @req: the request, filled in by the caller
+ *
+ * Returns 0 if the request was submitted, a negative error code
+ * otherwise.
+ */
+int aio_write(struct aio_request *req)
+{
+	return aio_submit(req, aio_write_thread);
+}
+EXPORT_SYMBOL(aio_write);
+
+/**
+ * aio_is_done - poll a request for completion
+ * @req: an in-flight request
+ *
+ * Gives the request a chance to make progress and returns true once
+ * it is done and req->ret is valid.
+ */
+bool aio_is_done(struct aio_request *req)
+{
+	if (!req->done)
+		yield();
+
+	return req->done;
+}
+EXPORT_SYMBOL(aio_is_done);
+
+/**
+ * aio_wait - wait for a request to complete
+ * @req: an in-flight request
+ *
+ * Returns the number of bytes transferred or a negative error code.
+ */
+ssize_t aio_wait(struct aio_request *req)
+{
+	while (!req->done)
+		yield();
+
+	return req->ret;
+}
+EXPORT_SYMBOL(aio_wait);
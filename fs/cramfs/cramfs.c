@@ -33,6 +33,7 @@
 #include <xfuncs.h>
 
 #include <asm/byteorder.h>
+#include <linux/list.h>
 #include <linux/stat.h>
 #include <linux/magic.h>
 #include <cramfs/cramfs_fs.h>
@@ -42,11 +43,24 @@
 #define CRAMINO(x)	(CRAMFS_GET_OFFSET(x) ? CRAMFS_GET_OFFSET(x)<<2 : 1)
 #define OFFSET(x)	((x)->i_ino)
 
+/*
+ * Sequential reads crossing block boundaries and re-opened files hit
+ * the same blocks again and again, so keep the last few decompressed
+ * blocks around instead of only the most recent one.
+ */
+#define CRAMFS_CACHE_BLOCKS	8
+
+struct cramfs_block {
+	struct list_head list;
+	int base;		/* device offset of the compressed block, -1 if unused */
+	size_t len;
+	char data[4096];
+};
+
 struct cramfs_priv {
 	struct cramfs_super super;
-	int curr_base;
-	char buf[4096];
-	size_t curr_block_len;
+	struct list_head block_lru;	/* most recently used first */
+	struct cramfs_block blocks[CRAMFS_CACHE_BLOCKS];
 	struct cdev *cdev;
 };
 
@@ -113,6 +127,34 @@ static int cramfs_read_super(struct cramfs_priv *priv)
 	return 0;
 }
 
+static struct cramfs_block *cramfs_get_block(struct cramfs_priv *priv,
+					     uint32_t base)
+{
+	static char cramfs_read_buf[4096];
+	struct cramfs_block *block;
+
+	list_for_each_entry(block, &priv->block_lru, list) {
+		if (block->base == base)
+			goto out;
+	}
+
+	/* miss: decompress into the least recently used block */
+	block = list_last_entry(&priv->block_lru, struct cramfs_block, list);
+	block->base = -1;
+
+	cdev_read(priv->cdev, cramfs_read_buf, 4096, base, 0);
+	block->len = cramfs_uncompress_block(block->data, 4096,
+			cramfs_read_buf, 4096);
+	if ((ssize_t)block->len <= 0)
+		return NULL;
+
+	block->base = base;
+out:
+	list_move(&block->list, &priv->block_lru);
+
+	return block;
+}
+
 static int cramfs_read_file(struct inode *inode, unsigned long offset,
 			    void *buf, size_t size)
 {
@@ -124,9 +166,9 @@ static int cramfs_read_file(struct inode *inode, unsigned long offset,
 	unsigned int blocknr;
 	int outsize = 0;
 	int ofs = offset % 4096;
-	static char cramfs_read_buf[4096];
 
 	while (size) {
+		struct cramfs_block *block;
 		uint32_t base;
 		int copy;
 
@@ -138,20 +180,13 @@ static int cramfs_read_file(struct inode *inode, unsigned long offset,
 			base = (CRAMFS_GET_OFFSET(cramfs_inode) +
 				(((CRAMFS_24 (cramfs_inode->size)) + 4095) >> 12)) << 2;
 
-		if (priv->curr_base < 0 || priv->curr_base != base) {
-
-			cdev_read(priv->cdev, cramfs_read_buf, 4096, base, 0);
-			priv->curr_block_len = cramfs_uncompress_block(priv->buf, 4096,
-					cramfs_read_buf, 4096);
-			if (priv->curr_block_len <= 0)
-				break;
-
-			priv->curr_base = base;
-		}
+		block = cramfs_get_block(priv, base);
+		if (!block)
+			break;
 
-		copy = min(priv->curr_block_len, size);
+		copy = min(block->len, size);
 
-		memcpy(buf, priv->buf + ofs, copy);
+		memcpy(buf, block->data + ofs, copy);
 		ofs = 0;
 
 		outsize += copy;
@@ -452,7 +487,7 @@ static int cramfs_probe(struct device *dev)
 {
 	struct fs_device *fsdev;
 	struct cramfs_priv *priv;
-	int ret;
+	int i, ret;
 	struct super_block *sb;
 	struct inode *root;
 
@@ -475,7 +510,11 @@ static int cramfs_probe(struct device *dev)
 		ret =  -EINVAL;
 	}
 
-	priv->curr_base = -1;
+	INIT_LIST_HEAD(&priv->block_lru);
+	for (i = 0; i < CRAMFS_CACHE_BLOCKS; i++) {
+		priv->blocks[i].base = -1;
+		list_add(&priv->blocks[i].list, &priv->block_lru);
+	}
 
 	cramfs_uncompress_init ();
 
@@ -26,12 +26,29 @@
 #include <linux/fs.h>
 #include <linux/mtd/mtd.h>
 #include <unistd.h>
+#include <qsort.h>
 #include <range.h>
 #include <fs.h>
 #include <spec/dps.h>
 
 LIST_HEAD(cdev_list);
 
+#define CDEV_HASH_BITS	7
+#define CDEV_HASH_SIZE	(1 << CDEV_HASH_BITS)
+
+/* Registered cdevs hashed by name, so opens don't scan the whole list */
+static struct hlist_head cdev_hash[CDEV_HASH_SIZE];
+
+static struct hlist_head *cdev_hash_bucket(const char *name)
+{
+	unsigned int hash = 5381;
+
+	while (*name)
+		hash = hash * 33 + (unsigned char)*name++;
+
+	return &cdev_hash[hash & (CDEV_HASH_SIZE - 1)];
+}
+
 #ifdef CONFIG_AUTO_COMPLETE
 int devfs_partition_complete(struct string_list *sl, char *instr)
 {
@@ -68,7 +85,7 @@ struct cdev *lcdev_by_name(const char *filename)
 {
 	struct cdev *cdev;
 
-	for_each_cdev(cdev) {
+	hlist_for_each_entry(cdev, cdev_hash_bucket(filename), name_hash) {
 		if (!strcmp(cdev->name, filename))
 			return cdev;
 	}
@@ -326,6 +343,49 @@ ssize_t cdev_read(struct cdev *cdev, void *buf, size_t count, loff_t offset, ulo
 	return cdev->ops->read(master, buf, count, cdev->offset +offset, flags);
 }
 
+static int io_segment_compare(const void *a, const void *b)
+{
+	const struct io_segment *seg_a = a, *seg_b = b;
+
+	if (seg_a->offset < seg_b->offset)
+		return -1;
+
+	return seg_a->offset > seg_b->offset;
+}
+
+/**
+ * cdev_readv - gather read from a cdev
+ * @cdev: the cdev to read from
+ * @segs: the segments to read, sorted by offset in place
+ * @nsegs: number of segments
+ *
+ * Read multiple ranges in one pass over the medium: the segments are
+ * sorted by offset first, which keeps seeks short and read buffering
+ * effective. Returns the total number of bytes read, which is less
+ * than requested when a segment read came up short, or a negative
+ * error code.
+ */
+ssize_t cdev_readv(struct cdev *cdev, struct io_segment *segs, unsigned int nsegs)
+{
+	ssize_t ret, total = 0;
+	unsigned int i;
+
+	qsort(segs, nsegs, sizeof(*segs), io_segment_compare);
+
+	for (i = 0; i < nsegs; i++) {
+		ret = cdev_read(cdev, segs[i].buf, segs[i].count,
+				segs[i].offset, 0);
+		if (ret < 0)
+			return ret;
+
+		total += ret;
+		if ((size_t)ret < segs[i].count)
+			break;
+	}
+
+	return total;
+}
+
 ssize_t cdev_write(struct cdev *cdev, const void *buf, size_t count, loff_t offset, ulong flags)
 {
 	struct cdev *master = cdev_get_master(cdev);
@@ -464,6 +524,7 @@ int devfs_create(struct cdev *new)
 	INIT_LIST_HEAD(&new->partitions);
 
 	list_add_tail(&new->list, &cdev_list);
+	hlist_add_head(&new->name_hash, cdev_hash_bucket(new->name));
 	if (new->dev) {
 		list_add_tail(&new->devices_list, &new->dev->cdevs);
 		if (!new->device_node)
@@ -520,6 +581,7 @@ int devfs_remove(struct cdev *cdev)
 		return -EBUSY;
 
 	list_del(&cdev->list);
+	hlist_del(&cdev->name_hash);
 
 	if (cdev->dev)
 		list_del(&cdev->devices_list);
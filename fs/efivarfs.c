@@ -36,6 +36,12 @@ struct efivarfs_inode {
 	efi_guid_t vendor;
 	char *full_name; /* name including vendor namespacing */
 	struct list_head node;
+
+	/* contents as read from the firmware, valid when cached is true */
+	void *buf;
+	size_t size;
+	u32 attributes;
+	bool cached;
 };
 
 struct efivarfs_dir {
@@ -47,6 +53,67 @@ struct efivarfs_priv {
 	struct list_head inodes;
 };
 
+static struct efivarfs_inode *efivarfs_get_inode(struct efivarfs_priv *priv,
+						 const char *pathname)
+{
+	struct efivarfs_inode *inode;
+
+	if (pathname[0] == '/')
+		pathname++;
+
+	list_for_each_entry(inode, &priv->inodes, node)
+		if (!strcmp(inode->full_name, pathname))
+			return inode;
+
+	return NULL;
+}
+
+/*
+ * Read the variable contents from the firmware once and keep them in the
+ * inode. All subsequent opens and stats are served from the cache, which
+ * saves two slow firmware round trips per access. Writes go through to the
+ * firmware and update the cache, so it only goes stale when the variable
+ * is modified behind our back. Remounting rebuilds the cache.
+ */
+static int efivarfs_inode_load(struct efivarfs_inode *inode)
+{
+	efi_status_t efiret;
+
+	if (inode->cached)
+		return 0;
+
+	inode->size = 0;
+
+	efiret = RT->get_variable(inode->name, &inode->vendor,
+				  NULL, &inode->size, NULL);
+	if (EFI_ERROR(efiret) && efiret != EFI_BUFFER_TOO_SMALL)
+		return -efi_errno(efiret);
+
+	inode->buf = malloc(inode->size);
+	if (!inode->buf)
+		return -ENOMEM;
+
+	efiret = RT->get_variable(inode->name, &inode->vendor,
+				  &inode->attributes, &inode->size,
+				  inode->buf);
+	if (EFI_ERROR(efiret)) {
+		free(inode->buf);
+		inode->buf = NULL;
+		return -efi_errno(efiret);
+	}
+
+	inode->cached = true;
+
+	return 0;
+}
+
+static void efivarfs_inode_invalidate(struct efivarfs_inode *inode)
+{
+	free(inode->buf);
+	inode->buf = NULL;
+	inode->cached = false;
+}
+
 static int efivars_create(struct device *dev, const char *pathname,
 			  mode_t mode)
 {
@@ -110,6 +177,7 @@ static int efivars_unlink(struct device *dev, const char *pathname)
 			if (EFI_ERROR(efiret))
 				return -efi_errno(efiret);
 			list_del(&inode->node);
+			efivarfs_inode_invalidate(inode);
 			free(inode);
 		}
 	}
@@ -123,40 +191,42 @@ struct efivars_file {
 	efi_guid_t vendor;
 	s16 *name;
 	u32 attributes;
+	struct efivarfs_inode *inode;
 };
 
 static int efivarfs_open(struct device *dev, struct file *f, const char *filename)
 {
+	struct efivarfs_priv *priv = dev->priv;
 	struct efivars_file *efile;
-	efi_status_t efiret;
 	int ret;
 
 	efile = xzalloc(sizeof(*efile));
 
 	ret = efivarfs_parse_filename(filename, &efile->vendor, &efile->name);
-	if (ret)
+	if (ret) {
+		free(efile);
 		return -ENOENT;
+	}
 
-	efiret = RT->get_variable(efile->name, &efile->vendor,
-				  NULL, &efile->size, NULL);
-	if (EFI_ERROR(efiret) && efiret != EFI_BUFFER_TOO_SMALL) {
-		ret = -efi_errno(efiret);
+	efile->inode = efivarfs_get_inode(priv, filename);
+	if (!efile->inode) {
+		ret = -ENOENT;
 		goto out;
 	}
 
+	ret = efivarfs_inode_load(efile->inode);
+	if (ret)
+		goto out;
+
+	efile->size = efile->inode->size;
+	efile->attributes = efile->inode->attributes;
 	efile->buf = malloc(efile->size);
 	if (!efile->buf) {
 		ret = -ENOMEM;
 		goto out;
 	}
 
-	efiret = RT->get_variable(efile->name, &efile->vendor,
-				  &efile->attributes, &efile->size,
-				  efile->buf);
-	if (EFI_ERROR(efiret)) {
-		ret = -efi_errno(efiret);
-		goto out;
-	}
+	memcpy(efile->buf, efile->inode->buf, efile->size);
 
 	f->f_size = efile->size;
 	f->private_data = efile;
@@ -164,7 +234,7 @@ static int efivarfs_open(struct device *dev, struct file *f, const char *filenam
 	return 0;
 
 out:
-	free(efile->buf);
+	free(efile->name);
 	free(efile);
 
 	return ret;
@@ -175,11 +245,23 @@ static int efivarfs_close(struct device *dev, struct file *f)
 	struct efivars_file *efile = f->private_data;
 
 	free(efile->buf);
+	free(efile->name);
 	free(efile);
 
 	return 0;
 }
 
+static void efivarfs_inode_update(struct efivars_file *efile)
+{
+	struct efivarfs_inode *inode = efile->inode;
+
+	free(inode->buf);
+	inode->buf = xmemdup(efile->buf, efile->size);
+	inode->size = efile->size;
+	inode->attributes = efile->attributes;
+	inode->cached = true;
+}
+
 static int efivarfs_read(struct file *f, void *buf, size_t insize)
 {
 	struct efivars_file *efile = f->private_data;
@@ -207,6 +289,8 @@ static int efivarfs_write(struct file *f, const void *buf, size_t insize)
 	if (EFI_ERROR(efiret))
 		return -efi_errno(efiret);
 
+	efivarfs_inode_update(efile);
+
 	return insize;
 }
 
@@ -224,6 +308,8 @@ static int efivarfs_truncate(struct file *f, loff_t size)
 	if (EFI_ERROR(efiret))
 		return -efi_errno(efiret);
 
+	efivarfs_inode_update(efile);
+
 	return 0;
 }
 
@@ -268,25 +354,20 @@ static int efivarfs_closedir(struct device *dev, DIR *dir)
 static int efivarfs_stat(struct device *dev, const char *filename,
 			 struct stat *s)
 {
-	efi_guid_t vendor;
-	s16 *name;
-	efi_status_t efiret;
-	size_t size = 0;
+	struct efivarfs_priv *priv = dev->priv;
+	struct efivarfs_inode *inode;
 	int ret;
 
-	ret = efivarfs_parse_filename(filename, &vendor, &name);
-	if (ret)
+	inode = efivarfs_get_inode(priv, filename);
+	if (!inode)
 		return -ENOENT;
 
-	efiret = RT->get_variable(name, &vendor, NULL, &size, NULL);
-
-	free(name);
-
-	if (EFI_ERROR(efiret) && efiret != EFI_BUFFER_TOO_SMALL)
-		return -efi_errno(efiret);
+	ret = efivarfs_inode_load(inode);
+	if (ret)
+		return ret;
 
 	s->st_mode = 00666 | S_IFREG;
-	s->st_size = size;
+	s->st_size = inode->size;
 
 	return 0;
 }
@@ -336,6 +417,8 @@ static void efivarfs_remove(struct device *dev)
 	struct efivarfs_inode *inode, *tmp;
 
 	list_for_each_entry_safe(inode, tmp, &priv->inodes, node) {
+		free(inode->buf);
+		free(inode->full_name);
 		free(inode->name);
 		free(inode);
 	}
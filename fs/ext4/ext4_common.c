@@ -267,6 +267,89 @@ long int read_allocated_block(struct ext2fs_node *node, int fileblock)
 	return blknr;
 }
 
+/*
+ * Map a file block to its physical block like read_allocated_block(),
+ * but additionally return in 'run' how many file blocks starting at
+ * 'fileblock' are physically contiguous (or part of the same hole).
+ * The containing extent is cached in the node, so sequential mappings
+ * do not traverse the extent tree again.
+ */
+long int read_allocated_extent(struct ext2fs_node *node, int fileblock,
+			       uint32_t *run)
+{
+	struct ext4_extent_cache *cache = &node->ext_cache;
+	struct ext2_inode *inode = &node->inode;
+	struct ext2_data *data = node->data;
+	int log2_blksz = LOG2_EXT2_BLOCK_SIZE(data);
+	int blksz = EXT2_BLOCK_SIZE(data);
+	unsigned long long start;
+
+	if (cache->len && fileblock >= cache->start &&
+	    fileblock < cache->start + cache->len) {
+		*run = cache->start + cache->len - fileblock;
+		if (!cache->pstart)
+			return 0;
+		return (fileblock - cache->start) + cache->pstart;
+	}
+
+	if (le32_to_cpu(inode->flags) & EXT4_EXTENTS_FL) {
+		long int startblock, endblock;
+		char *buf = zalloc(blksz);
+		struct ext4_extent_header *ext_block;
+		struct ext4_extent *extent;
+		int i;
+
+		if (!buf)
+			return -ENOMEM;
+
+		ext_block = ext4fs_get_extent_block(data, buf,
+				(struct ext4_extent_header *)inode->b.blocks.dir_blocks,
+				fileblock, log2_blksz);
+		if (!ext_block) {
+			pr_err("invalid extent block\n");
+			free(buf);
+			return -EINVAL;
+		}
+
+		extent = (struct ext4_extent *)(ext_block + 1);
+
+		for (i = 0; i < le16_to_cpu(ext_block->eh_entries); i++) {
+			startblock = le32_to_cpu(extent[i].ee_block);
+			endblock = startblock + le16_to_cpu(extent[i].ee_len);
+
+			if (startblock > fileblock) {
+				/* Sparse file */
+				cache->start = fileblock;
+				cache->len = startblock - fileblock;
+				cache->pstart = 0;
+				*run = cache->len;
+				free(buf);
+				return 0;
+			}
+
+			if (fileblock < endblock) {
+				start = le16_to_cpu(extent[i].ee_start_hi);
+				start = (start << 32) +
+					le32_to_cpu(extent[i].ee_start_lo);
+				cache->start = startblock;
+				cache->len = endblock - startblock;
+				cache->pstart = start;
+				*run = endblock - fileblock;
+				free(buf);
+				return (fileblock - startblock) + start;
+			}
+		}
+
+		free(buf);
+		*run = 1;
+		return 0;
+	}
+
+	/* The indirect block scheme carries no run information */
+	*run = 1;
+	return read_allocated_block(node, fileblock);
+}
+
 int ext4fs_iterate_dir(struct ext2fs_node *dir, char *name,
 				struct ext2fs_node **fnode, int *ftype)
 {
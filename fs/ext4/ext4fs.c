@@ -68,42 +68,43 @@ loff_t ext4fs_read_file(struct ext2fs_node *node, loff_t pos,
 
 	blockcnt = ((len + pos) + blocksize - 1) >> blockshift;
 
-	for (i = pos >> blockshift; i < blockcnt; i++) {
+	/*
+	 * Map whole extents at once and issue a single read per run of
+	 * physically contiguous blocks instead of resolving and reading
+	 * every file block separately.
+	 */
+	i = pos >> blockshift;
+	while (i < blockcnt) {
 		sector_t blknr;
-		loff_t blockoff = pos - (blocksize * i);
-		loff_t blockend = blocksize;
-		loff_t skipfirst = 0;
+		uint32_t run;
+		loff_t start, end;
+		long int blk;
 
-		ret = read_allocated_block(node, i);
-		if (ret < 0)
-			return ret;
+		blk = read_allocated_extent(node, i, &run);
+		if (blk < 0)
+			return blk;
 
-		blknr = ret << log2blocksize;
+		blknr = (sector_t)blk << log2blocksize;
 
-		/* Last block.  */
-		if (i == blockcnt - 1) {
-			blockend = (len + pos) - (blocksize * i);
+		if (i + run > blockcnt)
+			run = blockcnt - i;
 
-			/* The last portion is exactly blocksize. */
-			if (!blockend)
-				blockend = blocksize;
-		}
-
-		/* First block. */
-		if (i == pos >> blockshift) {
-			skipfirst = blockoff;
-			blockend -= skipfirst;
-		}
+		/* byte range covered by this run, clipped to the request */
+		start = max_t(loff_t, pos, i << blockshift);
+		end = min_t(loff_t, pos + len, (i + run) << blockshift);
 
 		if (blknr) {
-			ret = ext4fs_devread(fs, blknr, skipfirst, blockend, buf);
+			ret = ext4fs_devread(fs, blknr,
+					     start - (i << blockshift),
+					     end - start, buf + (start - pos));
 			if (ret)
 				return ret;
 		} else {
-			memset(buf, 0, blockend);
+			/* Sparse hole */
+			memset(buf + (start - pos), 0, end - start);
 		}
 
-		buf += blocksize - skipfirst;
+		i += run;
 	}
 
 	return len;
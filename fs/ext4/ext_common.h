@@ -209,12 +209,20 @@ struct ext2_dirent {
 	__u8 filetype;
 };
 
+/* one cached logical to physical extent mapping */
+struct ext4_extent_cache {
+	uint32_t start;		/* first file block of the run */
+	uint32_t len;		/* run length in blocks, 0 when invalid */
+	sector_t pstart;	/* physical start block, 0 for a hole */
+};
+
 struct ext2fs_node {
 	struct inode i;
 	struct ext2_data *data;
 	struct ext2_inode inode;
 	int ino;
 	int inode_read;
+	struct ext4_extent_cache ext_cache;
 };
 
 struct ext4fs_indir_block {
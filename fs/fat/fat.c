@@ -34,9 +34,16 @@ struct fat_priv {
 	FATFS fat;
 };
 
+/*
+ * Size of the per-file cluster link map table in DWORDs. Two items of
+ * bookkeeping plus two items per fragment, i.e. files with up to 63
+ * contiguous cluster runs are fully mapped.
+ */
+#define FAT_LINKMAP_ENTRIES	128
+
 /* ---------------------------------------------------------------*/
 
-DRESULT disk_read(FATFS *fat, BYTE *buf, DWORD sector, BYTE count)
+DRESULT disk_read(FATFS *fat, BYTE *buf, DWORD sector, UINT count)
 {
 	struct fat_priv *priv = fat->userdata;
 	int ret;
@@ -203,6 +210,23 @@ static int fat_open(struct device *dev, struct file *file, const char *filename)
 		}
 	}
 
+	if ((file->f_flags & O_ACCMODE) == O_RDONLY) {
+		/*
+		 * Resolve the cluster chain once on open, so reads can map
+		 * file offsets without walking the FAT on the device and
+		 * merge contiguous clusters into single large transfers.
+		 * Heavily fragmented files fall back to chain walking.
+		 */
+		DWORD *cltbl = xzalloc(FAT_LINKMAP_ENTRIES * sizeof(DWORD));
+
+		cltbl[0] = FAT_LINKMAP_ENTRIES;
+		f_file->cltbl = cltbl;
+		if (f_lseek(f_file, CREATE_LINKMAP)) {
+			free(cltbl);
+			f_file->cltbl = NULL;
+		}
+	}
+
 	file->private_data = f_file;
 	file->f_size = f_file->fsize;
 
@@ -216,6 +240,7 @@ static int fat_close(struct device *dev, struct file *f)
 
 	f_close(f_file);
 
+	free(f_file->cltbl);
 	free(f_file);
 
 	cdev_flush(priv->cdev);
@@ -567,6 +567,64 @@ DWORD create_chain (	/* 0:No free cluster, 1:Internal error, 0xFFFFFFFF:Disk err
 
 	return ncl; /* Return new cluster number or error code */
 }
+
+/*
+ * FAT handling - Stretch a cluster chain by multiple clusters at once
+ */
+static
+DWORD create_chain_n (	/* Return value as create_chain() */
+	FATFS *fs,	/* File system object */
+	DWORD clst,	/* Cluster# to stretch. 0 means create a new chain. */
+	DWORD n		/* Number of clusters the caller is about to write */
+)
+{
+	DWORD cs, first, prev;
+	int res;
+
+	first = create_chain(fs, clst);
+	if (first < 2 || first == 0xFFFFFFFF)
+		return first;	/* Error or disk full */
+
+	/*
+	 * Only extend when the first cluster terminates the chain, i.e. was
+	 * newly allocated. When create_chain() returned an already linked
+	 * cluster the chain must not be relinked here.
+	 */
+	cs = get_fat(fs, first);
+	if (cs < fs->n_fatent)
+		return first;
+
+	/*
+	 * Link as much of the contiguous free run following the first
+	 * cluster as the caller is going to fill. Contiguous FAT entries
+	 * share sectors, so the links are batched in the FAT window and
+	 * each FAT sector is written once instead of once per cluster.
+	 * When the run ends early the remaining clusters are allocated
+	 * one at a time as before.
+	 */
+	prev = first;
+	while (--n) {
+		if (prev + 1 >= fs->n_fatent)
+			break;
+		cs = get_fat(fs, prev + 1);
+		if (cs != 0)
+			break;	/* Run ends (occupied or disk error) */
+		res = put_fat(fs, prev + 1, 0x0FFFFFFF);
+		if (res == 0)
+			res = put_fat(fs, prev, prev + 1);
+		if (res != 0)
+			return (res == -EIO) ? 0xFFFFFFFF : 1;
+		prev++;
+		/* Update FSINFO */
+		fs->last_clust = prev;
+		if (fs->free_clust != 0xFFFFFFFF) {
+			fs->free_clust--;
+			fs->fsi_flag = 1;
+		}
+	}
+
+	return first;
+}
 #endif /* FS_FAT_WRITE */
 
 /*
@@ -1812,6 +1870,9 @@ int f_open (
 		fp->fsize = LD_DWORD(dir+DIR_FileSize);	/* File size */
 		fp->fptr = 0;			/* File pointer */
 		fp->dsect = 0;
+#if _USE_FASTSEEK
+		fp->cltbl = NULL;		/* Normal seek mode */
+#endif
 		fp->fs = dj.fs;
 	}
 
@@ -1821,6 +1882,64 @@ int f_open (
 
 
 
+#if _USE_FASTSEEK
+/*
+ * Get the cluster containing a given file offset from the cluster link
+ * map table. The table stores the chain as (length, start cluster)
+ * fragment pairs, so the lookup is O(number of fragments) instead of
+ * walking the FAT on the device.
+ */
+static DWORD clmt_clust (	/* <2:Error, >=2:Cluster# */
+	FIL *fp,		/* Pointer to the file object */
+	DWORD ofs		/* File offset to be converted to cluster# */
+)
+{
+	DWORD cl, ncl, *tbl;
+
+	tbl = fp->cltbl + 1;			/* Top of CLMT */
+	cl = ofs / SS(fp->fs) / fp->fs->csize;	/* Cluster order from top of the file */
+	for (;;) {
+		ncl = *tbl++;		/* Number of clusters in the fragment */
+		if (!ncl)
+			return 0;	/* End of table? (error) */
+		if (cl < ncl)
+			break;		/* In this fragment? */
+		cl -= ncl; tbl++;	/* Next fragment */
+	}
+	return cl + *tbl;		/* Return the cluster number */
+}
+
+
+
+
+/*
+ * Number of physically contiguous clusters from a given file offset to
+ * the end of its fragment
+ */
+static DWORD clmt_contig (
+	FIL *fp,		/* Pointer to the file object */
+	DWORD ofs		/* File offset to start from */
+)
+{
+	DWORD cl, ncl, *tbl;
+
+	tbl = fp->cltbl + 1;
+	cl = ofs / SS(fp->fs) / fp->fs->csize;
+	for (;;) {
+		ncl = *tbl++;
+		if (!ncl)
+			return 0;
+		if (cl < ncl)
+			break;
+		cl -= ncl; tbl++;
+	}
+	return ncl - cl;
+}
+#endif /* _USE_FASTSEEK */
+
+
+
+
 /*
  * Read File
  */
@@ -1853,6 +1972,11 @@ int f_read (
 				if (fp->fptr == 0) {		/* On the top of the file? */
 					clst = fp->sclust;	/* Follow from the origin */
 				} else {			/* Middle or end of the file */
+#if _USE_FASTSEEK
+					if (fp->cltbl)
+						clst = clmt_clust(fp, fp->fptr);	/* Get cluster# from the CLMT */
+					else
+#endif
 						clst = get_fat(fp->fs, fp->clust);	/* Follow cluster chain on the FAT */
 				}
 				if (clst < 2)
@@ -1867,9 +1991,17 @@ int f_read (
 			sect += csect;
 			cc = btr / SS(fp->fs);		/* When remaining bytes >= sector size, */
 			if (cc) {			/* Read maximum contiguous sectors directly */
-				if (csect + cc > fp->fs->csize)	/* Clip at cluster boundary */
-					cc = fp->fs->csize - csect;
-				if (disk_read(fp->fs, rbuff, sect, (BYTE)cc) != RES_OK)
+				UINT climit = fp->fs->csize - csect;
+#if _USE_FASTSEEK
+				if (fp->cltbl) {	/* Extend across contiguous clusters of the fragment */
+					DWORD contig = clmt_contig(fp, fp->fptr);
+					if (contig)
+						climit = contig * fp->fs->csize - csect;
+				}
+#endif
+				if (cc > climit)	/* Clip at cluster/fragment boundary */
+					cc = climit;
+				if (disk_read(fp->fs, rbuff, sect, cc) != RES_OK)
 					ABORT(fp->fs, -EIO);
 #if defined FS_FAT_WRITE
 				/* Replace one of the read sectors with cached data if it contains a dirty sector */
@@ -1877,6 +2009,10 @@ int f_read (
 					memcpy(rbuff + ((fp->dsect - sect) * SS(fp->fs)), fp->buf, SS(fp->fs));
 #endif
 				rcnt = SS(fp->fs) * cc;	/* Number of bytes transferred */
+#if _USE_FASTSEEK
+				if (fp->cltbl)	/* The read may have crossed cluster boundaries */
+					fp->clust = clmt_clust(fp, fp->fptr + rcnt - 1);
+#endif
 				continue;
 			}
 			if (fp->dsect != sect) {	/* Load data sector if not in cache */
@@ -1915,7 +2051,7 @@ int f_write (
 	UINT *bw		/* Pointer to number of bytes written */
 )
 {
-	DWORD clst, sect;
+	DWORD clst, sect, bcs, ncl;
 	UINT wcnt, cc;
 	const BYTE *wbuff = buff;
 	BYTE csect;
@@ -1937,16 +2073,19 @@ int f_write (
 			csect = (BYTE)(fp->fptr / SS(fp->fs) & (fp->fs->csize - 1));
 			/* On the cluster boundary? */
 			if (!csect) {
+				/* Number of clusters this write still spans */
+				bcs = (DWORD)fp->fs->csize * SS(fp->fs);
+				ncl = btw / bcs + (btw % bcs ? 1 : 0);
 				/* On the top of the file? */
 				if (fp->fptr == 0) {
 					clst = fp->sclust;		/* Follow from the origin */
 					if (clst == 0)			/* When no cluster is allocated, */
 						/* Create a new cluster chain */
-						fp->sclust = clst = create_chain(fp->fs, 0);
+						fp->sclust = clst = create_chain_n(fp->fs, 0, ncl);
 				} else {
 					/* Middle or end of the file */
 					/* Follow or stretch cluster chain on the FAT */
-					clst = create_chain(fp->fs, fp->clust);
+					clst = create_chain_n(fp->fs, fp->clust, ncl);
 				}
 				if (clst == 0)
 					break;		/* Could not allocate a new cluster (disk full) */
@@ -2082,6 +2221,67 @@ int f_lseek (
 	if (fp->flag & FA__ERROR)		/* Check abort flag */
 		return -ERESTARTSYS;
 
+#if _USE_FASTSEEK
+	if (fp->cltbl) {	/* Fast seek */
+		DWORD cl, pcl, ncl, tcl, dsc, tlen, ulen, *tbl;
+
+		if (ofs == CREATE_LINKMAP) {	/* Create CLMT */
+			tbl = fp->cltbl;
+			tlen = *tbl++; ulen = 2;	/* Given table size and required table size */
+			cl = fp->sclust;		/* Top of the chain */
+			if (cl) {
+				do {
+					/* Get a fragment */
+					tcl = cl; ncl = 0; ulen += 2;	/* Top, length and used items */
+					do {
+						pcl = cl; ncl++;
+						cl = get_fat(fp->fs, cl);
+						if (cl <= 1)
+							ABORT(fp->fs, -ERESTARTSYS);
+						if (cl == 0xFFFFFFFF)
+							ABORT(fp->fs, -EIO);
+					} while (cl == pcl + 1);
+					if (ulen <= tlen) {	/* Store the length and top of the fragment */
+						*tbl++ = ncl; *tbl++ = tcl;
+					}
+				} while (cl < fp->fs->n_fatent);	/* Repeat until end of chain */
+			}
+			*fp->cltbl = ulen;	/* Number of items used */
+			if (ulen <= tlen) {
+				*tbl = 0;	/* Terminate table */
+			} else {
+				fp->cltbl = NULL;	/* Given table size is smaller than required */
+				res = -ENOMEM;
+			}
+		} else {			/* Fast seek */
+			if (ofs > fp->fsize)	/* Clip offset at the file size */
+				ofs = fp->fsize;
+			fp->fptr = ofs;		/* Set file pointer */
+			if (ofs) {
+				fp->clust = clmt_clust(fp, ofs - 1);
+				dsc = clust2sect(fp->fs, fp->clust);
+				if (!dsc)
+					ABORT(fp->fs, -ERESTARTSYS);
+				dsc += (ofs - 1) / SS(fp->fs) & (fp->fs->csize - 1);
+				if (fp->fptr % SS(fp->fs) && dsc != fp->dsect) {	/* Refill sector cache if needed */
+#ifdef FS_FAT_WRITE
+					if (fp->flag & FA__DIRTY) {	/* Write-back dirty sector cache */
+						if (disk_write(fp->fs, fp->buf, fp->dsect, 1) != RES_OK)
+							ABORT(fp->fs, -EIO);
+						fp->flag &= ~FA__DIRTY;
+					}
+#endif
+					if (disk_read(fp->fs, fp->buf, dsc, 1) != RES_OK)	/* Load current sector */
+						ABORT(fp->fs, -EIO);
+					fp->dsect = dsc;
+				}
+			}
+		}
+
+		return res;
+	}
+#endif
+
 	if (ofs > fp->fsize	/* In read-only mode, clip offset with the file size */
 #ifdef FS_FAT_WRITE
 		 && !(fp->flag & FA_WRITE)
@@ -34,6 +34,8 @@
 #include <slice.h>
 #include <libfile.h>
 #include <parseopt.h>
+#include <qsort.h>
+#include <linux/hash.h>
 #include <linux/namei.h>
 #include <security/config.h>
 
@@ -245,6 +247,20 @@ static void path_put(const struct path *path);
 
 LIST_HEAD(fs_device_list);
 
+/*
+ * Mounted filesystems hashed by their mountpoint dentry, so that
+ * crossing a mountpoint during a path walk doesn't have to scan all
+ * mounts. A dentry hosts at most one mount, stacking is refused.
+ */
+#define MOUNT_HASH_SIZE	32
+
+static struct hlist_head mount_hash[MOUNT_HASH_SIZE];
+
+static struct hlist_head *mount_hash_bucket(const struct dentry *mountpoint)
+{
+	return &mount_hash[hash_ptr(mountpoint, ilog2(MOUNT_HASH_SIZE))];
+}
+
 static struct vfsmount *mntget(struct vfsmount *mnt)
 {
 	if (!mnt)
@@ -267,7 +283,8 @@ static struct vfsmount *lookup_mnt(struct path *path)
 {
 	struct fs_device *fsdev;
 
-	for_each_fs_device(fsdev) {
+	hlist_for_each_entry(fsdev, mount_hash_bucket(path->dentry),
+			     mount_hash) {
 		if (path->dentry == fsdev->vfsmount.mountpoint) {
 			mntget(&fsdev->vfsmount);
 			return &fsdev->vfsmount;
@@ -459,6 +476,49 @@ ssize_t pread(int fd, void *buf, size_t count, loff_t offset)
 }
 EXPORT_SYMBOL(pread);
 
+static int io_segment_compare(const void *a, const void *b)
+{
+	const struct io_segment *seg_a = a, *seg_b = b;
+
+	if (seg_a->offset < seg_b->offset)
+		return -1;
+
+	return seg_a->offset > seg_b->offset;
+}
+
+/**
+ * pread_segments - gather read from a file
+ * @fd: file descriptor to read from
+ * @segs: the segments to read, sorted by offset in place
+ * @nsegs: number of segments
+ *
+ * Read multiple file ranges in one pass: the segments are sorted by
+ * offset first, so the underlying medium is traversed front to back
+ * with minimal seeking. Returns the total number of bytes read, which
+ * is less than requested when a segment read came up short, or a
+ * negative error code.
+ */
+ssize_t pread_segments(int fd, struct io_segment *segs, unsigned int nsegs)
+{
+	ssize_t ret, total = 0;
+	unsigned int i;
+
+	qsort(segs, nsegs, sizeof(*segs), io_segment_compare);
+
+	for (i = 0; i < nsegs; i++) {
+		ret = pread(fd, segs[i].buf, segs[i].count, segs[i].offset);
+		if (ret < 0)
+			return ret;
+
+		total += ret;
+		if ((size_t)ret < segs[i].count)
+			break;
+	}
+
+	return total;
+}
+EXPORT_SYMBOL(pread_segments);
+
 ssize_t read(int fd, void *buf, size_t count)
 {
 	struct file *f = fd_to_file(fd, false);
@@ -866,8 +926,10 @@ static void fs_remove(struct device *dev)
 		}
 	}
 
-	if (fsdev->vfsmount.mountpoint)
+	if (fsdev->vfsmount.mountpoint) {
 		fsdev->vfsmount.mountpoint->d_flags &= ~DCACHE_MOUNTED;
+		hlist_del(&fsdev->mount_hash);
+	}
 
 	dentry_delete_subtree(sb, sb->s_root);
 
@@ -1050,6 +1112,7 @@ static int fillonedir(struct dir_context *ctx, const char *name, int namlen,
 
 	entry = xzalloc(sizeof(*entry));
 	memcpy(entry->d.d_name, name, namlen);
+	entry->d.d_type = d_type;
 	list_add_tail(&entry->list, &rd->dir->entries);
 
 	return 0;
@@ -1090,6 +1153,7 @@ struct dirent *readdir(DIR *dir)
 
 	list_del(&entry->list);
 	strcpy(dir->d.d_name, entry->d.d_name);
+	dir->d.d_type = entry->d.d_type;
 	free(entry);
 
 	return &dir->d;
@@ -1468,7 +1532,7 @@ static struct dentry *__d_alloc(struct super_block *sb, const struct qstr *name)
 	memcpy(dentry->name, name->name, name->len);
 	dentry->name[name->len] = 0;
 
-	dentry->d_name.len = name->len;
+	dentry->d_name.hash_len = name->hash_len;
 	dentry->d_name.name = dentry->name;
 
 	dentry->d_count = 1;
@@ -1553,10 +1617,26 @@ void d_add(struct dentry *dentry, struct inode *inode)
 	dentry->d_flags |= d_flags_for_inode(inode);
 }
 
+/*
+ * Dentries live until their filesystem is unmounted, so d_lookup() below
+ * effectively is our dentry cache. Hash the component names once while
+ * the path is split up in link_path_walk() so that scanning the children
+ * of a big directory compares a word instead of a string most of the time.
+ */
+static u32 d_name_hash(const unsigned char *name, u32 len)
+{
+	u32 hash = 0;
+
+	while (len--)
+		hash = hash * 31 + *name++;
+
+	return hash;
+}
+
 static bool d_same_name(const struct dentry *dentry,
 			const struct qstr *name)
 {
-	if (dentry->d_name.len != name->len)
+	if (dentry->d_name.hash_len != name->hash_len)
 		return false;
 
 	return strncmp(dentry->d_name.name, name->name, name->len) == 0;
@@ -1574,6 +1654,35 @@ static struct dentry *d_lookup(struct dentry *parent, const struct qstr *name)
 	return NULL;
 }
 
+/**
+ * d_prime_readdir - enter a name learned while reading a directory into the cache
+ * @parent: dentry of the directory being read
+ * @name: entry name as returned by the filesystem
+ *
+ * Filesystems whose directory reads return the per-entry inode data as
+ * well (like NFSv3 READDIRPLUS) use this to satisfy the stat() calls
+ * that typically follow a readdir from the cache instead of the medium.
+ * Returns a negative dentry the caller must fill in with d_add(), or
+ * NULL when the name is already cached.
+ */
+struct dentry *d_prime_readdir(struct dentry *parent, const char *name)
+{
+	struct qstr this;
+	struct dentry *dentry;
+
+	this.name = name;
+	this.len = strlen(name);
+	this.hash = d_name_hash(name, this.len);
+
+	dentry = d_lookup(parent, &this);
+	if (dentry) {
+		dput(dentry);
+		return NULL;
+	}
+
+	return d_alloc(parent, &this);
+}
+
 static void d_invalidate(struct dentry *dentry)
 {
 }
@@ -2148,6 +2257,7 @@ static int link_path_walk(const char *name, struct nameidata *nd)
 		if (likely(type == LAST_NORM))
 			nd->flags &= ~LOOKUP_JUMPED;
 
+		nd->last.hash = d_name_hash(name, len);
 		nd->last.len = len;
 		nd->last.name = name;
 		nd->last_type = type;
@@ -3249,6 +3359,9 @@ int mount(const char *device, const char *fsname, const char *pathname,
 
 	fsdev->vfsmount.mnt_root = fsdev->sb.s_root;
 
+	hlist_add_head(&fsdev->mount_hash,
+		       mount_hash_bucket(fsdev->vfsmount.mountpoint));
+
 	if (!fsdev->linux_rootarg) {
 		char *str;
 
@@ -3316,12 +3429,17 @@ EXPORT_SYMBOL(umount);
 
 #define AUTOMOUNT_IS_FILE (1 << 0)
 
+/* a failed automount attempt is not repeated for this long */
+#define AUTOMOUNT_RETRY_DELAY	(10 * SECOND)
+
 struct automount {
 	char *path;
 	struct dentry *dentry;
 	char *cmd;
 	struct list_head list;
 	unsigned int flags;
+	/* no new attempt before this time, 0 after a successful one */
+	u64 retry_after;
 };
 
 static LIST_HEAD(automount_list);
@@ -3429,6 +3547,15 @@ static int automount_mount(struct dentry *dentry)
 		if (am->dentry != dentry)
 			continue;
 
+		/*
+		 * Scripts probing optional media would otherwise pay the
+		 * full mount timeout on every access to a missing device.
+		 */
+		if (am->retry_after && get_time_ns() < am->retry_after) {
+			ret = -ENODEV;
+			break;
+		}
+
 		setenv("automount_path", am->path);
 		export("automount_path");
 		ret = run_command(am->cmd);
@@ -3444,6 +3571,9 @@ static int automount_mount(struct dentry *dentry)
 			ret = -ENODEV;
 		}
 
+		am->retry_after = ret ?
+			get_time_ns() + AUTOMOUNT_RETRY_DELAY : 0;
+
 		break;
 	}
 
@@ -255,6 +255,7 @@ static void jffs2_put_super(struct super_block *sb)
 
 		jffs2_free_ino_caches(ctx);
 		jffs2_free_raw_node_refs(ctx);
+		jffs2_sum_exit(ctx);
 		kfree(ctx->blocks);
 		kfree(ctx->inocache_list);
 		jffs2_flash_cleanup(ctx);
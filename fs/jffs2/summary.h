@@ -166,7 +166,7 @@ struct jffs2_sum_marker
 
 #define JFFS2_SUMMARY_FRAME_SIZE (sizeof(struct jffs2_raw_summary) + sizeof(struct jffs2_sum_marker))
 
-#ifdef CONFIG_JFFS2_SUMMARY	/* SUMMARY SUPPORT ENABLED */
+#ifdef CONFIG_FS_JFFS2_SUMMARY	/* SUMMARY SUPPORT ENABLED */
 
 #define jffs2_sum_active() (1)
 int jffs2_sum_init(struct jffs2_sb_info *c);
@@ -205,6 +205,6 @@ int jffs2_sum_scan_sumnode(struct jffs2_sb_info *c, struct jffs2_eraseblock *jeb
 #define jffs2_sum_add_xref_mem(a,b,c)
 #define jffs2_sum_scan_sumnode(a,b,c,d,e) (0)
 
-#endif /* CONFIG_JFFS2_SUMMARY */
+#endif /* CONFIG_FS_JFFS2_SUMMARY */
 
 #endif /* JFFS2_SUMMARY_H */
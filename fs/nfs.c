@@ -56,6 +56,7 @@
 #define NFSPROC3_READLINK	5
 #define NFSPROC3_READ		6
 #define NFSPROC3_READDIR	16
+#define NFSPROC3_READDIRPLUS	17
 
 #define NFS3_FHSIZE      64
 #define NFS3_COOKIEVERFSIZE	8
@@ -144,6 +145,7 @@ struct nfs_priv {
 	unsigned manual_mount_port:1;
 	uint16_t nfs_port;
 	unsigned manual_nfs_port:1;
+	unsigned broken_readdirplus:1;
 	uint32_t rpc_id;
 	struct nfs_fh rootfh;
 	struct list_head packets;
@@ -264,6 +266,8 @@ struct nfs_dir {
 	uint64_t cookie;
 	char cookieverf[NFS3_COOKIEVERFSIZE];
 	struct nfs_fh fh;
+	/* entries carry attributes and file handles (READDIRPLUS) */
+	bool plus;
 };
 
 struct nfserror {
@@ -988,6 +992,7 @@ static void *nfs_readdirattr_req(struct nfs_priv *npriv, struct nfs_dir *dir)
 	int len;
 	struct packet *nfs_packet;
 	void *buf = NULL;
+	bool plus = !npriv->broken_readdirplus;
 	int ret;
 
 	/*
@@ -998,6 +1003,8 @@ static void *nfs_readdirattr_req(struct nfs_priv *npriv, struct nfs_dir *dir)
 	 * 	count3 count;
 	 * };
 	 *
+	 * READDIRPLUS3args carry a dircount/maxcount pair instead of count.
+	 *
 	 * struct entry3 {
 	 * 	fileid3 fileid;
 	 * 	filename3 name;
@@ -1005,6 +1012,9 @@ static void *nfs_readdirattr_req(struct nfs_priv *npriv, struct nfs_dir *dir)
 	 * 	entry3 *nextentry;
 	 * };
 	 *
+	 * entryplus3 additionally carry post_op_attr name_attributes and
+	 * post_op_fh3 name_handle before nextentry.
+	 *
 	 * struct dirlist3 {
 	 * 	entry3 *entries;
 	 * 	bool eof;
@@ -1028,6 +1038,7 @@ static void *nfs_readdirattr_req(struct nfs_priv *npriv, struct nfs_dir *dir)
 	 * };
 	 */
 
+again:
 	p = &(data[0]);
 	p = rpc_add_credentials(p);
 
@@ -1037,9 +1048,16 @@ static void *nfs_readdirattr_req(struct nfs_priv *npriv, struct nfs_dir *dir)
 	memcpy(p, dir->cookieverf, NFS3_COOKIEVERFSIZE);
 	p += NFS3_COOKIEVERFSIZE / 4;
 
-	p = nfs_add_uint32(p, 1024); /* count */
+	if (plus) {
+		p = nfs_add_uint32(p, 1024); /* dircount */
+		p = nfs_add_uint32(p, 1024); /* maxcount */
+	} else {
+		p = nfs_add_uint32(p, 1024); /* count */
+	}
 
-	nfs_packet = rpc_req(npriv, PROG_NFS, NFSPROC3_READDIR, data, p - data);
+	nfs_packet = rpc_req(npriv, PROG_NFS,
+			     plus ? NFSPROC3_READDIRPLUS : NFSPROC3_READDIR,
+			     data, p - data);
 	if (IS_ERR(nfs_packet))
 		return NULL;
 
@@ -1051,6 +1069,13 @@ static void *nfs_readdirattr_req(struct nfs_priv *npriv, struct nfs_dir *dir)
 
 	status = ntoh32(net_read_uint32(p));
 	if (status != NFS3_OK) {
+		if (plus && status == NFS3ERR_NOTSUPP) {
+			dev_dbg(dev, "no READDIRPLUS support, falling back to READDIR\n");
+			npriv->broken_readdirplus = 1;
+			plus = false;
+			nfs_free_packet(nfs_packet);
+			goto again;
+		}
 		dev_err(dev, "Readdir failed: %s\n", nfserrstr(status, NULL));
 		ret = -EIO;
 		goto err_free_packet;
@@ -1073,6 +1098,8 @@ static void *nfs_readdirattr_req(struct nfs_priv *npriv, struct nfs_dir *dir)
 
 	xdr_init(&dir->stream, buf, len);
 
+	dir->plus = plus;
+
 	ret = 0;
 
 	/* now xdr points to dirlist3 res.resok.reply */
@@ -1082,19 +1109,32 @@ err_free_packet:
 	return ret ? NULL : buf;
 }
 
-/*
- * nfs_read_req - Read File on NFS Server
- */
-static int nfs_read_req(struct file_priv *priv, uint64_t offset,
-		uint32_t readlen)
+/* Amount of data requested with one READ call. The net stack cannot
+   reassemble IP fragments, so the reply including RPC and attribute
+   overhead must fit into a single ethernet frame. */
+#define NFS_READ_SIZE		1280
+
+/* number of READ calls kept in flight for sequential reads */
+#define NFS_READ_PIPELINE	4
+
+struct nfs_read_slot {
+	uint32_t rpc_id;
+	uint64_t offset;
+	struct packet *pkt;
+	void *data;
+	uint32_t rlen;
+	uint32_t eof;
+	bool done;
+};
+
+static int nfs_send_read_call(struct file_priv *priv, struct nfs_read_slot *slot)
 {
 	struct nfs_priv *npriv = priv->npriv;
-	struct device *dev = npriv->dev;
+	unsigned char *payload = net_udp_get_payload(npriv->con);
 	uint32_t data[1024];
-	uint32_t *p, status;
-	int len, ret;
-	struct packet *nfs_packet;
-	uint32_t rlen, eof;
+	struct rpc_call pkt;
+	uint32_t *p;
+	int len;
 
 	/*
 	 * struct READ3args {
@@ -1102,7 +1142,41 @@ static int nfs_read_req(struct file_priv *priv, uint64_t offset,
 	 * 	offset3 offset;
 	 * 	count3 count;
 	 * };
-	 *
+	 */
+	p = &(data[0]);
+	p = rpc_add_credentials(p);
+
+	p = nfs_add_fh3(p, &priv->fh);
+	p = nfs_add_uint64(p, slot->offset);
+	p = nfs_add_uint32(p, NFS_READ_SIZE);
+
+	len = p - &(data[0]);
+
+	npriv->rpc_id++;
+	slot->rpc_id = npriv->rpc_id;
+
+	pkt.id = hton32(slot->rpc_id);
+	pkt.type = hton32(MSG_CALL);
+	pkt.rpcvers = hton32(2);
+	pkt.prog = hton32(PROG_NFS);
+	pkt.vers = hton32(3);
+	pkt.proc = hton32(NFSPROC3_READ);
+
+	memcpy(payload, &pkt, sizeof(pkt));
+	memcpy(payload + sizeof(pkt), data, len * sizeof(uint32_t));
+
+	npriv->con->udp->uh_dport = hton16(npriv->nfs_port);
+
+	return net_udp_send(npriv->con, sizeof(pkt) + len * sizeof(uint32_t));
+}
+
+static int nfs_parse_read_reply(struct nfs_priv *npriv, struct packet *nfs_packet,
+				struct nfs_read_slot *slot)
+{
+	uint32_t *p, status;
+	int ret;
+
+	/*
 	 * struct READ3resok {
 	 * 	post_op_attr file_attributes;
 	 * 	count3 count;
@@ -1121,72 +1195,156 @@ static int nfs_read_req(struct file_priv *priv, uint64_t offset,
 	 * 	READ3resfail resfail;
 	 * };
 	 */
-	p = &(data[0]);
-	p = rpc_add_credentials(p);
-
-	p = nfs_add_fh3(p, &priv->fh);
-	p = nfs_add_uint64(p, offset);
-	p = nfs_add_uint32(p, readlen);
-
-	len = p - &(data[0]);
-
-	nfs_packet = rpc_req(priv->npriv, PROG_NFS, NFSPROC3_READ, data, len);
-	if (IS_ERR(nfs_packet))
-		return PTR_ERR(nfs_packet);
-
 	p = nfs_packet_read(nfs_packet, sizeof(uint32_t));
-	if (!p) {
-		ret = -EINVAL;
-		goto err_free_packet;
-	}
+	if (!p)
+		return -EINVAL;
 
 	status = ntoh32(net_read_uint32(p));
 	if (status != NFS3_OK) {
-		dev_err(dev, "Read failed: %s\n", nfserrstr(status, &ret));
-		goto err_free_packet;
+		dev_err(npriv->dev, "Read failed: %s\n", nfserrstr(status, &ret));
+		return ret;
 	}
 
 	ret = nfs_read_post_op_attr(npriv, nfs_packet, NULL);
-	if (ret) {
-		ret = -EINVAL;
-		goto err_free_packet;
-	}
+	if (ret)
+		return -EINVAL;
 
 	p = nfs_packet_read(nfs_packet, sizeof(uint32_t));
-	if (!p) {
-		ret = -EINVAL;
-		goto err_free_packet;
-	}
+	if (!p)
+		return -EINVAL;
 
-	rlen = ntoh32(net_read_uint32(p));
+	slot->rlen = ntoh32(net_read_uint32(p));
 
 	p = nfs_packet_read(nfs_packet, sizeof(uint32_t));
-	if (!p) {
-		ret = -EINVAL;
-		goto err_free_packet;
-	}
+	if (!p)
+		return -EINVAL;
 
-	eof = ntoh32(net_read_uint32(p));
+	slot->eof = ntoh32(net_read_uint32(p));
 
 	/*
-	 * skip over eof and count embedded in the representation of data
+	 * skip over the count embedded in the representation of data
 	 * assuming it equals rlen above.
 	 */
 	nfs_packet_read(nfs_packet, sizeof(uint32_t));
 
-	if (readlen && !rlen && !eof) {
-		ret = -EIO;
-		goto err_free_packet;
+	p = nfs_packet_read(nfs_packet, slot->rlen);
+	if (!p)
+		return -EINVAL;
+
+	slot->data = p;
+
+	return 0;
+}
+
+/*
+ * nfs_read_req - Read File on NFS Server
+ *
+ * Keeps NFS_READ_PIPELINE READ calls for consecutive file ranges in
+ * flight so the server can process and transmit the next replies while
+ * earlier ones are still on the wire, then pushes the replies into the
+ * fifo in file order. This hides most of the RPC round trip latency of
+ * the lock-step one-call-at-a-time scheme.
+ */
+static int nfs_read_req(struct file_priv *priv, uint64_t offset)
+{
+	struct nfs_priv *npriv = priv->npriv;
+	struct nfs_read_slot slots[NFS_READ_PIPELINE];
+	const int nslots = NFS_READ_PIPELINE;
+	struct packet *packet, *tmp;
+	int ndone = 0, tries = 0;
+	int ret = 0, i;
+
+	memset(slots, 0, sizeof(slots));
+
+	for (i = 0; i < nslots; i++) {
+		slots[i].offset = offset + (uint64_t)i * NFS_READ_SIZE;
+		ret = nfs_send_read_call(priv, &slots[i]);
+		if (ret)
+			return ret;
 	}
 
-	p = nfs_packet_read(nfs_packet, rlen);
+	nfs_timer_start = get_time_ns();
 
-	kfifo_put(priv->fifo, (char *)p, rlen);
+	while (ndone < nslots) {
+		net_poll();
 
-	ret = 0;
+		if (is_timeout(nfs_timer_start, NFS_TIMEOUT)) {
+			tries++;
+			if (tries == NFS_MAX_RESEND) {
+				ret = -ETIMEDOUT;
+				goto out;
+			}
 
-err_free_packet:
-	nfs_free_packet(nfs_packet);
+			for (i = 0; i < nslots; i++) {
+				if (slots[i].done)
+					continue;
+				ret = nfs_send_read_call(priv, &slots[i]);
+				if (ret)
+					goto out;
+			}
+
+			nfs_timer_start = get_time_ns();
+		}
+
+		list_for_each_entry_safe(packet, tmp, &npriv->packets, list) {
+			struct nfs_read_slot *slot = NULL;
+			struct rpc_reply rpc;
+			void *p;
+
+			p = nfs_packet_read(packet, sizeof(rpc));
+			if (!p) {
+				nfs_free_packet(packet);
+				continue;
+			}
+
+			memcpy(&rpc, p, sizeof(rpc));
+
+			for (i = 0; i < nslots; i++) {
+				if (!slots[i].done &&
+				    slots[i].rpc_id == ntoh32(rpc.id)) {
+					slot = &slots[i];
+					break;
+				}
+			}
+
+			/* stale id from an earlier resend or broken reply */
+			if (!slot || rpc.rstatus || rpc.verifier || rpc.astatus) {
+				nfs_free_packet(packet);
+				continue;
+			}
+
+			ret = nfs_parse_read_reply(npriv, packet, slot);
+			if (ret) {
+				nfs_free_packet(packet);
+				goto out;
+			}
+
+			/* keep the packet; slot->data points into it */
+			list_del(&packet->list);
+			slot->pkt = packet;
+			slot->done = true;
+			ndone++;
+		}
+	}
+
+	for (i = 0; i < nslots; i++) {
+		struct nfs_read_slot *slot = &slots[i];
+
+		if (slot->rlen)
+			kfifo_put(priv->fifo, slot->data, slot->rlen);
+
+		if (slot->eof)
+			break;
+
+		if (!slot->rlen) {
+			ret = -EIO;
+			break;
+		}
+	}
+
+out:
+	for (i = 0; i < nslots; i++)
+		free(slots[i].pkt);
 
 	return ret;
 }
@@ -1323,7 +1481,7 @@ static int nfs_open(struct inode *inode, struct file *file)
 	priv->npriv = npriv;
 	file->private_data = priv;
 
-	priv->fifo = kfifo_alloc(1024);
+	priv->fifo = kfifo_alloc(NFS_READ_SIZE * NFS_READ_PIPELINE);
 	if (!priv->fifo) {
 		free(priv);
 		return -ENOMEM;
@@ -1350,11 +1508,11 @@ static int nfs_read(struct file *file, void *buf, size_t insize)
 {
 	struct file_priv *priv = file->private_data;
 
-	if (insize > 1024)
-		insize = 1024;
+	if (insize > NFS_READ_SIZE * NFS_READ_PIPELINE)
+		insize = NFS_READ_SIZE * NFS_READ_PIPELINE;
 
 	if (insize && !kfifo_len(priv->fifo)) {
-		int ret = nfs_read_req(priv, file->f_pos, insize);
+		int ret = nfs_read_req(priv, file->f_pos);
 		if (ret)
 			return ret;
 	}
@@ -1371,6 +1529,10 @@ static int nfs_lseek(struct file *file, loff_t pos)
 	return 0;
 }
 
+static void nfs_prime_dcache(struct nfs_priv *npriv, struct dentry *parent,
+			     const char *name, uint32_t *attr, void *fh,
+			     u32 fh_size);
+
 static int nfs_iterate(struct file *file, struct dir_context *ctx)
 {
 	struct dentry *dentry = file->f_path.dentry;
@@ -1433,6 +1595,47 @@ static int nfs_iterate(struct file *file, struct dir_context *ctx)
 				goto err_eop;
 
 			ndir->cookie = ntoh64(net_read_uint64(p));
+
+			if (ndir->plus) {
+				uint32_t *attr = NULL;
+				void *fh = NULL;
+				u32 fh_size = 0;
+
+				/* name_attributes */
+				p = xdr_inline_decode(xdr, 4);
+				if (!p)
+					goto err_eop;
+
+				if (net_read_uint32(p)) {
+					attr = xdr_inline_decode(xdr,
+							21 * sizeof(uint32_t));
+					if (!attr)
+						goto err_eop;
+				}
+
+				/* name_handle */
+				p = xdr_inline_decode(xdr, 4);
+				if (!p)
+					goto err_eop;
+
+				if (net_read_uint32(p)) {
+					p = xdr_inline_decode(xdr, 4);
+					if (!p)
+						goto err_eop;
+
+					fh_size = ntoh32(net_read_uint32(p));
+					if (fh_size > NFS3_FHSIZE)
+						goto err_eop;
+
+					fh = xdr_inline_decode(xdr, fh_size);
+					if (!fh)
+						goto err_eop;
+				}
+
+				if (attr && fh_size)
+					nfs_prime_dcache(npriv, dentry, name,
+							 attr, fh, fh_size);
+			}
 		}
 		free(buf);
 	}
@@ -1514,6 +1717,50 @@ static int nfs_init_inode(struct nfs_priv *npriv, struct inode *inode,
 	return 0;
 }
 
+/*
+ * READDIRPLUS returns the attributes and the file handle of every entry
+ * along with its name. Enter them into the dentry cache so that the
+ * stat() calls that typically follow a readdir are answered from the
+ * cache instead of going over the wire again.
+ */
+static void nfs_prime_dcache(struct nfs_priv *npriv, struct dentry *parent,
+			     const char *name, uint32_t *attr, void *fh,
+			     u32 fh_size)
+{
+	struct nfs_inode *ninode;
+	struct dentry *dentry;
+	struct inode *inode;
+
+	if (!strcmp(name, ".") || !strcmp(name, ".."))
+		return;
+
+	inode = new_inode(parent->d_sb);
+	if (!inode)
+		return;
+
+	if (nfs_fattr3_to_stat(npriv, attr, inode)) {
+		iput(inode);
+		return;
+	}
+
+	ninode = nfsi(inode);
+	ninode->fh.size = fh_size;
+	memcpy(ninode->fh.data, fh, fh_size);
+
+	if (nfs_init_inode(npriv, inode, inode->i_mode)) {
+		iput(inode);
+		return;
+	}
+
+	dentry = d_prime_readdir(parent, name);
+	if (!dentry) {
+		iput(inode);
+		return;
+	}
+
+	d_add(dentry, inode);
+}
+
 static struct dentry *nfs_lookup(struct inode *dir, struct dentry *dentry,
 				   unsigned int flags)
 {
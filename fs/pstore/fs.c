@@ -269,6 +269,12 @@ static int pstore_probe(struct device *dev)
 
 	dev->priv = priv;
 
+	/*
+	 * Populate the record list from the backend now. On a remount
+	 * the records are already there, so skip the -EEXIST warnings.
+	 */
+	pstore_get_records(1);
+
 	dev_dbg(dev, "mounted pstore\n");
 
 	return 0;
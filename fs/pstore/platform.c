@@ -89,10 +89,9 @@ static void pstore_console_capture_log(void)
 
 /*
  * platform specific persistent storage driver registers with
- * us here. If pstore is already mounted, call the platform
- * read function right away to populate the file system. If not
- * then the pstore mount code will call us later to fill out
- * the file system.
+ * us here. The records are not read here; the pstore mount code
+ * calls us later to fill out the file system, so boots that never
+ * look at the records do not pay for decoding them.
  *
  * Register with kmsg_dump to save last part of console log on panic.
  */
@@ -111,8 +110,6 @@ int pstore_register(struct pstore_info *psi)
 	mutex_init(&psinfo->read_mutex);
 	spin_unlock(&pstore_lock);
 
-	pstore_get_records(0);
-
 	pstore_console_capture_log();
 	pstore_ready = 1;
 
@@ -96,8 +96,7 @@ static int ramoops_pstore_open(struct pstore_info *psi)
 static struct persistent_ram_zone *
 ramoops_get_next_prz(struct persistent_ram_zone *przs[], uint *c, uint max,
 		     u64 *id,
-		     enum pstore_type_id *typep, enum pstore_type_id type,
-		     bool update)
+		     enum pstore_type_id *typep, enum pstore_type_id type)
 {
 	struct persistent_ram_zone *prz;
 	int i = (*c)++;
@@ -109,9 +108,8 @@ ramoops_get_next_prz(struct persistent_ram_zone *przs[], uint *c, uint max,
 	if (!prz)
 		return NULL;
 
-	/* Update old/shadowed buffer. */
-	if (update)
-		persistent_ram_save_old(prz);
+	/* Decode and unwrap the old contents on first access. */
+	persistent_ram_save_old(prz);
 
 	if (!persistent_ram_old_size(prz))
 		return NULL;
@@ -140,20 +138,20 @@ static ssize_t ramoops_pstore_read(struct pstore_record *record)
 	prz = ramoops_get_next_prz(cxt->przs, &cxt->dump_read_cnt,
 				   cxt->max_dump_cnt, &record->id,
 				   &record->type,
-				   PSTORE_TYPE_DMESG, 0);
+				   PSTORE_TYPE_DMESG);
 	if (!prz_ok(prz))
 		prz = ramoops_get_next_prz(&cxt->cprz, &cxt->console_read_cnt,
 					   1, &record->id, &record->type,
-					   PSTORE_TYPE_CONSOLE, 0);
+					   PSTORE_TYPE_CONSOLE);
 
 	if (!prz_ok(prz))
 		prz = ramoops_get_next_prz(&cxt->fprz, &cxt->ftrace_read_cnt,
 					   1, &record->id, &record->type,
-					   PSTORE_TYPE_FTRACE, 0);
+					   PSTORE_TYPE_FTRACE);
 	if (!prz_ok(prz))
 		prz = ramoops_get_next_prz(&cxt->mprz, &cxt->pmsg_read_cnt,
 					   1, &record->id, &record->type,
-					   PSTORE_TYPE_PMSG, 0);
+					   PSTORE_TYPE_PMSG);
 	if (!prz_ok(prz))
 		return 0;
 
@@ -610,6 +608,14 @@ static int ramoops_probe(struct device *dev)
 	cxt->pstore.data = cxt;
 	spin_lock_init(&cxt->pstore.buf_lock);
 
+	/*
+	 * Registering with pstore appends this boot's console log to the
+	 * console zone, so snapshot its previous contents now. All other
+	 * zones are decoded lazily on first read.
+	 */
+	if (cxt->cprz)
+		persistent_ram_save_old(cxt->cprz);
+
 	err = pstore_register(&cxt->pstore);
 	if (err) {
 		pr_err("registering with pstore failed\n");
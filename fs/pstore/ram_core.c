@@ -268,13 +268,11 @@ void persistent_ram_save_old(struct persistent_ram_zone *prz)
 	size_t size = buffer_size(prz);
 	size_t start = buffer_start(prz);
 
-	if (!size)
+	if (!size || prz->old_log)
 		return;
 
-	if (!prz->old_log) {
-		persistent_ram_ecc_old(prz);
-		prz->old_log = kmalloc(size, GFP_KERNEL);
-	}
+	persistent_ram_ecc_old(prz);
+	prz->old_log = kmalloc(size, GFP_KERNEL);
 	if (!prz->old_log) {
 		pr_err("failed to allocate buffer\n");
 		return;
@@ -378,7 +376,11 @@ static int persistent_ram_post_init(struct persistent_ram_zone *prz, u32 sig,
 		else {
 			pr_debug("found existing buffer, size %zu, start %zu\n",
 				 buffer_size(prz), buffer_start(prz));
-			persistent_ram_save_old(prz);
+			/*
+			 * The contents are ECC corrected and copied out
+			 * lazily by persistent_ram_save_old() once somebody
+			 * reads the zone.
+			 */
 			return 0;
 		}
 	} else {
@@ -21,12 +21,81 @@
 #include <init.h>
 #include <fs.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <malloc.h>
+#include <xfuncs.h>
+#include <linux/sizes.h>
 #include <linux/stat.h>
 #include <asm/semihosting.h>
 
-static int file_to_fd(const struct file *f)
+/*
+ * Every semihosting operation traps to the debugger, which costs
+ * milliseconds regardless of the transfer size. Stage file I/O through
+ * a large per-file window so that sequential access needs one trap per
+ * window instead of one per caller-sized read or write.
+ */
+#define SMHFS_BUF_SIZE	SZ_1M
+
+struct smhfs_file {
+	int fd;
+	loff_t host_pos;	/* current position of the host file */
+	void *buf;
+	loff_t buf_pos;		/* file offset the buffer starts at */
+	size_t buf_len;		/* valid bytes in the buffer */
+	bool dirty;		/* buffer holds data not yet written back */
+};
+
+static struct smhfs_file *file_to_smhfs(const struct file *f)
 {
-	return (int)(uintptr_t)f->private_data;
+	return f->private_data;
+}
+
+static int smhfs_host_seek(struct smhfs_file *sf, loff_t pos)
+{
+	int ret;
+
+	if (sf->host_pos == pos)
+		return 0;
+
+	ret = semihosting_seek(sf->fd, pos);
+	if (ret < 0)
+		return ret;
+
+	sf->host_pos = pos;
+
+	return 0;
+}
+
+static int smhfs_flush_file(struct smhfs_file *sf)
+{
+	ssize_t ret;
+
+	if (!sf->dirty)
+		return 0;
+
+	ret = smhfs_host_seek(sf, sf->buf_pos);
+	if (ret)
+		return ret;
+
+	ret = semihosting_write(sf->fd, sf->buf, sf->buf_len);
+	if (ret < 0)
+		return ret;
+	if (ret != sf->buf_len)
+		return -EIO;
+
+	sf->host_pos += ret;
+	sf->dirty = false;
+	sf->buf_len = 0;
+
+	return 0;
+}
+
+static void *smhfs_buf(struct smhfs_file *sf)
+{
+	if (!sf->buf)
+		sf->buf = malloc(SMHFS_BUF_SIZE);
+
+	return sf->buf;
 }
 
 static int smhfs_create(struct device __always_unused *dev,
@@ -60,6 +129,7 @@ static int smhfs_truncate(struct file __always_unused *f,
 static int smhfs_open(struct device __always_unused *dev,
 		      struct file *file, const char *filename)
 {
+	struct smhfs_file *sf;
 	int fd;
 	/* Get rid of leading '/' */
 	filename = &filename[1];
@@ -68,10 +138,15 @@ static int smhfs_open(struct device __always_unused *dev,
 	if (fd < 0)
 		return fd;
 
-	file->private_data = (void *)(uintptr_t)fd;
+	sf = xzalloc(sizeof(*sf));
+	sf->fd = fd;
+
+	file->private_data = sf;
 	file->f_size = semihosting_flen(fd);
-	if (file->f_size < 0)
+	if (file->f_size < 0) {
+		free(sf);
 		return file->f_size;
+	}
 
 	return 0;
 }
@@ -79,24 +154,137 @@ static int smhfs_open(struct device __always_unused *dev,
 static int smhfs_close(struct device __always_unused *dev,
 		       struct file *f)
 {
-	return semihosting_close(file_to_fd(f));
+	struct smhfs_file *sf = file_to_smhfs(f);
+	int ret, close_ret;
+
+	ret = smhfs_flush_file(sf);
+	close_ret = semihosting_close(sf->fd);
+
+	free(sf->buf);
+	free(sf);
+
+	return ret ?: close_ret;
 }
 
 static int smhfs_write(struct file *f, const void *inbuf, size_t insize)
 {
-	long ret = semihosting_write(file_to_fd(f), inbuf, insize);
-	return ret < 0 ? ret : insize;
+	struct smhfs_file *sf = file_to_smhfs(f);
+	loff_t pos = f->f_pos;
+	size_t done = 0;
+	ssize_t ret;
+
+	/* large writes go to the host directly */
+	if (!smhfs_buf(sf) || insize >= SMHFS_BUF_SIZE) {
+		ret = smhfs_flush_file(sf);
+		if (ret)
+			return ret;
+
+		/* drop the read-ahead window, it may overlap the write */
+		sf->buf_len = 0;
+
+		ret = smhfs_host_seek(sf, pos);
+		if (ret)
+			return ret;
+
+		ret = semihosting_write(sf->fd, inbuf, insize);
+		if (ret < 0)
+			return ret;
+
+		sf->host_pos += ret;
+
+		return ret;
+	}
+
+	while (done < insize) {
+		size_t chunk;
+
+		if (sf->dirty && pos == sf->buf_pos + sf->buf_len &&
+		    sf->buf_len < SMHFS_BUF_SIZE) {
+			chunk = min_t(size_t, insize - done,
+				      SMHFS_BUF_SIZE - sf->buf_len);
+			memcpy(sf->buf + sf->buf_len, inbuf + done, chunk);
+			sf->buf_len += chunk;
+			done += chunk;
+			pos += chunk;
+			continue;
+		}
+
+		ret = smhfs_flush_file(sf);
+		if (ret)
+			return ret;
+
+		/* start a new coalescing window, dropping any read-ahead */
+		sf->dirty = true;
+		sf->buf_pos = pos;
+		sf->buf_len = 0;
+	}
+
+	return insize;
 }
 
 static int smhfs_read(struct file *f, void *buf, size_t insize)
 {
-	long ret = semihosting_read(file_to_fd(f), buf, insize);
-	return ret < 0 ? ret : insize;
+	struct smhfs_file *sf = file_to_smhfs(f);
+	loff_t pos = f->f_pos;
+	size_t done = 0;
+	ssize_t ret;
+
+	while (done < insize) {
+		size_t chunk = insize - done;
+
+		/* the buffer holds the most recent data, dirty or not */
+		if (pos >= sf->buf_pos && pos < sf->buf_pos + sf->buf_len) {
+			chunk = min_t(size_t, chunk,
+				      sf->buf_pos + sf->buf_len - pos);
+			memcpy(buf + done, sf->buf + (pos - sf->buf_pos),
+			       chunk);
+			done += chunk;
+			pos += chunk;
+			continue;
+		}
+
+		ret = smhfs_flush_file(sf);
+		if (ret)
+			return ret;
+
+		ret = smhfs_host_seek(sf, pos);
+		if (ret)
+			return ret;
+
+		/* large requests go to the host directly */
+		if (!smhfs_buf(sf) || chunk >= SMHFS_BUF_SIZE) {
+			ret = semihosting_read(sf->fd, buf + done, chunk);
+			if (ret < 0)
+				return ret;
+
+			sf->host_pos += ret;
+			done += ret;
+			pos += ret;
+
+			if (ret < chunk)
+				break;
+			continue;
+		}
+
+		ret = semihosting_read(sf->fd, sf->buf, SMHFS_BUF_SIZE);
+		if (ret < 0)
+			return ret;
+		if (!ret)
+			break;
+
+		sf->buf_pos = pos;
+		sf->buf_len = ret;
+		sf->host_pos += ret;
+	}
+
+	return done;
 }
 
-static int smhfs_lseek(struct file *f, loff_t pos)
+static int smhfs_lseek(struct file __always_unused *f,
+		       loff_t __always_unused pos)
 {
-	return semihosting_seek(file_to_fd(f), pos);
+	/* the host file is repositioned lazily on the next transfer */
+	return 0;
 }
 
 static DIR* smhfs_opendir(struct device __always_unused *dev,
@@ -108,15 +296,16 @@ static DIR* smhfs_opendir(struct device __always_unused *dev,
 static int smhfs_stat(struct device __always_unused *dev,
 		      const char *filename, struct stat *s)
 {
-	struct file file;
+	struct file file = {};
 
 	file.f_inode = xzalloc(sizeof(*file.f_inode));
+	file.f_flags = O_RDONLY;
 
 	if (smhfs_open(NULL, &file, filename) == 0) {
 		s->st_mode = S_IFREG | S_IRWXU | S_IRWXG | S_IRWXO;
 		s->st_size = file.f_size;
+		smhfs_close(NULL, &file);
 	}
-	smhfs_close(NULL, &file);
 
 	free(file.f_inode);
 
@@ -226,9 +226,16 @@ static int squashfs_fill_super(struct super_block *sb, void *data, int silent)
 	if (msblk->block_cache == NULL)
 		goto failed_mount;
 
-	/* Allocate read_page block */
+	/*
+	 * Allocate read_page blocks. squashfs_cache_get() looks entries up
+	 * by block address, so sizing this beyond the number of decompressors
+	 * turns the scratch space into a small LRU cache of decompressed
+	 * datablocks, which saves re-decompressing them when several files
+	 * are read alternately.
+	 */
 	msblk->read_page = squashfs_cache_init("data",
-		squashfs_max_decompressors(), msblk->block_size);
+		max_t(int, squashfs_max_decompressors(),
+		      SQUASHFS_CACHED_DATA_BLKS), msblk->block_size);
 	if (msblk->read_page == NULL) {
 		ERROR("Failed to allocate read_page block\n");
 		goto failed_mount;
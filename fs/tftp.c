@@ -21,6 +21,7 @@
 #include <net.h>
 #include <driver.h>
 #include <clock.h>
+#include <sched.h>
 #include <fs.h>
 #include <errno.h>
 #include <libgen.h>
@@ -124,6 +125,8 @@ struct file_priv {
 	int blocksize;
 	unsigned int windowsize;
 	bool is_getattr;
+	uint16_t gap_block;
+	bool gap_acked;
 	struct tftp_cache cache;
 };
 
@@ -317,6 +320,7 @@ static int tftp_poll(struct file_priv *priv)
 
 	if (is_timeout(priv->resend_timeout, TFTP_RESEND_TIMEOUT)) {
 		printf("T ");
+		perfstat_inc(net_perfstat, NET_PERFSTAT_TFTP_RETRANSMITS);
 		priv->resend_timeout = get_time_ns();
 		return TFTP_ERR_RESEND;
 	}
@@ -328,6 +332,7 @@ static int tftp_poll(struct file_priv *priv)
 	}
 
 	net_poll();
+	yield();
 
 	return 0;
 }
@@ -491,15 +496,23 @@ static void tftp_handle_data(struct file_priv *priv, uint16_t block,
 			pr_warn_once("Unexpected packet. global.tftp.windowsize set too high?\n");
 	} else {
 		/* The 'rc < 0' below happens e.g. when datagrams in the first
-		   part of the transfer window are dropped.
-
-		   TODO: this will usually result in a timeout
-		   (TFTP_RESEND_TIMEOUT).  It should be possible to bypass
-		   this timeout by acknowledging the last packet (e.g. by
-		   doing 'priv->ack_block = priv->last_block' here). */
+		   part of the transfer window are dropped. */
 		rc = tftp_window_cache_insert(&priv->cache, block, data, len);
 		if (rc < 0)
 			printf("M");
+
+		/* A cached out-of-order block means 'exp_block' was lost on
+		   the wire.  Instead of waiting for TFTP_RESEND_TIMEOUT,
+		   re-acknowledge the last in-order block once per gap; rfc
+		   7440 servers rewind and resend the window starting after
+		   the acknowledged block. */
+		if (rc >= 0 &&
+		    (!priv->gap_acked || priv->gap_block != exp_block)) {
+			priv->gap_block = exp_block;
+			priv->gap_acked = true;
+			printf("R");
+			tftp_send(priv);
+		}
 	}
 }
 
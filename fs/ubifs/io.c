@@ -95,12 +95,113 @@ void ubifs_ro_mode(struct ubifs_info *c, int err)
  * for more information.
  */
 
+/*
+ * barebox mounts UBIFS read-only and typically streams a few large files at
+ * boot time. The TNC and the data path issue lots of small node reads which
+ * are clustered in a handful of LEBs, so instead of passing every read down
+ * to UBI (and thus to the flash driver) individually, keep the most recently
+ * used LEBs cached in full and serve node reads from the cache.
+ */
+#define UBIFS_LEB_CACHE_NR	4
+
+/**
+ * struct ubifs_leb_cache - one cached logical eraseblock.
+ * @lnum: number of the cached LEB (%-1 if the entry is unused)
+ * @buf: buffer of @c->leb_size bytes holding the LEB contents
+ */
+struct ubifs_leb_cache {
+	int lnum;
+	void *buf;
+};
+
+/**
+ * ubifs_leb_cache_free - free the LEB read cache.
+ * @c: UBIFS file-system description object
+ */
+void ubifs_leb_cache_free(struct ubifs_info *c)
+{
+	int i;
+
+	if (!c->leb_cache)
+		return;
+
+	for (i = 0; i < UBIFS_LEB_CACHE_NR; i++)
+		vfree(c->leb_cache[i].buf);
+	kfree(c->leb_cache);
+	c->leb_cache = NULL;
+}
+
+/**
+ * leb_cache_read - try to serve a read from the LEB cache.
+ * @c: UBIFS file-system description object
+ * @lnum: logical eraseblock number
+ * @buf: buffer to read to
+ * @offs: offset within the logical eraseblock
+ * @len: length to read
+ *
+ * On a cache miss the whole LEB is read from UBI and inserted in MRU order,
+ * evicting the least recently used entry. Returns zero when @buf has been
+ * filled from the cache and %-ENOENT when the caller has to read from UBI
+ * directly (cache unavailable or the LEB could not be read in full, e.g.
+ * because of an ECC error outside the requested range).
+ */
+static int leb_cache_read(struct ubifs_info *c, int lnum, void *buf, int offs,
+			  int len)
+{
+	struct ubifs_leb_cache *lc = c->leb_cache, ent;
+	int i, err;
+
+	if (!lc) {
+		lc = kzalloc(UBIFS_LEB_CACHE_NR * sizeof(*lc), GFP_NOFS);
+		if (!lc)
+			return -ENOENT;
+
+		for (i = 0; i < UBIFS_LEB_CACHE_NR; i++) {
+			lc[i].lnum = -1;
+			lc[i].buf = vmalloc(c->leb_size);
+			if (!lc[i].buf) {
+				while (i--)
+					vfree(lc[i].buf);
+				kfree(lc);
+				return -ENOENT;
+			}
+		}
+
+		c->leb_cache = lc;
+	}
+
+	for (i = 0; i < UBIFS_LEB_CACHE_NR; i++)
+		if (lc[i].lnum == lnum)
+			break;
+
+	if (i == UBIFS_LEB_CACHE_NR) {
+		i--;
+		lc[i].lnum = -1;
+		err = ubi_read(c->ubi, lnum, lc[i].buf, 0, c->leb_size);
+		if (err)
+			return -ENOENT;
+		lc[i].lnum = lnum;
+	}
+
+	/* move the entry to the front so eviction is LRU */
+	ent = lc[i];
+	memmove(&lc[1], &lc[0], i * sizeof(*lc));
+	lc[0] = ent;
+
+	memcpy(buf, lc[0].buf + offs, len);
+
+	return 0;
+}
+
 int ubifs_leb_read(const struct ubifs_info *c, int lnum, void *buf, int offs,
 		   int len, int even_ebadmsg)
 {
 	int err;
 
-	err = ubi_read(c->ubi, lnum, buf, offs, len);
+	/* the cache is mutable state even though the read itself is not */
+	err = leb_cache_read((struct ubifs_info *)c, lnum, buf, offs, len);
+	if (err)
+		err = ubi_read(c->ubi, lnum, buf, offs, len);
 	/*
 	 * In case of %-EBADMSG print the error message only if the
 	 * @even_ebadmsg is true.
@@ -934,6 +934,7 @@ out_free:
 	kfree(c->bu.buf);
 	vfree(c->ileb_buf);
 	vfree(c->sbuf);
+	ubifs_leb_cache_free(c);
 	kfree(c->bottom_up_buf);
 	return err;
 }
@@ -968,6 +969,7 @@ void ubifs_umount(struct ubifs_info *c)
 	kfree(c->bu.buf);
 	vfree(c->ileb_buf);
 	vfree(c->sbuf);
+	ubifs_leb_cache_free(c);
 	kfree(c->bottom_up_buf);
 }
 
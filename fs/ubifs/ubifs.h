@@ -1010,6 +1010,7 @@ struct ubifs_budg_info {
 };
 
 struct ubifs_debug_info;
+struct ubifs_leb_cache;
 
 /**
  * struct ubifs_info - UBIFS file-system description data structure
@@ -1181,6 +1182,7 @@ struct ubifs_debug_info;
  *
  * @gc_lnum: LEB number used for garbage collection
  * @sbuf: a buffer of LEB size used by GC and replay for scanning
+ * @leb_cache: MRU-ordered cache of whole LEBs backing 'ubifs_leb_read()'
  * @idx_gc: list of index LEBs that have been garbage collected
  * @idx_gc_cnt: number of elements on the idx_gc list
  * @gc_seq: incremented for every non-index LEB garbage collected
@@ -1426,6 +1428,7 @@ struct ubifs_info {
 
 	int gc_lnum;
 	void *sbuf;
+	struct ubifs_leb_cache *leb_cache;
 	struct list_head idx_gc;
 	int idx_gc_cnt;
 	int gc_seq;
@@ -1698,6 +1701,7 @@ static inline int ubifs_shash_copy_state(const struct ubifs_info *c,
 
 /* io.c */
 void ubifs_ro_mode(struct ubifs_info *c, int err);
+void ubifs_leb_cache_free(struct ubifs_info *c);
 int ubifs_leb_read(const struct ubifs_info *c, int lnum, void *buf, int offs,
 		   int len, int even_ebadmsg);
 int ubifs_leb_write(struct ubifs_info *c, int lnum, const void *buf, int offs,
@@ -0,0 +1,67 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef __AIO_H
+#define __AIO_H
+
+#include <linux/types.h>
+#include <errno.h>
+
+struct bthread;
+
+/**
+ * struct aio_request - an asynchronous file I/O request
+ * @fd:		file descriptor to operate on
+ * @buf:	buffer to read into or write from
+ * @count:	number of bytes to transfer
+ * @offset:	file offset to transfer at, the file position is not used
+ * @complete:	optional, called from thread context once the transfer is done
+ * @priv:	free for use by the submitter
+ * @ret:	transfer result, valid once the request is done: number of
+ *		bytes transferred or a negative error code
+ *
+ * The request must stay allocated until it is done. One request
+ * describes one transfer; it can be reused after completion, but not
+ * resubmitted while in flight.
+ */
+struct aio_request {
+	int fd;
+	void *buf;
+	size_t count;
+	loff_t offset;
+	void (*complete)(struct aio_request *req);
+	void *priv;
+
+	ssize_t ret;
+
+	/* internal */
+	struct bthread *bthread;
+	bool done;
+};
+
+#ifdef CONFIG_FS_AIO
+int aio_read(struct aio_request *req);
+int aio_write(struct aio_request *req);
+bool aio_is_done(struct aio_request *req);
+ssize_t aio_wait(struct aio_request *req);
+#else
+static inline int aio_read(struct aio_request *req)
+{
+	return -ENOSYS;
+}
+
+static inline int aio_write(struct aio_request *req)
+{
+	return -ENOSYS;
+}
+
+static inline bool aio_is_done(struct aio_request *req)
+{
+	return true;
+}
+
+static inline ssize_t aio_wait(struct aio_request *req)
+{
+	return -ENOSYS;
+}
+#endif
+
+#endif /* __AIO_H */
@@ -0,0 +1,20 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef __ARENA_H
+#define __ARENA_H
+
+#include <types.h>
+#include <stdarg.h>
+#include <linux/compiler.h>
+
+struct arena;
+
+struct arena *arena_push(const char *name);
+void arena_pop(struct arena *arena);
+
+void *arena_alloc(struct arena *arena, size_t size);
+void *arena_zalloc(struct arena *arena, size_t size);
+char *arena_strdup(struct arena *arena, const char *s);
+char *arena_vasprintf(struct arena *arena, const char *fmt, va_list ap);
+char *arena_asprintf(struct arena *arena, const char *fmt, ...) __printf(2, 3);
+
+#endif /* __ARENA_H */
@@ -33,10 +33,24 @@ enum blk_type {
 
 const char *blk_type_str(enum blk_type);
 
+/* log2 service time buckets: <1us, 1-2us, ... with the last a catch-all */
+#define BLK_STATS_LAT_BUCKETS	16
+
+/* transfer size classes: <=8, <=64, <=512 and >512 sectors */
+#define BLK_STATS_SIZE_CLASSES	4
+
+enum blk_stats_dir {
+	BLK_STATS_READ,
+	BLK_STATS_WRITE,
+	BLK_STATS_DIR_COUNT,
+};
+
 struct block_device_stats {
 	blkcnt_t read_sectors;
 	blkcnt_t write_sectors;
 	blkcnt_t erase_sectors;
+	u32 latency[BLK_STATS_DIR_COUNT][BLK_STATS_SIZE_CLASSES]
+		   [BLK_STATS_LAT_BUCKETS];
 };
 
 struct block_device {
@@ -49,10 +63,14 @@ struct block_device {
 	blkcnt_t num_blocks;
 	int rdbufsize;
 	int blkmask;
+	unsigned int cache_size;
 
 	sector_t discard_start;
 	blkcnt_t discard_size;
 
+	sector_t ra_next;
+	void *ra_buf;
+
 	struct list_head buffered_blocks;
 	struct list_head idle_blocks;
 
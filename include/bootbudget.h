@@ -0,0 +1,25 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef __BOOTBUDGET_H
+#define __BOOTBUDGET_H
+
+enum boot_budget_stage {
+	BOOT_BUDGET_PROBE,	/* device probing done */
+	BOOT_BUDGET_ENV,	/* environment loaded */
+	BOOT_BUDGET_BOOT,	/* handing over to the kernel */
+	BOOT_BUDGET_MAX,
+};
+
+#ifdef CONFIG_BOOT_BUDGET
+void boot_budget_set(enum boot_budget_stage stage, unsigned int budget_ms);
+void boot_budget_checkpoint(enum boot_budget_stage stage);
+#else
+static inline void boot_budget_set(enum boot_budget_stage stage,
+				   unsigned int budget_ms)
+{
+}
+static inline void boot_budget_checkpoint(enum boot_budget_stage stage)
+{
+}
+#endif
+
+#endif /* __BOOTBUDGET_H */
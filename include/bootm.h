@@ -6,6 +6,8 @@
 #include <filetype.h>
 #include <linux/list.h>
 
+struct arena;
+
 enum bootm_verify {
 	BOOTM_VERIFY_NONE,
 	BOOTM_VERIFY_HASH,
@@ -46,7 +48,12 @@ struct bootm_data {
 
 int bootm_boot(struct bootm_data *data);
 
+struct bootm_prefetch;
+
 struct image_data {
+	/* scope for allocations living until the end of the boot attempt */
+	struct arena *arena;
+
 	/* simplest case. barebox has already loaded the os here */
 	struct resource *os_res;
 
@@ -87,6 +94,10 @@ struct image_data {
 	char *oftree_file;
 	char *oftree_part;
 
+	/* in-flight reads of the companion images, see bootm_prefetch_start() */
+	struct bootm_prefetch *initrd_prefetch;
+	struct bootm_prefetch *oftree_prefetch;
+
 	const void *fit_kernel;
 	unsigned long fit_kernel_size;
 	void *fit_config;
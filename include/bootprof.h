@@ -0,0 +1,23 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef __BOOTPROF_H
+#define __BOOTPROF_H
+
+#include <types.h>
+
+enum bootprof_type {
+	BOOTPROF_INITCALL,
+	BOOTPROF_PROBE,
+	BOOTPROF_BOOTM,
+};
+
+#ifdef CONFIG_BOOTPROF
+void bootprof_record(enum bootprof_type type, const void *func,
+		     const char *name, u64 start);
+#else
+static inline void bootprof_record(enum bootprof_type type, const void *func,
+				   const char *name, u64 start)
+{
+}
+#endif
+
+#endif /* __BOOTPROF_H */
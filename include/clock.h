@@ -35,12 +35,14 @@ static inline uint64_t cyc2ns(struct clocksource *cs, uint64_t cycles)
 int init_clock(struct clocksource *);
 
 uint64_t get_time_ns(void);
+uint64_t get_time_ns_coarse(void);
 
 void clocks_calc_mult_shift(uint32_t *mult, uint32_t *shift, uint32_t from, uint32_t to, uint32_t maxsec);
 
 uint32_t clocksource_hz2mult(uint32_t hz, uint32_t shift_constant);
 
 int is_timeout(uint64_t start_ns, uint64_t time_offset_ns);
+int is_timeout_coarse(uint64_t start_ns, uint64_t time_offset_ns);
 int is_timeout_non_interruptible(uint64_t start_ns, uint64_t time_offset_ns);
 
 #define SCHED_TIMEOUT_MIN	(100 * USECOND)
@@ -55,6 +57,7 @@ void arm_architected_timer_udelay(unsigned long us);
 
 void ndelay(unsigned long nsecs);
 void udelay(unsigned long usecs);
+void udelay_yield(unsigned long usecs);
 void mdelay(unsigned long msecs);
 void mdelay_non_interruptible(unsigned long msecs);
 
@@ -61,6 +61,8 @@ struct of_device_id;
  *          should actually detect client devices.
  * @rescan: Callback to rescan the device.
  * @deferred_probe_reason: If a driver probe is deferred, this stores the last error.
+ * @deferred_driver: The driver that matched but deferred its probe, so the
+ *                   retry passes don't have to scan the whole bus again.
  */
 struct device {
 	union {
@@ -122,6 +124,8 @@ struct device {
 	void (*rescan)(struct device *);
 
 	char *deferred_probe_reason;
+
+	struct driver *deferred_driver;
 };
 
 #define bobj_to_dev(__bobj)	container_of_const(__bobj, struct device, bobject)
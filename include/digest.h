@@ -8,9 +8,15 @@
 
 #include <linux/list.h>
 #include <errno.h>
+#include <perfstat.h>
 
 struct digest;
 
+enum {
+	DIGEST_PERFSTAT_BYTES,
+};
+DECLARE_PERFSTAT_GROUP(digest_perfstat);
+
 enum hash_algo {
 	HASH_ALGO_MD4,
 	HASH_ALGO_MD5,
@@ -119,6 +125,9 @@ static inline int digest_init(struct digest *d)
 static inline int digest_update(struct digest *d, const void *data,
 				      unsigned long len)
 {
+	if (IN_PROPER)
+		perfstat_add(digest_perfstat, DIGEST_PERFSTAT_BYTES, len);
+
 	return d->algo->update(d, data, len);
 }
 
@@ -130,6 +139,9 @@ static inline int digest_final(struct digest *d, unsigned char *md)
 static inline int digest_digest(struct digest *d, const void *data,
 		      unsigned int len, u8 *md)
 {
+	if (IN_PROPER)
+		perfstat_add(digest_perfstat, DIGEST_PERFSTAT_BYTES, len);
+
 	return d->algo->digest(d, data, len, md);
 }
 
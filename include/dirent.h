@@ -5,6 +5,8 @@
 #include <linux/list.h>
 
 struct dirent {
+	/* DT_* entry type, DT_UNKNOWN if the filesystem doesn't say */
+	unsigned char d_type;
 	char d_name[256];
 };
 
@@ -2,6 +2,7 @@
 #ifndef __DMA_DEVICES_H
 #define __DMA_DEVICES_H
 
+#include <linux/errno.h>
 #include <linux/types.h>
 
 /**
@@ -171,4 +172,18 @@ int dma_send(struct dma *dma, dma_addr_t src, size_t len, void *metadata);
 int dma_receive(struct dma *dma, dma_addr_t *dst, void *metadata);
 int dma_release(struct dma *dma);
 
+/*
+ * Offload a bulk copy to the first registered DMA device implementing the
+ * ->transfer() operation. The buffers may be cached, they are mapped and
+ * unmapped here. Callers are expected to fall back to a CPU copy on error.
+ */
+#ifdef CONFIG_DMADEVICES
+int dma_memcpy(void *dst, const void *src, size_t len);
+#else
+static inline int dma_memcpy(void *dst, const void *src, size_t len)
+{
+	return -ENOSYS;
+}
+#endif
+
 #endif /* __DMA_DEVICES_H */
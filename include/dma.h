@@ -111,6 +111,20 @@ dma_addr_t dma_map_single(struct device *dev, void *ptr,
 
 void dma_unmap_single(struct device *dev, dma_addr_t dma_addr,
 		      size_t size, enum dma_data_direction dir);
+
+struct scatterlist;
+
+int dma_map_sg(struct device *dev, struct scatterlist *sgl, int nents,
+	       enum dma_data_direction dir);
+
+void dma_unmap_sg(struct device *dev, struct scatterlist *sgl, int nents,
+		  enum dma_data_direction dir);
+
+void dma_sync_sg_for_cpu(struct device *dev, struct scatterlist *sgl,
+			 int nents, enum dma_data_direction dir);
+
+void dma_sync_sg_for_device(struct device *dev, struct scatterlist *sgl,
+			    int nents, enum dma_data_direction dir);
 #else
 /*
  * assumes buffers are in coherent/uncached memory, e.g. because
@@ -141,6 +155,25 @@ static inline void dma_unmap_single(struct device *dev, dma_addr_t dma_addr,
 #endif
 
 
+#ifdef CONFIG_DMA_COHERENT_POOL
+void *dma_pool_alloc_coherent(size_t size, dma_addr_t *dma_handle);
+bool dma_pool_free_coherent(void *mem);
+bool dma_pool_contains(const void *mem);
+#else
+static inline void *dma_pool_alloc_coherent(size_t size, dma_addr_t *dma_handle)
+{
+	return NULL;
+}
+static inline bool dma_pool_free_coherent(void *mem)
+{
+	return false;
+}
+static inline bool dma_pool_contains(const void *mem)
+{
+	return false;
+}
+#endif
+
 #ifndef dma_alloc_coherent
 void *dma_alloc_coherent(struct device *dev, size_t size, dma_addr_t *dma_handle);
 #endif
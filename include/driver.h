@@ -45,6 +45,11 @@ struct driver {
 	/*! Called if an instance of a device is gone. */
 	void (*remove)(struct device *);
 
+	/*! When true and CONFIG_ASYNC_PROBE is enabled, probe may run in
+	 * a bthread, so that delay loops in it overlap with the rest of
+	 * the startup sequence. */
+	bool probe_async;
+
 	struct bus_type *bus;
 
 	const struct platform_device_id *id_table;
@@ -412,6 +417,7 @@ struct cdev {
 	struct device *dev;
 	struct device_node *device_node;
 	struct list_head list;
+	struct hlist_node name_hash;
 	struct list_head devices_list;
 	char *name; /* filename under /dev/ */
 	char *partname; /* the partition name, usually the above without the
@@ -477,6 +483,21 @@ int cdev_fdopen(struct cdev *cdev, unsigned long flags);
 int cdev_close(struct cdev *cdev);
 int cdev_flush(struct cdev *cdev);
 
+/**
+ * struct io_segment - one segment of a gather read
+ * @offset: device or file offset to read at
+ * @buf:    buffer to read into
+ * @count:  number of bytes to read
+ *
+ * Segments may be passed in any order; gather reads sort them by
+ * offset so the medium is traversed in a single pass.
+ */
+struct io_segment {
+	loff_t offset;
+	void *buf;
+	size_t count;
+};
+
 typedef int (*cdev_alias_processor_t)(struct cdev *, void *data);
 
 #ifdef CONFIG_CDEV_ALIAS
@@ -491,6 +512,7 @@ static inline int cdev_alias_resolve_for_each(const char *name,
 #endif
 #if IN_PROPER
 ssize_t cdev_read(struct cdev *cdev, void *buf, size_t count, loff_t offset, ulong flags);
+ssize_t cdev_readv(struct cdev *cdev, struct io_segment *segs, unsigned int nsegs);
 ssize_t cdev_write(struct cdev *cdev, const void *buf, size_t count, loff_t offset, ulong flags);
 struct cdev *cdev_by_name(const char *filename);
 struct cdev *cdev_open_by_name(const char *name, unsigned long flags);
@@ -500,6 +522,10 @@ static inline ssize_t cdev_read(struct cdev *cdev, void *buf, size_t count, loff
 {
 	return -ENOSYS;
 }
+static inline ssize_t cdev_readv(struct cdev *cdev, struct io_segment *segs, unsigned int nsegs)
+{
+	return -ENOSYS;
+}
 static inline ssize_t cdev_write(struct cdev *cdev, const void *buf, size_t count, loff_t offset, ulong flags)
 {
 	return -ENOSYS;
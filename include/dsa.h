@@ -67,8 +67,6 @@ struct dsa_port {
 	struct dsa_switch *ds;
 	unsigned int index;
 	struct eth_device edev;
-	unsigned char *rx_buf;
-	size_t rx_buf_length;
 	bool enabled;
 };
 
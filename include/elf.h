@@ -398,6 +398,8 @@ struct elf_image {
 	void *low_addr;
 	void *high_addr;
 	void *hdr_buf;
+	u64 hdr_size;
+	int fd;
 	const char *filename;
 };
 
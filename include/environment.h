@@ -10,11 +10,21 @@
 #include <linux/list.h>
 #include <errno.h>
 
+/* Buckets of the per-context variable name index */
+#define ENV_HASH_BITS	6
+#define ENV_HASH_SIZE	(1 << ENV_HASH_BITS)
+
 /**
  * Managment of a environment variable
+ *
+ * Variables are kept on two structures in parallel: the list preserves
+ * creation order for iteration, the hash chain makes lookups by name
+ * independent of the number of variables.
  */
 struct variable_d {
 	struct list_head list;
+	struct hlist_node hash_node;
+	unsigned int hash;
 	const char *name;
 	const char *data;
 };
@@ -23,6 +33,8 @@ struct env_context {
 	struct env_context *parent;
 	struct list_head local;
 	struct list_head global;
+	struct hlist_head local_hash[ENV_HASH_SIZE];
+	struct hlist_head global_hash[ENV_HASH_SIZE];
 };
 
 struct env_context *get_current_context(void);
@@ -133,6 +133,8 @@ struct fb_ops {
 	int (*fb_activate_var)(struct fb_info *info);
 	void (*fb_damage)(struct fb_info *info, const struct fb_rect *rect);
 	void (*fb_flush)(struct fb_info *info);
+	/* make screen_base the visible buffer, after the core swapped it */
+	int (*fb_flip)(struct fb_info *info);
 };
 
 /*
@@ -166,6 +168,7 @@ struct fb_info {
 
 	void *screen_base;
 	void *screen_base_shadow;
+	void *screen_base_back;
 	unsigned long screen_size;
 
 	void *priv;
@@ -206,10 +209,12 @@ int fb_enable(struct fb_info *info);
 int fb_disable(struct fb_info *info);
 void fb_damage(struct fb_info *info, struct fb_rect *rect);
 void fb_flush(struct fb_info *info);
+int fb_flip(struct fb_info *info);
 
 #define FBIOGET_SCREENINFO	_IOR('F', 1, loff_t)
 #define	FBIO_ENABLE		_IO('F', 2)
 #define	FBIO_DISABLE		_IO('F', 3)
+#define	FBIO_FLIP		_IO('F', 4)
 
 extern struct bus_type fb_bus;
 
@@ -89,6 +89,8 @@ struct fs_device {
 	bool loop;
 	char *path;
 	struct list_head list;
+	/* chains mounted filesystems hashed by mountpoint dentry */
+	struct hlist_node mount_hash;
 	char *options;
 	char *linux_rootarg;
 
@@ -113,6 +115,7 @@ int flush(int fd);
 int umount_by_cdev(struct cdev *cdev);
 
 /* not-so-standard functions */
+ssize_t pread_segments(int fd, struct io_segment *segs, unsigned int nsegs);
 #define ERASE_SIZE_ALL	((loff_t) - 1)
 int erase(int fd, loff_t count, loff_t offset, enum erase_type type);
 int protect(int fd, size_t count, loff_t offset, int prot);
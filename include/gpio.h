@@ -12,6 +12,9 @@
 #ifdef CONFIG_GENERIC_GPIO
 void gpio_set_value(unsigned gpio, int value);
 int gpio_get_value(unsigned gpio);
+int gpio_set_multiple(const unsigned *gpios, const int *values,
+		      unsigned int ngpio);
+int gpio_get_multiple(const unsigned *gpios, int *values, unsigned int ngpio);
 int gpio_direction_output(unsigned gpio, int value);
 int gpio_direction_input(unsigned gpio);
 #else
@@ -22,6 +25,16 @@ static inline int gpio_get_value(unsigned gpio)
 {
 	return 0;
 }
+static inline int gpio_set_multiple(const unsigned *gpios, const int *values,
+				    unsigned int ngpio)
+{
+	return -EINVAL;
+}
+static inline int gpio_get_multiple(const unsigned *gpios, int *values,
+				    unsigned int ngpio)
+{
+	return -EINVAL;
+}
 static inline int gpio_direction_output(unsigned gpio, int value)
 {
 	return -EINVAL;
@@ -195,6 +208,14 @@ struct gpio_ops {
 	int (*get_direction)(struct gpio_chip *chip, unsigned offset);
 	int (*get)(struct gpio_chip *chip, unsigned offset);
 	void (*set)(struct gpio_chip *chip, unsigned offset, int value);
+	/*
+	 * Optional bank-wide accessors. mask selects the lines to operate
+	 * on, bits holds their values, both indexed by chip offset.
+	 */
+	int (*get_multiple)(struct gpio_chip *chip, unsigned long *mask,
+			    unsigned long *bits);
+	void (*set_multiple)(struct gpio_chip *chip, unsigned long *mask,
+			     unsigned long *bits);
 	int (*set_config)(struct gpio_chip *chip, unsigned offset, unsigned long config);
 
 #if defined(CONFIG_OF_GPIO)
@@ -15,6 +15,7 @@ struct fit_handle {
 	void *fit_alloc;
 	size_t size;
 	char *filename;
+	int fd;		/* kept open while @fit points into a mapping */
 
 	struct list_head entry;
 	refcount_t users;
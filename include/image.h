@@ -299,6 +299,7 @@ struct uimage_handle_data {
 struct uimage_handle *uimage_open(const char *filename);
 void uimage_close(struct uimage_handle *handle);
 int uimage_verify(struct uimage_handle *handle);
+int uimage_defer_verify(struct uimage_handle *handle);
 int uimage_load(struct uimage_handle *handle, unsigned int image_no,
 		long(*flush)(void*, unsigned long));
 void uimage_print_contents(struct uimage_handle *handle);
@@ -317,6 +318,8 @@ struct uimage_handle {
 	int nb_data_entries;
 	size_t data_offset;
 	int fd;
+	void *map;
+	bool verify_deferred;
 };
 
 #define UIMAGE_INVALID_ADDRESS	(~0)
@@ -30,9 +30,13 @@ int write_file_flash(const char *filename, const void *buf, size_t size);
 
 #define COPY_FILE_VERBOSE	BIT(0)
 #define COPY_FILE_NO_OVERWRITE	BIT(1)
+#define COPY_FILE_SPARSE	BIT(2)
 
 int copy_file(const char *src, const char *dst, unsigned flags);
 
+int copy_file_verify(const char *src, const char *dst, unsigned flags,
+		     const char *algo, const char *hex);
+
 int copy_recursive(const char *src, const char *dst, unsigned flags);
 
 int compare_file(const char *f1, const char *f2);
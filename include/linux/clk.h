@@ -390,6 +390,7 @@ struct clk {
 	const struct clk_ops *ops;
 	int enable_count;
 	struct list_head list;
+	struct hlist_node name_hash;
 	const char *name;
 	const char * const *parent_names;
 	int num_parents;
@@ -92,6 +92,7 @@ void d_add(struct dentry *, struct inode *);
 struct dentry * d_alloc_anon(struct super_block *);
 void d_set_d_op(struct dentry *dentry, const struct dentry_operations *op);
 void d_instantiate(struct dentry *dentry, struct inode *inode);
+struct dentry *d_prime_readdir(struct dentry *parent, const char *name);
 void d_delete(struct dentry *);
 struct dentry *dget(struct dentry *);
 void dput(struct dentry *);
@@ -12,6 +12,7 @@
 
 #ifndef __ASSEMBLY__
 #include <linux/list.h>
+#include <linux/rbtree.h>
 #include <linux/compiler.h>
 #include <linux/types.h>
 /*
@@ -29,6 +30,9 @@ struct resource {
 	struct resource *parent;
 	struct list_head children;
 	struct list_head sibling;
+	/* children additionally kept in an rbtree ordered by start */
+	struct rb_root rb_children;
+	struct rb_node rb;
 };
 
 /*
@@ -109,6 +109,8 @@ struct mtd_ooblayout_ops {
 		    struct mtd_oob_region *oobfree);
 };
 
+struct mtd_page_cache;
+
 struct mtd_info {
 	u_char type;
 	u_int32_t flags;
@@ -233,6 +235,9 @@ struct mtd_info {
 
 	struct cdev *cdev_bb;
 
+	/* cache of recently read pages, see CONFIG_MTD_READ_CACHE */
+	struct mtd_page_cache *page_cache;
+
 	struct param_d param_size;
 	char *size_str;
 
@@ -281,6 +286,28 @@ static inline void mtd_set_ooblayout(struct mtd_info *mtd,
 }
 
 int mtd_erase(struct mtd_info *mtd, struct erase_info *instr);
+
+#ifdef CONFIG_MTD_ERASE_ASYNC
+int mtd_erase_async(struct mtd_info *mtd, loff_t addr, loff_t len);
+int mtd_erase_async_finish(struct mtd_info *mtd);
+#else
+static inline int mtd_erase_async(struct mtd_info *mtd, loff_t addr, loff_t len)
+{
+	struct erase_info erase = {
+		.mtd = mtd,
+		.addr = addr,
+		.len = len,
+	};
+
+	return mtd_erase(mtd, &erase);
+}
+
+static inline int mtd_erase_async_finish(struct mtd_info *mtd)
+{
+	return 0;
+}
+#endif
+
 int mtd_read(struct mtd_info *mtd, loff_t from, size_t len, size_t *retlen,
 	     u_char *buf);
 int mtd_write(struct mtd_info *mtd, loff_t to, size_t len, size_t *retlen,
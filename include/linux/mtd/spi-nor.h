@@ -112,6 +112,9 @@
 
 #define SR_QUAD_EN_MX		BIT(6)	/* Macronix Quad I/O */
 
+/* Status Register 2 bits. */
+#define SR2_QUAD_EN_BIT7	BIT(1)
+
 /* Flag Status Register bits */
 #define FSR_READY		BIT(7)
 
@@ -180,6 +180,7 @@ struct log_entry {
 	struct list_head list;
 	uint64_t timestamp;
 	int level;
+	int alloc;
 	char msg[];
 };
 
@@ -159,6 +159,13 @@ struct usb_host {
 
 	bool no_desc_before_addr;
 
+	/*
+	 * Biggest buffer submit_bulk_msg() accepts in one call, or 0 if the
+	 * host controller driver doesn't state one. Class drivers may use
+	 * this to size their transfers.
+	 */
+	size_t max_transfer;
+
 	struct list_head list;
 
 	struct device *hw_dev;
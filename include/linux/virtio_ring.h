@@ -85,6 +85,7 @@ struct vring {
 
 struct vring_desc_state_split {
 	void *data;			/* Data for callback. */
+	struct vring_desc *indir_desc;	/* Indirect descriptor table, if any. */
 };
 
 /**
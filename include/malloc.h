@@ -94,4 +94,16 @@ void memleak_check(void);
 static inline void memleak_check(void) {}
 #endif
 
+#ifdef CONFIG_MALLOC_TRACE
+void malloc_trace_alloc(void *mem, size_t bytes);
+void malloc_trace_free(void *mem);
+void malloc_trace_enable(unsigned int interval);
+void malloc_trace_report(void);
+#else
+static inline void malloc_trace_alloc(void *mem, size_t bytes) {}
+static inline void malloc_trace_free(void *mem) {}
+static inline void malloc_trace_enable(unsigned int interval) {}
+static inline void malloc_trace_report(void) {}
+#endif
+
 #endif /* __MALLOC_H */
@@ -541,6 +541,13 @@ enum mci_timing {
 	MMC_TIMING_SD_EXP_1_2V	= 12,
 };
 
+/* Upper limit for the eMMC timing mode, settable via device parameter */
+enum mci_timing_cap {
+	MCI_TIMING_CAP_DDR52	= 0,
+	MCI_TIMING_CAP_HS200	= 1,
+	MCI_TIMING_CAP_HS400	= 2,
+};
+
 static inline bool mci_timing_is_ddr(enum mci_timing timing)
 {
 	switch (timing) {
@@ -630,6 +637,8 @@ struct mci_host {
 	unsigned mmc_avail_type;	/**< supported device type by both host and card */
 	unsigned hs_max_dtr;
 	unsigned hs200_max_dtr;
+	unsigned hs400_max_dtr;
+	int max_timing;		/**< cap on the negotiated eMMC timing mode */
 	unsigned max_req_size;
 	unsigned dsr_val;	/**< optional dsr value */
 	int use_dsr;		/**< optional dsr usage flag */
@@ -761,6 +770,7 @@ static inline struct mci *mci_get_device_by_devpath(const char *devpath)
 #define MMC_HIGH_52_MAX_DTR	52000000
 #define MMC_HIGH_DDR_MAX_DTR	52000000
 #define MMC_HS200_MAX_DTR	200000000
+#define MMC_HS400_MAX_DTR	200000000
 
 static inline int mmc_card_hs(struct mci *mci)
 {
@@ -798,4 +808,9 @@ static inline bool mmc_card_hs200(struct mci *mci)
 	return mci->host->ios.timing == MMC_TIMING_MMC_HS200;
 }
 
+static inline bool mmc_card_hs400(struct mci *mci)
+{
+	return mci->host->ios.timing == MMC_TIMING_MMC_HS400;
+}
+
 #endif /* _MCI_H_ */
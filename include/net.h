@@ -17,6 +17,7 @@
 #include <clock.h>
 #include <led.h>
 #include <dma.h>
+#include <perfstat.h>
 #include <slice.h>
 #include <xfuncs.h>
 #include <linux/phy.h>
@@ -29,6 +30,14 @@
 /* The number of receive packet buffers */
 #define PKTBUFSRX	4
 
+/* hot-path event counters, shared between net core, eth and tftp */
+enum {
+	NET_PERFSTAT_RX_PACKETS,
+	NET_PERFSTAT_TX_PACKETS,
+	NET_PERFSTAT_TFTP_RETRANSMITS,
+};
+DECLARE_PERFSTAT_GROUP(net_perfstat);
+
 struct device;
 
 struct eth_device {
@@ -97,6 +106,8 @@ static inline int eth_send_raw(struct eth_device *edev, void *packet,
 	if (edev->tx_monitor)
 		edev->tx_monitor(edev, packet, length);
 
+	perfstat_inc(net_perfstat, NET_PERFSTAT_TX_PACKETS);
+
 	return edev->send(edev, packet, length);
 }
 
@@ -109,6 +120,7 @@ void eth_close(struct eth_device *edev);
 int eth_send(struct eth_device *edev, void *packet, int length);	   /* Send a packet		*/
 int eth_rx(void);			/* Check for received packets	*/
 void eth_open_all(void);
+void net_arp_invalidate(struct eth_device *edev); /* Drop cached ARP entries */
 struct eth_device *of_find_eth_device_by_node(struct device_node *np);
 int eth_set_promisc(struct eth_device *edev, bool enable);
 
@@ -157,6 +169,7 @@ struct ethernet {
 #define PROT_VLAN	0x8100		/* IEEE 802.1q protocol		*/
 
 #define IPPROTO_ICMP	 1	/* Internet Control Message Protocol	*/
+#define IPPROTO_TCP	 6	/* Transmission Control Protocol	*/
 #define IPPROTO_UDP	17	/* User Datagram Protocol		*/
 
 #define IP_BROADCAST    0xffffffff /* Broadcast IP aka 255.255.255.255 */
@@ -185,6 +198,23 @@ struct udphdr {
 	uint16_t	uh_sum;		/* udp checksum */
 } __attribute__ ((packed));
 
+struct tcphdr {
+	uint16_t	th_sport;	/* source port */
+	uint16_t	th_dport;	/* destination port */
+	uint32_t	th_seq;		/* sequence number */
+	uint32_t	th_ack;		/* acknowledgment number */
+	uint8_t		th_off;		/* data offset in upper 4 bits */
+	uint8_t		th_flags;	/* segment flags */
+#define TCP_FIN		0x01
+#define TCP_SYN		0x02
+#define TCP_RST		0x04
+#define TCP_PSH		0x08
+#define TCP_ACK		0x10
+	uint16_t	th_win;		/* advertised receive window */
+	uint16_t	th_sum;		/* checksum */
+	uint16_t	th_urp;		/* urgent pointer */
+} __attribute__ ((packed));
+
 /*
  *	Address Resolution Protocol (ARP) header.
  */
@@ -302,6 +332,11 @@ static inline char *net_eth_to_udp_payload(char *pkt)
 	return (char *)(net_eth_to_udphdr(pkt) + 1);
 }
 
+static inline struct tcphdr *net_eth_to_tcphdr(char *pkt)
+{
+	return (struct tcphdr *)(net_eth_to_iphdr(pkt) + 1);
+}
+
 static inline int net_eth_to_udplen(char *pkt)
 {
 	struct udphdr *udp = net_eth_to_udphdr(pkt);
@@ -369,11 +404,16 @@ int string_to_ethaddr(const char *str, u8 enetaddr[6]);
 
 #ifdef CONFIG_NET_RESOLV
 int resolv(const char *host, IPaddr_t *ip);
+void resolv_prefetch(const char *host);
 #else
 static inline int resolv(const char *host, IPaddr_t *ip)
 {
 	return string_to_ip(host, ip);
 }
+
+static inline void resolv_prefetch(const char *host)
+{
+}
 #endif
 
 /**
@@ -547,6 +587,7 @@ struct net_connection {
 	struct udphdr *udp;
 	struct eth_device *edev;
 	struct icmphdr *icmp;
+	struct tcphdr *tcp;
 	unsigned char *packet;
 	struct list_head list;
 	rx_handler_f *handler;
@@ -554,15 +595,8 @@ struct net_connection {
 	void *priv;
 };
 
-static inline char *net_alloc_packet(void)
-{
-	return dma_alloc(PKTSIZE);
-}
-
-static inline void net_free_packet(char *pkt)
-{
-	return dma_free(pkt);
-}
+char *net_alloc_packet(void);
+void net_free_packet(char *pkt);
 
 int net_alloc_packets(void **packets, int count);
 void net_free_packets(void **packets, unsigned count);
@@ -577,6 +611,9 @@ struct net_connection *net_udp_eth_new(struct eth_device *edev, IPaddr_t dest,
 struct net_connection *net_icmp_new(IPaddr_t dest, rx_handler_f *handler,
 		void *ctx);
 
+struct net_connection *net_tcp_new(IPaddr_t dest, uint16_t dport,
+		rx_handler_f *handler, void *ctx);
+
 void net_unregister(struct net_connection *con);
 
 static inline int net_udp_bind(struct net_connection *con, uint16_t sport)
@@ -591,8 +628,15 @@ static inline void *net_udp_get_payload(struct net_connection *con)
 		sizeof(struct udphdr);
 }
 
+static inline void *net_tcp_get_payload(struct net_connection *con)
+{
+	return con->packet + sizeof(struct ethernet) + sizeof(struct iphdr) +
+		sizeof(struct tcphdr);
+}
+
 int net_udp_send(struct net_connection *con, int len);
 int net_icmp_send(struct net_connection *con, int len);
+int net_tcp_send(struct net_connection *con, int len);
 
 void led_trigger_network(enum led_trigger trigger);
 
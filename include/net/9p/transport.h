@@ -32,6 +32,10 @@ struct iov_iter;
  * @create: member function to create a new connection on this transport
  * @close: member function to discard a connection on this transport
  * @request: member function to issue a request to the transport
+ * @zc_request: member function to issue a request where the data payloads
+ *              are handed to the transport untouched, so that it can map
+ *              them directly instead of copying them through the inline
+ *              message buffers
  * @poll: member function to poll for completed requests
  * @cancel: member function to cancel a request (if it hasn't been sent)
  * @cancelled: member function to notify that a cancelled request will not
@@ -55,6 +59,12 @@ struct p9_trans_module {
 		      const char *devname, char *args);
 	void (*close)(struct p9_client *client);
 	int (*request)(struct p9_client *client, struct p9_req_t *req);
+	/* Like @request, but with zero-copy payloads: @uidata receives the
+	 * response payload, @uodata carries the request payload. On success
+	 * @uodata is advanced by @outlen, @uidata is left to the caller. */
+	int (*zc_request)(struct p9_client *client, struct p9_req_t *req,
+			  struct iov_iter *uidata, struct iov_iter *uodata,
+			  int inlen, int outlen, int in_hdr_len);
 	int (*poll)(struct p9_client *client);
 	int (*cancel)(struct p9_client *client, struct p9_req_t *req);
 	int (*cancelled)(struct p9_client *client, struct p9_req_t *req);
@@ -0,0 +1,14 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef __OBJCACHE_H
+#define __OBJCACHE_H
+
+#include <types.h>
+
+struct objcache;
+
+struct objcache *objcache_create(const char *name, size_t size, size_t align,
+				 unsigned int max_free);
+void *objcache_alloc(struct objcache *cache);
+void objcache_free(struct objcache *cache, void *obj);
+
+#endif /* __OBJCACHE_H */
@@ -89,6 +89,7 @@ struct driver;
 struct resource;
 
 void of_fix_tree(struct device_node *);
+void of_fix_tree_dirty(void);
 
 bool of_match(struct device *dev, const struct driver *drv);
 
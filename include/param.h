@@ -51,6 +51,7 @@ const char *get_param_type(struct param_d *param);
 const char *bobject_get_param(bobject_t bobj, const char *name);
 int bobject_set_param(bobject_t bobj, const char *name, const char *val);
 struct param_d *get_param_by_name(bobject_t bobj, const char *name);
+const char *param_get_value(struct param_d *param);
 
 struct param_d *bobject_add_param(bobject_t bobj, const char *name,
 			      int (*set)(bobject_t bobj, struct param_d *p, const char *val),
@@ -136,6 +137,11 @@ static inline struct param_d *get_param_by_name(bobject_t bobj,
 	return NULL;
 }
 
+static inline const char *param_get_value(struct param_d *param)
+{
+	return NULL;
+}
+
 static inline struct param_d *bobject_add_param(bobject_t bobj,
 					    const char *name,
 					    int (*set)(bobject_t bobj, struct param_d *p, const char *val),
@@ -0,0 +1,59 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef __PERFSTAT_H
+#define __PERFSTAT_H
+
+#include <linux/types.h>
+#include <linux/list.h>
+#include <init.h>
+
+struct perfstat_counter {
+	const char *name;
+	u64 count;
+};
+
+struct perfstat_group {
+	const char *name;
+	struct perfstat_counter *counters;
+	unsigned int num;
+	u64 *snap;		/* last snapshot, NULL before the first one */
+	struct list_head list;
+};
+
+/*
+ * Define a subsystem's counter array. The counters are plain u64s and
+ * always present; only the perfstat command depends on CONFIG_PERFSTAT.
+ */
+#define DEFINE_PERFSTAT_GROUP(_var, _name, ...)				\
+	struct perfstat_group _var = {					\
+		.name = _name,						\
+		.counters = (struct perfstat_counter[]) { __VA_ARGS__ },\
+		.num = sizeof((struct perfstat_counter[]) { __VA_ARGS__ }) / \
+		       sizeof(struct perfstat_counter),			\
+	}
+
+#define DECLARE_PERFSTAT_GROUP(_var)	extern struct perfstat_group _var
+
+#define PERFSTAT_GROUP_REGISTER(_var)					\
+	static int _var##_register(void)				\
+	{								\
+		perfstat_register_group(&_var);				\
+		return 0;						\
+	}								\
+	device_initcall(_var##_register)
+
+#ifdef CONFIG_PERFSTAT
+void perfstat_register_group(struct perfstat_group *group);
+
+/* a load, an add and a store - cheap enough for any hot path */
+#define perfstat_inc(_var, _idx)	((_var).counters[_idx].count++)
+#define perfstat_add(_var, _idx, _n)	((_var).counters[_idx].count += (_n))
+#else
+static inline void perfstat_register_group(struct perfstat_group *group)
+{
+}
+
+#define perfstat_inc(_var, _idx)	do { } while (0)
+#define perfstat_add(_var, _idx, _n)	do { } while (0)
+#endif
+
+#endif /* __PERFSTAT_H */
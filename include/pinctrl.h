@@ -8,8 +8,24 @@
 struct pinctrl_device;
 struct device_node;
 
+/* One precomputed register write of a resolved pinctrl group */
+struct pinctrl_reg_write {
+	void __iomem *addr;
+	u32 val;
+};
+
 struct pinctrl_ops {
 	int (*set_state)(struct pinctrl_device *, struct device_node *);
+	/*
+	 * Optional: resolve a pin group into a run of plain 32bit register
+	 * writes. The core caches the run per group node, so repeated applies
+	 * of the same group skip the device tree parsing and turn into one
+	 * tight write loop. Return -ENOTSUPP for groups that need
+	 * read-modify-write; the core then falls back to set_state.
+	 */
+	int (*resolve_group)(struct pinctrl_device *, struct device_node *,
+			     struct pinctrl_reg_write **writes,
+			     unsigned int *nwrites);
 	int (*set_direction)(struct pinctrl_device *, unsigned int, bool);
 	int (*get_direction)(struct pinctrl_device *, unsigned int);
 };
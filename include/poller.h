@@ -13,6 +13,13 @@ struct poller_struct {
 	void (*func)(struct poller_struct *poller);
 	u16 registered:1;
 	u16 overtime;
+	/*
+	 * Absolute time of the next run in get_time_ns() terms. Pollers
+	 * that know when their next action is due update this from their
+	 * callback and get skipped on earlier poll cycles. Zero means
+	 * run on every cycle.
+	 */
+	u64 deadline;
 	struct list_head list;
 	const char *name;
 };
@@ -70,5 +70,17 @@ static inline void dump_stack(void)
 }
 #endif
 
+#ifdef CONFIG_ARCH_HAS_STACK_SAVE
+unsigned int stack_save(unsigned long *entries, unsigned int max_entries,
+			unsigned int skip);
+#else
+static inline unsigned int stack_save(unsigned long *entries,
+				      unsigned int max_entries,
+				      unsigned int skip)
+{
+	return 0;
+}
+#endif
+
 
 #endif
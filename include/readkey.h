@@ -24,8 +24,12 @@
 #define BB_KEY_PAGEUP		135		/* Cursor Key Page Up	*/
 #define BB_KEY_PAGEDOWN		136		/* Cursor Key Page Down	*/
 #define BB_KEY_DEL		137		/* Cursor Key Del	*/
+#define BB_KEY_PASTE_START	138		/* Bracketed paste begin */
+#define BB_KEY_PASTE_END	139		/* Bracketed paste end	*/
 
 #define ANSI_CLEAR_SCREEN "\e[2J\e[;H"
+#define ANSI_BRACKETED_PASTE_ON "\e[?2004h"
+#define ANSI_BRACKETED_PASTE_OFF "\e[?2004l"
 
 #define printf_reverse(fmt,args...)	printf("\e[7m" fmt "\e[0m",##args)
 #define puts_reverse(fmt)		puts("\e[7m" fmt "\e[0m")
@@ -125,6 +125,8 @@ struct regulator_dev {
 	int enable_time_us;
 	int min_uv;
 	int max_uv;
+	/* last voltage read from or written to the hardware, 0 if unknown */
+	int last_uv;
 	struct list_head consumer_list;
 	const struct regulator_desc *desc;
 	struct regmap *regmap;
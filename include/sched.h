@@ -4,10 +4,15 @@
 
 #if defined CONFIG_HAS_SCHED && IN_PROPER
 void resched(void);
+void yield(void);
 #else
 static inline void resched(void)
 {
 }
+
+static inline void yield(void)
+{
+}
 #endif
 
 #endif
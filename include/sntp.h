@@ -3,7 +3,20 @@
 #define __SNTP_H
 
 #include <types.h>
+#include <errno.h>
 
+#ifdef CONFIG_NET_SNTP
 s64 sntp(const char *server);
+void sntp_prefetch(const char *server);
+#else
+static inline s64 sntp(const char *server)
+{
+	return -ENOSYS;
+}
+
+static inline void sntp_prefetch(const char *server)
+{
+}
+#endif
 
 #endif /* __SNTP_H */
@@ -131,6 +131,8 @@ static inline void ddr_get_firmware(enum dram_type dram_type)
 int ddr_cfg_phy(struct dram_controller *dram, struct dram_timing_info *timing_info);
 void ddrphy_trained_csr_save(struct dram_controller *dram, struct dram_cfg_param *param,
 			     unsigned int num);
+void ddrphy_trained_csr_restore(struct dram_controller *dram, struct dram_cfg_param *param,
+				unsigned int num);
 void *dram_config_save(struct dram_controller *dram, struct dram_timing_info *info,
 		       unsigned long base);
 
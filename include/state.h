@@ -18,6 +18,7 @@ struct state *state_by_alias(const char *alias);
 int state_load_no_auth(struct state *state);
 int state_load(struct state *state);
 int state_save(struct state *state);
+int state_flush(struct state *state);
 void state_info(void);
 
 int state_read_mac(struct state *state, const char *name, u8 *buf);
@@ -55,6 +56,11 @@ static inline int state_save(struct state *state)
 	return -ENOSYS;
 }
 
+static inline int state_flush(struct state *state)
+{
+	return -ENOSYS;
+}
+
 static inline int state_read_mac(struct state *state, const char *name, u8 *buf)
 {
 	return -ENOSYS;
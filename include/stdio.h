@@ -60,6 +60,7 @@ int tstc(void);
 void console_putc(unsigned int ch, const char c);
 int getchar(void);
 int console_puts(unsigned int ch, const char *s);
+int console_write(unsigned int ch, const char *s, size_t nbytes);
 void console_flush(void);
 
 int vprintf(const char *fmt, va_list args);
@@ -80,6 +81,11 @@ static inline int console_puts(unsigned int ch, const char *str)
 	return 0;
 }
 
+static inline int console_write(unsigned int ch, const char *str, size_t nbytes)
+{
+	return 0;
+}
+
 static inline int getchar(void)
 {
 	return -EINVAL;
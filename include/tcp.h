@@ -0,0 +1,14 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef __TCP_H
+#define __TCP_H
+
+#include <net.h>
+
+struct tcp_socket;
+
+struct tcp_socket *tcp_connect(IPaddr_t dest, uint16_t dport);
+int tcp_write(struct tcp_socket *sock, const void *buf, size_t len);
+int tcp_read(struct tcp_socket *sock, void *buf, size_t len);
+void tcp_close(struct tcp_socket *sock);
+
+#endif /* __TCP_H */
@@ -12,12 +12,22 @@ struct work_struct {
 	bool delayed;
 };
 
+struct bthread;
+
 struct work_queue {
 	void (*fn)(struct work_struct *work);
 	void (*cancel)(struct work_struct *work);
 
+	/*
+	 * Pending work of higher priority queues runs first in each
+	 * wq_do_all_works() pass. Queues registered with the same
+	 * priority keep registration order.
+	 */
+	int prio;
+
 	struct list_head list;
 	struct list_head work;
+	struct bthread *bthread;
 };
 
 static inline void wq_queue_work(struct work_queue *wq, struct work_struct *work)
@@ -36,6 +46,7 @@ static inline void wq_queue_delayed_work(struct work_queue *wq,
 }
 
 void wq_register(struct work_queue *wq);
+int wq_register_bthread(struct work_queue *wq);
 void wq_unregister(struct work_queue *wq);
 
 void wq_do_all_works(void);
@@ -34,6 +34,7 @@ struct fpgamgr {
 	int programmed;
 	char *buf;
 	size_t size;
+	size_t capacity;
 	u32 features;
 	const struct xilinx_fpga_devdata *devdata;
 };
@@ -0,0 +1,156 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+/*
+ * arena.c - scoped arenas for transient allocations
+ *
+ * An arena bump-allocates out of large chunks taken from the general
+ * allocator and is released as a whole. Code with a clear allocation
+ * scope, like the boot paths, pushes an arena, draws all of its
+ * short-lived buffers from it and pops it on the way out. Individual
+ * objects are never freed, so cleanup is a handful of chunk frees and
+ * the transient allocations don't interleave with long-lived heap
+ * objects, which keeps the heap from fragmenting.
+ */
+
+#define pr_fmt(fmt) "arena: " fmt
+
+#include <common.h>
+#include <malloc.h>
+#include <arena.h>
+#include <xfuncs.h>
+#include <stdio.h>
+#include <linux/align.h>
+#include <linux/list.h>
+#include <linux/sizes.h>
+
+#define ARENA_CHUNK_SIZE	SZ_4K
+
+struct arena_chunk {
+	struct list_head list;
+	size_t size;
+	size_t used;
+	char mem[];
+};
+
+struct arena {
+	const char *name;
+	struct list_head chunks;
+};
+
+/**
+ * arena_push - open a new allocation scope
+ * @name: name of the arena, for debugging
+ */
+struct arena *arena_push(const char *name)
+{
+	struct arena *arena = xzalloc(sizeof(*arena));
+
+	arena->name = name;
+	INIT_LIST_HEAD(&arena->chunks);
+
+	return arena;
+}
+
+/**
+ * arena_pop - close an allocation scope
+ * @arena: the arena to release
+ *
+ * Releases the arena and everything ever allocated from it.
+ */
+void arena_pop(struct arena *arena)
+{
+	struct arena_chunk *chunk, *tmp;
+
+	if (!arena)
+		return;
+
+	list_for_each_entry_safe(chunk, tmp, &arena->chunks, list)
+		free(chunk);
+
+	free(arena);
+}
+
+static struct arena_chunk *arena_new_chunk(struct arena *arena, size_t size)
+{
+	struct arena_chunk *chunk;
+
+	chunk = xmalloc(sizeof(*chunk) + size);
+	chunk->size = size;
+	chunk->used = 0;
+
+	return chunk;
+}
+
+void *arena_alloc(struct arena *arena, size_t size)
+{
+	struct arena_chunk *chunk;
+	void *obj;
+
+	size = ALIGN(size, sizeof(long));
+
+	/* outsized allocations get a chunk of their own */
+	if (size > ARENA_CHUNK_SIZE) {
+		chunk = arena_new_chunk(arena, size);
+		/* keep any partially filled chunk in front */
+		list_add_tail(&chunk->list, &arena->chunks);
+		chunk->used = size;
+		return chunk->mem;
+	}
+
+	chunk = list_first_entry_or_null(&arena->chunks,
+					 struct arena_chunk, list);
+	if (!chunk || chunk->used + size > chunk->size) {
+		chunk = arena_new_chunk(arena, ARENA_CHUNK_SIZE);
+		list_add(&chunk->list, &arena->chunks);
+	}
+
+	obj = chunk->mem + chunk->used;
+	chunk->used += size;
+
+	return obj;
+}
+
+void *arena_zalloc(struct arena *arena, size_t size)
+{
+	void *obj = arena_alloc(arena, size);
+
+	memset(obj, 0, size);
+
+	return obj;
+}
+
+char *arena_strdup(struct arena *arena, const char *s)
+{
+	if (!s)
+		return NULL;
+
+	return strcpy(arena_alloc(arena, strlen(s) + 1), s);
+}
+
+char *arena_vasprintf(struct arena *arena, const char *fmt, va_list ap)
+{
+	va_list aq;
+	char *str;
+	int len;
+
+	va_copy(aq, ap);
+	len = vsnprintf(NULL, 0, fmt, aq);
+	va_end(aq);
+
+	str = arena_alloc(arena, len + 1);
+	vsnprintf(str, len + 1, fmt, ap);
+
+	return str;
+}
+
+char *arena_asprintf(struct arena *arena, const char *fmt, ...)
+{
+	va_list ap;
+	char *str;
+
+	va_start(ap, fmt);
+	str = arena_vasprintf(arena, fmt, ap);
+	va_end(ap);
+
+	return str;
+}
@@ -18,10 +18,22 @@
 #include <fcntl.h>
 #include <malloc.h>
 #include <libfile.h>
+#include <digest.h>
+#include <image-sparse.h>
+#include <linux/hex.h>
 #include <progress.h>
 #include <stdlib.h>
+#include <linux/sizes.h>
 #include <linux/stat.h>
 
+/*
+ * Chunk size for file copies. Big enough that per-call overhead of the
+ * fs and block layers doesn't dominate and block devices see whole
+ * write chunks instead of read-modify-write cycles, small enough that
+ * the progress bar stays alive on slow media.
+ */
+#define COPY_BUF_SIZE	SZ_64K
+
 /*
  * pwrite_full - write to filedescriptor at offset
  *
@@ -428,28 +440,113 @@ out_close:
 }
 EXPORT_SYMBOL(write_file_flash);
 
-/**
- * copy_file - Copy a file
- * @src:	The source filename
- * @dst:	The destination filename
- * @flags:	A bitmask of COPY_FILE_* flags. Possible values:
- *
- *                COPY_FILE_VERBOSE: show a progression bar
- *                COPY_FILE_NO_OVERWRITE: don't clobber existing files
+/*
+ * copy_file_sparse - expand an Android sparse image to the destination
  *
- * Return: 0 for success or negative error code
+ * Only the chunks actually present in the image are written, at the
+ * offsets the chunk headers specify, so the "don't care" ranges cost
+ * neither reads nor writes.
  */
-int copy_file(const char *src, const char *dst, unsigned flags)
+static int copy_file_sparse(const char *src, int dstfd, void *buf,
+			    bool dst_is_regular, unsigned flags)
+{
+	struct sparse_image_ctx *sparse;
+	loff_t total = 0;
+	int ret;
+
+	if (!IS_ENABLED(CONFIG_IMAGE_SPARSE))
+		return -ENOSYS;
+
+	sparse = sparse_image_open(src);
+	if (IS_ERR(sparse)) {
+		printf("could not open %s as sparse image\n", src);
+		return PTR_ERR(sparse);
+	}
+
+	discard_range(dstfd, sparse_image_size(sparse), 0);
+
+	if (dst_is_regular) {
+		ret = ftruncate(dstfd, sparse_image_size(sparse));
+		if (ret)
+			goto out;
+	}
+
+	if (flags & COPY_FILE_VERBOSE)
+		init_progression_bar(sparse_image_size(sparse));
+
+	while (1) {
+		size_t retlen;
+		loff_t pos;
+
+		ret = sparse_image_read(sparse, buf, &pos, COPY_BUF_SIZE,
+					&retlen);
+		if (ret)
+			goto out;
+		if (!retlen)
+			break;
+
+		ret = pwrite_full(dstfd, buf, retlen, pos);
+		if (ret < 0) {
+			perror("write");
+			goto out;
+		}
+
+		total = pos + retlen;
+
+		if (flags & COPY_FILE_VERBOSE)
+			show_progress(total);
+	}
+
+	ret = 0;
+out:
+	if (flags & COPY_FILE_VERBOSE)
+		putchar('\n');
+	sparse_image_close(sparse);
+
+	return ret;
+}
+
+/*
+ * Re-read the tail of the destination and compare it against the source
+ * data it should contain. The earlier batches went through the very same
+ * write path, so checking the final batch is enough to catch a transfer
+ * that was cut short.
+ */
+static int copy_file_readback(int dstfd, const void *src, loff_t offset,
+			      size_t size)
+{
+	void *buf;
+	int ret;
+
+	if (lseek(dstfd, offset, SEEK_SET) != offset)
+		return -errno;
+
+	buf = xmalloc(size);
+
+	ret = read_full(dstfd, buf, size);
+	if (ret >= 0 && ret != size)
+		ret = -EIO;
+	if (ret < 0)
+		goto out;
+
+	ret = memcmp(buf, src, size) ? -EILSEQ : 0;
+out:
+	free(buf);
+	return ret;
+}
+
+static int __copy_file(const char *src, const char *dst, unsigned flags,
+		       struct digest *digest)
 {
 	char *rw_buf = NULL;
 	int srcfd = 0, dstfd = 0;
-	int r, s;
+	int r, s, last = 0;
 	int ret = 1, err1 = 0;
 	int mode;
 	loff_t total = 0;
 	struct stat srcstat, dststat;
 
-	rw_buf = xmalloc(RW_BUF_SIZE);
+	rw_buf = xmalloc(COPY_BUF_SIZE);
 
 	srcfd = open(src, O_RDONLY);
 	if (srcfd < 0) {
@@ -458,7 +555,8 @@ int copy_file(const char *src, const char *dst, unsigned flags)
 		goto out;
 	}
 
-	mode = O_WRONLY | O_CREAT;
+	/* the destination is read back when the data is digested */
+	mode = (digest ? O_RDWR : O_WRONLY) | O_CREAT;
 
 	s = stat(dst, &dststat);
 	if (s && s != -ENOENT) {
@@ -483,6 +581,12 @@ int copy_file(const char *src, const char *dst, unsigned flags)
 		goto out;
 	}
 
+	if (flags & COPY_FILE_SPARSE) {
+		ret = copy_file_sparse(src, dstfd, rw_buf,
+				       s || S_ISREG(dststat.st_mode), flags);
+		goto out;
+	}
+
 	ret = stat(src, &srcstat);
 	if (ret)
 		goto out;
@@ -499,8 +603,57 @@ int copy_file(const char *src, const char *dst, unsigned flags)
 	if (flags & COPY_FILE_VERBOSE)
 		init_progression_bar(srcstat.st_size);
 
+	/*
+	 * If the source can be memory-mapped, write straight out of the
+	 * mapping instead of bouncing every chunk through the heap buffer.
+	 */
+	if (srcstat.st_size != FILESIZE_MAX) {
+		void *map = memmap(srcfd, PROT_READ);
+
+		if (map != MAP_FAILED) {
+			while (total < srcstat.st_size) {
+				loff_t now = min_t(loff_t, srcstat.st_size - total,
+						   COPY_BUF_SIZE);
+
+				if (digest) {
+					ret = digest_update(digest, map + total,
+							    now);
+					if (ret)
+						goto out_newline;
+				}
+
+				ret = write_full(dstfd, map + total, now);
+				if (ret < 0) {
+					perror("write");
+					goto out_newline;
+				}
+
+				total += now;
+
+				if (flags & COPY_FILE_VERBOSE)
+					show_progress(total);
+			}
+
+			if (digest && total) {
+				loff_t tail = min_t(loff_t, total, COPY_BUF_SIZE);
+
+				ret = copy_file_readback(dstfd,
+							 map + total - tail,
+							 total - tail, tail);
+				if (ret) {
+					printf("%s: readback of last chunk failed\n",
+					       dst);
+					goto out_newline;
+				}
+			}
+
+			ret = 0;
+			goto out_newline;
+		}
+	}
+
 	while (1) {
-		r = read(srcfd, rw_buf, RW_BUF_SIZE);
+		r = read(srcfd, rw_buf, COPY_BUF_SIZE);
 		if (r < 0) {
 			perror("read");
 			ret = r;
@@ -509,6 +662,12 @@ int copy_file(const char *src, const char *dst, unsigned flags)
 		if (!r)
 			break;
 
+		if (digest) {
+			ret = digest_update(digest, rw_buf, r);
+			if (ret)
+				goto out_newline;
+		}
+
 		ret = write_full(dstfd, rw_buf, r);
 		if (ret < 0) {
 			perror("write");
@@ -516,6 +675,7 @@ int copy_file(const char *src, const char *dst, unsigned flags)
 		}
 
 		total += r;
+		last = r;
 
 		if (flags & COPY_FILE_VERBOSE) {
 			if (srcstat.st_size && srcstat.st_size != FILESIZE_MAX)
@@ -525,6 +685,14 @@ int copy_file(const char *src, const char *dst, unsigned flags)
 		}
 	}
 
+	if (digest && last) {
+		ret = copy_file_readback(dstfd, rw_buf, total - last, last);
+		if (ret) {
+			printf("%s: readback of last chunk failed\n", dst);
+			goto out_newline;
+		}
+	}
+
 	ret = 0;
 out_newline:
 	if (flags & COPY_FILE_VERBOSE)
@@ -538,8 +706,87 @@ out:
 
 	return ret ?: err1;
 }
+
+/**
+ * copy_file - Copy a file
+ * @src:	The source filename
+ * @dst:	The destination filename
+ * @flags:	A bitmask of COPY_FILE_* flags. Possible values:
+ *
+ *                COPY_FILE_VERBOSE: show a progression bar
+ *                COPY_FILE_NO_OVERWRITE: don't clobber existing files
+ *                COPY_FILE_SPARSE: treat the source as an Android sparse
+ *                                  image and expand it while copying
+ *
+ * Return: 0 for success or negative error code
+ */
+int copy_file(const char *src, const char *dst, unsigned flags)
+{
+	return __copy_file(src, dst, flags, NULL);
+}
 EXPORT_SYMBOL(copy_file);
 
+/**
+ * copy_file_verify - Copy a file and verify the data against a digest
+ * @src:	The source filename
+ * @dst:	The destination filename
+ * @flags:	A bitmask of COPY_FILE_* flags as for copy_file().
+ *		COPY_FILE_SPARSE is not supported here
+ * @algo:	The digest algorithm, e.g. "sha256"
+ * @hex:	The expected digest of the source data as a hex string
+ *
+ * Like copy_file(), but the digest of the data is computed during the
+ * single read pass and compared against @hex, and the final chunk of
+ * the destination is read back and compared, so no separate
+ * verification pass over source or destination is needed.
+ *
+ * Return: 0 if the copy succeeded and the digest matches, a negative
+ * error code otherwise
+ */
+int copy_file_verify(const char *src, const char *dst, unsigned flags,
+		     const char *algo, const char *hex)
+{
+	struct digest *digest;
+	unsigned char *md;
+	int ret;
+
+	if (flags & COPY_FILE_SPARSE)
+		return -EINVAL;
+
+	digest = digest_alloc(algo);
+	if (!digest) {
+		printf("digest algo '%s' not found\n", algo);
+		return -EINVAL;
+	}
+
+	md = xmalloc(digest_length(digest));
+
+	if (strlen(hex) != 2 * digest_length(digest) ||
+	    hex2bin(md, hex, digest_length(digest))) {
+		printf("'%s' is not a valid %s digest\n", hex, algo);
+		ret = -EINVAL;
+		goto out;
+	}
+
+	ret = digest_init(digest);
+	if (ret)
+		goto out;
+
+	ret = __copy_file(src, dst, flags, digest);
+	if (ret)
+		goto out;
+
+	ret = digest_verify(digest, md);
+	if (ret == -EINVAL)
+		printf("%s does not match the given %s digest\n", src, algo);
+out:
+	free(md);
+	digest_free(digest);
+
+	return ret;
+}
+EXPORT_SYMBOL(copy_file_verify);
+
 /**
  * copy_recursive - Copy files recursively
  * @src:	The source filename or directory
@@ -0,0 +1,83 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+/*
+ * objcache.c - fixed-size object caches on top of the general allocator
+ *
+ * An object cache keeps freed objects of one size on a freelist instead
+ * of returning them to the heap. High-churn allocation sites like
+ * network packet buffers then pay a pointer pop/push on the fast path
+ * instead of going through the general purpose allocator for every
+ * object.
+ */
+
+#define pr_fmt(fmt) "objcache: " fmt
+
+#include <common.h>
+#include <malloc.h>
+#include <objcache.h>
+#include <xfuncs.h>
+#include <linux/align.h>
+
+struct objcache {
+	const char *name;
+	size_t size;
+	size_t align;
+	void *freelist;
+	unsigned int nr_free;
+	unsigned int max_free;
+};
+
+/**
+ * objcache_create - create a cache of fixed-size objects
+ * @name: name of the cache, for debugging
+ * @size: size of one object in bytes
+ * @align: alignment of the objects, 0 for the allocator default
+ * @max_free: maximum number of objects kept on the freelist, 0 for
+ *            no limit. Objects freed beyond that go back to the heap.
+ */
+struct objcache *objcache_create(const char *name, size_t size, size_t align,
+				 unsigned int max_free)
+{
+	struct objcache *cache = xzalloc(sizeof(*cache));
+
+	cache->name = name;
+	cache->align = align;
+	/* a free object has to be able to hold the freelist pointer */
+	cache->size = max_t(size_t, size, sizeof(void *));
+	if (align)
+		cache->size = ALIGN(cache->size, align);
+	cache->max_free = max_free;
+
+	return cache;
+}
+
+void *objcache_alloc(struct objcache *cache)
+{
+	void *obj = cache->freelist;
+
+	if (obj) {
+		cache->freelist = *(void **)obj;
+		cache->nr_free--;
+		return obj;
+	}
+
+	if (cache->align)
+		return xmemalign(cache->align, cache->size);
+
+	return xmalloc(cache->size);
+}
+
+void objcache_free(struct objcache *cache, void *obj)
+{
+	if (!obj)
+		return;
+
+	if (cache->max_free && cache->nr_free >= cache->max_free) {
+		free(obj);
+		return;
+	}
+
+	*(void **)obj = cache->freelist;
+	cache->freelist = obj;
+	cache->nr_free++;
+}
@@ -55,13 +55,32 @@ struct param_d *get_param_by_name(bobject_t _bobj, const char *name)
 	struct param_d *p;
 
 	list_for_each_entry(p, &bobj->parameters, list) {
-		if (!strcmp(p->name, name))
+		int cmp = strcmp(p->name, name);
+
+		if (!cmp)
 			return p;
+		/* The list is sorted, no need to look any further */
+		if (cmp > 0)
+			break;
 	}
 
 	return NULL;
 }
 
+/**
+ * param_get_value - get the value of an already looked up parameter
+ * @param param	The parameter
+ * @return	The value
+ *
+ * Unlike bobject_get_param() this does not look up the parameter by
+ * name again, so iterating over all parameters of an object stays
+ * linear in the number of parameters.
+ */
+const char *param_get_value(struct param_d *param)
+{
+	return param->get(param->bobj, param);
+}
+
 /**
  * bobject_get_param - get the value of a parameter
  * @param bobj	The barebox object
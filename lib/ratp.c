@@ -1308,14 +1308,15 @@ static int msg_recv(struct ratp_internal *ri, void *pkt)
 	pr_debug("%s: Put msg in receive queue\n", __func__);
 
 	msg = xzalloc(sizeof(*msg));
-	if (hdr->data_length) {
-		msg->len = hdr->data_length;
-		msg->buf = xzalloc(msg->len);
-		memcpy(msg->buf, pkt + sizeof(struct ratp_header), msg->len);
-	} else {
+	if (hdr->control & RATP_CONTROL_SO) {
+		/* single byte packets carry their data in the length field */
 		msg->len = 1;
 		msg->buf = xzalloc(1);
 		*(uint8_t *)msg->buf = hdr->data_length;
+	} else {
+		msg->len = hdr->data_length;
+		msg->buf = xzalloc(msg->len);
+		memcpy(msg->buf, pkt + sizeof(struct ratp_header), msg->len);
 	}
 
 	if (hdr->control & RATP_CONTROL_EOR)
@@ -1569,8 +1570,13 @@ int ratp_poll(struct ratp *ratp)
 
 	ri->in_ratp++;
 
-	ret = ratp_recv_pkt(ri, ri->recvbuf, 100);
-	if (ret == 0) {
+	/*
+	 * Process every packet that has already arrived. The window of this
+	 * protocol is fixed at one outstanding packet by the one bit sequence
+	 * number of RFC916, but draining the receive FIFO in one go at least
+	 * keeps back-to-back packets from each waiting for another poll cycle.
+	 */
+	while ((ret = ratp_recv_pkt(ri, ri->recvbuf, 100)) == 0) {
 
 		if (ri->state == RATP_STATE_TIME_WAIT &&
 		    is_timeout(ri->timewait_timer_start, ri->srtt * 2 * MSECOND)) {
@@ -1587,6 +1593,9 @@ int ratp_poll(struct ratp *ratp)
 			ret = ri->status;
 			goto out;
 		}
+
+		if (ri->sendbuf_len == 0 && !list_empty(&ri->sendmsg))
+			ratp_send_next_data(ri);
 	}
 
 	if (ri->sendbuf_len && is_timeout(ri->retransmission_timer_start,
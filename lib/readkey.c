@@ -44,12 +44,14 @@ static const struct esc_cmds esccmds[] = {
 	{"[4~", BB_KEY_END},     // Cursor Key End
 	{"[5~", BB_KEY_PAGEUP},  // Cursor Key Page Up
 	{"[6~", BB_KEY_PAGEDOWN},// Cursor Key Page Down
+	{"[200~", BB_KEY_PASTE_START}, // Bracketed paste begin
+	{"[201~", BB_KEY_PASTE_END},   // Bracketed paste end
 };
 
 int read_key(void)
 {
 	unsigned char c;
-	unsigned char esc[5];
+	unsigned char esc[8];
 	c = getchar();
 
 	if (c == 27) {
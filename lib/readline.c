@@ -186,6 +186,9 @@ int readline(const char *prompt, char *buf, int len)
 {
 	unsigned long num = 0;
 	unsigned long eol_num = 0;
+	unsigned long pending = 0;
+	/* survives the per-line returns of a multi line paste */
+	static bool in_paste;
 	unsigned wlen;
 	int ichar;
 	int insert = 1;
@@ -198,6 +201,7 @@ int readline(const char *prompt, char *buf, int len)
 #endif
 	history_current = &history_list;
 
+	puts (ANSI_BRACKETED_PASTE_ON);
 	puts (prompt);
 
 	while (1) {
@@ -206,6 +210,41 @@ int readline(const char *prompt, char *buf, int len)
 
 		ichar = read_key();
 
+		if (ichar == BB_KEY_PASTE_START) {
+			in_paste = true;
+			continue;
+		}
+
+		if (in_paste) {
+			if (isascii(ichar) && isprint(ichar) &&
+			    num == eol_num && eol_num <= len - 2) {
+				/*
+				 * Collect pasted characters without per
+				 * character redraw, the chunk is echoed in
+				 * one go once the input queue drains.
+				 */
+				buf[num++] = ichar;
+				eol_num++;
+				pending++;
+				if (!tstc()) {
+					putnstr(buf + num - pending, pending);
+					pending = 0;
+				}
+				continue;
+			}
+
+			/* echo what was collected before handling this key */
+			if (pending) {
+				putnstr(buf + num - pending, pending);
+				pending = 0;
+			}
+
+			if (ichar == BB_KEY_PASTE_END) {
+				in_paste = false;
+				continue;
+			}
+		}
+
 		if ((ichar == '\n') || (ichar == '\r')) {
 			putchar('\n');
 			break;
@@ -246,6 +285,7 @@ int readline(const char *prompt, char *buf, int len)
 			break;
 		case CTL_CH('c'):	/* ^C - break */
 			*buf = 0;	/* discard input */
+			puts(ANSI_BRACKETED_PASTE_OFF);
 			return -1;
 		case BB_KEY_RIGHT:
 			if (num < eol_num) {
@@ -363,6 +403,8 @@ int readline(const char *prompt, char *buf, int len)
 			break;
 		}
 	}
+	puts(ANSI_BRACKETED_PASTE_OFF);
+
 	len = eol_num;
 	buf[eol_num] = '\0';	/* lose the newline */
 
@@ -46,43 +46,34 @@
 		goto decode;
 
 	/* form the syndromes; i.e., evaluate data(x) at roots of
-	 * g(x) */
-	for (i = 0; i < nroots; i++)
-		syn[i] = (((uint16_t) data[0]) ^ invmsk) & msk;
+	 * g(x). This is the hot loop of the decoder, so it is done
+	 * root-major: the accumulator stays in a register instead of
+	 * being loaded and stored per step and the root's multiplier
+	 * is reduced only once. The message easily fits into the
+	 * cache, so rescanning it per root is cheap.
+	 */
+	syn_error = 0;
+	for (i = 0; i < nroots; i++) {
+		int mul = rs_modnn(rs, (fcr + i) * prim);
+		uint16_t sy = (((uint16_t) data[0]) ^ invmsk) & msk;
 
-	for (j = 1; j < len; j++) {
-		for (i = 0; i < nroots; i++) {
-			if (syn[i] == 0) {
-				syn[i] = (((uint16_t) data[j]) ^
-					  invmsk) & msk;
-			} else {
-				syn[i] = ((((uint16_t) data[j]) ^
-					   invmsk) & msk) ^
-					alpha_to[rs_modnn(rs, index_of[syn[i]] +
-						       (fcr + i) * prim)];
-			}
+		for (j = 1; j < len; j++) {
+			if (sy)
+				sy = alpha_to[rs_modnn(rs, index_of[sy] + mul)];
+			sy ^= (((uint16_t) data[j]) ^ invmsk) & msk;
 		}
-	}
 
-	for (j = 0; j < nroots; j++) {
-		for (i = 0; i < nroots; i++) {
-			if (syn[i] == 0) {
-				syn[i] = ((uint16_t) par[j]) & msk;
-			} else {
-				syn[i] = (((uint16_t) par[j]) & msk) ^
-					alpha_to[rs_modnn(rs, index_of[syn[i]] +
-						       (fcr+i)*prim)];
-			}
+		for (j = 0; j < nroots; j++) {
+			if (sy)
+				sy = alpha_to[rs_modnn(rs, index_of[sy] + mul)];
+			sy ^= ((uint16_t) par[j]) & msk;
 		}
-	}
-	s = syn;
 
-	/* Convert syndromes to index form, checking for nonzero condition */
-	syn_error = 0;
-	for (i = 0; i < nroots; i++) {
-		syn_error |= s[i];
-		s[i] = index_of[s[i]];
+		/* Store in index form, checking for nonzero condition */
+		syn_error |= sy;
+		syn[i] = index_of[sy];
 	}
+	s = syn;
 
 	if (!syn_error) {
 		/* if syndrome is zero, data[] is a codeword and there are no
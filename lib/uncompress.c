@@ -19,6 +19,7 @@
 #include <gunzip.h>
 #include <lzo.h>
 #include <linux/xz.h>
+#include <linux/zstd.h>
 #include <linux/decompress/unlz4.h>
 #include <linux/decompress/unzstd.h>
 #include <errno.h>
@@ -26,6 +27,7 @@
 #include <malloc.h>
 #include <fs.h>
 #include <libfile.h>
+#include <asm/unaligned.h>
 
 static void *uncompress_buf;
 static unsigned long uncompress_size;
@@ -191,6 +193,39 @@ int uncompress_buf_to_fd(const void *input, size_t input_len,
 			  NULL, NULL, error_fn);
 }
 
+/*
+ * With both source and destination contiguous in memory the decompressor
+ * backends can run their one-shot decoders straight into the destination,
+ * but for that the uncompressed size must be known up front. Recover it
+ * from the stream headers where the format records it. Returns 0 when it
+ * doesn't.
+ */
+static size_t uncompressed_size(const void *input, size_t input_len)
+{
+	const u8 *in = input;
+
+	switch (file_detect_compression_type(input, input_len)) {
+	case filetype_gzip:
+		/* ISIZE, the uncompressed size modulo 2^32, trails the stream */
+		if (input_len < 18)
+			return 0;
+		return get_unaligned_le32(in + input_len - 4);
+	case filetype_zstd_compressed:
+		if (IS_ENABLED(CONFIG_ZSTD_DECOMPRESS)) {
+			unsigned long long size;
+
+			size = ZSTD_findDecompressedSize(input, input_len);
+			if (size == ZSTD_CONTENTSIZE_UNKNOWN ||
+			    size == ZSTD_CONTENTSIZE_ERROR)
+				return 0;
+			return size;
+		}
+		return 0;
+	default:
+		return 0;
+	}
+}
+
 ssize_t uncompress_buf_to_buf(const void *input, size_t input_len,
 			      void **buf, void(*error_fn)(char *x))
 {
@@ -198,6 +233,28 @@ ssize_t uncompress_buf_to_buf(const void *input, size_t input_len,
 	int fd, ret;
 	void *p;
 
+	/*
+	 * When the stream records its uncompressed size, decompress in one
+	 * shot directly into the result buffer instead of streaming through
+	 * a temporary file and copying the result back.
+	 */
+	size = uncompressed_size(input, input_len);
+	if (size) {
+		p = malloc(size);
+		if (!p)
+			return -ENOMEM;
+
+		ret = uncompress((void *)input, input_len, NULL, NULL, p,
+				 NULL, error_fn);
+		if (ret) {
+			free(p);
+			return ret;
+		}
+
+		*buf = p;
+		return size;
+	}
+
 	fd = open("/tmp", O_TMPFILE | O_RDWR);
 	if (fd < 0)
 		return -ENODEV;
@@ -9,10 +9,11 @@
  */
 
 /*
- * This is not the fastest implementation, but it is pretty compact.
- * The fastest versions of xz_crc32() on modern CPUs without hardware
- * accelerated CRC instruction are 3-5 times as fast as this version,
- * but they are bigger and use more memory for the lookup table.
+ * Slice-by-four implementation: the CRC is advanced four bytes at a
+ * time through four 256-entry lookup tables. The check runs over every
+ * decompressed byte, so this is worth the 3 KiB of extra table over the
+ * classic one-table byte-at-a-time loop, which it is about three times
+ * as fast as.
  */
 
 #include "xz_private.h"
@@ -25,7 +26,7 @@
 #	define STATIC_RW_DATA static
 #endif
 
-STATIC_RW_DATA uint32_t xz_crc32_table[256];
+STATIC_RW_DATA uint32_t xz_crc32_table[4][256];
 
 XZ_EXTERN void xz_crc32_init(void)
 {
@@ -40,7 +41,15 @@ XZ_EXTERN void xz_crc32_init(void)
 		for (j = 0; j < 8; ++j)
 			r = (r >> 1) ^ (poly & ~((r & 1) - 1));
 
-		xz_crc32_table[i] = r;
+		xz_crc32_table[0][i] = r;
+	}
+
+	for (i = 0; i < 256; ++i) {
+		r = xz_crc32_table[0][i];
+		for (j = 1; j < 4; ++j) {
+			r = xz_crc32_table[0][r & 0xFF] ^ (r >> 8);
+			xz_crc32_table[j][i] = r;
+		}
 	}
 
 	return;
@@ -50,8 +59,23 @@ XZ_EXTERN uint32_t xz_crc32(const uint8_t *buf, size_t size, uint32_t crc)
 {
 	crc = ~crc;
 
+	while (size != 0 && ((uintptr_t)buf & 3) != 0) {
+		crc = xz_crc32_table[0][*buf++ ^ (crc & 0xFF)] ^ (crc >> 8);
+		--size;
+	}
+
+	while (size >= 4) {
+		crc ^= get_unaligned_le32(buf);
+		crc = xz_crc32_table[3][crc & 0xFF]
+			^ xz_crc32_table[2][(crc >> 8) & 0xFF]
+			^ xz_crc32_table[1][(crc >> 16) & 0xFF]
+			^ xz_crc32_table[0][crc >> 24];
+		buf += 4;
+		size -= 4;
+	}
+
 	while (size != 0) {
-		crc = xz_crc32_table[*buf++ ^ (crc & 0xFF)] ^ (crc >> 8);
+		crc = xz_crc32_table[0][*buf++ ^ (crc & 0xFF)] ^ (crc >> 8);
 		--size;
 	}
 
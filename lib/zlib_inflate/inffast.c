@@ -4,6 +4,7 @@
  */
 
 #include <linux/zutil.h>
+#include <asm/unaligned.h>
 #include "inftrees.h"
 #include "inflate.h"
 #include "inffast.h"
@@ -138,10 +139,15 @@ void inflate_fast(z_streamp strm, unsigned start)
        input data or output space */
     do {
         if (bits < 15) {
-            hold += (unsigned long)(PUP(in)) << bits;
-            bits += 8;
-            hold += (unsigned long)(PUP(in)) << bits;
-            bits += 8;
+            /*
+             * Refill with one 16-bit load instead of two byte loads
+             * with dependent shifts. This consumes exactly the same
+             * two bytes, so the five byte lookahead margin encoded
+             * in 'last' still holds.
+             */
+            hold += (unsigned long)get_unaligned_le16(in + OFF) << bits;
+            in += 2;
+            bits += 16;
         }
         this = lcode[hold & lmask];
       dolen:
@@ -165,10 +171,9 @@ void inflate_fast(z_streamp strm, unsigned start)
                 bits -= op;
             }
             if (bits < 15) {
-                hold += (unsigned long)(PUP(in)) << bits;
-                bits += 8;
-                hold += (unsigned long)(PUP(in)) << bits;
-                bits += 8;
+                hold += (unsigned long)get_unaligned_le16(in + OFF) << bits;
+                in += 2;
+                bits += 16;
             }
             this = dcode[hold & dmask];
           dodist:
@@ -33,7 +33,7 @@
  * room for write (16 extra) or read (11 extra) operands.
  */
 
-#define DEFAULT_MSIZE ((128 * 1024) + P9_IOHDRSZ)
+#define DEFAULT_MSIZE ((256 * 1024) + P9_IOHDRSZ)
 
 /* Client Option Parsing (code inspired by NFS code)
  *  - a little lazy - parse all client options
@@ -620,6 +620,83 @@ reterr:
 	return ERR_PTR(safe_errno(err));
 }
 
+/**
+ * p9_client_zc_rpc - issue a request and wait for a response
+ * @c: client session
+ * @type: type of request
+ * @uidata: destination for zero copy read
+ * @uodata: source for zero copy write
+ * @inlen: read buffer size
+ * @olen: write buffer size
+ * @in_hdr_len: reader header size, This is the size of response protocol data
+ * @fmt: protocol format string (see protocol.c)
+ *
+ * Returns request structure (which client must free using p9_req_put)
+ */
+static struct p9_req_t *p9_client_zc_rpc(struct p9_client *c, int8_t type,
+					 struct iov_iter *uidata,
+					 struct iov_iter *uodata,
+					 int inlen, int olen, int in_hdr_len,
+					 const char *fmt, ...)
+{
+	va_list ap;
+	int err;
+	struct p9_req_t *req;
+
+	va_start(ap, fmt);
+	/*
+	 * We allocate a inline protocol data of only 4k bytes.
+	 * The actual content is passed in zero-copy fashion.
+	 */
+	req = p9_client_prepare_req(c, type, P9_ZC_HDR_SZ, P9_ZC_HDR_SZ,
+				    fmt, ap);
+	va_end(ap);
+	if (IS_ERR(req))
+		return req;
+
+	err = c->trans_mod->zc_request(c, req, uidata, uodata,
+				       inlen, olen, in_hdr_len);
+	if (err < 0) {
+		/* write won't happen */
+		p9_req_put(c, req);
+		if (err != -ERESTARTSYS && err != -EFAULT)
+			c->status = Disconnected;
+		goto recalc_sigpending;
+	}
+
+	do {
+		c->trans_mod->poll(c);
+	} while (!completion_done(&req->completion) && !(err = ctrlc()));
+
+	if (err)
+		err = -ERESTARTSYS;
+
+	if (READ_ONCE(req->status) == REQ_STATUS_ERROR) {
+		p9_debug(P9_DEBUG_ERROR, "req_status error %d\n", req->t_err);
+		err = req->t_err;
+	}
+	if (err == -ERESTARTSYS && c->status == Connected) {
+		p9_debug(P9_DEBUG_MUX, "flushing\n");
+
+		if (c->trans_mod->cancel(c, req))
+			p9_client_flush(c, req);
+
+		/* if we received the response anyway, don't signal error */
+		if (READ_ONCE(req->status) == REQ_STATUS_RCVD)
+			err = 0;
+	}
+recalc_sigpending:
+	if (err < 0)
+		goto reterr;
+
+	err = p9_check_errors(c, req);
+	if (!err)
+		return req;
+reterr:
+	p9_req_put(c, req);
+	return ERR_PTR(safe_errno(err));
+}
+
 static struct p9_fid *p9_fid_create(struct p9_client *clnt)
 {
 	int ret;
@@ -1262,7 +1339,7 @@ p9_client_read_once(struct p9_fid *fid, u64 offset, struct iov_iter *to,
 	struct p9_client *clnt = fid->clnt;
 	struct p9_req_t *req;
 	int count = iov_iter_count(to);
-	int rsize, received;
+	int rsize, received, non_zc = 0;
 	char *dataptr;
 
 	*err = 0;
@@ -1276,8 +1353,18 @@ p9_client_read_once(struct p9_fid *fid, u64 offset, struct iov_iter *to,
 	if (count < rsize)
 		rsize = count;
 
-	req = p9_client_rpc(clnt, P9_TREAD, "dqd", fid->fid, offset,
-			    rsize);
+	/* Don't bother zerocopy for small IO (< 1024) */
+	if (clnt->trans_mod->zc_request && rsize > 1024) {
+		/* response header len is 11
+		 * PDU Header(7) + IO Size (4)
+		 */
+		req = p9_client_zc_rpc(clnt, P9_TREAD, to, NULL, rsize, 0,
+				       11, "dqd", fid->fid, offset, rsize);
+	} else {
+		non_zc = 1;
+		req = p9_client_rpc(clnt, P9_TREAD, "dqd", fid->fid, offset,
+				    rsize);
+	}
 
 	if (IS_ERR(req)) {
 		*err = PTR_ERR(req);
@@ -1285,7 +1372,7 @@ p9_client_read_once(struct p9_fid *fid, u64 offset, struct iov_iter *to,
 	}
 
 	*err = p9pdu_readf(&req->rc, clnt->proto_version,
-			   "D", &received, &dataptr);
+			   non_zc ? "D" : "d", &received, &dataptr);
 	if (*err) {
 		p9_req_put(clnt, req);
 		return 0;
@@ -1297,12 +1384,16 @@ p9_client_read_once(struct p9_fid *fid, u64 offset, struct iov_iter *to,
 
 	p9_debug(P9_DEBUG_9P, "<<< RREAD count %d\n", received);
 
-	int n = copy_to_iter(dataptr, received, to);
+	if (non_zc) {
+		int n = copy_to_iter(dataptr, received, to);
 
-	if (n != received) {
-		*err = -EFAULT;
-		p9_req_put(clnt, req);
-		return n;
+		if (n != received) {
+			*err = -EFAULT;
+			p9_req_put(clnt, req);
+			return n;
+		}
+	} else {
+		iov_iter_advance(to, received);
 	}
 
 	p9_req_put(clnt, req);
@@ -1332,8 +1423,14 @@ p9_client_write(struct p9_fid *fid, u64 offset, struct iov_iter *from, int *err)
 		p9_debug(P9_DEBUG_9P, ">>> TWRITE fid %d offset %llu count %d (/%d)\n",
 			 fid->fid, offset, rsize, count);
 
-		req = p9_client_rpc(clnt, P9_TWRITE, "dqV", fid->fid,
-				    offset, rsize, from);
+		/* Don't bother zerocopy for small IO (< 1024) */
+		if (clnt->trans_mod->zc_request && rsize > 1024)
+			req = p9_client_zc_rpc(clnt, P9_TWRITE, NULL, from, 0,
+					       rsize, P9_ZC_HDR_SZ, "dqd",
+					       fid->fid, offset, rsize);
+		else
+			req = p9_client_rpc(clnt, P9_TWRITE, "dqV", fid->fid,
+					    offset, rsize, from);
 		if (IS_ERR(req)) {
 			iov_iter_revert(from, count - iov_iter_count(from));
 			*err = PTR_ERR(req);
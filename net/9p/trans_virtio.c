@@ -157,6 +157,131 @@ p9_virtio_request(struct p9_client *client, struct p9_req_t *req)
 	return 0;
 }
 
+/**
+ * pack_sg_iter - pack a payload iterator into a scatter gather list
+ * @chan: virtio channel
+ * @start: which segment of the sg array to start at
+ * @limit: maximum number of segments in the sg array
+ * @iter: payload to pack, must be a kernel (kvec) iterator
+ * @count: amount of data to pack into the scatter/gather list
+ *
+ * The iterator is not advanced, the buffers stay owned by the caller
+ * until the request completes. Returns the number of segments used or
+ * -ENOMEM if the payload needs more segments than available.
+ */
+static int pack_sg_iter(struct virtio_chan *chan, int start, int limit,
+			const struct iov_iter *iter, int count)
+{
+	const struct kvec *kv = iter->kvec;
+	size_t skip = iter->iov_offset;
+	int index = start;
+
+	BUG_ON(!iov_iter_is_kvec(iter));
+
+	while (count) {
+		int len = min_t(size_t, kv->iov_len - skip, count);
+
+		if (index >= limit)
+			return -ENOMEM;
+
+		sg_set_buf(&chan->sg[index], kv->iov_base + skip, len);
+		sg_unmark_end(&chan->sg[index++]);
+
+		count -= len;
+		kv++;
+		skip = 0;
+	}
+
+	sg_mark_end(&chan->sg[index - 1]);
+
+	return index - start;
+}
+
+/**
+ * p9_virtio_zc_request - issue a zero copy request
+ * @client: client instance issuing the request
+ * @req: request to be issued
+ * @uidata: destination of the response payload
+ * @uodata: source of the request payload
+ * @inlen: response payload size
+ * @outlen: request payload size
+ * @in_hdr_len: response protocol data size
+ *
+ * Only the protocol headers go through the inline tc/rc buffers, the
+ * payloads are mapped into the virtqueue directly from the caller's
+ * buffers.
+ */
+static int
+p9_virtio_zc_request(struct p9_client *client, struct p9_req_t *req,
+		     struct iov_iter *uidata, struct iov_iter *uodata,
+		     int inlen, int outlen, int in_hdr_len)
+{
+	int err;
+	int n, out_sgs, in_sgs, sg_idx = 0;
+	unsigned long flags;
+	struct virtio_chan *chan = client->trans;
+	struct scatterlist *sgs[4];
+
+	p9_debug(P9_DEBUG_TRANS, "9p debug: virtio zero-copy request\n");
+
+	WRITE_ONCE(req->status, REQ_STATUS_SENT);
+	spin_lock_irqsave(&chan->lock, flags);
+
+	out_sgs = in_sgs = 0;
+
+	/* request header */
+	sg_init_one(&chan->sg[sg_idx], req->tc.sdata, req->tc.size);
+	sgs[out_sgs++] = &chan->sg[sg_idx++];
+
+	/* request payload, straight from the caller's buffer */
+	if (outlen) {
+		n = pack_sg_iter(chan, sg_idx, VIRTQUEUE_NUM, uodata, outlen);
+		if (n < 0) {
+			err = n;
+			goto err_out;
+		}
+		sgs[out_sgs++] = &chan->sg[sg_idx];
+		sg_idx += n;
+	}
+
+	/* response header */
+	sg_init_one(&chan->sg[sg_idx], req->rc.sdata, in_hdr_len);
+	sgs[out_sgs + in_sgs++] = &chan->sg[sg_idx++];
+
+	/* response payload, written by the host directly to the caller */
+	if (inlen) {
+		n = pack_sg_iter(chan, sg_idx, VIRTQUEUE_NUM, uidata, inlen);
+		if (n < 0) {
+			err = n;
+			goto err_out;
+		}
+		sgs[out_sgs + in_sgs++] = &chan->sg[sg_idx];
+		sg_idx += n;
+	}
+
+	err = virtqueue_add_sgs(chan->vq, sgs, out_sgs, in_sgs, req);
+	if (err < 0) {
+		p9_debug(P9_DEBUG_TRANS,
+			 "virtio rpc add_sgs returned failure\n");
+		err = err == -ENOSPC ? -ENOSPC : -EIO;
+		goto err_out;
+	}
+	virtqueue_kick(chan->vq);
+	spin_unlock_irqrestore(&chan->lock, flags);
+
+	p9_debug(P9_DEBUG_TRANS, "virtio request kicked\n");
+
+	/* the request payload is in flight now, consume it */
+	if (outlen)
+		iov_iter_advance(uodata, outlen);
+
+	return 0;
+
+err_out:
+	spin_unlock_irqrestore(&chan->lock, flags);
+	return err;
+}
+
 /**
  * p9_virtio_poll - poll for request completion
  * @client: client instance issuing the request
@@ -389,6 +514,7 @@ static struct p9_trans_module p9_virtio_trans = {
 	.create = p9_virtio_create,
 	.close = p9_virtio_close,
 	.request = p9_virtio_request,
+	.zc_request = p9_virtio_zc_request,
 	.poll = p9_virtio_poll,
 	.cancel = p9_virtio_cancel,
 	.cancelled = p9_virtio_cancelled,
@@ -22,6 +22,7 @@
 #include <getopt.h>
 #include <globalvar.h>
 #include <init.h>
+#include <sched.h>
 #include <dhcp.h>
 
 #define OPT_SIZE 312	/* Minimum DHCP Options size per RFC2131 - results in 576 byte pkt */
@@ -522,6 +523,7 @@ int dhcp_request(struct eth_device *edev, const struct dhcp_req_param *param,
 			goto out1;
 		}
 		net_poll();
+		yield();
 		if (is_timeout(dhcp_start, 3 * SECOND)) {
 			dhcp_start = get_time_ns();
 			printf("T ");
@@ -29,6 +29,8 @@
 #include <net.h>
 #include <clock.h>
 #include <environment.h>
+#include <init.h>
+#include <poller.h>
 #include <linux/err.h>
 
 #define DNS_PORT 53
@@ -57,11 +59,69 @@ struct header {
 #define STATE_DONE	1
 
 static struct net_connection *dns_con;
+static IPaddr_t dns_nameserver;	/* nameserver dns_con is bound to */
+static const char *dns_query_name; /* hostname of the in-flight query */
+static char *dns_prefetch_name;
 static uint64_t dns_timer_start;
 static uint16_t dns_req_id;
-static int dns_state;
+static int dns_state = STATE_DONE;
 static IPaddr_t dns_ip;
 
+#define DNS_CACHE_SIZE		4
+/* Entries older than this are resolved again before use */
+#define DNS_CACHE_LIFETIME	(60 * SECOND)
+/* Age at which the poller starts refreshing an entry in the background */
+#define DNS_CACHE_REFRESH	(30 * SECOND)
+
+struct dns_cache_entry {
+	char *name;
+	IPaddr_t ip;
+	uint64_t time;		/* when the answer for this entry was received */
+	uint64_t refresh_time;	/* when we last sent a background refresh */
+};
+
+static struct dns_cache_entry dns_cache[DNS_CACHE_SIZE];
+
+static struct dns_cache_entry *dns_cache_lookup(const char *name)
+{
+	int i;
+
+	for (i = 0; i < DNS_CACHE_SIZE; i++) {
+		if (dns_cache[i].name && !strcmp(dns_cache[i].name, name))
+			return &dns_cache[i];
+	}
+
+	return NULL;
+}
+
+static void dns_cache_insert(const char *name, IPaddr_t ip)
+{
+	struct dns_cache_entry *entry, *oldest = &dns_cache[0];
+	int i;
+
+	if (!name)
+		return;
+
+	for (i = 0; i < DNS_CACHE_SIZE; i++) {
+		entry = &dns_cache[i];
+
+		if (entry->name && !strcmp(entry->name, name)) {
+			entry->ip = ip;
+			entry->time = get_time_ns();
+			return;
+		}
+
+		if (entry->time < oldest->time)
+			oldest = entry;
+	}
+
+	free(oldest->name);
+	oldest->name = xstrdup(name);
+	oldest->ip = ip;
+	oldest->time = get_time_ns();
+	oldest->refresh_time = 0;
+}
+
 static int dns_send(const char *name)
 {
 	int ret;
@@ -201,6 +261,7 @@ static void dns_recv(struct header *header, unsigned len)
 		p += 12;
 		dns_ip = net_read_ip(p);
 		dns_state = STATE_DONE;
+		dns_cache_insert(dns_query_name, dns_ip);
 	}
 }
 
@@ -211,29 +272,141 @@ static void dns_handler(void *ctx, char *packet, unsigned len)
 		net_eth_to_udplen(packet));
 }
 
-int resolv(const char *host, IPaddr_t *ip)
+static int dns_connect(void)
 {
 	IPaddr_t nameserver;
 
+	nameserver = net_get_nameserver();
+	if (!nameserver) {
+		pr_err("no nameserver specified in $global.net.nameserver\n");
+		return -ENOENT;
+	}
+
+	if (dns_con && nameserver == dns_nameserver)
+		return 0;
+
+	if (dns_con)
+		net_unregister(dns_con);
+
+	dns_con = net_udp_new(nameserver, DNS_PORT, dns_handler, NULL);
+	if (IS_ERR(dns_con)) {
+		int ret = PTR_ERR(dns_con);
+
+		dns_con = NULL;
+		return ret;
+	}
+
+	dns_nameserver = nameserver;
+
+	return 0;
+}
+
+/*
+ * Re-query entries that are about to expire so that repeated network
+ * commands within a session keep hitting the cache. Only one query is
+ * in flight at a time and a foreground resolv() always takes precedence.
+ */
+static void dns_poller_func(struct poller_struct *poller)
+{
+	int i;
+
+	if (!dns_con || dns_state != STATE_DONE)
+		return;
+
+	for (i = 0; i < DNS_CACHE_SIZE; i++) {
+		struct dns_cache_entry *entry = &dns_cache[i];
+
+		if (!entry->name)
+			continue;
+
+		if (!is_timeout(entry->time, DNS_CACHE_REFRESH) ||
+		    is_timeout(entry->time, DNS_CACHE_LIFETIME))
+			continue;
+
+		if (!is_timeout(entry->refresh_time, 5 * SECOND))
+			continue;
+
+		entry->refresh_time = get_time_ns();
+		dns_query_name = entry->name;
+		dns_timer_start = get_time_ns();
+		dns_send(entry->name);
+		return;
+	}
+}
+
+static struct poller_struct dns_poller = {
+	.func = dns_poller_func,
+};
+
+static int init_dns_poll(void)
+{
+	return poller_register(&dns_poller, "dns");
+}
+device_initcall(init_dns_poll);
+
+/*
+ * resolv_prefetch - start resolving @host in the background
+ *
+ * Fires off a single query whose answer lands in the cache, so a later
+ * resolv() of the same name returns without waiting. Failures are
+ * silently ignored, the foreground path retries synchronously.
+ */
+void resolv_prefetch(const char *host)
+{
+	struct dns_cache_entry *entry;
+	IPaddr_t ip;
+
+	if (!host || !string_to_ip(host, &ip))
+		return;
+
+	entry = dns_cache_lookup(host);
+	if (entry && !is_timeout(entry->time, DNS_CACHE_LIFETIME))
+		return;
+
+	if (dns_state != STATE_DONE)
+		return;	/* a foreground resolve is running */
+
+	if (dns_connect())
+		return;
+
+	free(dns_prefetch_name);
+	dns_prefetch_name = xstrdup(host);
+	dns_query_name = dns_prefetch_name;
+	dns_timer_start = get_time_ns();
+	dns_send(host);
+}
+
+int resolv(const char *host, IPaddr_t *ip)
+{
+	struct dns_cache_entry *entry;
+	int ret;
+
 	if (!string_to_ip(host, ip))
 		return 0;
 
-	dns_ip = 0;
 	*ip = 0;
 
+	entry = dns_cache_lookup(host);
+	if (entry && !is_timeout(entry->time, DNS_CACHE_LIFETIME)) {
+		pr_debug("host %s is at %pI4 (cached)\n", host, &entry->ip);
+		*ip = entry->ip;
+		return 0;
+	}
+
+	dns_ip = 0;
+
 	dns_state = STATE_INIT;
 
-	nameserver = net_get_nameserver();
-	if (!nameserver) {
-		pr_err("no nameserver specified in $global.net.nameserver\n");
-		return -ENOENT;
+	ret = dns_connect();
+	if (ret) {
+		dns_state = STATE_DONE;
+		return ret;
 	}
 
-	pr_debug("resolving host %s via nameserver %pI4\n", host, &nameserver);
+	pr_debug("resolving host %s via nameserver %pI4\n", host,
+		 &dns_nameserver);
 
-	dns_con = net_udp_new(nameserver, DNS_PORT, dns_handler, NULL);
-	if (IS_ERR(dns_con))
-		return PTR_ERR(dns_con);
+	dns_query_name = host;
 	dns_timer_start = get_time_ns();
 	dns_send(host);
 
@@ -249,7 +422,8 @@ int resolv(const char *host, IPaddr_t *ip)
 		}
 	}
 
-	net_unregister(dns_con);
+	dns_query_name = NULL;
+	dns_state = STATE_DONE;
 
 	if (dns_ip) {
 		pr_debug("host %s is at %pI4\n", host, &dns_ip);
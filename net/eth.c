@@ -13,6 +13,7 @@
 #include <machine_id.h>
 #include <of.h>
 #include <of_net.h>
+#include <poller.h>
 #include <linux/phy.h>
 #include <errno.h>
 #include <malloc.h>
@@ -185,6 +186,48 @@ int eth_carrier_poll_once(struct eth_device *edev)
 	return edev->phydev->link ? 0 : -ENETDOWN;
 }
 
+/*
+ * Poll the PHYs of active interfaces without link in the background, so
+ * that autonegotiation completes during delay loops and console idle
+ * instead of the first packet sent having to sit out the whole
+ * negotiation in eth_carrier_check(). This overlaps e.g. DHCP retries
+ * with link establishment on other interfaces.
+ */
+static void eth_carrier_poller_func(struct poller_struct *poller)
+{
+	struct eth_device *edev;
+
+	for_each_netdev(edev) {
+		struct phy_device *phydev = edev->phydev;
+
+		if (!edev->active || !phydev || phydev->link)
+			continue;
+
+		if (phy_acquired(phydev))
+			continue;
+
+		if (edev->last_link_check &&
+		    !is_timeout_non_interruptible(edev->last_link_check,
+						  phydev->polling_interval))
+			continue;
+
+		eth_carrier_poll_once(edev);
+	}
+}
+
+static struct poller_struct eth_carrier_poller = {
+	.func = eth_carrier_poller_func,
+};
+
+static int eth_carrier_poller_init(void)
+{
+	if (!IS_ENABLED(CONFIG_POLLER) || !IS_ENABLED(CONFIG_PHYLIB))
+		return 0;
+
+	return poller_register(&eth_carrier_poller, "ethcarrier");
+}
+device_initcall(eth_carrier_poller_init);
+
 /*
  * Check for link if we haven't done so for longer.
  */
@@ -529,6 +572,8 @@ void eth_unregister(struct eth_device *edev)
 	if (edev->active)
 		edev->halt(edev);
 
+	net_arp_invalidate(edev);
+
 	list_for_each_entry_safe(q, tmp, &edev->send_queue, list) {
 		if (q->edev != edev)
 			continue;
@@ -12,6 +12,7 @@
 #include <getopt.h>
 #include <dhcp.h>
 #include <net.h>
+#include <sntp.h>
 #include <fs.h>
 #include <globalvar.h>
 #include <string.h>
@@ -202,6 +203,14 @@ static int ifup_edev_conf(struct eth_device *edev, unsigned flags)
 
 	edev->ifup = true;
 
+	/*
+	 * Kick off lookups the following netboot steps usually pay for
+	 * serially. The results land in the DNS and SNTP caches while
+	 * e.g. the TFTP connection is being established.
+	 */
+	resolv_prefetch(net_get_server());
+	sntp_prefetch(NULL);
+
 	return 0;
 }
 
@@ -26,11 +26,19 @@
 #include <globalvar.h>
 #include <magicvar.h>
 #include <machine_id.h>
+#include <objcache.h>
 #include <linux/ctype.h>
 #include <linux/err.h>
 
 static unsigned int net_ip_id;
 
+DEFINE_PERFSTAT_GROUP(net_perfstat, "net",
+	[NET_PERFSTAT_RX_PACKETS] = { .name = "rx_packets" },
+	[NET_PERFSTAT_TX_PACKETS] = { .name = "tx_packets" },
+	[NET_PERFSTAT_TFTP_RETRANSMITS] = { .name = "tftp_retransmits" },
+);
+PERFSTAT_GROUP_REGISTER(net_perfstat);
+
 char *net_server;
 IPaddr_t net_gateway;
 static IPaddr_t net_nameserver;
@@ -113,16 +121,81 @@ int setenv_ip(const char *name, IPaddr_t ip)
 static unsigned char *arp_ether;
 static IPaddr_t arp_wait_ip;
 
-static void arp_handler(struct arprequest *arp)
+#define ARP_CACHE_SIZE		8
+/* Entries older than this are resolved again before use */
+#define ARP_CACHE_LIFETIME	(30 * SECOND)
+/* Age at which the poller starts refreshing an entry in the background */
+#define ARP_CACHE_REFRESH	(10 * SECOND)
+
+struct arp_cache_entry {
+	IPaddr_t ip;
+	unsigned char ether[6];
+	struct eth_device *edev;
+	uint64_t time;		/* when the reply for this entry was received */
+	uint64_t refresh_time;	/* when we last sent a background refresh */
+};
+
+static struct arp_cache_entry arp_cache[ARP_CACHE_SIZE];
+
+static struct arp_cache_entry *arp_cache_lookup(IPaddr_t ip)
+{
+	int i;
+
+	for (i = 0; i < ARP_CACHE_SIZE; i++) {
+		if (arp_cache[i].ip == ip)
+			return &arp_cache[i];
+	}
+
+	return NULL;
+}
+
+static void arp_cache_insert(struct eth_device *edev, IPaddr_t ip,
+			     const unsigned char *ether)
+{
+	struct arp_cache_entry *entry, *oldest = &arp_cache[0];
+	int i;
+
+	for (i = 0; i < ARP_CACHE_SIZE; i++) {
+		entry = &arp_cache[i];
+
+		if (entry->ip == ip) {
+			oldest = entry;
+			break;
+		}
+
+		if (entry->time < oldest->time)
+			oldest = entry;
+	}
+
+	oldest->ip = ip;
+	oldest->edev = edev;
+	memcpy(oldest->ether, ether, 6);
+	oldest->time = get_time_ns();
+}
+
+void net_arp_invalidate(struct eth_device *edev)
+{
+	int i;
+
+	for (i = 0; i < ARP_CACHE_SIZE; i++) {
+		if (arp_cache[i].edev == edev)
+			memset(&arp_cache[i], 0, sizeof(arp_cache[i]));
+	}
+}
+
+static void arp_handler(struct eth_device *edev, struct arprequest *arp)
 {
 	IPaddr_t tmp;
 
+	tmp = net_read_ip(&arp->ar_data[6]);
+
+	/* remember the sender, also for background refreshes */
+	arp_cache_insert(edev, tmp, &arp->ar_data[0]);
+
 	/* are we waiting for a reply */
 	if (!arp_wait_ip)
 		return;
 
-	tmp = net_read_ip(&arp->ar_data[6]);
-
 	/* matched waiting packet's address */
 	if (tmp == arp_wait_ip) {
 		/* save address for later use */
@@ -154,18 +227,12 @@ struct eth_device *net_route(IPaddr_t dest)
 	return NULL;
 }
 
-static int arp_request(struct eth_device *edev, IPaddr_t dest, unsigned char *ether)
+static int arp_send_request(struct eth_device *edev, IPaddr_t ip)
 {
 	char *pkt;
 	struct arprequest *arp;
-	uint64_t arp_start;
 	static char *arp_packet;
 	struct ethernet *et;
-	unsigned retries = 0;
-	int ret;
-
-	if (!edev)
-		return -EHOSTUNREACH;
 
 	if (!arp_packet) {
 		arp_packet = net_alloc_packet();
@@ -176,9 +243,7 @@ static int arp_request(struct eth_device *edev, IPaddr_t dest, unsigned char *et
 	pkt = arp_packet;
 	et = (struct ethernet *)arp_packet;
 
-	arp_wait_ip = dest;
-
-	pr_debug("send ARP broadcast for %pI4\n", &dest);
+	pr_debug("send ARP broadcast for %pI4\n", &ip);
 
 	memset(et->et_dest, 0xff, 6);
 	memcpy(et->et_src, edev->ethaddr, 6);
@@ -195,21 +260,39 @@ static int arp_request(struct eth_device *edev, IPaddr_t dest, unsigned char *et
 	memcpy(arp->ar_data, edev->ethaddr, 6);	/* source ET addr	*/
 	net_write_ip(arp->ar_data + 6, edev->ipaddr);	/* source IP addr	*/
 	memset(arp->ar_data + 10, 0, 6);	/* dest ET addr = 0     */
+	net_write_ip(arp->ar_data + 16, ip);
 
-	if ((dest & edev->netmask) != (edev->ipaddr & edev->netmask)) {
-		if (!net_gateway)
-			arp_wait_ip = dest;
-		else
-			arp_wait_ip = net_gateway;
-	} else {
-		arp_wait_ip = dest;
-	}
+	return eth_send(edev, arp_packet, ETHER_HDR_SIZE + ARP_HDR_SIZE);
+}
+
+static int arp_request(struct eth_device *edev, IPaddr_t dest, unsigned char *ether)
+{
+	struct arp_cache_entry *entry;
+	uint64_t arp_start;
+	unsigned retries = 0;
+	IPaddr_t ip;
+	int ret;
 
-	net_write_ip(arp->ar_data + 16, arp_wait_ip);
+	if (!edev)
+		return -EHOSTUNREACH;
 
+	if ((dest & edev->netmask) != (edev->ipaddr & edev->netmask) &&
+	    net_gateway)
+		ip = net_gateway;
+	else
+		ip = dest;
+
+	entry = arp_cache_lookup(ip);
+	if (entry && !is_timeout(entry->time, ARP_CACHE_LIFETIME)) {
+		pr_debug("Using cached ARP entry for %pI4\n", &ip);
+		memcpy(ether, entry->ether, 6);
+		return 0;
+	}
+
+	arp_wait_ip = ip;
 	arp_ether = ether;
 
-	ret = eth_send(edev, arp_packet, ETHER_HDR_SIZE + ARP_HDR_SIZE);
+	ret = arp_send_request(edev, ip);
 	if (ret)
 		return ret;
 	arp_start = get_time_ns();
@@ -221,7 +304,7 @@ static int arp_request(struct eth_device *edev, IPaddr_t dest, unsigned char *et
 		if (is_timeout(arp_start, 3 * SECOND)) {
 			printf("T ");
 			arp_start = get_time_ns();
-			ret = eth_send(edev, arp_packet, ETHER_HDR_SIZE + ARP_HDR_SIZE);
+			ret = arp_send_request(edev, ip);
 			if (ret)
 				return ret;
 			retries++;
@@ -239,6 +322,33 @@ static int arp_request(struct eth_device *edev, IPaddr_t dest, unsigned char *et
 	return 0;
 }
 
+/*
+ * Re-ARP entries that are about to expire so that repeated network
+ * commands within a session keep hitting the cache. Replies are picked
+ * up by arp_handler() which restarts the entry's lifetime.
+ */
+static void arp_cache_refresh(void)
+{
+	int i;
+
+	for (i = 0; i < ARP_CACHE_SIZE; i++) {
+		struct arp_cache_entry *entry = &arp_cache[i];
+
+		if (!entry->ip || !entry->edev || !entry->edev->ifup)
+			continue;
+
+		if (!is_timeout(entry->time, ARP_CACHE_REFRESH) ||
+		    is_timeout(entry->time, ARP_CACHE_LIFETIME))
+			continue;
+
+		if (!is_timeout(entry->refresh_time, 1 * SECOND))
+			continue;
+
+		entry->refresh_time = get_time_ns();
+		arp_send_request(entry->edev, entry->ip);
+	}
+}
+
 void net_poll(void)
 {
 	static bool in_net_poll;
@@ -281,6 +391,8 @@ static void __net_poll(struct poller_struct *poller)
 
 	net_poll();
 
+	arp_cache_refresh();
+
 	last = get_time_ns();
 }
 
@@ -441,6 +553,7 @@ static struct net_connection *net_new(struct eth_device *edev, IPaddr_t dest,
 	con->ip = (struct iphdr *)(con->packet + ETHER_HDR_SIZE);
 	con->udp = (struct udphdr *)(con->packet + ETHER_HDR_SIZE + sizeof(struct iphdr));
 	con->icmp = (struct icmphdr *)(con->packet + ETHER_HDR_SIZE + sizeof(struct iphdr));
+	con->tcp = (struct tcphdr *)(con->packet + ETHER_HDR_SIZE + sizeof(struct iphdr));
 	con->handler = handler;
 
 	if (dest == IP_BROADCAST) {
@@ -507,6 +620,22 @@ struct net_connection *net_icmp_new(IPaddr_t dest, rx_handler_f *handler,
 	return con;
 }
 
+struct net_connection *net_tcp_new(IPaddr_t dest, uint16_t dport,
+		rx_handler_f *handler, void *ctx)
+{
+	struct net_connection *con = net_new(NULL, dest, handler, ctx);
+
+	if (IS_ERR(con))
+		return con;
+
+	con->proto = IPPROTO_TCP;
+	con->tcp->th_dport = htons(dport);
+	con->tcp->th_sport = htons(net_udp_new_localport());
+	con->ip->protocol = IPPROTO_TCP;
+
+	return con;
+}
+
 void net_unregister(struct net_connection *con)
 {
 	list_del(&con->list);
@@ -532,6 +661,32 @@ int net_udp_send(struct net_connection *con, int len)
 	return net_ip_send(con, sizeof(struct udphdr) + len);
 }
 
+/*
+ * net_tcp_send - send a TCP segment prepared in con->packet
+ * @len: length of the segment including the TCP header and options
+ *
+ * The TCP checksum covers a pseudo header containing the IP addresses,
+ * so it cannot be computed by net_checksum() over the segment alone.
+ */
+int net_tcp_send(struct net_connection *con, int len)
+{
+	uint32_t sum;
+
+	con->tcp->th_sum = 0;
+
+	sum = net_checksum((unsigned char *)con->tcp, len);
+	sum += net_checksum((unsigned char *)&con->ip->saddr, 8);
+	sum += htons(IPPROTO_TCP);
+	sum += htons(len);
+
+	sum = (sum & 0xffff) + (sum >> 16);
+	sum = (sum & 0xffff) + (sum >> 16);
+
+	con->tcp->th_sum = ~sum;
+
+	return net_ip_send(con, len);
+}
+
 int net_icmp_send(struct net_connection *con, int len)
 {
 	con->icmp->checksum = ~net_checksum((unsigned char *)con->icmp,
@@ -544,8 +699,6 @@ static int net_answer_arp(struct eth_device *edev, unsigned char *pkt, int len)
 {
 	struct arprequest *arp = (struct arprequest *)(pkt + ETHER_HDR_SIZE);
 	struct ethernet *et = (struct ethernet *)pkt;
-	unsigned char *packet;
-	int ret;
 
 	pr_debug("%s\n", __func__);
 
@@ -559,14 +712,12 @@ static int net_answer_arp(struct eth_device *edev, unsigned char *pkt, int len)
 	memcpy(&arp->ar_data[0], edev->ethaddr, 6);
 	net_copy_ip(&arp->ar_data[6], &edev->ipaddr);
 
-	packet = net_alloc_packet();
-	if (!packet)
-		return 0;
-	memcpy(packet, pkt, ETHER_HDR_SIZE + ARP_HDR_SIZE);
-	ret = eth_send(edev, packet, ETHER_HDR_SIZE + ARP_HDR_SIZE);
-	net_free_packet(packet);
-
-	return ret;
+	/*
+	 * The reply was constructed in place in the received frame and
+	 * eth_send() doesn't keep a reference to the buffer, so there is
+	 * no need to copy it into a freshly allocated packet.
+	 */
+	return eth_send(edev, pkt, ETHER_HDR_SIZE + ARP_HDR_SIZE);
 }
 
 static void net_bad_packet(unsigned char *pkt, int len)
@@ -615,7 +766,7 @@ static int net_handle_arp(struct eth_device *edev, unsigned char *pkt, int len)
 	case ARPOP_REQUEST:
 		return net_answer_arp(edev, pkt, len);
 	case ARPOP_REPLY:
-		arp_handler(arp);
+		arp_handler(edev, arp);
 		return 1;
 	default:
 		pr_debug("Unexpected ARP opcode 0x%x\n", ntohs(arp->ar_op));
@@ -645,6 +796,25 @@ static int net_handle_udp(unsigned char *pkt, int len)
 	return -EINVAL;
 }
 
+static int net_handle_tcp(unsigned char *pkt, int len)
+{
+	struct iphdr *ip = (struct iphdr *)(pkt + ETHER_HDR_SIZE);
+	struct net_connection *con;
+	struct tcphdr *tcp;
+	int port;
+
+	tcp = (struct tcphdr *)(ip + 1);
+
+	port = ntohs(tcp->th_dport);
+	list_for_each_entry(con, &connection_list, list) {
+		if (con->proto == IPPROTO_TCP && port == ntohs(con->tcp->th_sport)) {
+			con->handler(con->priv, pkt, len);
+			return 0;
+		}
+	}
+	return -EINVAL;
+}
+
 static struct iphdr *ip_verify_size(unsigned char *pkt, int *total_len_nic)
 {
 	struct iphdr *ip = (struct iphdr *)(pkt + ETHER_HDR_SIZE);
@@ -687,8 +857,6 @@ static int ping_reply(struct eth_device *edev, unsigned char *pkt, int len)
 	struct ethernet *et = (struct ethernet *)pkt;
 	struct icmphdr *icmp;
 	struct iphdr *ip;
-	unsigned char *packet;
-	int ret;
 
 	memcpy(et->et_dest, et->et_src, 6);
 	memcpy(et->et_src, edev->ethaddr, 6);
@@ -711,17 +879,8 @@ static int ping_reply(struct eth_device *edev, unsigned char *pkt, int len)
 	net_copy_ip((void *)&ip->saddr, &edev->ipaddr);
 	ip->check = ~net_checksum((unsigned char *)ip, sizeof(struct iphdr));
 
-	packet = net_alloc_packet();
-	if (!packet)
-		return 0;
-
-	memcpy(packet, pkt, len);
-
-	ret = eth_send(edev, packet, len);
-
-	net_free_packet(packet);
-
-	return ret;
+	/* The reply was built in place, send it without a bounce buffer */
+	return eth_send(edev, pkt, len);
 }
 
 static int net_handle_icmp(struct eth_device *edev, unsigned char *pkt, int len)
@@ -777,6 +936,8 @@ static int net_handle_ip(struct eth_device *edev, unsigned char *pkt, int len)
 	switch (ip->protocol) {
 	case IPPROTO_ICMP:
 		return net_handle_icmp(edev, pkt, len);
+	case IPPROTO_TCP:
+		return net_handle_tcp(pkt, len);
 	case IPPROTO_UDP:
 		return net_handle_udp(pkt, len);
 	}
@@ -794,6 +955,7 @@ int net_receive(struct eth_device *edev, unsigned char *pkt, int len)
 	int ret;
 
 	led_trigger_network(LED_TRIGGER_NET_RX);
+	perfstat_inc(net_perfstat, NET_PERFSTAT_RX_PACKETS);
 
 	if (len < ETHER_HDR_SIZE) {
 		ret = 0;
@@ -830,6 +992,27 @@ out:
 	return ret;
 }
 
+/*
+ * Packet buffers are all PKTSIZE sized and allocated and freed at high
+ * rates by the protocol handlers, so recycle them through an object
+ * cache instead of the general purpose allocator.
+ */
+static struct objcache *net_packet_cache;
+
+char *net_alloc_packet(void)
+{
+	if (!net_packet_cache)
+		net_packet_cache = objcache_create("net_packet", PKTSIZE,
+						   DMA_ALIGNMENT, 32);
+
+	return objcache_alloc(net_packet_cache);
+}
+
+void net_free_packet(char *pkt)
+{
+	objcache_free(net_packet_cache, pkt);
+}
+
 void net_free_packets(void **packets, unsigned count)
 {
 	while (count-- > 0)
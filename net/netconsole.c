@@ -16,13 +16,29 @@
 #include <net.h>
 #include <kfifo.h>
 #include <init.h>
+#include <poller.h>
+#include <clock.h>
 #include <linux/err.h>
 
+/*
+ * Console output is batched into the UDP payload buffer and flushed as
+ * one datagram on newline, when the payload is full or when the poller
+ * notices output has been sitting around. One packet per line instead
+ * of one packet per character is what keeps verbose logging from
+ * dominating boot time.
+ */
+#define NC_MAX_PAYLOAD		1024
+#define NC_FLUSH_TIMEOUT	(10 * MSECOND)
+
 struct nc_priv {
 	struct console_device cdev;
 	struct kfifo *fifo;
 	int busy;
 	struct net_connection *con;
+	struct poller_struct poller;
+
+	unsigned int txlen;
+	u64 last_put;
 
 	unsigned int port;
 	IPaddr_t ip;
@@ -71,6 +87,23 @@ static int nc_tstc(struct console_device *cdev)
 	return kfifo_len(priv->fifo) ? 1 : 0;
 }
 
+static void nc_flush(struct nc_priv *priv)
+{
+	if (!priv->txlen || priv->busy)
+		return;
+
+	priv->busy = 1;
+	/*
+	 * Observability must not cost boot time: when the send fails,
+	 * e.g. because the link went away, the output is dropped rather
+	 * than retried.
+	 */
+	net_udp_send(priv->con, priv->txlen);
+	priv->busy = 0;
+
+	priv->txlen = 0;
+}
+
 static void nc_putc(struct console_device *cdev, char c)
 {
 	struct nc_priv *priv = container_of(cdev,
@@ -80,15 +113,24 @@ static void nc_putc(struct console_device *cdev, char c)
 	if (!priv->con)
 		return;
 
+	/* lose output re-entering us while the packet is on its way out */
 	if (priv->busy)
 		return;
 
 	packet = net_udp_get_payload(priv->con);
-	*packet = c;
+	packet[priv->txlen++] = c;
+	priv->last_put = get_time_ns();
 
-	priv->busy = 1;
-	net_udp_send(priv->con, 1);
-	priv->busy = 0;
+	if (c == '\n' || priv->txlen >= NC_MAX_PAYLOAD)
+		nc_flush(priv);
+}
+
+static void nc_poller(struct poller_struct *poller)
+{
+	struct nc_priv *priv = container_of(poller, struct nc_priv, poller);
+
+	if (priv->txlen && is_timeout(priv->last_put, NC_FLUSH_TIMEOUT))
+		nc_flush(priv);
 }
 
 static int nc_open(struct console_device *cdev)
@@ -115,6 +157,9 @@ static int nc_open(struct console_device *cdev)
 
 	net_udp_bind(priv->con, priv->port);
 
+	priv->poller.func = nc_poller;
+	poller_register(&priv->poller, "netconsole");
+
 	pr_info("netconsole initialized with %pI4:%d\n", &priv->ip, priv->port);
 
 	return 0;
@@ -126,6 +171,8 @@ static int nc_close(struct console_device *cdev)
 					struct nc_priv, cdev);
 
 	if (priv->con) {
+		nc_flush(priv);
+		poller_unregister(&priv->poller);
 		net_unregister(priv->con);
 		priv->con = NULL;
 		return 0;
@@ -10,6 +10,8 @@
 #include <sntp.h>
 #include <errno.h>
 #include <environment.h>
+#include <init.h>
+#include <poller.h>
 #include <linux/err.h>
 
 #define SNTP_PORT       123
@@ -60,6 +62,13 @@ static int sntp_state;
 static struct net_connection *sntp_con;
 
 static s64 curr_timestamp;
+static uint64_t sntp_rx_time;	/* local time when curr_timestamp was taken */
+static uint64_t sntp_timer_start;
+static int sntp_retries;
+static bool sntp_blocking;	/* a foreground sntp() drives the query */
+
+/* A fetched timestamp stays usable this long, advanced by local time */
+#define SNTP_CACHE_LIFETIME	(120 * SECOND)
 
 static int sntp_send(void)
 {
@@ -97,14 +106,21 @@ static void sntp_handler(void *ctx, char *pkt, unsigned len)
 		return;
 
 	curr_timestamp = (get_unaligned_be64(&ntp->xmt) >> 32) - 2208988800UL;
+	sntp_rx_time = get_time_ns();
 
 	sntp_state = SNTP_STATE_SUCCESS;
 }
 
-s64 sntp(const char *server)
+static s64 sntp_cached_timestamp(void)
 {
-	int ret, repeat = 5;
-	u64 sntp_start;
+	u64 elapsed = get_time_ns() - sntp_rx_time;
+
+	return curr_timestamp + div64_u64(elapsed, SECOND);
+}
+
+static int sntp_start_query(const char *server)
+{
+	int ret;
 
 	if (!server)
 		server = getenv("global.dhcp.ntpserver");
@@ -120,15 +136,92 @@ s64 sntp(const char *server)
 	sntp_con = net_udp_new(net_sntp_ip, SNTP_PORT, sntp_handler, NULL);
 	if (IS_ERR(sntp_con)) {
 		ret = PTR_ERR(sntp_con);
-		goto out;
+		sntp_con = NULL;
+		return ret;
 	}
 
-	sntp_start = get_time_ns();
+	sntp_state = SNTP_STATE_INIT;
+	sntp_timer_start = get_time_ns();
+
 	ret = sntp_send();
-	if (ret)
-		goto out_unreg;
+	if (ret) {
+		net_unregister(sntp_con);
+		sntp_con = NULL;
+		return ret;
+	}
 
-	sntp_state = SNTP_STATE_INIT;
+	return 0;
+}
+
+/* Drives a query started by sntp_prefetch() to completion */
+static void sntp_poller_func(struct poller_struct *poller)
+{
+	if (!sntp_con || sntp_blocking)
+		return;
+
+	if (sntp_state == SNTP_STATE_SUCCESS) {
+		net_unregister(sntp_con);
+		sntp_con = NULL;
+		return;
+	}
+
+	if (!is_timeout(sntp_timer_start, 1 * SECOND))
+		return;
+
+	if (!sntp_retries--) {
+		net_unregister(sntp_con);
+		sntp_con = NULL;
+		return;
+	}
+
+	sntp_timer_start = get_time_ns();
+	sntp_send();
+}
+
+static struct poller_struct sntp_poller = {
+	.func = sntp_poller_func,
+};
+
+static int init_sntp_poll(void)
+{
+	return poller_register(&sntp_poller, "sntp");
+}
+device_initcall(init_sntp_poll);
+
+/*
+ * sntp_prefetch - query the NTP server in the background
+ *
+ * The reply is picked up by the poller and cached, so a later sntp()
+ * call returns without a network round trip. Failures are silently
+ * ignored, the foreground path retries synchronously.
+ */
+void sntp_prefetch(const char *server)
+{
+	if (sntp_con)
+		return;
+
+	if (sntp_rx_time && !is_timeout(sntp_rx_time, SNTP_CACHE_LIFETIME))
+		return;
+
+	sntp_retries = 5;
+	sntp_start_query(server);
+}
+
+s64 sntp(const char *server)
+{
+	int ret, repeat = 5;
+
+	if (sntp_rx_time && !is_timeout(sntp_rx_time, SNTP_CACHE_LIFETIME))
+		return sntp_cached_timestamp();
+
+	/* adopt a prefetched query still in flight, if there is one */
+	if (!sntp_con) {
+		ret = sntp_start_query(server);
+		if (ret)
+			return ret;
+	}
+
+	sntp_blocking = true;
 
 	while (sntp_state == SNTP_STATE_INIT) {
 		if (ctrlc()) {
@@ -138,8 +231,8 @@ s64 sntp(const char *server)
 
 		net_poll();
 
-		if (is_timeout(sntp_start, 1 * SECOND)) {
-			sntp_start = get_time_ns();
+		if (is_timeout(sntp_timer_start, 1 * SECOND)) {
+			sntp_timer_start = get_time_ns();
 			ret = sntp_send();
 			if (ret)
 				goto out_unreg;
@@ -151,12 +244,15 @@ s64 sntp(const char *server)
 		}
 	}
 
+	sntp_blocking = false;
 	net_unregister(sntp_con);
+	sntp_con = NULL;
 
 	return curr_timestamp;
 
 out_unreg:
+	sntp_blocking = false;
 	net_unregister(sntp_con);
-out:
+	sntp_con = NULL;
 	return ret;
 }
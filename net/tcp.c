@@ -0,0 +1,470 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+/*
+ * tcp.c - minimal TCP client support
+ *
+ * This is a deliberately small TCP: one connection per socket, in-order
+ * receive only (out-of-order segments are dropped and recovered by peer
+ * retransmission) and a stop-and-wait transmit path. That is sufficient
+ * for the request/response protocols barebox uses it for, where we
+ * mostly download: the receive side buffers into a large ring and
+ * advertises a scaled window, so the peer can keep the pipe full while
+ * barebox transmits little more than ACKs.
+ */
+
+#define pr_fmt(fmt) "tcp: " fmt
+
+#include <common.h>
+#include <clock.h>
+#include <net.h>
+#include <tcp.h>
+#include <malloc.h>
+#include <linux/err.h>
+#include <linux/sizes.h>
+
+/* Our maximum segment size, limited by PKTSIZE on the transmit side */
+#define TCP_MSS			1460
+/* Receive ring buffer size */
+#define TCP_RX_BUFSIZE		SZ_256K
+/* Our receive window scale shift, makes TCP_RX_BUFSIZE advertisable */
+#define TCP_RX_WSCALE		3
+/* Retransmit interval for the stop-and-wait transmit path */
+#define TCP_RETRANS_TIMEOUT	(500 * MSECOND)
+/* Give up on a read when the peer stays silent for this long */
+#define TCP_TIMEOUT		(10 * SECOND)
+
+enum tcp_state {
+	TCP_CLOSED,
+	TCP_SYN_SENT,
+	TCP_ESTABLISHED,
+	TCP_CLOSE_WAIT,		/* peer sent FIN, buffered data is still readable */
+	TCP_FIN_WAIT1,		/* we sent FIN, waiting for its ACK */
+	TCP_FIN_WAIT2,		/* our FIN is acked, waiting for the peer's */
+	TCP_LAST_ACK,		/* FIN sent after CLOSE_WAIT */
+};
+
+struct tcp_socket {
+	struct net_connection *con;
+	enum tcp_state state;
+
+	uint32_t snd_nxt;	/* next sequence number to send */
+	uint32_t snd_una;	/* oldest unacknowledged sequence number */
+	uint32_t rcv_nxt;	/* next sequence number expected */
+
+	unsigned int mss;	/* peer's maximum segment size */
+	bool wscale_ok;		/* peer negotiated window scaling */
+
+	uint8_t *rxbuf;		/* receive ring buffer */
+	unsigned int rx_head;	/* read position in @rxbuf */
+	unsigned int rx_len;	/* bytes buffered in @rxbuf */
+};
+
+static inline bool tcp_seq_before(uint32_t a, uint32_t b)
+{
+	return (int32_t)(a - b) < 0;
+}
+
+static unsigned int tcp_rx_space(struct tcp_socket *sock)
+{
+	return TCP_RX_BUFSIZE - sock->rx_len;
+}
+
+static uint16_t tcp_rx_window(struct tcp_socket *sock)
+{
+	unsigned int space = tcp_rx_space(sock);
+
+	if (sock->wscale_ok)
+		space >>= TCP_RX_WSCALE;
+
+	return min_t(unsigned int, space, 0xffff);
+}
+
+static int tcp_output(struct tcp_socket *sock, uint32_t seq, uint8_t flags,
+		      const void *data, int dlen)
+{
+	struct net_connection *con = sock->con;
+	struct tcphdr *tcp = con->tcp;
+	uint8_t *opt = net_tcp_get_payload(con);
+	int optlen = 0;
+
+	if (flags & TCP_SYN) {
+		/* maximum segment size */
+		opt[0] = 2;
+		opt[1] = 4;
+		opt[2] = TCP_MSS >> 8;
+		opt[3] = TCP_MSS & 0xff;
+		/* window scale, padded to 32bit with a NOP */
+		opt[4] = 1;
+		opt[5] = 3;
+		opt[6] = 3;
+		opt[7] = TCP_RX_WSCALE;
+		optlen = 8;
+	}
+
+	if (dlen)
+		memcpy(opt + optlen, data, dlen);
+
+	tcp->th_seq = htonl(seq);
+	tcp->th_ack = htonl(flags & TCP_ACK ? sock->rcv_nxt : 0);
+	tcp->th_off = ((sizeof(*tcp) + optlen) / 4) << 4;
+	tcp->th_flags = flags;
+	/* the window field of the SYN itself is never scaled */
+	if (flags & TCP_SYN)
+		tcp->th_win = htons(min_t(unsigned int, tcp_rx_space(sock),
+					  0xffff));
+	else
+		tcp->th_win = htons(tcp_rx_window(sock));
+	tcp->th_urp = 0;
+
+	return net_tcp_send(con, sizeof(*tcp) + optlen + dlen);
+}
+
+static int tcp_send_ack(struct tcp_socket *sock)
+{
+	return tcp_output(sock, sock->snd_nxt, TCP_ACK, NULL, 0);
+}
+
+static void tcp_parse_syn_options(struct tcp_socket *sock, struct tcphdr *tcp)
+{
+	uint8_t *opt = (uint8_t *)(tcp + 1);
+	uint8_t *end = (uint8_t *)tcp + (tcp->th_off >> 4) * 4;
+
+	sock->mss = 536;
+	sock->wscale_ok = false;
+
+	while (opt < end) {
+		if (opt[0] == 0)	/* end of options */
+			return;
+
+		if (opt[0] == 1) {	/* NOP */
+			opt++;
+			continue;
+		}
+
+		if (opt + 1 >= end || opt[1] < 2 || opt + opt[1] > end)
+			return;
+
+		switch (opt[0]) {
+		case 2:			/* maximum segment size */
+			if (opt[1] == 4)
+				sock->mss = min_t(unsigned int,
+						  (opt[2] << 8) | opt[3],
+						  TCP_MSS);
+			break;
+		case 3:			/* window scale */
+			/*
+			 * We only scale our own receive window, so it is
+			 * enough to know that the peer supports the option.
+			 */
+			if (opt[1] == 3)
+				sock->wscale_ok = true;
+			break;
+		}
+
+		opt += opt[1];
+	}
+}
+
+static void tcp_rx_handler(void *ctx, char *pkt, unsigned int len)
+{
+	struct tcp_socket *sock = ctx;
+	struct iphdr *ip = net_eth_to_iphdr(pkt);
+	struct tcphdr *tcp = net_eth_to_tcphdr(pkt);
+	unsigned int doff = (tcp->th_off >> 4) * 4;
+	int dlen = ntohs(ip->tot_len) - sizeof(*ip) - doff;
+	uint8_t *data = (uint8_t *)tcp + doff;
+	uint32_t seq = ntohl(tcp->th_seq);
+	uint8_t flags = tcp->th_flags;
+
+	if (tcp->th_sport != sock->con->tcp->th_dport)
+		return;
+	if (doff < sizeof(*tcp) || dlen < 0)
+		return;
+
+	if (flags & TCP_RST) {
+		pr_debug("connection reset by peer\n");
+		sock->state = TCP_CLOSED;
+		return;
+	}
+
+	if (sock->state == TCP_SYN_SENT) {
+		if ((flags & (TCP_SYN | TCP_ACK)) != (TCP_SYN | TCP_ACK))
+			return;
+		if (ntohl(tcp->th_ack) != sock->snd_nxt)
+			return;
+
+		tcp_parse_syn_options(sock, tcp);
+		sock->rcv_nxt = seq + 1;
+		sock->snd_una = ntohl(tcp->th_ack);
+		sock->state = TCP_ESTABLISHED;
+		tcp_send_ack(sock);
+		return;
+	}
+
+	if (flags & TCP_ACK) {
+		uint32_t ack = ntohl(tcp->th_ack);
+
+		if (tcp_seq_before(sock->snd_una, ack) &&
+		    !tcp_seq_before(sock->snd_nxt, ack))
+			sock->snd_una = ack;
+
+		if (sock->snd_una == sock->snd_nxt) {
+			if (sock->state == TCP_FIN_WAIT1)
+				sock->state = TCP_FIN_WAIT2;
+			else if (sock->state == TCP_LAST_ACK)
+				sock->state = TCP_CLOSED;
+		}
+	}
+
+	if (seq != sock->rcv_nxt) {
+		/*
+		 * Drop out-of-order segments, the duplicate ACK makes
+		 * the peer retransmit from rcv_nxt.
+		 */
+		tcp_send_ack(sock);
+		return;
+	}
+
+	if (dlen > 0) {
+		unsigned int n = min_t(unsigned int, dlen,
+				       tcp_rx_space(sock));
+		unsigned int tail = (sock->rx_head + sock->rx_len) %
+				    TCP_RX_BUFSIZE;
+		unsigned int chunk = min_t(unsigned int, n,
+					   TCP_RX_BUFSIZE - tail);
+
+		memcpy(sock->rxbuf + tail, data, chunk);
+		if (n > chunk)
+			memcpy(sock->rxbuf, data + chunk, n - chunk);
+
+		sock->rx_len += n;
+		sock->rcv_nxt += n;
+
+		if (n < (unsigned int)dlen) {
+			/* ring full, the remainder is retransmitted later */
+			tcp_send_ack(sock);
+			return;
+		}
+	}
+
+	if (flags & TCP_FIN) {
+		sock->rcv_nxt++;
+
+		switch (sock->state) {
+		case TCP_ESTABLISHED:
+			sock->state = TCP_CLOSE_WAIT;
+			break;
+		case TCP_FIN_WAIT1:
+		case TCP_FIN_WAIT2:
+			/* skip TIME_WAIT, we are a short-lived client */
+			sock->state = TCP_CLOSED;
+			break;
+		default:
+			break;
+		}
+
+		tcp_send_ack(sock);
+		return;
+	}
+
+	if (dlen > 0)
+		tcp_send_ack(sock);
+}
+
+struct tcp_socket *tcp_connect(IPaddr_t dest, uint16_t dport)
+{
+	struct tcp_socket *sock;
+	unsigned retries = 0;
+	uint64_t start;
+	int ret;
+
+	sock = xzalloc(sizeof(*sock));
+	sock->rxbuf = xmalloc(TCP_RX_BUFSIZE);
+	sock->mss = 536;
+
+	sock->con = net_tcp_new(dest, dport, tcp_rx_handler, sock);
+	if (IS_ERR(sock->con)) {
+		ret = PTR_ERR(sock->con);
+		goto out_free;
+	}
+
+	/* weak initial sequence number, fine for a boot-time transfer */
+	sock->snd_una = sock->snd_nxt = (uint32_t)get_time_ns();
+
+	ret = tcp_output(sock, sock->snd_nxt, TCP_SYN, NULL, 0);
+	if (ret)
+		goto out_unreg;
+	sock->snd_nxt++;
+	sock->state = TCP_SYN_SENT;
+
+	start = get_time_ns();
+	while (sock->state == TCP_SYN_SENT) {
+		if (ctrlc()) {
+			ret = -EINTR;
+			goto out_unreg;
+		}
+
+		if (is_timeout(start, SECOND)) {
+			start = get_time_ns();
+			ret = tcp_output(sock, sock->snd_nxt - 1, TCP_SYN,
+					 NULL, 0);
+			if (ret)
+				goto out_unreg;
+			retries++;
+		}
+
+		if (retries > PKT_NUM_RETRIES) {
+			ret = -ETIMEDOUT;
+			goto out_unreg;
+		}
+
+		net_poll();
+	}
+
+	if (sock->state != TCP_ESTABLISHED) {
+		ret = -ECONNREFUSED;
+		goto out_unreg;
+	}
+
+	return sock;
+
+out_unreg:
+	net_unregister(sock->con);
+out_free:
+	free(sock->rxbuf);
+	free(sock);
+	return ERR_PTR(ret);
+}
+
+/*
+ * tcp_write - send data, blocking until it is acknowledged
+ *
+ * This is stop-and-wait with one segment in flight: our transmissions
+ * are small protocol requests, the bulk data flows the other way.
+ */
+int tcp_write(struct tcp_socket *sock, const void *buf, size_t len)
+{
+	const uint8_t *data = buf;
+	size_t sent = 0;
+
+	while (sent < len) {
+		size_t n = min_t(size_t, sock->mss, len - sent);
+		unsigned retries = 0;
+		uint64_t start;
+		uint32_t seq;
+		int ret;
+
+		if (sock->state != TCP_ESTABLISHED &&
+		    sock->state != TCP_CLOSE_WAIT)
+			return -ENOTCONN;
+
+		seq = sock->snd_nxt;
+		ret = tcp_output(sock, seq, TCP_PSH | TCP_ACK, data + sent, n);
+		if (ret)
+			return ret;
+		sock->snd_nxt += n;
+
+		start = get_time_ns();
+		while (tcp_seq_before(sock->snd_una, sock->snd_nxt)) {
+			if (ctrlc())
+				return -EINTR;
+
+			if (sock->state == TCP_CLOSED)
+				return -ECONNRESET;
+
+			if (is_timeout(start, TCP_RETRANS_TIMEOUT)) {
+				start = get_time_ns();
+				ret = tcp_output(sock, seq, TCP_PSH | TCP_ACK,
+						 data + sent, n);
+				if (ret)
+					return ret;
+				retries++;
+			}
+
+			if (retries > PKT_NUM_RETRIES)
+				return -ETIMEDOUT;
+
+			net_poll();
+		}
+
+		sent += n;
+	}
+
+	return len;
+}
+
+/*
+ * tcp_read - read received data, blocking until some is available
+ *
+ * Returns the number of bytes copied to @buf, 0 when the peer has
+ * closed the connection and all buffered data has been consumed or a
+ * negative error code.
+ */
+int tcp_read(struct tcp_socket *sock, void *buf, size_t len)
+{
+	uint64_t start = get_time_ns();
+	unsigned int n, chunk;
+	bool was_tight;
+
+	while (!sock->rx_len) {
+		if (sock->state == TCP_CLOSE_WAIT ||
+		    sock->state == TCP_CLOSED)
+			return 0;
+
+		if (ctrlc())
+			return -EINTR;
+
+		if (is_timeout(start, TCP_TIMEOUT))
+			return -ETIMEDOUT;
+
+		net_poll();
+	}
+
+	/* fast path: copy straight out of the ring buffer */
+	was_tight = tcp_rx_space(sock) < 2 * TCP_MSS;
+
+	n = min_t(size_t, len, sock->rx_len);
+	chunk = min_t(unsigned int, n, TCP_RX_BUFSIZE - sock->rx_head);
+	memcpy(buf, sock->rxbuf + sock->rx_head, chunk);
+	if (n > chunk)
+		memcpy((uint8_t *)buf + chunk, sock->rxbuf, n - chunk);
+
+	sock->rx_head = (sock->rx_head + n) % TCP_RX_BUFSIZE;
+	sock->rx_len -= n;
+
+	/* reopen a window the peer may have seen closed */
+	if (was_tight && sock->state == TCP_ESTABLISHED)
+		tcp_send_ack(sock);
+
+	return n;
+}
+
+void tcp_close(struct tcp_socket *sock)
+{
+	uint64_t start;
+
+	switch (sock->state) {
+	case TCP_ESTABLISHED:
+	case TCP_CLOSE_WAIT:
+		if (tcp_output(sock, sock->snd_nxt, TCP_FIN | TCP_ACK,
+			       NULL, 0))
+			break;
+
+		sock->state = sock->state == TCP_ESTABLISHED ?
+			TCP_FIN_WAIT1 : TCP_LAST_ACK;
+		sock->snd_nxt++;
+
+		/* best effort, don't hold up the caller for long */
+		start = get_time_ns();
+		while (sock->state != TCP_CLOSED &&
+		       !is_timeout(start, SECOND) && !ctrlc())
+			net_poll();
+		break;
+	default:
+		break;
+	}
+
+	net_unregister(sock->con);
+	free(sock->rxbuf);
+	free(sock);
+}
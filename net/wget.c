@@ -0,0 +1,208 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+/* wget - fetch a file from an HTTP server */
+
+#define pr_fmt(fmt) "wget: " fmt
+
+#include <common.h>
+#include <command.h>
+#include <complete.h>
+#include <fcntl.h>
+#include <fs.h>
+#include <getopt.h>
+#include <net.h>
+#include <progress.h>
+#include <tcp.h>
+#include <linux/err.h>
+
+#define WGET_BUFSIZE	4096
+
+static int wget_read_line(struct tcp_socket *sock, char *line, int size)
+{
+	int n = 0;
+
+	while (n < size - 1) {
+		char c;
+		int ret = tcp_read(sock, &c, 1);
+
+		if (ret < 0)
+			return ret;
+		if (ret == 0 || c == '\n')
+			break;
+		if (c != '\r')
+			line[n++] = c;
+	}
+
+	line[n] = '\0';
+
+	return n;
+}
+
+static int do_wget(int argc, char *argv[])
+{
+	struct tcp_socket *sock = NULL;
+	char *url, *host, *path = NULL, *p;
+	const char *dest = NULL;
+	char line[256];
+	char *request, *buf;
+	long long content_length = -1;
+	loff_t total = 0;
+	uint16_t port = 80;
+	int opt, status, fd = -1, ret;
+	IPaddr_t ip;
+
+	while ((opt = getopt(argc, argv, "O:")) > 0) {
+		switch (opt) {
+		case 'O':
+			dest = optarg;
+			break;
+		default:
+			return COMMAND_ERROR_USAGE;
+		}
+	}
+
+	if (optind == argc)
+		return COMMAND_ERROR_USAGE;
+
+	url = xstrdup(argv[optind]);
+
+	if (!strncmp(url, "http://", 7)) {
+		host = url + 7;
+	} else if (strstr(url, "://")) {
+		printf("only http:// URLs are supported\n");
+		ret = -EINVAL;
+		goto out;
+	} else {
+		host = url;
+	}
+
+	p = strchr(host, '/');
+	if (p) {
+		path = xstrdup(p);
+		*p = '\0';
+	} else {
+		path = xstrdup("/");
+	}
+
+	p = strchr(host, ':');
+	if (p) {
+		*p = '\0';
+		port = simple_strtoul(p + 1, NULL, 10);
+	}
+
+	if (!dest) {
+		dest = strrchr(path, '/') + 1;
+		if (!*dest)
+			dest = "index.html";
+	}
+
+	ret = resolv(host, &ip);
+	if (ret) {
+		printf("cannot resolve \"%s\": %pe\n", host, ERR_PTR(ret));
+		goto out;
+	}
+
+	sock = tcp_connect(ip, port);
+	if (IS_ERR(sock)) {
+		ret = PTR_ERR(sock);
+		sock = NULL;
+		printf("cannot connect to %pI4:%u: %pe\n", &ip, port,
+		       ERR_PTR(ret));
+		goto out;
+	}
+
+	/*
+	 * HTTP/1.0 keeps the reply body a plain octet stream terminated
+	 * by the connection close, no chunked transfer encoding.
+	 */
+	request = basprintf("GET %s HTTP/1.0\r\nHost: %s\r\n\r\n", path, host);
+	ret = tcp_write(sock, request, strlen(request));
+	free(request);
+	if (ret < 0)
+		goto out;
+
+	ret = wget_read_line(sock, line, sizeof(line));
+	if (ret < 0)
+		goto out;
+
+	p = strchr(line, ' ');
+	status = p ? simple_strtoul(p + 1, NULL, 10) : 0;
+	if (status != 200) {
+		printf("server replied: %s\n", line);
+		ret = -ENOENT;
+		goto out;
+	}
+
+	while (1) {
+		ret = wget_read_line(sock, line, sizeof(line));
+		if (ret < 0)
+			goto out;
+		if (ret == 0)	/* end of headers */
+			break;
+		if (!strncasecmp(line, "Content-Length:", 15))
+			content_length = simple_strtoull(skip_spaces(line + 15),
+							 NULL, 10);
+	}
+
+	fd = open(dest, O_WRONLY | O_CREAT | O_TRUNC);
+	if (fd < 0) {
+		perror("open");
+		ret = fd;
+		goto out;
+	}
+
+	init_progression_bar(content_length > 0 ? content_length : 0);
+
+	buf = xmalloc(WGET_BUFSIZE);
+
+	while ((ret = tcp_read(sock, buf, WGET_BUFSIZE)) > 0) {
+		int now = write(fd, buf, ret);
+
+		if (now < 0) {
+			ret = now;
+			break;
+		}
+
+		total += ret;
+		show_progress(total);
+	}
+
+	free(buf);
+	putchar('\n');
+
+	if (ret >= 0 && content_length >= 0 && total != content_length) {
+		printf("short transfer: %llu of %llu bytes\n",
+		       (unsigned long long)total, content_length);
+		ret = -EIO;
+	}
+
+out:
+	if (fd >= 0)
+		close(fd);
+	if (sock)
+		tcp_close(sock);
+	free(path);
+	free(url);
+
+	if (ret < 0) {
+		printf("wget failed: %pe\n", ERR_PTR(ret));
+		return COMMAND_ERROR;
+	}
+
+	return 0;
+}
+
+BAREBOX_CMD_HELP_START(wget)
+BAREBOX_CMD_HELP_TEXT("Fetch a file from an HTTP server.")
+BAREBOX_CMD_HELP_TEXT("")
+BAREBOX_CMD_HELP_TEXT("Options:")
+BAREBOX_CMD_HELP_OPT ("-O FILE", "write output to FILE instead of the URL basename")
+BAREBOX_CMD_HELP_END
+
+BAREBOX_CMD_START(wget)
+	.cmd		= do_wget,
+	BAREBOX_CMD_DESC("fetch a file over HTTP")
+	BAREBOX_CMD_OPTS("[-O FILE] URL")
+	BAREBOX_CMD_GROUP(CMD_GRP_NET)
+	BAREBOX_CMD_HELP(cmd_wget_help)
+BAREBOX_CMD_END
@@ -10,6 +10,8 @@
 #include <crypto/pbl-sha.h>
 #include <digest.h>
 #include <asm/sections.h>
+#include <asm/unaligned.h>
+#include <linux/sizes.h>
 #include <pbl.h>
 #include <debug_ll.h>
 
@@ -89,10 +91,26 @@ int pbl_barebox_verify(const void *compressed_start, unsigned int len,
 	return memcmp(hash, computed_hash, SHA256_DIGEST_SIZE);
 }
 
+/*
+ * Safety margin needed between the write and the read pointer for
+ * overlap-safe in-place decompression. All supported decompressors
+ * consume their input sequentially, so once the compressed stream is
+ * placed at the very end of the destination buffer, the read pointer
+ * stays ahead of the write pointer as long as the stream ends this many
+ * bytes beyond the decompressed output. The constants are the worst
+ * case for gzip (five bytes overhead per 32K stored block plus the
+ * block lookahead); the other decompressors need less.
+ */
+static unsigned int inplace_margin(unsigned int uncompressed_len)
+{
+	return (uncompressed_len >> 12) + SZ_32K + 18;
+}
+
 void pbl_barebox_uncompress(void *dest, void *compressed_start, unsigned int len)
 {
 	uint32_t pbl_hash_len;
 	void *pbl_hash_start, *pbl_hash_end;
+	uint32_t uncompressed_len;
 
 	if (IS_ENABLED(CONFIG_PBL_VERIFY_PIGGY)) {
 		pbl_hash_start = sha_sum;
@@ -105,6 +123,25 @@ void pbl_barebox_uncompress(void *dest, void *compressed_start, unsigned int len
 		}
 	}
 
+	/*
+	 * If the compressed stream overlaps the destination, move it to
+	 * the end of the destination buffer plus the safety margin, so
+	 * decompression can proceed in place. This allows constrained
+	 * layouts where only one image-sized region (plus margin) is
+	 * available instead of separate source and destination regions.
+	 * The uncompressed size is appended to the piggy data as a
+	 * 32 bit word by the image build.
+	 */
+	uncompressed_len = get_unaligned((const u32 *)(compressed_start + len - 4));
+	if (dest < compressed_start + len &&
+	    compressed_start < dest + uncompressed_len) {
+		void *relocated = dest + uncompressed_len +
+			inplace_margin(uncompressed_len) - len;
+
+		memmove(relocated, compressed_start, len);
+		compressed_start = relocated;
+	}
+
 	decompress((void *)compressed_start,
 			len,
 			NULL, NULL,
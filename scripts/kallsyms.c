@@ -141,10 +141,12 @@ static int symbol_valid(struct sym_entry *s)
 	 * specified so exclude them to get a stable symbol list.
 	 */
 	static char *special_symbols[] = {
-		"kallsyms_addresses",
+		"kallsyms_offsets",
+		"kallsyms_relative_base",
 		"kallsyms_num_syms",
 		"kallsyms_names",
 		"kallsyms_markers",
+		"kallsyms_seqs_of_names",
 		"kallsyms_token_table",
 		"kallsyms_token_index",
 
@@ -245,11 +247,21 @@ static int expand_symbol(unsigned char *data, int len, char *result)
 	return total;
 }
 
+static char **sorted_names;
+
+/* compare the name-sorted index entries by the symbol name they refer to */
+static int compare_names(const void *a, const void *b)
+{
+	return strcmp(sorted_names[*(const unsigned int *)a],
+		      sorted_names[*(const unsigned int *)b]);
+}
+
 static void write_src(void)
 {
 	unsigned int i, k, off;
 	unsigned int best_idx[256];
-	unsigned int *markers;
+	unsigned int *markers, *sorted;
+	unsigned long long relative_base;
 	char buf[KSYM_NAME_LEN];
 
 	printf("#include <asm/types.h>\n");
@@ -263,28 +275,41 @@ static void write_src(void)
 
 	printf("\t.section .rodata, \"a\"\n");
 
-	/* Provide proper symbols relocatability by their '_text'
-	 * relativeness.  The symbol names cannot be used to construct
-	 * normal symbol references as the list of symbols contains
-	 * symbols that are declared static and are private to their
-	 * .o files.  This prevents .tmp_kallsyms.o or any other
-	 * object from referencing them.
+	/* Find the lowest address so that all offsets come out non-negative.
+	 * The input is sorted by nm -n, but be defensive about it.
+	 */
+	relative_base = table[0].addr;
+	for (i = 1; i < table_cnt; i++)
+		if (table[i].addr < relative_base)
+			relative_base = table[i].addr;
+
+	/* The addresses are emitted as 32 bit offsets from a single base
+	 * instead of one pointer per symbol. This halves the table on 64 bit
+	 * and, since the offsets are plain numbers, leaves the base as the
+	 * only entry the relocation code has to fix up when barebox moves
+	 * itself. The base is expressed by its '_text' relativeness because
+	 * the symbol names cannot be used to construct normal symbol
+	 * references: the list of symbols contains symbols that are declared
+	 * static and are private to their .o files.
 	 */
-	output_label("kallsyms_addresses");
+	output_label("kallsyms_offsets");
 	for (i = 0; i < table_cnt; i++) {
-		if (toupper(table[i].sym[0]) != 'A') {
-			if (_text <= table[i].addr)
-				printf("\tPTR\t_text + %#llx\n",
-					table[i].addr - _text);
-			else
-				printf("\tPTR\t_text - %#llx\n",
-					_text - table[i].addr);
-		} else {
-			printf("\tPTR\t%#llx\n", table[i].addr);
+		if (table[i].addr - relative_base > 0xffffffffULL) {
+			fprintf(stderr, "kallsyms failure: "
+				"symbol offset exceeds 32 bit\n");
+			exit(EXIT_FAILURE);
 		}
+		printf("\t.long\t%#llx\n", table[i].addr - relative_base);
 	}
 	printf("\n");
 
+	output_label("kallsyms_relative_base");
+	if (_text <= relative_base)
+		printf("\tPTR\t_text + %#llx\n", relative_base - _text);
+	else
+		printf("\tPTR\t_text - %#llx\n", _text - relative_base);
+	printf("\n");
+
 	output_label("kallsyms_num_syms");
 	printf("\tPTR\t%u\n", table_cnt);
 	printf("\n");
@@ -334,6 +359,41 @@ static void write_src(void)
 	for (i = 0; i < 256; i++)
 		printf("\t.short\t%u\n", best_idx[i]);
 	printf("\n");
+
+	/* table of the symbol indices sorted by symbol name, so that name
+	 * lookups can binary search instead of decompressing every symbol.
+	 * Three bytes per entry keep the table small while still covering
+	 * far more symbols than an image will ever carry.
+	 */
+	sorted = malloc(sizeof(unsigned int) * table_cnt);
+	sorted_names = malloc(sizeof(char *) * table_cnt);
+	if (!sorted || !sorted_names) {
+		fprintf(stderr, "kallsyms failure: "
+			"unable to allocate required memory\n");
+		exit(EXIT_FAILURE);
+	}
+
+	for (i = 0; i < table_cnt; i++) {
+		expand_symbol(table[i].sym, table[i].len, buf);
+		/* skip the type char, the runtime compares bare names */
+		sorted_names[i] = strdup(buf + 1);
+		sorted[i] = i;
+	}
+
+	qsort(sorted, table_cnt, sizeof(unsigned int), compare_names);
+
+	output_label("kallsyms_seqs_of_names");
+	for (i = 0; i < table_cnt; i++)
+		printf("\t.byte 0x%02x, 0x%02x, 0x%02x\n",
+			(sorted[i] >> 16) & 0xFF,
+			(sorted[i] >> 8) & 0xFF,
+			sorted[i] & 0xFF);
+	printf("\n");
+
+	for (i = 0; i < table_cnt; i++)
+		free(sorted_names[i]);
+	free(sorted_names);
+	free(sorted);
 }
 
 
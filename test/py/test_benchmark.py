@@ -0,0 +1,128 @@
+# SPDX-License-Identifier: GPL-2.0-only
+
+"""Performance benchmark tier.
+
+Each test runs one of the in-barebox benchmark commands, records the
+parsed metrics as a JSON artifact and optionally compares them against
+a baseline:
+
+  BAREBOX_BENCH_DIR       directory the JSON artifacts are written to
+                          (default: $LG_BUILDDIR/benchmarks)
+  BAREBOX_BENCH_BASELINE  JSON file mapping metric names to minimum
+                          acceptable values; metrics below their
+                          baseline fail the test. Without a baseline
+                          the tests only record.
+
+Run with -m benchmark to select only this tier, or -m 'not benchmark'
+to exclude it from a functional test run.
+"""
+
+import json
+import os
+import re
+
+import pytest
+
+from .helper import skip_disabled
+
+pytestmark = pytest.mark.benchmark
+
+
+def record_artifact(name, metrics):
+    bench_dir = os.environ.get(
+        'BAREBOX_BENCH_DIR',
+        os.path.join(os.environ.get('LG_BUILDDIR', '.'), 'benchmarks'))
+    os.makedirs(bench_dir, exist_ok=True)
+
+    with open(os.path.join(bench_dir, name + '.json'), 'w') as f:
+        json.dump(metrics, f, indent=2, sort_keys=True)
+        f.write('\n')
+
+
+def check_baseline(metrics):
+    baseline_file = os.environ.get('BAREBOX_BENCH_BASELINE')
+    if not baseline_file:
+        return
+
+    with open(baseline_file) as f:
+        baseline = json.load(f)
+
+    regressions = [
+        f"{key}: {metrics[key]} < {minimum}"
+        for key, minimum in baseline.items()
+        if key in metrics and metrics[key] < minimum
+    ]
+
+    assert not regressions, "metrics below baseline: " + ", ".join(regressions)
+
+
+def parse_keyvals(line):
+    """Parse 'key=value' result lines as emitted by iobench/netbench."""
+    return {
+        key: int(val) if val.lstrip('-').isdigit() else val
+        for key, val in (field.split('=', 1)
+                         for field in line.split() if '=' in field)
+    }
+
+
+def test_membench(barebox, barebox_config):
+    skip_disabled(barebox_config, "CONFIG_CMD_MEMBENCH")
+
+    out = barebox.run_check("membench -s 1M -i 4")
+
+    metrics = {}
+    for line in out:
+        m = re.match(r'(memset|memcpy):\s+\d+ns \((\d+) MiB/s\)', line)
+        if m:
+            metrics[m.group(1) + '_mib_s'] = int(m.group(2))
+
+    assert 'memset_mib_s' in metrics and 'memcpy_mib_s' in metrics
+
+    record_artifact('membench', metrics)
+    check_baseline(metrics)
+
+
+def test_iobench(barebox, barebox_config):
+    skip_disabled(barebox_config, "CONFIG_CMD_IOBENCH", "CONFIG_CMD_MEMCPY")
+
+    # benchmark the ramfs as the lowest common denominator; lab hardware
+    # with real storage can additionally point iobench at a /dev cdev
+    barebox.run_check("memcpy -b /dev/zero /iobench.img 1M")
+
+    metrics = {}
+    for op, args in [('seqread', ''), ('rndread', '-r ')]:
+        out = barebox.run_check(f"iobench {args}-s 1M /iobench.img")
+        results = parse_keyvals(out[-1])
+        metrics[op + '_kib_s'] = results['rate_kib_s']
+        metrics[op + '_lat_avg_ns'] = results['lat_avg_ns']
+
+    barebox.run_check("rm /iobench.img")
+
+    record_artifact('iobench', metrics)
+    check_baseline(metrics)
+
+
+def test_bootprof(barebox, barebox_config):
+    skip_disabled(barebox_config, "CONFIG_CMD_BOOTPROF")
+
+    out = barebox.run_check("bootprof -r")
+
+    init_done_ns = 0
+    events = 0
+    for line in out:
+        fields = line.split()
+        if len(fields) < 4 or fields[0] not in ('initcall', 'probe'):
+            continue
+        events += 1
+        init_done_ns = max(init_done_ns, int(fields[1]) + int(fields[2]))
+
+    assert events, "no boot profiling events recorded"
+
+    # negated so that 'bigger is better' holds for all baseline checks
+    metrics = {
+        'neg_init_done_us': -(init_done_ns // 1000),
+        'events': events,
+    }
+
+    record_artifact('bootprof', metrics)
+    check_baseline(metrics)